@@ -0,0 +1,195 @@
+/*
+ *   Copyright (C) 2015,2016 by Jonathan Naylor G4KLX
+ *   Copyright (C) 2018 by Andy Uribe CA6JAU
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "CRC.h"
+
+#include "ECCTables.h"
+#include "Utils.h"
+#include "Log.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cassert>
+#include <cmath>
+
+static constexpr CECCTable<uint8_t, 2048U>  CRC8_TABLE     = CECCTables::crcSlices<uint8_t, 8U>(0x07U, false);
+static constexpr CECCTable<uint16_t, 2048U> CCITT16_TABLE1 = CECCTables::crcSlices<uint16_t, 8U>(0x8408U, true);
+static constexpr CECCTable<uint16_t, 2048U> CCITT16_TABLE2 = CECCTables::crcSlices<uint16_t, 8U>(0x1021U, false);
+
+static_assert(CRC8_TABLE.checksum() == 0xC8E9A9E5U, "CRC8_TABLE has changed");
+static_assert(CCITT16_TABLE1.checksum() == 0xF9911545U, "CCITT16_TABLE1 has changed");
+static_assert(CCITT16_TABLE2.checksum() == 0x60A86AC5U, "CCITT16_TABLE2 has changed");
+
+// The CRC kernels take eight bytes at a time, then four, then single
+// bytes, each step being independent lookups into the slicing tables.
+// There is no hardware CRC for these polynomials, the CRC32 instructions
+// only implement CRC-32C.
+
+// CRC-8, polynomial 0x07, MSB first
+static constexpr uint8_t crc8Bytes(uint8_t crc, const unsigned char* in, unsigned int length)
+{
+	for (; length >= 8U; in += 8U, length -= 8U)
+		crc = CRC8_TABLE[7U * 256U + (crc ^ in[0U])] ^ CRC8_TABLE[6U * 256U + in[1U]] ^
+		      CRC8_TABLE[5U * 256U + in[2U]] ^ CRC8_TABLE[4U * 256U + in[3U]] ^
+		      CRC8_TABLE[3U * 256U + in[4U]] ^ CRC8_TABLE[2U * 256U + in[5U]] ^
+		      CRC8_TABLE[1U * 256U + in[6U]] ^ CRC8_TABLE[in[7U]];
+
+	for (; length >= 4U; in += 4U, length -= 4U)
+		crc = CRC8_TABLE[3U * 256U + (crc ^ in[0U])] ^ CRC8_TABLE[2U * 256U + in[1U]] ^
+		      CRC8_TABLE[1U * 256U + in[2U]] ^ CRC8_TABLE[in[3U]];
+
+	for (; length > 0U; in++, length--)
+		crc = CRC8_TABLE[crc ^ in[0U]];
+
+	return crc;
+}
+
+// CCITT, polynomial 0x1021, LSB first (reflected)
+static constexpr uint16_t ccittLSBBytes(uint16_t crc, const unsigned char* in, unsigned int length)
+{
+	for (; length >= 8U; in += 8U, length -= 8U)
+		crc = CCITT16_TABLE1[7U * 256U + ((crc & 0xFFU) ^ in[0U])] ^ CCITT16_TABLE1[6U * 256U + ((crc >> 8) ^ in[1U])] ^
+		      CCITT16_TABLE1[5U * 256U + in[2U]] ^ CCITT16_TABLE1[4U * 256U + in[3U]] ^
+		      CCITT16_TABLE1[3U * 256U + in[4U]] ^ CCITT16_TABLE1[2U * 256U + in[5U]] ^
+		      CCITT16_TABLE1[1U * 256U + in[6U]] ^ CCITT16_TABLE1[in[7U]];
+
+	for (; length >= 4U; in += 4U, length -= 4U)
+		crc = CCITT16_TABLE1[3U * 256U + ((crc & 0xFFU) ^ in[0U])] ^ CCITT16_TABLE1[2U * 256U + ((crc >> 8) ^ in[1U])] ^
+		      CCITT16_TABLE1[1U * 256U + in[2U]] ^ CCITT16_TABLE1[in[3U]];
+
+	for (; length > 0U; in++, length--)
+		crc = uint16_t(crc >> 8) ^ CCITT16_TABLE1[(crc & 0xFFU) ^ in[0U]];
+
+	return crc;
+}
+
+// CCITT, polynomial 0x1021, MSB first
+static constexpr uint16_t ccittMSBBytes(uint16_t crc, const unsigned char* in, unsigned int length)
+{
+	for (; length >= 8U; in += 8U, length -= 8U)
+		crc = CCITT16_TABLE2[7U * 256U + ((crc >> 8) ^ in[0U])] ^ CCITT16_TABLE2[6U * 256U + ((crc & 0xFFU) ^ in[1U])] ^
+		      CCITT16_TABLE2[5U * 256U + in[2U]] ^ CCITT16_TABLE2[4U * 256U + in[3U]] ^
+		      CCITT16_TABLE2[3U * 256U + in[4U]] ^ CCITT16_TABLE2[2U * 256U + in[5U]] ^
+		      CCITT16_TABLE2[1U * 256U + in[6U]] ^ CCITT16_TABLE2[in[7U]];
+
+	for (; length >= 4U; in += 4U, length -= 4U)
+		crc = CCITT16_TABLE2[3U * 256U + ((crc >> 8) ^ in[0U])] ^ CCITT16_TABLE2[2U * 256U + ((crc & 0xFFU) ^ in[1U])] ^
+		      CCITT16_TABLE2[1U * 256U + in[2U]] ^ CCITT16_TABLE2[in[3U]];
+
+	for (; length > 0U; in++, length--)
+		crc = uint16_t(crc << 8) ^ CCITT16_TABLE2[(crc >> 8) ^ in[0U]];
+
+	return crc;
+}
+
+// The standard check values over "123456789", in one go and split so
+// that the eight, four and single byte steps are all covered
+static constexpr unsigned char CHECK_DATA[] = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+
+static_assert(crc8Bytes(0x00U, CHECK_DATA, 9U) == 0xF4U, "crc8Bytes is wrong");
+static_assert(crc8Bytes(crc8Bytes(0x00U, CHECK_DATA, 4U), CHECK_DATA + 4U, 5U) == 0xF4U, "crc8Bytes is wrong");
+static_assert(uint16_t(~ccittLSBBytes(0xFFFFU, CHECK_DATA, 9U)) == 0x906EU, "ccittLSBBytes is wrong");
+static_assert(uint16_t(~ccittLSBBytes(ccittLSBBytes(0xFFFFU, CHECK_DATA, 4U), CHECK_DATA + 4U, 5U)) == 0x906EU, "ccittLSBBytes is wrong");
+static_assert(uint16_t(~ccittMSBBytes(0x0000U, CHECK_DATA, 9U)) == 0xCE3CU, "ccittMSBBytes is wrong");
+static_assert(uint16_t(~ccittMSBBytes(ccittMSBBytes(0x0000U, CHECK_DATA, 4U), CHECK_DATA + 4U, 5U)) == 0xCE3CU, "ccittMSBBytes is wrong");
+
+bool CCRC::checkFiveBit(const unsigned char* in, unsigned int tcrc)
+{
+	assert(in != NULL);
+
+	unsigned int crc;
+	encodeFiveBit(in, crc);
+
+	return crc == tcrc;
+}
+
+void CCRC::encodeFiveBit(const unsigned char* in, unsigned int& tcrc)
+{
+	assert(in != NULL);
+
+	unsigned int total = 0U;
+	for (unsigned int i = 0U; i < 9U; i++)
+		total += in[i];
+
+	total %= 31U;
+
+	tcrc = total;
+}
+
+void CCRC::addCCITT162(unsigned char *in, unsigned int length)
+{
+	assert(in != NULL);
+	assert(length > 2U);
+
+	uint16_t crc16 = ~ccittMSBBytes(0x0000U, in, length - 2U);
+
+	in[length - 2U] = crc16 >> 8;
+	in[length - 1U] = crc16 & 0xFFU;
+}
+
+bool CCRC::checkCCITT162(const unsigned char *in, unsigned int length)
+{
+	assert(in != NULL);
+	assert(length > 2U);
+
+	uint16_t crc16 = ~ccittMSBBytes(0x0000U, in, length - 2U);
+
+	return (crc16 >> 8) == in[length - 2U] && (crc16 & 0xFFU) == in[length - 1U];
+}
+
+void CCRC::addCCITT161(unsigned char *in, unsigned int length)
+{
+	assert(in != NULL);
+	assert(length > 2U);
+
+	uint16_t crc16 = ~ccittLSBBytes(0xFFFFU, in, length - 2U);
+
+	in[length - 2U] = crc16 & 0xFFU;
+	in[length - 1U] = crc16 >> 8;
+}
+
+bool CCRC::checkCCITT161(const unsigned char *in, unsigned int length)
+{
+	assert(in != NULL);
+	assert(length > 2U);
+
+	uint16_t crc16 = ~ccittLSBBytes(0xFFFFU, in, length - 2U);
+
+	return (crc16 & 0xFFU) == in[length - 2U] && (crc16 >> 8) == in[length - 1U];
+}
+
+unsigned char CCRC::crc8(const unsigned char *in, unsigned int length)
+{
+	assert(in != NULL);
+
+	return crc8Bytes(0x00U, in, length);
+}
+
+unsigned char CCRC::addCRC(const unsigned char* in, unsigned int length)
+{
+	assert(in != NULL);
+
+	unsigned char crc = 0U;
+
+	for (unsigned int i = 0U; i < length; i++)
+		crc += in[i];
+
+	return crc;
+}
+
@@ -0,0 +1,179 @@
+/*
+ *   Copyright (C) 2019 by Manuel Sanchez EA7EE
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#ifndef ECCTables_H
+#define ECCTables_H
+
+#include <cstdint>
+
+// Fixed size lookup table that can be filled in by a constexpr function,
+// so the compiler builds it and places it in read only data.
+template<class T, unsigned int N> class CECCTable {
+public:
+	constexpr const T& operator[](unsigned int n) const
+	{
+		return m_data[n];
+	}
+
+	// FNV-1a over the entries, used by the static_asserts next to each
+	// table to pin it to the values it has always had.
+	constexpr uint32_t checksum() const
+	{
+		uint32_t hash = 2166136261U;
+
+		for (unsigned int i = 0U; i < N; i++)
+			hash = (hash ^ uint32_t(m_data[i])) * 16777619U;
+
+		return hash;
+	}
+
+	T m_data[N];
+};
+
+// Generators for the encoding, decoding and CRC tables, all computed at
+// compile time from the generator polynomials.
+class CECCTables {
+public:
+	// Remainder of the pattern divided by the generator polynomial of the
+	// given degree.
+	static constexpr unsigned int remainder(unsigned int pattern, unsigned int genpol, unsigned int degree)
+	{
+		for (unsigned int bit = 31U; bit >= degree; bit--) {
+			if ((pattern >> bit) & 0x01U)
+				pattern ^= genpol << (bit - degree);
+		}
+
+		return pattern;
+	}
+
+	// Systematic codeword, the data bits followed by the check bits.
+	static constexpr unsigned int codeword(unsigned int data, unsigned int genpol, unsigned int degree)
+	{
+		return (data << degree) | remainder(data << degree, genpol, degree);
+	}
+
+	// Syndrome of each value of the data bits of a cyclic code. The check
+	// bits are their own remainder, so the syndrome of a received word is
+	// table[word >> degree] ^ (word & ((1 << degree) - 1)).
+	template<unsigned int N>
+	static constexpr CECCTable<unsigned int, N> syndromes(unsigned int genpol, unsigned int degree)
+	{
+		CECCTable<unsigned int, N> table = {};
+
+		for (unsigned int data = 0U; data < N; data++)
+			table.m_data[data] = remainder(data << degree, genpol, degree);
+
+		return table;
+	}
+
+	static constexpr unsigned int parity(unsigned int value)
+	{
+		unsigned int count = 0U;
+
+		for (; value != 0U; value >>= 1)
+			count ^= value & 0x01U;
+
+		return count;
+	}
+
+	// Error pattern for each syndrome of a cyclic code with the given number
+	// of bits. For every weight up to maxWeight the patterns are visited in
+	// lexicographic order of their bit positions and the first, lowest weight
+	// pattern found for a syndrome is kept. Syndromes not reached are zero.
+	template<unsigned int N>
+	static constexpr CECCTable<unsigned int, N> decoding(unsigned int bits, unsigned int genpol, unsigned int degree, unsigned int maxWeight)
+	{
+		CECCTable<unsigned int, N> table = {};
+
+		for (unsigned int weight = 1U; weight <= maxWeight; weight++)
+			addErrors(table, 0U, 0U, weight, bits, genpol, degree);
+
+		return table;
+	}
+
+	// Byte wise CRC table, MSB first or, when reflected, LSB first with the
+	// polynomial given in reflected form.
+	template<class T>
+	static constexpr CECCTable<T, 256U> crc(T poly, bool reflected)
+	{
+		CECCTable<T, 256U> table = {};
+
+		const unsigned int width = sizeof(T) * 8U;
+		const T topBit = T(1U) << (width - 1U);
+
+		for (unsigned int i = 0U; i < 256U; i++) {
+			T value = reflected ? T(i) : T(T(i) << (width - 8U));
+
+			for (unsigned int j = 0U; j < 8U; j++) {
+				if (reflected)
+					value = (value & 0x01U) ? T((value >> 1) ^ poly) : T(value >> 1);
+				else
+					value = (value & topBit) ? T((value << 1) ^ poly) : T(value << 1);
+			}
+
+			table.m_data[i] = value;
+		}
+
+		return table;
+	}
+
+	// Slicing tables for crc(), entry k * 256 + i is the CRC of byte i
+	// followed by k zero bytes, for k from 0 to N - 1. This lets N bytes be
+	// folded into the CRC with N independent lookups.
+	template<class T, unsigned int N>
+	static constexpr CECCTable<T, N * 256U> crcSlices(T poly, bool reflected)
+	{
+		CECCTable<T, N * 256U> table = {};
+
+		const unsigned int width = sizeof(T) * 8U;
+		const CECCTable<T, 256U> base = crc<T>(poly, reflected);
+
+		for (unsigned int i = 0U; i < 256U; i++)
+			table.m_data[i] = base[i];
+
+		for (unsigned int k = 1U; k < N; k++) {
+			for (unsigned int i = 0U; i < 256U; i++) {
+				T value = table.m_data[(k - 1U) * 256U + i];
+
+				if (reflected)
+					table.m_data[k * 256U + i] = T((value >> 8) ^ base[value & 0xFFU]);
+				else
+					table.m_data[k * 256U + i] = T((value << 8) ^ base[value >> (width - 8U)]);
+			}
+		}
+
+		return table;
+	}
+
+private:
+	template<unsigned int N>
+	static constexpr void addErrors(CECCTable<unsigned int, N>& table, unsigned int pattern, unsigned int first, unsigned int weight, unsigned int bits, unsigned int genpol, unsigned int degree)
+	{
+		if (weight == 0U) {
+			unsigned int syndrome = remainder(pattern, genpol, degree);
+			if (syndrome != 0U && table.m_data[syndrome] == 0U)
+				table.m_data[syndrome] = pattern;
+			return;
+		}
+
+		for (unsigned int i = first; i < bits; i++)
+			addErrors(table, pattern | (1U << i), i + 1U, weight - 1U, bits, genpol, degree);
+	}
+};
+
+#endif
@@ -0,0 +1,73 @@
+/*
+ *   Copyright (C) 2015,2016 by Jonathan Naylor G4KLX
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "Golay2087.h"
+
+#include "ECCTables.h"
+
+#include <cstdio>
+#include <cassert>
+
+#define GENPOL          0x00000c75   /* generator polinomial, g(x) */
+
+// Check bits of the (20,8) code, a shortened (23,12) Golay codeword plus an
+// overall parity bit, laid out as they are sent in the second and third bytes.
+static constexpr CECCTable<unsigned int, 256U> makeEncodingTable2087()
+{
+	CECCTable<unsigned int, 256U> table = {};
+
+	for (unsigned int data = 0U; data < 256U; data++) {
+		unsigned int code  = CECCTables::codeword(data, GENPOL, 11U);
+		unsigned int check = code & 0x7FFU;
+		table.m_data[data] = ((check >> 3) & 0xFFU) | ((check & 0x07U) << 13) | (CECCTables::parity(code) << 12);
+	}
+
+	return table;
+}
+
+static constexpr CECCTable<unsigned int, 256U>  ENCODING_TABLE_2087 = makeEncodingTable2087();
+static constexpr CECCTable<unsigned int, 256U>  SYNDROME_TABLE_1987 = CECCTables::syndromes<256U>(GENPOL, 11U);
+static constexpr CECCTable<unsigned int, 2048U> DECODING_TABLE_1987 = CECCTables::decoding<2048U>(19U, GENPOL, 11U, 5U);
+
+static_assert(ENCODING_TABLE_2087.checksum() == 0x372F9705U, "ENCODING_TABLE_2087 has changed");
+static_assert(SYNDROME_TABLE_1987.checksum() == 0x97E9A9C5U, "SYNDROME_TABLE_1987 has changed");
+static_assert(DECODING_TABLE_1987.checksum() == 0xE1158443U, "DECODING_TABLE_1987 has changed");
+
+unsigned char CGolay2087::decode(const unsigned char* data)
+{
+	assert(data != NULL);
+
+	unsigned int code = (data[0U] << 11) + (data[1U] << 3) + (data[2U] >> 5);
+	unsigned int syndrome = SYNDROME_TABLE_1987[code >> 11] ^ (code & 0x7FFU);
+
+	code ^= DECODING_TABLE_1987[syndrome];
+
+	return code >> 11;
+}
+
+void CGolay2087::encode(unsigned char* data)
+{
+	assert(data != NULL);
+
+	unsigned int value = data[0U];
+
+	unsigned int cksum = ENCODING_TABLE_2087[value];
+
+	data[1U] = cksum & 0xFFU;
+	data[2U] = cksum >> 8;
+}
@@ -0,0 +1,98 @@
+/*
+ *   Copyright (C) 2010,2016 by Jonathan Naylor G4KLX
+ *   Copyright (C) 2002 by Robert H. Morelos-Zaragoza. All rights reserved.
+ */
+
+#include "Golay24128.h"
+
+#include "ECCTables.h"
+
+#include <cstdio>
+#include <cassert>
+
+const unsigned int GENPOL_23127 = 0xC75U;
+
+static constexpr CECCTable<unsigned int, 4096U> makeEncodingTable23127()
+{
+	CECCTable<unsigned int, 4096U> table = {};
+
+	for (unsigned int data = 0U; data < 4096U; data++)
+		table.m_data[data] = CECCTables::codeword(data, GENPOL_23127, 11U) << 1;
+
+	return table;
+}
+
+static constexpr CECCTable<unsigned int, 4096U> makeEncodingTable24128()
+{
+	CECCTable<unsigned int, 4096U> table = {};
+
+	for (unsigned int data = 0U; data < 4096U; data++) {
+		unsigned int code = CECCTables::codeword(data, GENPOL_23127, 11U);
+		table.m_data[data] = (code << 1) | CECCTables::parity(code);
+	}
+
+	return table;
+}
+
+// Remainder of (d << 11) divided by the generator polynomial for all
+// twelve bit d. The code is linear, so the syndrome of a received word is
+// SYNDROME_TABLE_23127[code >> 11] ^ (code & 0x7FF), with no long division.
+static constexpr CECCTable<unsigned int, 4096U> makeSyndromeTable23127()
+{
+	CECCTable<unsigned int, 4096U> table = {};
+
+	for (unsigned int data = 0U; data < 4096U; data++)
+		table.m_data[data] = CECCTables::remainder(data << 11, GENPOL_23127, 11U);
+
+	return table;
+}
+
+static constexpr CECCTable<unsigned int, 4096U> ENCODING_TABLE_23127 = makeEncodingTable23127();
+static constexpr CECCTable<unsigned int, 4096U> ENCODING_TABLE_24128 = makeEncodingTable24128();
+static constexpr CECCTable<unsigned int, 4096U> SYNDROME_TABLE_23127 = makeSyndromeTable23127();
+
+// The code is perfect, every syndrome maps to an error of weight three or less
+static constexpr CECCTable<unsigned int, 2048U> DECODING_TABLE_23127 = CECCTables::decoding<2048U>(23U, GENPOL_23127, 11U, 3U);
+
+static_assert(ENCODING_TABLE_23127.checksum() == 0xC7A875C5U, "ENCODING_TABLE_23127 has changed");
+static_assert(ENCODING_TABLE_24128.checksum() == 0x28CC4845U, "ENCODING_TABLE_24128 has changed");
+static_assert(SYNDROME_TABLE_23127.checksum() == 0x54995BC5U, "SYNDROME_TABLE_23127 has changed");
+static_assert(DECODING_TABLE_23127.checksum() == 0xA5DD5055U, "DECODING_TABLE_23127 has changed");
+
+unsigned int CGolay24128::encode23127(unsigned int data)
+{
+    return ENCODING_TABLE_23127[data];
+}
+
+unsigned int CGolay24128::encode24128(unsigned int data)
+{
+    return ENCODING_TABLE_24128[data];
+}
+
+unsigned int CGolay24128::decode23127(unsigned int code)
+{
+	unsigned int syndrome = SYNDROME_TABLE_23127[(code >> 11) & 0xFFFU] ^ (code & 0x7FFU);
+	unsigned int error_pattern = DECODING_TABLE_23127[syndrome];
+
+	code ^= error_pattern;
+
+	return code >> 11;
+}
+
+unsigned int CGolay24128::decode24128(unsigned int code)
+{
+	return decode23127(code >> 1);
+}
+
+unsigned int CGolay24128::decode24128(unsigned char* bytes)
+{
+	assert(bytes != NULL);
+
+	unsigned int code = bytes[0U];
+	code <<= 8;
+	code |= bytes[1U];
+	code <<= 8;
+	code |= bytes[2U];
+
+	return decode23127(code >> 1);
+}
@@ -18,9 +18,104 @@
 
 #include "Hamming.h"
 
+#include "ECCTables.h"
+
 #include <cstdio>
 #include <cassert>
 
+// Parity check rows of each code on a packed word, d[0] being the most
+// significant bit. Bit i of a syndrome is the parity of the word under row i.
+static constexpr unsigned int ROWS_15113_1[] = {0x7F08U, 0x78E4U, 0x66D2U, 0x55B1U};
+static constexpr unsigned int ROWS_15113_2[] = {0x7AC8U, 0x3D64U, 0x1EB2U, 0x7591U};
+static constexpr unsigned int ROWS_1393[]    = {0x1AC8U, 0x1D64U, 0x1EB2U, 0x1591U};
+static constexpr unsigned int ROWS_1063[]    = {0x0398U, 0x0354U, 0x02E2U, 0x01E1U};
+static constexpr unsigned int ROWS_16114[]   = {0xF590U, 0x7AC8U, 0x3D64U, 0xEB22U, 0xA6E1U};
+static constexpr unsigned int ROWS_17123[]   = {0x1E690U, 0x1F348U, 0x0F9A4U, 0x19A42U, 0x1CD21U};
+
+// The syndrome is linear, so it is the sum of the syndromes of the three
+// bytes of the word, each taken from its own 256 entry part of the table.
+static constexpr CECCTable<unsigned char, 768U> makeSyndromeTable(const unsigned int* rows, unsigned int checks)
+{
+	CECCTable<unsigned char, 768U> table = {};
+
+	for (unsigned int n = 0U; n < 3U; n++) {
+		for (unsigned int value = 0U; value < 256U; value++) {
+			unsigned int word = value << (n * 8U);
+
+			unsigned char syndrome = 0U;
+			for (unsigned int i = 0U; i < checks; i++)
+				syndrome |= CECCTables::parity(word & rows[i]) << i;
+
+			table.m_data[n * 256U + value] = syndrome;
+		}
+	}
+
+	return table;
+}
+
+// The single bit error for each syndrome, zero when there is none.
+static constexpr CECCTable<unsigned int, 32U> makeErrorTable(unsigned int bits, const unsigned int* rows, unsigned int checks)
+{
+	CECCTable<unsigned int, 32U> table = {};
+
+	for (unsigned int n = 0U; n < bits; n++) {
+		unsigned int syndrome = 0U;
+		for (unsigned int i = 0U; i < checks; i++)
+			syndrome |= CECCTables::parity((1U << n) & rows[i]) << i;
+
+		table.m_data[syndrome] = 1U << n;
+	}
+
+	return table;
+}
+
+static constexpr CECCTable<unsigned char, 768U> SYNDROME_TABLE_15113_1 = makeSyndromeTable(ROWS_15113_1, 4U);
+static constexpr CECCTable<unsigned char, 768U> SYNDROME_TABLE_15113_2 = makeSyndromeTable(ROWS_15113_2, 4U);
+static constexpr CECCTable<unsigned char, 768U> SYNDROME_TABLE_1393    = makeSyndromeTable(ROWS_1393, 4U);
+static constexpr CECCTable<unsigned char, 768U> SYNDROME_TABLE_1063    = makeSyndromeTable(ROWS_1063, 4U);
+static constexpr CECCTable<unsigned char, 768U> SYNDROME_TABLE_16114   = makeSyndromeTable(ROWS_16114, 5U);
+static constexpr CECCTable<unsigned char, 768U> SYNDROME_TABLE_17123   = makeSyndromeTable(ROWS_17123, 5U);
+
+static constexpr CECCTable<unsigned int, 32U> ERROR_TABLE_15113_1 = makeErrorTable(15U, ROWS_15113_1, 4U);
+static constexpr CECCTable<unsigned int, 32U> ERROR_TABLE_15113_2 = makeErrorTable(15U, ROWS_15113_2, 4U);
+static constexpr CECCTable<unsigned int, 32U> ERROR_TABLE_1393    = makeErrorTable(13U, ROWS_1393, 4U);
+static constexpr CECCTable<unsigned int, 32U> ERROR_TABLE_1063    = makeErrorTable(10U, ROWS_1063, 4U);
+static constexpr CECCTable<unsigned int, 32U> ERROR_TABLE_16114   = makeErrorTable(16U, ROWS_16114, 5U);
+static constexpr CECCTable<unsigned int, 32U> ERROR_TABLE_17123   = makeErrorTable(17U, ROWS_17123, 5U);
+
+static_assert(SYNDROME_TABLE_15113_1.checksum() == 0x152F1A45U, "SYNDROME_TABLE_15113_1 has changed");
+static_assert(SYNDROME_TABLE_15113_2.checksum() == 0x5DC01DC5U, "SYNDROME_TABLE_15113_2 has changed");
+static_assert(SYNDROME_TABLE_1393.checksum() == 0x2823C045U, "SYNDROME_TABLE_1393 has changed");
+static_assert(SYNDROME_TABLE_1063.checksum() == 0x39E5CB45U, "SYNDROME_TABLE_1063 has changed");
+static_assert(SYNDROME_TABLE_16114.checksum() == 0x071C6685U, "SYNDROME_TABLE_16114 has changed");
+static_assert(SYNDROME_TABLE_17123.checksum() == 0x1C901145U, "SYNDROME_TABLE_17123 has changed");
+
+static_assert(ERROR_TABLE_15113_1.checksum() == 0xCA32B77AU, "ERROR_TABLE_15113_1 has changed");
+static_assert(ERROR_TABLE_15113_2.checksum() == 0x56C02DFAU, "ERROR_TABLE_15113_2 has changed");
+static_assert(ERROR_TABLE_1393.checksum() == 0x7A21CDFAU, "ERROR_TABLE_1393 has changed");
+static_assert(ERROR_TABLE_1063.checksum() == 0x0ACE8F1AU, "ERROR_TABLE_1063 has changed");
+static_assert(ERROR_TABLE_16114.checksum() == 0x331E522AU, "ERROR_TABLE_16114 has changed");
+static_assert(ERROR_TABLE_17123.checksum() == 0x2DEAE32AU, "ERROR_TABLE_17123 has changed");
+
+static inline unsigned int getSyndrome(const CECCTable<unsigned char, 768U>& table, unsigned int word)
+{
+	return table[word & 0xFFU] ^ table[256U + ((word >> 8) & 0xFFU)] ^ table[512U + ((word >> 16) & 0xFFU)];
+}
+
+// The check bits are the syndrome of the data with the check bits clear,
+// each check bit only appearing in its own row, the last row last.
+static inline unsigned int encodePacked(const CECCTable<unsigned char, 768U>& table, unsigned int data, unsigned int checks)
+{
+	unsigned int code = data << checks;
+	unsigned int syndrome = getSyndrome(table, code);
+
+	unsigned int check = 0U;
+	for (unsigned int i = 0U; i < checks; i++)
+		check |= ((syndrome >> i) & 0x01U) << (checks - 1U - i);
+
+	return code | check;
+}
+
  // Hamming (15,11,3) check a boolean data array
 bool CHamming::decode15113_1(bool* d)
 {
@@ -347,3 +442,91 @@ void CHamming::encode17123(bool* d)
 	d[15] = d[0] ^ d[1] ^ d[4] ^ d[5] ^ d[7] ^ d[10];
 	d[16] = d[0] ^ d[1] ^ d[2] ^ d[5] ^ d[6] ^ d[8] ^ d[11];
 }
+
+unsigned int CHamming::encode15113_1(unsigned int data)
+{
+	return encodePacked(SYNDROME_TABLE_15113_1, data & 0x7FFU, 4U);
+}
+
+bool CHamming::decode15113_1(unsigned int& code)
+{
+	unsigned int error = ERROR_TABLE_15113_1[getSyndrome(SYNDROME_TABLE_15113_1, code)];
+
+	code ^= error;
+
+	return error != 0U;
+}
+
+unsigned int CHamming::encode15113_2(unsigned int data)
+{
+	return encodePacked(SYNDROME_TABLE_15113_2, data & 0x7FFU, 4U);
+}
+
+bool CHamming::decode15113_2(unsigned int& code)
+{
+	unsigned int error = ERROR_TABLE_15113_2[getSyndrome(SYNDROME_TABLE_15113_2, code)];
+
+	code ^= error;
+
+	return error != 0U;
+}
+
+unsigned int CHamming::encode1393(unsigned int data)
+{
+	return encodePacked(SYNDROME_TABLE_1393, data & 0x1FFU, 4U);
+}
+
+bool CHamming::decode1393(unsigned int& code)
+{
+	unsigned int error = ERROR_TABLE_1393[getSyndrome(SYNDROME_TABLE_1393, code)];
+
+	code ^= error;
+
+	return error != 0U;
+}
+
+unsigned int CHamming::encode1063(unsigned int data)
+{
+	return encodePacked(SYNDROME_TABLE_1063, data & 0x3FU, 4U);
+}
+
+bool CHamming::decode1063(unsigned int& code)
+{
+	unsigned int error = ERROR_TABLE_1063[getSyndrome(SYNDROME_TABLE_1063, code)];
+
+	code ^= error;
+
+	return error != 0U;
+}
+
+unsigned int CHamming::encode16114(unsigned int data)
+{
+	return encodePacked(SYNDROME_TABLE_16114, data & 0x7FFU, 5U);
+}
+
+bool CHamming::decode16114(unsigned int& code)
+{
+	unsigned int syndrome = getSyndrome(SYNDROME_TABLE_16114, code);
+	unsigned int error = ERROR_TABLE_16114[syndrome];
+
+	code ^= error;
+
+	// Anything other than no error or a single error is unrecoverable
+	return syndrome == 0U || error != 0U;
+}
+
+unsigned int CHamming::encode17123(unsigned int data)
+{
+	return encodePacked(SYNDROME_TABLE_17123, data & 0xFFFU, 5U);
+}
+
+bool CHamming::decode17123(unsigned int& code)
+{
+	unsigned int syndrome = getSyndrome(SYNDROME_TABLE_17123, code);
+	unsigned int error = ERROR_TABLE_17123[syndrome];
+
+	code ^= error;
+
+	// Anything other than no error or a single error is unrecoverable
+	return syndrome == 0U || error != 0U;
+}
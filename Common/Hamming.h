@@ -38,6 +38,27 @@ public:
 
 	static void encode17123(bool* d);
 	static bool decode17123(bool* d);
+
+	// The same codes on packed words. The encoders take the data bits and
+	// return the codeword, d[0] being its most significant bit. The
+	// decoders correct the codeword in place and return as above.
+	static unsigned int encode15113_1(unsigned int data);
+	static bool decode15113_1(unsigned int& code);
+
+	static unsigned int encode15113_2(unsigned int data);
+	static bool decode15113_2(unsigned int& code);
+
+	static unsigned int encode1393(unsigned int data);
+	static bool decode1393(unsigned int& code);
+
+	static unsigned int encode1063(unsigned int data);
+	static bool decode1063(unsigned int& code);
+
+	static unsigned int encode16114(unsigned int data);
+	static bool decode16114(unsigned int& code);
+
+	static unsigned int encode17123(unsigned int data);
+	static bool decode17123(unsigned int& code);
 };
 
 #endif
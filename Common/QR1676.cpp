@@ -0,0 +1,71 @@
+/*
+ *   Copyright (C) 2015,2016 by Jonathan Naylor G4KLX
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "QR1676.h"
+#include "ECCTables.h"
+#include "Log.h"
+
+#include <cstdio>
+#include <cassert>
+
+#define GENPOL          0x00000139   /* generator polinomial, g(x) */
+
+// Codeword with a trailing overall parity bit, as sent in the EMB
+static constexpr CECCTable<unsigned int, 128U> makeEncodingTable1676()
+{
+	CECCTable<unsigned int, 128U> table = {};
+
+	for (unsigned int data = 0U; data < 128U; data++) {
+		unsigned int code = CECCTables::codeword(data, GENPOL, 8U);
+		table.m_data[data] = (code << 1) | CECCTables::parity(code);
+	}
+
+	return table;
+}
+
+static constexpr CECCTable<unsigned int, 128U> ENCODING_TABLE_1676 = makeEncodingTable1676();
+static constexpr CECCTable<unsigned int, 128U> SYNDROME_TABLE_1576 = CECCTables::syndromes<128U>(GENPOL, 8U);
+static constexpr CECCTable<unsigned int, 256U> DECODING_TABLE_1576 = CECCTables::decoding<256U>(15U, GENPOL, 8U, 4U);
+
+static_assert(ENCODING_TABLE_1676.checksum() == 0x1A9B7F05U, "ENCODING_TABLE_1676 has changed");
+static_assert(SYNDROME_TABLE_1576.checksum() == 0x20D63085U, "SYNDROME_TABLE_1576 has changed");
+static_assert(DECODING_TABLE_1576.checksum() == 0xD6CAB4F3U, "DECODING_TABLE_1576 has changed");
+
+// Compute the EMB against a precomputed list of correct words
+void CQR1676::encode(unsigned char* data)
+{
+	assert(data != NULL);
+
+	unsigned int value = (data[0U] >> 1) & 0x7FU;
+	unsigned int cksum = ENCODING_TABLE_1676[value];
+
+	data[0U] = cksum >> 8;
+	data[1U] = cksum & 0xFFU;
+}
+
+unsigned char CQR1676::decode(const unsigned char* data)
+{
+	assert(data != NULL);
+
+	unsigned int code = (data[0U] << 7) + (data[1U] >> 1);
+	unsigned int syndrome = SYNDROME_TABLE_1576[code >> 8] ^ (code & 0xFFU);
+
+	code ^= DECODING_TABLE_1576[syndrome];
+
+	return code >> 7;
+}
@@ -24,9 +24,6 @@ public:
 	static void encode(unsigned char* data);
 
 	static unsigned char decode(const unsigned char* data);
-
-private:
-	static unsigned int getSyndrome1576(unsigned int pattern);
 };
 
 #endif
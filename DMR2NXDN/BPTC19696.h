@@ -19,6 +19,8 @@
 #if !defined(BPTC19696_H)
 #define	BPTC19696_H
 
+#include <cstdint>
+
 class CBPTC19696
 {
 public:
@@ -30,18 +32,16 @@ public:
 	void encode(const unsigned char* in, unsigned char* out);
 
 private:
-	bool* m_rawData;
-	bool* m_deInterData;
+	// The 13 x 15 matrix, one row per word with column 0 in bit 14
+	uint16_t m_rows[13U];
 
 	void decodeExtractBinary(const unsigned char* in);
 	void decodeErrorCheck();
-	void decodeDeInterleave();
 	void decodeExtractData(unsigned char* data) const;
 
-	void encodeExtractData(const unsigned char* in) const;
-	void encodeInterleave();
+	void encodeExtractData(const unsigned char* in);
 	void encodeErrorCheck();
-	void encodeExtractBinary(unsigned char* data);
+	void encodeExtractBinary(unsigned char* data) const;
 };
 
 #endif
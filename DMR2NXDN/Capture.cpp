@@ -0,0 +1,240 @@
+/*
+ *   Copyright (C) 2019 by Manuel Sanchez EA7EE
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "Capture.h"
+#include "Clock.h"
+#include "Log.h"
+
+#include <cassert>
+#include <cstring>
+
+/*
+ * File layout, all integers big endian:
+ *   "YSF2CAP1"
+ *   per record: time (8, us since capture start), channel (1), tx (1),
+ *   address (4, network order), port (2), length (2), data
+ */
+const unsigned char CAPTURE_MAGIC[] = {'Y', 'S', 'F', '2', 'C', 'A', 'P', '1'};
+
+const unsigned int CAPTURE_HEADER_LENGTH = 18U;
+
+CCapture::CCapture(const std::string& filename) :
+m_filename(filename),
+m_fp(NULL),
+m_mutex(),
+m_start(0ULL)
+{
+	assert(!filename.empty());
+}
+
+CCapture::~CCapture()
+{
+}
+
+bool CCapture::open()
+{
+	m_fp = ::fopen(m_filename.c_str(), "wb");
+	if (m_fp == NULL) {
+		LogError("Cannot open the capture file - %s", m_filename.c_str());
+		return false;
+	}
+
+	::fwrite(CAPTURE_MAGIC, 1U, sizeof(CAPTURE_MAGIC), m_fp);
+
+	m_start = CClock::getTime();
+
+	LogMessage("Capturing network traffic to %s", m_filename.c_str());
+
+	return true;
+}
+
+void CCapture::write(unsigned char channel, bool tx, const in_addr& address, unsigned int port, const unsigned char* data, unsigned int length)
+{
+	assert(channel < CAPTURE_CHANNELS);
+	assert(data != NULL);
+	assert(length < 65536U);
+
+	if (m_fp == NULL)
+		return;
+
+	unsigned long long time = CClock::getTime() - m_start;
+
+	unsigned char header[CAPTURE_HEADER_LENGTH];
+	for (unsigned int i = 0U; i < 8U; i++)
+		header[i] = (unsigned char)(time >> (56U - i * 8U));
+	header[8U] = channel;
+	header[9U] = tx ? 1U : 0U;
+	::memcpy(header + 10U, &address.s_addr, 4U);
+	header[14U] = port >> 8;
+	header[15U] = port >> 0;
+	header[16U] = length >> 8;
+	header[17U] = length >> 0;
+
+	m_mutex.lock();
+
+	::fwrite(header, 1U, CAPTURE_HEADER_LENGTH, m_fp);
+	::fwrite(data, 1U, length, m_fp);
+
+	m_mutex.unlock();
+}
+
+void CCapture::close()
+{
+	if (m_fp == NULL)
+		return;
+
+	m_mutex.lock();
+
+	::fclose(m_fp);
+	m_fp = NULL;
+
+	m_mutex.unlock();
+}
+
+bool CCapture::load(const std::string& filename, bool tx, std::vector<CCaptureRecord>* records)
+{
+	assert(records != NULL);
+
+	FILE* fp = ::fopen(filename.c_str(), "rb");
+	if (fp == NULL) {
+		LogError("Cannot open the capture file - %s", filename.c_str());
+		return false;
+	}
+
+	unsigned char magic[sizeof(CAPTURE_MAGIC)];
+	if (::fread(magic, 1U, sizeof(CAPTURE_MAGIC), fp) != sizeof(CAPTURE_MAGIC) || ::memcmp(magic, CAPTURE_MAGIC, sizeof(CAPTURE_MAGIC)) != 0) {
+		LogError("%s is not a capture file", filename.c_str());
+		::fclose(fp);
+		return false;
+	}
+
+	unsigned char header[CAPTURE_HEADER_LENGTH];
+	while (::fread(header, 1U, CAPTURE_HEADER_LENGTH, fp) == CAPTURE_HEADER_LENGTH) {
+		CCaptureRecord record;
+
+		record.m_time = 0ULL;
+		for (unsigned int i = 0U; i < 8U; i++)
+			record.m_time = (record.m_time << 8) | header[i];
+
+		unsigned char channel = header[8U];
+		bool recordTx         = header[9U] == 1U;
+
+		::memcpy(&record.m_address.s_addr, header + 10U, 4U);
+		record.m_port = (header[14U] << 8) | header[15U];
+
+		unsigned int length = (header[16U] << 8) | header[17U];
+		record.m_data.resize(length);
+		if (length > 0U && ::fread(&record.m_data[0U], 1U, length, fp) != length) {
+			LogWarning("Truncated record at the end of %s", filename.c_str());
+			break;
+		}
+
+		if (recordTx != tx || channel >= CAPTURE_CHANNELS)
+			continue;
+
+		records[channel].push_back(record);
+	}
+
+	::fclose(fp);
+
+	return true;
+}
+
+CReplay::CReplay(const std::string& filename) :
+m_filename(filename),
+m_records(),
+m_start(0ULL)
+{
+	assert(!filename.empty());
+
+	for (unsigned int i = 0U; i < CAPTURE_CHANNELS; i++)
+		m_ptrs[i] = 0U;
+}
+
+CReplay::~CReplay()
+{
+}
+
+bool CReplay::open()
+{
+	if (!CCapture::load(m_filename, false, m_records))
+		return false;
+
+	unsigned int count = 0U;
+	for (unsigned int i = 0U; i < CAPTURE_CHANNELS; i++)
+		count += m_records[i].size();
+
+	LogMessage("Loaded %u datagrams to replay from %s", count, m_filename.c_str());
+
+	CClock::setVirtual();
+
+	return true;
+}
+
+void CReplay::start()
+{
+	m_start = CClock::getTime();
+}
+
+void CReplay::sleep(unsigned int ms)
+{
+	CClock::advance(ms);
+}
+
+int CReplay::read(unsigned char channel, unsigned char* buffer, unsigned int length, in_addr& address, unsigned int& port)
+{
+	assert(channel < CAPTURE_CHANNELS);
+	assert(buffer != NULL);
+	assert(length > 0U);
+
+	unsigned int ptr = m_ptrs[channel];
+	if (ptr >= m_records[channel].size())
+		return 0;
+
+	const CCaptureRecord& record = m_records[channel][ptr];
+	if ((CClock::getTime() - m_start) < record.m_time)
+		return 0;
+
+	m_ptrs[channel]++;
+
+	unsigned int len = record.m_data.size();
+	if (len > length)
+		len = length;
+	if (len > 0U)
+		::memcpy(buffer, &record.m_data[0U], len);
+
+	address = record.m_address;
+	port    = record.m_port;
+
+	return int(len);
+}
+
+bool CReplay::isFinished() const
+{
+	for (unsigned int i = 0U; i < CAPTURE_CHANNELS; i++) {
+		if (m_ptrs[i] < m_records[i].size())
+			return false;
+	}
+
+	return true;
+}
+
+unsigned int CReplay::getElapsed() const
+{
+	return (unsigned int)((CClock::getTime() - m_start) / 1000ULL);
+}
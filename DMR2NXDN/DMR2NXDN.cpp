@@ -116,13 +116,16 @@ m_nxdnFrame(NULL),
 m_dmrFrame(NULL),
 m_dmrFrames(0U),
 m_nxdnFrames(0U),
+m_lcCache(),
 m_EmbeddedLC(),
 m_dmrflco(FLCO_GROUP),
 m_dmrinfo(false),
 m_nxdninfo(false),
 m_config(NULL),
 m_configLen(0U),
-m_defaultID(65519U)
+m_defaultID(65519U),
+m_capture(NULL),
+m_replay(NULL)
 {
 	m_nxdnFrame = new unsigned char[200U];
 	m_dmrFrame  = new unsigned char[50U];
@@ -238,7 +241,26 @@ int CDMR2NXDN::run()
 
 	m_defaultID = m_conf.getDefaultID();
 
+	unsigned int captureMode = m_conf.getCaptureMode();
+	if (captureMode == 1U) {
+		m_capture = new CCapture(m_conf.getCaptureFile());
+		if (!m_capture->open()) {
+			::LogFinalise();
+			return 1;
+		}
+	} else if (captureMode == 2U) {
+		m_replay = new CReplay(m_conf.getCaptureFile());
+		m_capture = new CCapture(m_conf.getCaptureOutput());
+		if (!m_replay->open() || !m_capture->open()) {
+			::LogFinalise();
+			return 1;
+		}
+
+		m_replay->start();
+	}
+
 	m_nxdnNetwork = new CNXDNNetwork(localAddress, localPort, gatewayAddress, gatewayPort, false);
+	m_nxdnNetwork->setCapture(m_capture, m_replay);
 	m_nxdnNetwork->enable(true);
 
 	ret = m_nxdnNetwork->open();
@@ -261,7 +283,10 @@ int CDMR2NXDN::run()
 
 		m_dmrNetwork->clock(10U);
 
-		CThread::sleep(10U);
+		if (m_replay != NULL)
+			m_replay->sleep(10U);
+		else
+			CThread::sleep(10U);
 	}
 
 	if (m_killed) {
@@ -287,6 +312,7 @@ int CDMR2NXDN::run()
 	m_dmrflco = FLCO_GROUP;
 
 	CTimer networkWatchdog(100U, 0U, 1500U);
+	CTimer replayTimer(1000U, 2U);
 
 	CStopWatch stopWatch;
 	CStopWatch nxdnWatch;
@@ -595,108 +621,21 @@ int CDMR2NXDN::run()
 				m_nxdnSrc = findNXDNID(m_dmrSrc);
 				m_nxdnTG = m_dmrDst;
 
-				CNXDNLICH lich;
-				lich.setRFCT(NXDN_LICH_RFCT_RDCH);
-				lich.setFCT(NXDN_LICH_USC_SACCH_NS);
-				lich.setOption(NXDN_LICH_STEAL_FACCH);
-				lich.setDirection(NXDN_LICH_DIRECTION_INBOUND);
-				m_nxdnFrame[0U] = lich.getRaw();
-
-				CNXDNSACCH sacch;
-				sacch.setRAN(0x01);
-				sacch.setStructure(NXDN_SR_SINGLE);
-				sacch.setData(SACCH_IDLE);
-				sacch.getRaw(m_nxdnFrame + 1U);
-
-				unsigned char layer3data[25U];
-				CNXDNLayer3 layer3;
-				layer3.setMessageType(NXDN_MESSAGE_TYPE_VCALL);
-				layer3.setSourceUnitId(m_nxdnSrc & 0xFFFF);
-				layer3.setDestinationGroupId(m_nxdnTG & 0xFFFF);
-				layer3.setGroup(true);
-				layer3.setDataBlocks(0U);
-				layer3.getData(layer3data);
-
-				::memcpy(m_nxdnFrame + 5U, layer3data, 14U);
-				::memcpy(m_nxdnFrame + 5U + 14U, layer3data, 14U);
+				m_lcCache.writeHeader(m_nxdnFrame, m_nxdnSrc, m_nxdnTG);
 
 				m_nxdnNetwork->write(m_nxdnFrame, NNMT_VOICE_HEADER);
 
 				nxdnWatch.start();
 			}
 			else if (nxdnFrameType == TAG_EOT) {
-				CNXDNLICH lich;
-				lich.setRFCT(NXDN_LICH_RFCT_RDCH);
-				lich.setFCT(NXDN_LICH_USC_SACCH_NS);
-				lich.setOption(NXDN_LICH_STEAL_FACCH);
-				lich.setDirection(NXDN_LICH_DIRECTION_INBOUND);
-				m_nxdnFrame[0U] = lich.getRaw();
-
-				CNXDNSACCH sacch;
-				sacch.setRAN(0x01);
-				sacch.setStructure(NXDN_SR_SINGLE);
-				sacch.setData(SACCH_IDLE);
-				sacch.getRaw(m_nxdnFrame + 1U);
-
-				unsigned char layer3data[25U];
-				CNXDNLayer3 layer3;
-				layer3.setMessageType(NXDN_MESSAGE_TYPE_TX_REL);
-				layer3.setSourceUnitId(m_nxdnSrc & 0xFFFF);
-				layer3.setDestinationGroupId(m_nxdnTG & 0xFFFF);
-				layer3.setGroup(true);
-				layer3.setDataBlocks(0U);
-				layer3.getData(layer3data);
-
-				::memcpy(m_nxdnFrame + 5U, layer3data, 14U);
-				::memcpy(m_nxdnFrame + 5U + 14U, layer3data, 14U);
+				m_lcCache.writeTerminator(m_nxdnFrame, m_nxdnSrc, m_nxdnTG);
 
 				m_nxdnNetwork->write(m_nxdnFrame, NNMT_VOICE_TRAILER);
 
 				nxdn_cnt = 0U;
 			}
 			else if (nxdnFrameType == TAG_DATA) {
-				CNXDNLICH lich;
-				lich.setRFCT(NXDN_LICH_RFCT_RDCH);
-				lich.setFCT(NXDN_LICH_USC_SACCH_SS);
-				lich.setOption(NXDN_LICH_STEAL_NONE);
-				lich.setDirection(NXDN_LICH_DIRECTION_INBOUND);
-				m_nxdnFrame[0U] = lich.getRaw();
-
-				CNXDNSACCH sacch;
-				CNXDNLayer3 layer3;
-				unsigned char message[3U];
-
-				layer3.setMessageType(NXDN_MESSAGE_TYPE_VCALL);
-				layer3.setSourceUnitId(m_nxdnSrc & 0xFFFF);
-				layer3.setDestinationGroupId(m_nxdnTG & 0xFFFF);
-				layer3.setGroup(true);
-				layer3.setDataBlocks(0U);
-
-				switch (nxdn_cnt % 4) {
-					case 0:
-						sacch.setStructure(NXDN_SR_1_4);
-						layer3.encode(message, 18U, 0U);
-						sacch.setData(message);
-						break;
-					case 1:
-						sacch.setStructure(NXDN_SR_2_4);
-						layer3.encode(message, 18U, 18U);
-						sacch.setData(message);
-						break;
-					case 2:
-						sacch.setStructure(NXDN_SR_3_4);
-						layer3.encode(message, 18U, 36U);
-						sacch.setData(message);
-						break;
-					case 3:
-						sacch.setStructure(NXDN_SR_4_4);
-						layer3.encode(message, 18U, 54U);
-						sacch.setData(message);
-						break;
-				}
-
-				sacch.setRAN(0x01);
-				sacch.getRaw(m_nxdnFrame + 1U);
+				m_lcCache.writeVoice(m_nxdnFrame, nxdn_cnt, m_nxdnSrc, m_nxdnTG);
 
 				// Send data to MMDVMHost
 				m_nxdnNetwork->write(m_nxdnFrame, NNMT_VOICE_BODY);
@@ -711,7 +650,21 @@ int CDMR2NXDN::run()
 		m_dmrNetwork->clock(ms);
 		m_nxdnNetwork->clock(ms);
 
-		if (ms < 5U)
+		// Give the conversion time to drain once the replay has run out
+		if (m_replay != NULL && m_replay->isFinished()) {
+			if (!replayTimer.isRunning())
+				replayTimer.start();
+
+			replayTimer.clock(ms);
+			if (replayTimer.hasExpired()) {
+				LogMessage("Replay finished, %u ms of traffic in %.3f s of CPU", m_replay->getElapsed(), double(CThread::getCPUTime()) / 1000000.0);
+				m_killed = true;
+			}
+		}
+
+		if (m_replay != NULL)
+			m_replay->sleep(5U);
+		else if (ms < 5U)
 			CThread::sleep(5U);
 	}
 
@@ -720,6 +673,13 @@ int CDMR2NXDN::run()
 	delete m_dmrNetwork;
 	delete m_nxdnNetwork;
 
+	if (m_capture != NULL) {
+		m_capture->close();
+		delete m_capture;
+	}
+
+	delete m_replay;
+
 	::LogFinalise();
 
 	return 0;
@@ -779,6 +739,7 @@ bool CDMR2NXDN::createMMDVM()
 	LogInfo("    Local Port: %u", localPort);
 
 	m_dmrNetwork = new CMMDVMNetwork(rptAddress, rptPort, localAddress, localPort, debug);
+	m_dmrNetwork->setCapture(m_capture, m_replay);
 
 	bool ret = m_dmrNetwork->open();
 	if (!ret) {
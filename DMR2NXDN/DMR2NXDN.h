@@ -32,11 +32,13 @@
 #include "NXDNConvolution.h"
 #include "NXDNCRC.h"
 #include "NXDNLayer3.h"
+#include "NXDNLCCache.h"
 #include "NXDNLICH.h"
 #include "NXDNLookup.h"
 #include "NXDNSACCH.h"
 #include "NXDNNetwork.h"
 #include "UDPSocket.h"
+#include "Capture.h"
 #include "StopWatch.h"
 #include "Version.h"
 #include "Thread.h"
@@ -77,6 +79,7 @@ private:
 	unsigned char*   m_dmrFrame;
 	unsigned int     m_dmrFrames;
 	unsigned int     m_nxdnFrames;
+	CNXDNLCCache     m_lcCache;
 	CDMREmbeddedData m_EmbeddedLC;
 	FLCO             m_dmrflco;
 	bool             m_dmrinfo;
@@ -84,6 +87,8 @@ private:
 	unsigned char*   m_config;
 	unsigned int     m_configLen;
 	unsigned int     m_defaultID;
+	CCapture*        m_capture;
+	CReplay*         m_replay;
 
 	unsigned int findNXDNID(unsigned int dmrid);
 	unsigned int findDMRID(unsigned int nxdnid);
@@ -37,7 +37,7 @@ public:
 
 	bool addData(const unsigned char* data, unsigned char lcss);
 
-	CDMRLC* getLC() const;
+	bool getLC(CDMRLC& lc) const;
 	void setLC(const CDMRLC& lc);
 
 	unsigned char getData(unsigned char* data, unsigned char n) const;
@@ -50,11 +50,11 @@ public:
 	void reset();
 
 private:
-	bool*        m_raw;
-	LC_STATE     m_state;
-	bool*        m_data;
-	FLCO         m_FLCO;
-	bool         m_valid;
+	unsigned int  m_raw[4U];
+	LC_STATE      m_state;
+	unsigned char m_data[9U];
+	FLCO          m_FLCO;
+	bool          m_valid;
 
 	void decodeEmbeddedData();
 	void encodeEmbeddedData();
@@ -340,3 +340,8 @@ void CMMDVMNetwork::clock(unsigned int ms)
 		}
 	}
 }
+
+void CMMDVMNetwork::setCapture(CCapture* capture, CReplay* replay)
+{
+	m_socket.setCapture(capture, replay, CAPTURE_DMR);
+}
@@ -18,6 +18,8 @@
 
 #include "NXDNCRC.h"
 
+#include "ECCTables.h"
+
 #include <cstdio>
 #include <cassert>
 
@@ -26,6 +28,45 @@ const uint8_t  BIT_MASK_TABLE1[] = { 0x80U, 0x40U, 0x20U, 0x10U, 0x08U, 0x04U, 0
 #define WRITE_BIT1(p,i,b) p[(i)>>3] = (b) ? (p[(i)>>3] | BIT_MASK_TABLE1[(i)&7]) : (p[(i)>>3] & ~BIT_MASK_TABLE1[(i)&7])
 #define READ_BIT1(p,i)    (p[(i)>>3] & BIT_MASK_TABLE1[(i)&7])
 
+// The CRCs are kept in the top bits of the register, so that whole bytes
+// of the message go through the tables and only the bits after the last
+// whole byte are done one at a time. The polynomials are shifted to match.
+static constexpr uint8_t  CRC6_POLY  = 0x27U << 2;
+static constexpr uint16_t CRC12_POLY = 0x080FU << 4;
+static constexpr uint16_t CRC15_POLY = 0x4CC5U << 1;
+
+static constexpr CECCTable<uint8_t, 256U>  CRC6_TABLE  = CECCTables::crc<uint8_t>(CRC6_POLY, false);
+static constexpr CECCTable<uint16_t, 256U> CRC12_TABLE = CECCTables::crc<uint16_t>(CRC12_POLY, false);
+static constexpr CECCTable<uint16_t, 256U> CRC15_TABLE = CECCTables::crc<uint16_t>(CRC15_POLY, false);
+
+static_assert(CRC6_TABLE.checksum() == 0x289414C5U, "CRC6_TABLE has changed");
+static_assert(CRC12_TABLE.checksum() == 0x3C50B9C5U, "CRC12_TABLE has changed");
+static_assert(CRC15_TABLE.checksum() == 0x137FA4C5U, "CRC15_TABLE has changed");
+
+template<class T>
+static T createCRC(const CECCTable<T, 256U>& table, T poly, T crc, const unsigned char* in, unsigned int length)
+{
+	assert(in != NULL);
+
+	const unsigned int width = sizeof(T) * 8U;
+
+	unsigned int bytes = length / 8U;
+	for (unsigned int i = 0U; i < bytes; i++)
+		crc = T(crc << 8) ^ table[(crc >> (width - 8U)) ^ in[i]];
+
+	for (unsigned int i = bytes * 8U; i < length; i++) {
+		bool bit1 = READ_BIT1(in, i) != 0x00U;
+		bool bit2 = ((crc >> (width - 1U)) & 0x01U) == 0x01U;
+
+		crc = T(crc << 1);
+
+		if (bit1 ^ bit2)
+			crc ^= poly;
+	}
+
+	return crc;
+}
+
 bool CNXDNCRC::checkCRC6(const unsigned char* in, unsigned int length)
 {
 	assert(in != NULL);
@@ -135,51 +176,15 @@ void CNXDNCRC::encodeCRC15(unsigned char* in, unsigned int length)
 
 uint8_t CNXDNCRC::createCRC6(const unsigned char* in, unsigned int length)
 {
-	uint8_t crc = 0x3FU;
-
-	for (unsigned int i = 0U; i < length; i++) {
-		bool bit1 = READ_BIT1(in, i) != 0x00U;
-		bool bit2 = (crc & 0x20U) == 0x20U;
-
-		crc <<= 1;
-
-		if (bit1 ^ bit2)
-			crc ^= 0x27U;
-	}
-
-	return crc & 0x3FU;
+	return createCRC<uint8_t>(CRC6_TABLE, CRC6_POLY, 0x3FU << 2, in, length) >> 2;
 }
 
 uint16_t CNXDNCRC::createCRC12(const unsigned char* in, unsigned int length)
 {
-	uint16_t crc = 0x0FFFU;
-
-	for (unsigned int i = 0U; i < length; i++) {
-		bool bit1 = READ_BIT1(in, i) != 0x00U;
-		bool bit2 = (crc & 0x0800U) == 0x0800U;
-
-		crc <<= 1;
-
-		if (bit1 ^ bit2)
-			crc ^= 0x080FU;
-	}
-
-	return crc & 0x0FFFU;
+	return createCRC<uint16_t>(CRC12_TABLE, CRC12_POLY, 0x0FFFU << 4, in, length) >> 4;
 }
 
 uint16_t CNXDNCRC::createCRC15(const unsigned char* in, unsigned int length)
 {
-	uint16_t crc = 0x7FFFU;
-
-	for (unsigned int i = 0U; i < length; i++) {
-		bool bit1 = READ_BIT1(in, i) != 0x00U;
-		bool bit2 = (crc & 0x4000U) == 0x4000U;
-
-		crc <<= 1;
-
-		if (bit1 ^ bit2)
-			crc ^= 0x4CC5U;
-	}
-
-	return crc & 0x7FFFU;
+	return createCRC<uint16_t>(CRC15_TABLE, CRC15_POLY, 0x7FFFU << 1, in, length) >> 1;
 }
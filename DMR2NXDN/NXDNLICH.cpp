@@ -19,14 +19,56 @@
 #include "NXDNDefines.h"
 #include "NXDNLICH.h"
 
+#include "ECCTables.h"
+
+#include <cstdint>
 #include <cstdio>
 #include <cassert>
 #include <cstring>
 
-const unsigned char BIT_MASK_TABLE[] = {0x80U, 0x40U, 0x20U, 0x10U, 0x08U, 0x04U, 0x02U, 0x01U};
+// On air each LICH bit is followed by a one, the 16 bits starting half way
+// through the third byte of the frame, straight after the frame sync word.
+static_assert(NXDN_FSW_LENGTH_BITS == 20U && NXDN_LICH_LENGTH_BITS == 16U, "the LICH is not where expected");
+
+static constexpr bool lichParity(unsigned int lich)
+{
+	return (lich & 0xF0U) == 0x80U || (lich & 0xF0U) == 0xB0U;
+}
+
+// The 16 bits sent for each LICH value, with its parity bit put right.
+static constexpr CECCTable<uint16_t, 256U> makeEncodeTable()
+{
+	CECCTable<uint16_t, 256U> table = {};
+
+	for (unsigned int lich = 0U; lich < 256U; lich++) {
+		unsigned int value = (lich & 0xFEU) | (lichParity(lich) ? 0x01U : 0x00U);
+
+		unsigned int word = 0U;
+		for (unsigned int i = 0U; i < 8U; i++)
+			word = (word << 2) | (((value >> (7U - i)) & 0x01U) << 1) | 0x01U;
+
+		table.m_data[lich] = uint16_t(word);
+	}
+
+	return table;
+}
+
+// The four LICH bits in a received byte, the ones in bits 7, 5, 3 and 1.
+static constexpr CECCTable<uint8_t, 256U> makeDecodeTable()
+{
+	CECCTable<uint8_t, 256U> table = {};
+
+	for (unsigned int byte = 0U; byte < 256U; byte++)
+		table.m_data[byte] = uint8_t(((byte >> 4) & 0x08U) | ((byte >> 3) & 0x04U) | ((byte >> 2) & 0x02U) | ((byte >> 1) & 0x01U));
+
+	return table;
+}
+
+static constexpr CECCTable<uint16_t, 256U> LICH_ENCODE_TABLE = makeEncodeTable();
+static constexpr CECCTable<uint8_t, 256U>  LICH_DECODE_TABLE = makeDecodeTable();
 
-#define WRITE_BIT1(p,i,b) p[(i)>>3] = (b) ? (p[(i)>>3] | BIT_MASK_TABLE[(i)&7]) : (p[(i)>>3] & ~BIT_MASK_TABLE[(i)&7])
-#define READ_BIT1(p,i)    (p[(i)>>3] & BIT_MASK_TABLE[(i)&7])
+static_assert(LICH_ENCODE_TABLE.checksum() == 0x51E9FD85U, "LICH_ENCODE_TABLE has changed");
+static_assert(LICH_DECODE_TABLE.checksum() == 0x57B57945U, "LICH_DECODE_TABLE has changed");
 
 CNXDNLICH::CNXDNLICH(const CNXDNLICH& lich) :
 m_lich(NULL)
@@ -50,11 +92,9 @@ bool CNXDNLICH::decode(const unsigned char* bytes)
 {
 	assert(bytes != NULL);
 
-	unsigned int offset = NXDN_FSW_LENGTH_BITS;
-	for (unsigned int i = 0U; i < (NXDN_LICH_LENGTH_BITS / 2U); i++, offset += 2U) {
-		bool b = READ_BIT1(bytes, offset);
-		WRITE_BIT1(m_lich, i, b);
-	}
+	unsigned int word = ((bytes[2U] & 0x0FU) << 12) | (bytes[3U] << 4) | (bytes[4U] >> 4);
+
+	m_lich[0U] = (LICH_DECODE_TABLE[word >> 8] << 4) | LICH_DECODE_TABLE[word & 0xFFU];
 
 	bool newParity  = getParity();
 	bool origParity = (m_lich[0U] & 0x01U) == 0x01U;
@@ -66,20 +106,13 @@ void CNXDNLICH::encode(unsigned char* bytes)
 {
 	assert(bytes != NULL);
 
-	bool parity = getParity();
-	if (parity)
-		m_lich[0U] |= 0x01U;
-	else
-		m_lich[0U] &= 0xFEU;
+	unsigned int word = LICH_ENCODE_TABLE[m_lich[0U]];
 
-	unsigned int offset = NXDN_FSW_LENGTH_BITS;
-	for (unsigned int i = 0U; i < (NXDN_LICH_LENGTH_BITS / 2U); i++) {
-		bool b = READ_BIT1(m_lich, i);
-		WRITE_BIT1(bytes, offset, b);
-		offset++;
-		WRITE_BIT1(bytes, offset, true);
-		offset++;
-	}
+	m_lich[0U] = (m_lich[0U] & 0xFEU) | ((word >> 1) & 0x01U);
+
+	bytes[2U] = (bytes[2U] & 0xF0U) | (word >> 12);
+	bytes[3U] = (word >> 4) & 0xFFU;
+	bytes[4U] = (bytes[4U] & 0x0FU) | ((word << 4) & 0xF0U);
 }
 
 unsigned char CNXDNLICH::getRFCT() const
@@ -152,11 +185,5 @@ CNXDNLICH& CNXDNLICH::operator=(const CNXDNLICH& lich)
 
 bool CNXDNLICH::getParity() const
 {
-	switch (m_lich[0U] & 0xF0U) {
-	case 0x80U:
-	case 0xB0U:
-		return true;
-	default:
-		return false;
-	}
+	return (LICH_ENCODE_TABLE[m_lich[0U]] & 0x02U) == 0x02U;
 }
@@ -165,3 +165,8 @@ void CNXDNNetwork::enable(bool enabled)
 
 	m_enabled = enabled;
 }
+
+void CNXDNNetwork::setCapture(CCapture* capture, CReplay* replay)
+{
+	m_socket.setCapture(capture, replay, CAPTURE_NXDN);
+}
@@ -26,7 +26,7 @@
 #include <cassert>
 #include <cstring>
 
-const unsigned int INTERLEAVE_TABLE[] = {
+static constexpr unsigned int INTERLEAVE_TABLE[] = {
 	0U, 5U, 10U, 15U, 20U, 25U, 30U, 35U, 40U, 45U, 50U, 55U,
 	1U, 6U, 11U, 16U, 21U, 26U, 31U, 36U, 41U, 46U, 51U, 56U,
 	2U, 7U, 12U, 17U, 22U, 27U, 32U, 37U, 42U, 47U, 52U, 57U,
@@ -34,7 +34,14 @@ const unsigned int INTERLEAVE_TABLE[] = {
 	4U, 9U, 14U, 19U, 24U, 29U, 34U, 39U, 44U, 49U, 54U, 59U
 };
 
-const unsigned int PUNCTURE_LIST[] = { 5U, 11U, 17U, 23U, 29U, 35U, 41U, 47U, 53U, 59U, 65U, 71U };
+static constexpr unsigned int PUNCTURE_LIST[] = { 5U, 11U, 17U, 23U, 29U, 35U, 41U, 47U, 53U, 59U, 65U, 71U };
+
+// 26 bits of data, the CRC6 and the tail, coded at rate 1/2.
+const unsigned int SACCH_CODED_BITS = 36U;
+
+static constexpr CECCTable<uint8_t, 72U> DEPUNCTURE_MAP = CNXDNConvolution::depunctureMap<72U>(INTERLEAVE_TABLE, PUNCTURE_LIST, 12U);
+
+static_assert(DEPUNCTURE_MAP.checksum() == 0xC7EE1DFDU, "DEPUNCTURE_MAP has changed");
 
 const unsigned char BIT_MASK_TABLE[] = { 0x80U, 0x40U, 0x20U, 0x10U, 0x08U, 0x04U, 0x02U, 0x01U };
 
@@ -63,44 +70,21 @@ bool CNXDNSACCH::decode(const unsigned char* data)
 {
 	assert(data != NULL);
 
-	unsigned char temp1[8U];
+	uint8_t symbols[NXDN_SACCH_LENGTH_BITS];
 
-	for (unsigned int i = 0U; i < NXDN_SACCH_LENGTH_BITS; i++) {
-		unsigned int n = INTERLEAVE_TABLE[i] + NXDN_FSW_LENGTH_BITS + NXDN_LICH_LENGTH_BITS;
-		bool b = READ_BIT1(data, n);
-		WRITE_BIT1(temp1, i, b);
-	}
-
-	uint8_t temp2[90U];
-
-	unsigned int n = 0U;
-	unsigned int index = 0U;
-	for (unsigned int i = 0U; i < NXDN_SACCH_LENGTH_BITS; i++) {
-		if (n == PUNCTURE_LIST[index]) {
-			temp2[n++] = 1U;
-			index++;
-		}
+	unsigned int n = NXDN_FSW_LENGTH_BITS + NXDN_LICH_LENGTH_BITS;
+	for (unsigned int i = 0U; i < NXDN_SACCH_LENGTH_BITS; i++, n++)
+		symbols[i] = READ_BIT1(data, n) ? NXDN_SOFT_ONE : 0U;
 
-		bool b = READ_BIT1(temp1, i);
-		temp2[n++] = b ? 2U : 0U;
-	}
+	return decodeSoft(symbols);
+}
 
-	for (unsigned int i = 0U; i < 8U; i++) {
-		temp2[n++] = 0U;
-	}
+bool CNXDNSACCH::decodeSoft(const uint8_t* symbols)
+{
+	assert(symbols != NULL);
 
 	CNXDNConvolution conv;
-	conv.start();
-
-	n = 0U;
-	for (unsigned int i = 0U; i < 40U; i++) {
-		uint8_t s0 = temp2[n++];
-		uint8_t s1 = temp2[n++];
-
-		conv.decode(s0, s1);
-	}
-
-	conv.chainback(m_data, 36U);
+	conv.decode(symbols, DEPUNCTURE_MAP.m_data, m_data, SACCH_CODED_BITS);
 
 	return CNXDNCRC::checkCRC6(m_data, 26U);
 }
@@ -39,6 +39,9 @@ public:
 
   static void sleep(unsigned int ms);
 
+  // CPU time used by the calling thread, in microseconds
+  static unsigned long long getCPUTime();
+
 private:
 #if defined(_WIN32) || defined(_WIN64)
   HANDLE    m_handle;
@@ -30,7 +30,10 @@
 CUDPSocket::CUDPSocket(const std::string& address, unsigned int port) :
 m_address(address),
 m_port(port),
-m_fd(-1)
+m_fd(-1),
+m_capture(NULL),
+m_replay(NULL),
+m_channel(0U)
 {
 	assert(!address.empty());
 
@@ -45,7 +48,10 @@ m_fd(-1)
 CUDPSocket::CUDPSocket(unsigned int port) :
 m_address(),
 m_port(port),
-m_fd(-1)
+m_fd(-1),
+m_capture(NULL),
+m_replay(NULL),
+m_channel(0U)
 {
 #if defined(_WIN32) || defined(_WIN64)
 	WSAData data;
@@ -102,8 +108,20 @@ in_addr CUDPSocket::lookup(const std::string& hostname)
 #endif
 }
 
+void CUDPSocket::setCapture(CCapture* capture, CReplay* replay, unsigned char channel)
+{
+	assert(channel < CAPTURE_CHANNELS);
+
+	m_capture = capture;
+	m_replay  = replay;
+	m_channel = channel;
+}
+
 bool CUDPSocket::open()
 {
+	if (m_replay != NULL)
+		return true;
+
 	m_fd = ::socket(PF_INET, SOCK_DGRAM, 0);
 	if (m_fd < 0) {
 #if defined(_WIN32) || defined(_WIN64)
@@ -161,6 +179,9 @@ int CUDPSocket::read(unsigned char* buffer, unsigned int length, in_addr& addres
 	assert(buffer != NULL);
 	assert(length > 0U);
 
+	if (m_replay != NULL)
+		return m_replay->read(m_channel, buffer, length, address, port);
+
 	// Check that the readfrom() won't block
 	fd_set readFds;
 	FD_ZERO(&readFds);
@@ -212,6 +233,9 @@ int CUDPSocket::read(unsigned char* buffer, unsigned int length, in_addr& addres
 	address = addr.sin_addr;
 	port    = ntohs(addr.sin_port);
 
+	if (m_capture != NULL)
+		m_capture->write(m_channel, false, address, port, buffer, len);
+
 	return len;
 }
 
@@ -220,6 +244,12 @@ bool CUDPSocket::write(const unsigned char* buffer, unsigned int length, const i
 	assert(buffer != NULL);
 	assert(length > 0U);
 
+	if (m_capture != NULL)
+		m_capture->write(m_channel, true, address, port, buffer, length);
+
+	if (m_replay != NULL)
+		return true;
+
 	sockaddr_in addr;
 	::memset(&addr, 0x00, sizeof(sockaddr_in));
 
@@ -254,6 +284,9 @@ bool CUDPSocket::write(const unsigned char* buffer, unsigned int length, const i
 
 void CUDPSocket::close()
 {
+	if (m_replay != NULL)
+		return;
+
 #if defined(_WIN32) || defined(_WIN64)
 	::closesocket(m_fd);
 #else
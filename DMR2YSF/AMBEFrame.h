@@ -0,0 +1,61 @@
+/*
+ *   Copyright (C) 2019 by Manuel Sanchez EA7EE
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#ifndef AMBEFrame_H
+#define AMBEFrame_H
+
+#include <cstdint>
+
+// The AMBE+2 parameters of one 20 ms voice frame, as carried by DMR, YSF
+// V/D mode 2 and NXDN: the 12 data bits of a and b followed by the 25
+// bits of c, in the low 49 bits of a uint64_t. The bridges convert every
+// frame into this form when it arrives and out of it when it leaves, so
+// a conversion between any two modes is one decode and one encode.
+const unsigned int AMBE_FRAME_BITS = 49U;
+
+const uint64_t AMBE_FRAME_MASK = (uint64_t(1U) << AMBE_FRAME_BITS) - 1U;
+
+class CAMBEFrame {
+public:
+	static uint64_t     create(unsigned int a, unsigned int b, unsigned int c);
+
+	static unsigned int getA(uint64_t frame);
+	static unsigned int getB(uint64_t frame);
+	static unsigned int getC(uint64_t frame);
+
+	// One of the three 72 bit frames of a 33 byte DMR voice burst. Only
+	// the data bits are used, the Golay codes are not checked.
+	static uint64_t decodeDMR(const unsigned char* burst, unsigned int n);
+	// As above, but correcting a and b with their Golay codes
+	static uint64_t decodeDMRFEC(const unsigned char* burst, unsigned int n);
+	static void     encodeDMR(uint64_t frame, unsigned char* burst, unsigned int n);
+
+	// One of the four frames in the 28 bytes of voice of an NXDN frame
+	static uint64_t decodeNXDN(const unsigned char* voice, unsigned int n);
+	static void     encodeNXDN(uint64_t frame, unsigned char* voice, unsigned int n);
+
+	// A 13 byte YSF V/D mode 2 VCH, interleaved and whitened as sent.
+	// The middle copy of each tripled bit is used.
+	static uint64_t decodeYSF(const unsigned char* vch);
+	static void     encodeYSF(uint64_t frame, unsigned char* vch);
+
+	// The silence frame that calls are padded with
+	static const uint64_t SILENCE;
+};
+
+#endif
@@ -121,6 +121,7 @@ m_ysfFrame(NULL),
 m_dmrFrame(NULL),
 m_dmrFrames(0U),
 m_ysfFrames(0U),
+m_dchCache(),
 m_EmbeddedLC(),
 m_dmrflco(FLCO_GROUP),
 m_dmrinfo(false),
@@ -130,7 +131,9 @@ m_command(NULL),
 m_tgUnlink(4000U),
 m_currTGList(),
 m_FCSList(),
-m_lastTG(0U)
+m_lastTG(0U),
+m_capture(NULL),
+m_replay(NULL)
 {
 	m_ysfFrame = new unsigned char[200U];
 	m_dmrFrame = new unsigned char[50U];
@@ -261,8 +264,27 @@ int CDMR2YSF::run()
 	unsigned int localPort   = m_conf.getLocalPort();
 	unsigned int ysfdebug    = m_conf.getDebug();
 
+	unsigned int captureMode = m_conf.getCaptureMode();
+	if (captureMode == 1U) {
+		m_capture = new CCapture(m_conf.getCaptureFile());
+		if (!m_capture->open()) {
+			::LogFinalise();
+			return 1;
+		}
+	} else if (captureMode == 2U) {
+		m_replay = new CReplay(m_conf.getCaptureFile());
+		m_capture = new CCapture(m_conf.getCaptureOutput());
+		if (!m_replay->open() || !m_capture->open()) {
+			::LogFinalise();
+			return 1;
+		}
+
+		m_replay->start();
+	}
+
 	m_ysfNetwork = new CYSFNetwork(localAddress, localPort, m_callsign, ysfdebug);
 	m_ysfNetwork->setDestination(dstAddress, dstPort);
+	m_ysfNetwork->setCapture(m_capture, m_replay);
 
 	ret = m_ysfNetwork->open();
 	if (!ret) {
@@ -284,7 +306,10 @@ int CDMR2YSF::run()
 
 		m_dmrNetwork->clock(10U);
 
-		CThread::sleep(10U);
+		if (m_replay != NULL)
+			m_replay->sleep(10U);
+		else
+			CThread::sleep(10U);
 	}
 
 	if (m_killed) {
@@ -308,6 +333,7 @@ int CDMR2YSF::run()
 
 	CTimer networkWatchdog(100U, 0U, 1500U);
 	CTimer pollTimer(1000U, 5U);
+	CTimer replayTimer(1000U, 2U);
 
 	CStopWatch stopWatch;
 	CStopWatch ysfWatch;
@@ -707,7 +733,6 @@ int CDMR2YSF::run()
 			else if (ysfFrameType == TAG_DATA) {
 
 				CYSFFICH fich;
-				CYSFPayload ysfPayload;
 
 				unsigned int fn = (ysf_cnt - 1U) % 8U;
 
@@ -721,22 +746,22 @@ int CDMR2YSF::run()
 
 				switch (fn) {
 					case 0:
-						ysfPayload.writeVDMode2Data(m_ysfFrame + 35U, (const unsigned char*)"**********");
+						m_dchCache.writeVDMode2Data(m_ysfFrame + 35U, fn, (const unsigned char*)"**********");
 						break;
 					case 1:
-						ysfPayload.writeVDMode2Data(m_ysfFrame + 35U, (const unsigned char*)m_netSrc.c_str());
+						m_dchCache.writeVDMode2Data(m_ysfFrame + 35U, fn, (const unsigned char*)m_netSrc.c_str());
 						break;
 					case 2:
-						ysfPayload.writeVDMode2Data(m_ysfFrame + 35U, (const unsigned char*)m_netDst.c_str());
+						m_dchCache.writeVDMode2Data(m_ysfFrame + 35U, fn, (const unsigned char*)m_netDst.c_str());
 						break;
 					case 6:
-						ysfPayload.writeVDMode2Data(m_ysfFrame + 35U, gps_buffer);
+						m_dchCache.writeVDMode2Data(m_ysfFrame + 35U, fn, gps_buffer);
 						break;
 					case 7:
-						ysfPayload.writeVDMode2Data(m_ysfFrame + 35U, gps_buffer+10U);
+						m_dchCache.writeVDMode2Data(m_ysfFrame + 35U, fn, gps_buffer+10U);
 						break;
 					default:
-						ysfPayload.writeVDMode2Data(m_ysfFrame + 35U, (const unsigned char*)"          ");
+						m_dchCache.writeVDMode2Data(m_ysfFrame + 35U, fn, (const unsigned char*)"          ");
 				}
 				
 				// Set the FICH
@@ -773,7 +798,21 @@ int CDMR2YSF::run()
 			pollTimer.start();
 		}
 
-		if (ms < 5U)
+		// Give the conversion time to drain once the replay has run out
+		if (m_replay != NULL && m_replay->isFinished()) {
+			if (!replayTimer.isRunning())
+				replayTimer.start();
+
+			replayTimer.clock(ms);
+			if (replayTimer.hasExpired()) {
+				LogMessage("Replay finished, %u ms of traffic in %.3f s of CPU", m_replay->getElapsed(), double(CThread::getCPUTime()) / 1000000.0);
+				m_killed = true;
+			}
+		}
+
+		if (m_replay != NULL)
+			m_replay->sleep(5U);
+		else if (ms < 5U)
 			CThread::sleep(5U);
 	}
 
@@ -783,6 +822,13 @@ int CDMR2YSF::run()
 	delete m_dmrNetwork;
 	delete m_ysfNetwork;
 
+	if (m_capture != NULL) {
+		m_capture->close();
+		delete m_capture;
+	}
+
+	delete m_replay;
+
 	::LogFinalise();
 
 	return 0;
@@ -1091,6 +1137,7 @@ bool CDMR2YSF::createMMDVM()
 	LogInfo("    Local Port: %u", localPort);
 
 	m_dmrNetwork = new CMMDVMNetwork(rptAddress, rptPort, localAddress, localPort, debug);
+	m_dmrNetwork->setCapture(m_capture, m_replay);
 
 	bool ret = m_dmrNetwork->open();
 	if (!ret) {
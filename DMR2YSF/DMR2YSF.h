@@ -29,9 +29,11 @@
 #include "DMREMB.h"
 #include "DMRLookup.h"
 #include "UDPSocket.h"
+#include "Capture.h"
 #include "StopWatch.h"
 #include "Version.h"
 #include "YSFPayload.h"
+#include "YSFDCHCache.h"
 #include "YSFNetwork.h"
 #include "YSFFICH.h"
 #include "Thread.h"
@@ -96,6 +98,7 @@ private:
 	unsigned char*         m_dmrFrame;
 	unsigned int           m_dmrFrames;
 	unsigned int           m_ysfFrames;
+	CYSFDCHCache           m_dchCache;
 	CDMREmbeddedData       m_EmbeddedLC;
 	FLCO                   m_dmrflco;
 	bool                   m_dmrinfo;
@@ -106,6 +109,8 @@ private:
 	std::vector<CTGReg*>   m_currTGList;
 	std::vector<CFCSReg*>  m_FCSList;
 	unsigned int           m_lastTG;
+	CCapture*              m_capture;
+	CReplay*               m_replay;
 
 	void readTGList(std::string filename);
 	void readFCSRoomsFile(const std::string& filename);
@@ -25,22 +25,68 @@
 #include <cstdio>
 #include <cassert>
 #include <cstring>
+#include <cstdint>
+
+// The 128 bits are sent downwards in columns of the 8 x 16 bit matrix, so
+// each byte of the four fragments is one column, and turning the columns
+// into rows, and back, is two 8 x 8 bit transposes.
+static uint64_t transpose8(uint64_t x)
+{
+	uint64_t t;
+
+	t = (x ^ (x >> 7))  & 0x00AA00AA00AA00AAULL;
+	x = x ^ t ^ (t << 7);
+
+	t = (x ^ (x >> 14)) & 0x0000CCCC0000CCCCULL;
+	x = x ^ t ^ (t << 14);
+
+	t = (x ^ (x >> 28)) & 0x00000000F0F0F0F0ULL;
+	x = x ^ t ^ (t << 28);
+
+	return x;
+}
+
+static void columnsToRows(const unsigned int* columns, unsigned int* rows)
+{
+	uint64_t left  = transpose8((uint64_t(columns[0U]) << 32) | columns[1U]);
+	uint64_t right = transpose8((uint64_t(columns[2U]) << 32) | columns[3U]);
+
+	for (unsigned int i = 0U; i < 8U; i++) {
+		unsigned int shift = 56U - i * 8U;
+		rows[i] = (((left >> shift) & 0xFFU) << 8) | ((right >> shift) & 0xFFU);
+	}
+}
+
+static void rowsToColumns(const unsigned int* rows, unsigned int* columns)
+{
+	uint64_t left  = 0U;
+	uint64_t right = 0U;
+
+	for (unsigned int i = 0U; i < 8U; i++) {
+		left  = (left << 8)  | ((rows[i] >> 8) & 0xFFU);
+		right = (right << 8) | ((rows[i] >> 0) & 0xFFU);
+	}
+
+	left  = transpose8(left);
+	right = transpose8(right);
+
+	columns[0U] = (unsigned int)(left >> 32);
+	columns[1U] = (unsigned int)(left & 0xFFFFFFFFU);
+	columns[2U] = (unsigned int)(right >> 32);
+	columns[3U] = (unsigned int)(right & 0xFFFFFFFFU);
+}
 
 CDMREmbeddedData::CDMREmbeddedData() :
-m_raw(NULL),
 m_state(LCS_NONE),
-m_data(NULL),
 m_FLCO(FLCO_GROUP),
 m_valid(false)
 {
-	m_raw  = new bool[128U];
-	m_data = new bool[72U];
+	::memset(m_raw, 0x00U, sizeof(m_raw));
+	::memset(m_data, 0x00U, sizeof(m_data));
 }
 
 CDMREmbeddedData::~CDMREmbeddedData()
 {
-	delete[] m_raw;
-	delete[] m_data;
 }
 
 // Add LC data (which may consist of 4 blocks) to the data store
@@ -48,17 +94,12 @@ bool CDMREmbeddedData::addData(const unsigned char* data, unsigned char lcss)
 {
 	assert(data != NULL);
 
-	bool rawData[40U];
-	CUtils::byteToBitsBE(data[14U], rawData + 0U);
-	CUtils::byteToBitsBE(data[15U], rawData + 8U);
-	CUtils::byteToBitsBE(data[16U], rawData + 16U);
-	CUtils::byteToBitsBE(data[17U], rawData + 24U);
-	CUtils::byteToBitsBE(data[18U], rawData + 32U);
+	// The 32 bits of embedded signalling between the two halves of the EMB
+	unsigned int fragment = ((data[14U] & 0x0FU) << 28) | (data[15U] << 20) | (data[16U] << 12) | (data[17U] << 4) | ((data[18U] >> 4) & 0x0FU);
 
 	// Is this the first block of a 4 block embedded LC ?
 	if (lcss == 1U) {
-		for (unsigned int a = 0U; a < 32U; a++)
-			m_raw[a] = rawData[a + 4U];
+		m_raw[0U] = fragment;
 
 		// Show we are ready for the next LC block
 		m_state = LCS_FIRST;
@@ -69,8 +110,7 @@ bool CDMREmbeddedData::addData(const unsigned char* data, unsigned char lcss)
 
 	// Is this the 2nd block of a 4 block embedded LC ?
 	if (lcss == 3U && m_state == LCS_FIRST) {
-		for (unsigned int a = 0U; a < 32U; a++)
-			m_raw[a + 32U] = rawData[a + 4U];
+		m_raw[1U] = fragment;
 
 		// Show we are ready for the next LC block
 		m_state = LCS_SECOND;
@@ -80,8 +120,7 @@ bool CDMREmbeddedData::addData(const unsigned char* data, unsigned char lcss)
 
 	// Is this the 3rd block of a 4 block embedded LC ?
 	if (lcss == 3U && m_state == LCS_SECOND) {
-		for (unsigned int a = 0U; a < 32U; a++)
-			m_raw[a + 64U] = rawData[a + 4U];
+		m_raw[2U] = fragment;
 
 		// Show we are ready for the final LC block
 		m_state = LCS_THIRD;
@@ -91,8 +130,7 @@ bool CDMREmbeddedData::addData(const unsigned char* data, unsigned char lcss)
 
 	// Is this the final block of a 4 block embedded LC ?
 	if (lcss == 2U && m_state == LCS_THIRD)	{
-		for (unsigned int a = 0U; a < 32U; a++)
-			m_raw[a + 96U] = rawData[a + 4U];
+		m_raw[3U] = fragment;
 
 		// Show that we're not ready for any more data
 		m_state = LCS_NONE;
@@ -123,47 +161,35 @@ void CDMREmbeddedData::encodeEmbeddedData()
 	unsigned int crc;
 	CCRC::encodeFiveBit(m_data, crc);
 
-	bool data[128U];
-	::memset(data, 0x00U, 128U * sizeof(bool));
-
-	data[106U] = (crc & 0x01U) == 0x01U;
-	data[90U]  = (crc & 0x02U) == 0x02U;
-	data[74U]  = (crc & 0x04U) == 0x04U;
-	data[58U]  = (crc & 0x08U) == 0x08U;
-	data[42U]  = (crc & 0x10U) == 0x10U;
-
-	unsigned int b = 0U;
-	for (unsigned int a = 0U; a < 11U; a++, b++)
-		data[a] = m_data[b];
-	for (unsigned int a = 16U; a < 27U; a++, b++)
-		data[a] = m_data[b];
-	for (unsigned int a = 32U; a < 42U; a++, b++)
-		data[a] = m_data[b];
-	for (unsigned int a = 48U; a < 58U; a++, b++)
-		data[a] = m_data[b];
-	for (unsigned int a = 64U; a < 74U; a++, b++)
-		data[a] = m_data[b];
-	for (unsigned int a = 80U; a < 90U; a++, b++)
-		data[a] = m_data[b];
-	for (unsigned int a = 96U; a < 106U; a++, b++)
-		data[a] = m_data[b];
+	// Rows of 11 data bits, the last five rows carry one bit of the CRC in
+	// place of the last data bit. Hamming (16,11,4) each row except the last
+	// one, which holds the parity bits for each column.
+	unsigned int rows[8U];
+	rows[7U] = 0U;
+
+	unsigned int acc  = 0U;
+	unsigned int bits = 0U;
+	unsigned int pos  = 0U;
+	for (unsigned int a = 0U; a < 7U; a++) {
+		unsigned int count = (a < 2U) ? 11U : 10U;
+
+		while (bits < count) {
+			acc = (acc << 8) | m_data[pos++];
+			bits += 8U;
+		}
 
-	// Hamming (16,11,4) check each row except the last one
-	for (unsigned int a = 0U; a < 112U; a += 16U)
-		CHamming::encode16114(data + a);
+		bits -= count;
+		unsigned int value = (acc >> bits) & ((1U << count) - 1U);
 
-	// Add the parity bits for each column
-	for (unsigned int a = 0U; a < 16U; a++)
-		data[a + 112U] = data[a + 0U] ^ data[a + 16U] ^ data[a + 32U] ^ data[a + 48U] ^ data[a + 64U] ^ data[a + 80U] ^ data[a + 96U];
+		if (a >= 2U)
+			value = (value << 1) | ((crc >> (6U - a)) & 0x01U);
 
-	// The data is packed downwards in columns
-	b = 0U;
-	for (unsigned int a = 0U; a < 128U; a++) {
-		m_raw[a] = data[b];
-		b += 16U;
-		if (b > 127U)
-			b -= 127U;
+		rows[a] = CHamming::encode16114(value);
+		rows[7U] ^= rows[a];
 	}
+
+	// The data is packed downwards in columns
+	rowsToColumns(rows, m_raw);
 }
 
 unsigned char CDMREmbeddedData::getData(unsigned char* data, unsigned char n) const
@@ -173,22 +199,13 @@ unsigned char CDMREmbeddedData::getData(unsigned char* data, unsigned char n) co
 	if (n >= 1U && n < 5U) {
 		n--;
 
-		bool bits[40U];
-		::memset(bits, 0x00U, 40U * sizeof(bool));
-		::memcpy(bits + 4U, m_raw + n * 32U, 32U * sizeof(bool));
-
-		unsigned char bytes[5U];
-		CUtils::bitsToByteBE(bits + 0U,  bytes[0U]);
-		CUtils::bitsToByteBE(bits + 8U,  bytes[1U]);
-		CUtils::bitsToByteBE(bits + 16U, bytes[2U]);
-		CUtils::bitsToByteBE(bits + 24U, bytes[3U]);
-		CUtils::bitsToByteBE(bits + 32U, bytes[4U]);
+		unsigned int fragment = m_raw[n];
 
-		data[14U] = (data[14U] & 0xF0U) | (bytes[0U] & 0x0FU);
-		data[15U] = bytes[1U];
-		data[16U] = bytes[2U];
-		data[17U] = bytes[3U];
-		data[18U] = (data[18U] & 0x0FU) | (bytes[4U] & 0xF0U);
+		data[14U] = (data[14U] & 0xF0U) | ((fragment >> 28) & 0x0FU);
+		data[15U] = fragment >> 20;
+		data[16U] = fragment >> 12;
+		data[17U] = fragment >> 4;
+		data[18U] = (data[18U] & 0x0FU) | ((fragment << 4) & 0xF0U);
 
 		switch (n) {
 		case 0U:
@@ -212,55 +229,40 @@ unsigned char CDMREmbeddedData::getData(unsigned char* data, unsigned char n) co
 // Unpack and error check an embedded LC
 void CDMREmbeddedData::decodeEmbeddedData()
 {
-	// The data is unpacked downwards in columns
-	bool data[128U];
-	::memset(data, 0x00U, 128U * sizeof(bool));
-
-	unsigned int b = 0U;
-	for (unsigned int a = 0U; a < 128U; a++) {
-		data[b] = m_raw[a];
-		b += 16U;
-		if (b > 127U)
-			b -= 127U;
-	}
+	// The data is unpacked downwards in columns into 16 bit rows
+	unsigned int rows[8U];
+	columnsToRows(m_raw, rows);
 
 	// Hamming (16,11,4) check each row except the last one
-	for (unsigned int a = 0U; a < 112U; a += 16U) {
-		if (!CHamming::decode16114(data + a))
+	for (unsigned int a = 0U; a < 7U; a++) {
+		if (!CHamming::decode16114(rows[a]))
 			return;
 	}
 
 	// Check the parity bits
-	for (unsigned int a = 0U; a < 16U; a++) {
-		bool parity = data[a + 0U] ^ data[a + 16U] ^ data[a + 32U] ^ data[a + 48U] ^ data[a + 64U] ^ data[a + 80U] ^ data[a + 96U] ^ data[a + 112U];
-		if (parity)
-			return;
-	}
+	if ((rows[0U] ^ rows[1U] ^ rows[2U] ^ rows[3U] ^ rows[4U] ^ rows[5U] ^ rows[6U] ^ rows[7U]) != 0U)
+		return;
 
-	// We have passed the Hamming check so extract the actual payload
-	b = 0U;
-	for (unsigned int a = 0U; a < 11U; a++, b++)
-		m_data[b] = data[a];
-	for (unsigned int a = 16U; a < 27U; a++, b++)
-		m_data[b] = data[a];
-	for (unsigned int a = 32U; a < 42U; a++, b++)
-		m_data[b] = data[a];
-	for (unsigned int a = 48U; a < 58U; a++, b++)
-		m_data[b] = data[a];
-	for (unsigned int a = 64U; a < 74U; a++, b++)
-		m_data[b] = data[a];
-	for (unsigned int a = 80U; a < 90U; a++, b++)
-		m_data[b] = data[a];
-	for (unsigned int a = 96U; a < 106U; a++, b++)
-		m_data[b] = data[a];
-
-	// Extract the 5 bit CRC
-	unsigned int crc = 0U;
-	if (data[42])  crc += 16U;
-	if (data[58])  crc += 8U;
-	if (data[74])  crc += 4U;
-	if (data[90])  crc += 2U;
-	if (data[106]) crc += 1U;
+	// We have passed the Hamming check so extract the actual payload and
+	// the 5 bit CRC, which is the last data bit of the last five rows
+	unsigned int crc  = 0U;
+	unsigned int acc  = 0U;
+	unsigned int bits = 0U;
+	unsigned int pos  = 0U;
+	for (unsigned int a = 0U; a < 7U; a++) {
+		unsigned int count = (a < 2U) ? 11U : 10U;
+
+		acc = (acc << count) | (rows[a] >> (16U - count));
+		bits += count;
+
+		while (bits >= 8U) {
+			bits -= 8U;
+			m_data[pos++] = acc >> bits;
+		}
+
+		if (a >= 2U)
+			crc = (crc << 1) | ((rows[a] >> 5) & 0x01U);
+	}
 
 	// Now CRC check this
 	if (!CCRC::checkFiveBit(m_data, crc))
@@ -269,20 +271,20 @@ void CDMREmbeddedData::decodeEmbeddedData()
 	m_valid = true;
 
 	// Extract the FLCO
-	unsigned char flco;
-	CUtils::bitsToByteBE(m_data + 0U, flco);
-	m_FLCO = FLCO(flco & 0x3FU);
+	m_FLCO = FLCO(m_data[0U] & 0x3FU);
 }
 
-CDMRLC* CDMREmbeddedData::getLC() const
+bool CDMREmbeddedData::getLC(CDMRLC& lc) const
 {
 	if (!m_valid)
-		return NULL;
+		return false;
 
 	if (m_FLCO != FLCO_GROUP && m_FLCO != FLCO_USER_USER)
-		return NULL;
+		return false;
 
-	return new CDMRLC(m_data);
+	lc = CDMRLC(m_data);
+
+	return true;
 }
 
 bool CDMREmbeddedData::isValid() const
@@ -308,15 +310,7 @@ bool CDMREmbeddedData::getRawData(unsigned char* data) const
 	if (!m_valid)
 		return false;
 
-	CUtils::bitsToByteBE(m_data + 0U,  data[0U]);
-	CUtils::bitsToByteBE(m_data + 8U,  data[1U]);
-	CUtils::bitsToByteBE(m_data + 16U, data[2U]);
-	CUtils::bitsToByteBE(m_data + 24U, data[3U]);
-	CUtils::bitsToByteBE(m_data + 32U, data[4U]);
-	CUtils::bitsToByteBE(m_data + 40U, data[5U]);
-	CUtils::bitsToByteBE(m_data + 48U, data[6U]);
-	CUtils::bitsToByteBE(m_data + 56U, data[7U]);
-	CUtils::bitsToByteBE(m_data + 64U, data[8U]);
+	::memcpy(data, m_data, 9U);
 
 	return true;
 }
@@ -55,6 +55,8 @@ public:
 
 	void close();
 
+	void setCapture(CCapture* capture, CReplay* replay);
+
 private: 
 	in_addr                    m_rptAddress;
 	unsigned int               m_rptPort;
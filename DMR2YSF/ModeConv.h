@@ -21,6 +21,8 @@
 #include "YSFDefines.h"
 #include "RingBuffer.h"
 
+#include <cstdint>
+
 #if !defined(MODECONV_H)
 #define MODECONV_H
 
@@ -29,11 +31,11 @@ public:
 	CModeConv();
 	~CModeConv();
 
-	void putDMR(unsigned char* bytes);
+	void putDMR(const unsigned char* bytes);
 	void putDMRHeader();
 	void putDMREOT();
 
-	void putYSF(unsigned char* bytes);
+	void putYSF(const unsigned char* bytes);
 	void putYSFHeader();
 	void putYSFEOT();
 
@@ -41,13 +43,10 @@ public:
 	unsigned int getDMR(unsigned char* bytes);
 
 private:
-	void putAMBE2YSF(unsigned int a, unsigned int b, unsigned int dat_c);
-	void putAMBE2DMR(unsigned int dat_a, unsigned int dat_b, unsigned int dat_c);
 	unsigned int m_ysfN;
 	unsigned int m_dmrN;
-	CRingBuffer<unsigned char> m_YSF;
-	CRingBuffer<unsigned char> m_DMR;
-
+	CRingBuffer<uint64_t> m_YSF;
+	CRingBuffer<uint64_t> m_DMR;
 };
 
 #endif
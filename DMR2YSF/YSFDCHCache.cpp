@@ -0,0 +1,64 @@
+/*
+ *   Copyright (C) 2019 by Manuel Sanchez EA7EE
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "YSFDCHCache.h"
+
+#include <cstdio>
+#include <cassert>
+#include <cstring>
+
+CYSFDCHCache::CYSFDCHCache() :
+m_payload(),
+m_hits(0U),
+m_misses(0U)
+{
+	for (unsigned int i = 0U; i < 8U; i++)
+		m_valid[i] = false;
+}
+
+CYSFDCHCache::~CYSFDCHCache()
+{
+}
+
+void CYSFDCHCache::writeVDMode2Data(unsigned char* data, unsigned int fn, const unsigned char* dt)
+{
+	assert(data != NULL);
+	assert(fn < 8U);
+	assert(dt != NULL);
+
+	if (m_valid[fn] && ::memcmp(m_text[fn], dt, YSF_CALLSIGN_LENGTH) == 0) {
+		m_hits++;
+	} else {
+		::memcpy(m_text[fn], dt, YSF_CALLSIGN_LENGTH);
+		m_payload.encodeVDMode2Data(dt, m_dch[fn]);
+		m_valid[fn] = true;
+		m_misses++;
+	}
+
+	m_payload.writeVDMode2DCH(data, m_dch[fn]);
+}
+
+unsigned int CYSFDCHCache::getHits() const
+{
+	return m_hits;
+}
+
+unsigned int CYSFDCHCache::getMisses() const
+{
+	return m_misses;
+}
@@ -0,0 +1,49 @@
+/*
+ *   Copyright (C) 2019 by Manuel Sanchez EA7EE
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#ifndef YSFDCHCache_H
+#define YSFDCHCache_H
+
+#include "YSFDefines.h"
+#include "YSFPayload.h"
+
+// The VD mode 2 DCH of a stream repeats every eight frames: "**********",
+// the source, the destination, blanks and the GPS text. Each frame number
+// keeps the last text it was given and its encoded DCH, so the CRC,
+// convolutional encode and interleave only run when that text changes,
+// for example on a new source or destination, or a GPS update.
+class CYSFDCHCache {
+public:
+	CYSFDCHCache();
+	~CYSFDCHCache();
+
+	void writeVDMode2Data(unsigned char* data, unsigned int fn, const unsigned char* dt);
+
+	unsigned int getHits() const;
+	unsigned int getMisses() const;
+
+private:
+	CYSFPayload   m_payload;
+	bool          m_valid[8U];
+	unsigned char m_text[8U][YSF_CALLSIGN_LENGTH];
+	unsigned char m_dch[8U][YSF_VD_MODE2_DCH_LENGTH_BYTES];
+	unsigned int  m_hits;
+	unsigned int  m_misses;
+};
+
+#endif
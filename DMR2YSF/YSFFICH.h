@@ -59,6 +59,8 @@ public:
 
 private:
 	unsigned char* m_fich;
+
+	void encodeFICH(unsigned char* bytes);
 };
 
 #endif
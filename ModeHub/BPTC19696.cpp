@@ -0,0 +1,251 @@
+/*
+ *	 Copyright (C) 2012 by Ian Wraith
+ *   Copyright (C) 2015 by Jonathan Naylor G4KLX
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "BPTC19696.h"
+
+#include "ECCTables.h"
+
+#include <cstdio>
+#include <cassert>
+#include <cstring>
+
+// Where each of the 195 matrix bits, taken row by row, is in the 33 byte
+// burst, as the byte number times eight plus the shift of the bit in that
+// byte. The matrix position a + 1 (position 0 is the unused R(3)) is sent
+// as bit (a * 181) % 196 of the 196 BPTC bits, of which the first 98 are at
+// the start of the burst and the rest follow the sync/slot type.
+static constexpr CECCTable<uint16_t, 195U> makeInterleaveTable()
+{
+	CECCTable<uint16_t, 195U> table = {};
+
+	for (unsigned int i = 0U; i < 195U; i++) {
+		unsigned int bit = ((i + 1U) * 181U) % 196U;
+		if (bit >= 98U)
+			bit += 68U;
+
+		table.m_data[i] = uint16_t((bit & ~0x07U) | (7U - (bit & 0x07U)));
+	}
+
+	return table;
+}
+
+static constexpr CECCTable<uint16_t, 195U> INTERLEAVE_TABLE = makeInterleaveTable();
+
+// Hamming (15,11,3) check equations for a row, data and check bits
+const uint16_t ROW_CHECK[] = {0x7AC8U, 0x3D64U, 0x1EB2U, 0x7591U};
+
+// Bit to correct in a row for each syndrome
+const uint16_t ROW_ERROR[] = {0x0000U, 0x0008U, 0x0004U, 0x0040U, 0x0002U, 0x0200U, 0x0020U, 0x0800U,
+							  0x0001U, 0x4000U, 0x0100U, 0x2000U, 0x0010U, 0x0080U, 0x0400U, 0x1000U};
+
+// Hamming (13,9,3) syndromes and the row that each one corrects in a column
+const unsigned int COLUMN_ERRORS = 13U;
+const unsigned char COLUMN_SYNDROME[] = {0x01U, 0x02U, 0x04U, 0x08U, 0x0FU, 0x07U, 0x0EU, 0x05U, 0x0AU, 0x0DU, 0x03U, 0x06U, 0x0CU};
+const unsigned char COLUMN_ROW[]      = {9U,    10U,   11U,   12U,   0U,    1U,    2U,    3U,    4U,    5U,    6U,    7U,    8U};
+
+const uint16_t ROW_MASK = 0x7FFFU;
+
+static unsigned int parity(unsigned int value)
+{
+	value ^= value >> 8;
+	value ^= value >> 4;
+	value ^= value >> 2;
+	value ^= value >> 1;
+
+	return value & 0x01U;
+}
+
+CBPTC19696::CBPTC19696()
+{
+	::memset(m_rows, 0x00U, sizeof(m_rows));
+}
+
+CBPTC19696::~CBPTC19696()
+{
+}
+
+// The main decode function
+void CBPTC19696::decode(const unsigned char* in, unsigned char* out)
+{
+	assert(in != NULL);
+	assert(out != NULL);
+
+	//  Get the raw binary and deinterleave it
+	decodeExtractBinary(in);
+
+	// Error check
+	decodeErrorCheck();
+
+	// Extract Data
+	decodeExtractData(out);
+}
+
+// The main encode function
+void CBPTC19696::encode(const unsigned char* in, unsigned char* out)
+{
+	assert(in != NULL);
+	assert(out != NULL);
+
+	// Extract Data
+	encodeExtractData(in);
+
+	// Error check
+	encodeErrorCheck();
+
+	//  Interleave and get the raw binary
+	encodeExtractBinary(out);
+}
+
+void CBPTC19696::decodeExtractBinary(const unsigned char* in)
+{
+	const uint16_t* pos = &INTERLEAVE_TABLE[0U];
+
+	for (unsigned int r = 0U; r < 13U; r++) {
+		uint16_t row = 0U;
+
+		for (unsigned int c = 0U; c < 15U; c++, pos++)
+			row = (row << 1) | ((in[*pos >> 3] >> (*pos & 0x07U)) & 0x01U);
+
+		m_rows[r] = row;
+	}
+}
+
+// Check each row with a Hamming (15,11,3) code and each column with a Hamming (13,9,3) code
+void CBPTC19696::decodeErrorCheck()
+{
+	bool fixing;
+	unsigned int count = 0U;
+	do {
+		fixing = false;
+
+		// The columns are checked all at once, bit c of each syndrome word
+		// belongs to column c
+		const uint16_t* d = m_rows;
+		uint16_t s0 = d[0] ^ d[1] ^ d[3] ^ d[5] ^ d[6] ^ d[9];
+		uint16_t s1 = d[0] ^ d[1] ^ d[2] ^ d[4] ^ d[6] ^ d[7] ^ d[10];
+		uint16_t s2 = d[0] ^ d[1] ^ d[2] ^ d[3] ^ d[5] ^ d[7] ^ d[8] ^ d[11];
+		uint16_t s3 = d[0] ^ d[2] ^ d[4] ^ d[5] ^ d[8] ^ d[12];
+
+		for (unsigned int i = 0U; i < COLUMN_ERRORS; i++) {
+			unsigned char n = COLUMN_SYNDROME[i];
+
+			uint16_t columns = ROW_MASK;
+			columns &= (n & 0x01U) ? s0 : uint16_t(~s0);
+			columns &= (n & 0x02U) ? s1 : uint16_t(~s1);
+			columns &= (n & 0x04U) ? s2 : uint16_t(~s2);
+			columns &= (n & 0x08U) ? s3 : uint16_t(~s3);
+
+			if (columns != 0U) {
+				m_rows[COLUMN_ROW[i]] ^= columns;
+				fixing = true;
+			}
+		}
+
+		// Run through each of the 9 rows containing data
+		for (unsigned int r = 0U; r < 9U; r++) {
+			unsigned int n = 0U;
+			for (unsigned int i = 0U; i < 4U; i++)
+				n |= parity(m_rows[r] & ROW_CHECK[i]) << i;
+
+			if (n != 0U) {
+				m_rows[r] ^= ROW_ERROR[n];
+				fixing = true;
+			}
+		}
+
+		count++;
+	} while (fixing && count < 5U);
+}
+
+// Extract the 96 bits of payload, eight from the first row and eleven from
+// each of the next eight
+void CBPTC19696::decodeExtractData(unsigned char* data) const
+{
+	data[0U] = (m_rows[0U] >> 4) & 0xFFU;
+
+	unsigned int n = 1U;
+	unsigned int bits = 0U;
+	uint32_t acc = 0U;
+	for (unsigned int r = 1U; r < 9U; r++) {
+		acc = (acc << 11) | ((m_rows[r] >> 4) & 0x7FFU);
+		bits += 11U;
+
+		while (bits >= 8U) {
+			bits -= 8U;
+			data[n++] = (acc >> bits) & 0xFFU;
+		}
+	}
+}
+
+// Place the 96 bits of payload in the matrix, the three reserved bits of
+// the first row are left as zero
+void CBPTC19696::encodeExtractData(const unsigned char* in)
+{
+	::memset(m_rows, 0x00U, sizeof(m_rows));
+
+	m_rows[0U] = uint16_t(in[0U]) << 4;
+
+	unsigned int n = 1U;
+	unsigned int bits = 0U;
+	uint32_t acc = 0U;
+	for (unsigned int r = 1U; r < 9U; r++) {
+		while (bits < 11U) {
+			acc = (acc << 8) | in[n++];
+			bits += 8U;
+		}
+
+		bits -= 11U;
+		m_rows[r] = uint16_t(((acc >> bits) & 0x7FFU) << 4);
+	}
+}
+
+// Add the Hamming (15,11,3) check bits to each row and the Hamming (13,9,3) check bits to each column
+void CBPTC19696::encodeErrorCheck()
+{
+	// Run through each of the 9 rows containing data
+	for (unsigned int r = 0U; r < 9U; r++) {
+		for (unsigned int i = 0U; i < 4U; i++)
+			m_rows[r] |= parity(m_rows[r] & ROW_CHECK[i] & 0x7FF0U) << (3U - i);
+	}
+
+	// The four check rows cover all 15 columns at once
+	uint16_t* d = m_rows;
+	d[9U]  = d[0] ^ d[1] ^ d[3] ^ d[5] ^ d[6];
+	d[10U] = d[0] ^ d[1] ^ d[2] ^ d[4] ^ d[6] ^ d[7];
+	d[11U] = d[0] ^ d[1] ^ d[2] ^ d[3] ^ d[5] ^ d[7] ^ d[8];
+	d[12U] = d[0] ^ d[2] ^ d[4] ^ d[5] ^ d[8];
+}
+
+void CBPTC19696::encodeExtractBinary(unsigned char* data) const
+{
+	// Clear the 196 BPTC bits, this also sends the unused R(3) as zero
+	::memset(data + 0U, 0x00U, 12U);
+	data[12U] &= 0x3FU;
+	data[20U] &= 0xFCU;
+	::memset(data + 21U, 0x00U, 12U);
+
+	const uint16_t* pos = &INTERLEAVE_TABLE[0U];
+
+	for (unsigned int r = 0U; r < 13U; r++) {
+		unsigned int row = m_rows[r];
+
+		for (unsigned int c = 0U; c < 15U; c++, pos++)
+			data[*pos >> 3] |= ((row >> (14U - c)) & 0x01U) << (*pos & 0x07U);
+	}
+}
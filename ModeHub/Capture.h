@@ -0,0 +1,106 @@
+/*
+ *   Copyright (C) 2019 by Manuel Sanchez EA7EE
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#ifndef Capture_H
+#define Capture_H
+
+#include "Mutex.h"
+
+#include <string>
+#include <vector>
+#include <atomic>
+#include <cstdio>
+
+#if !defined(_WIN32) && !defined(_WIN64)
+#include <netinet/in.h>
+#else
+#include <winsock.h>
+#endif
+
+// Datagram channels, one per network socket
+const unsigned char CAPTURE_YSF  = 0U;
+const unsigned char CAPTURE_DMR  = 1U;
+const unsigned char CAPTURE_NXDN = 2U;
+const unsigned char CAPTURE_P25  = 3U;
+
+const unsigned int  CAPTURE_CHANNELS = 4U;
+
+class CCaptureRecord {
+public:
+	unsigned long long         m_time;
+	in_addr                    m_address;
+	unsigned int               m_port;
+	std::vector<unsigned char> m_data;
+};
+
+// Records every datagram read from or written to the network sockets,
+// with its time in microseconds. Several threads may write records.
+class CCapture {
+public:
+	CCapture(const std::string& filename);
+	~CCapture();
+
+	bool open();
+
+	void write(unsigned char channel, bool tx, const in_addr& address, unsigned int port, const unsigned char* data, unsigned int length);
+
+	void close();
+
+	// Reads either the received or the transmitted records of a capture
+	// file, split by channel
+	static bool load(const std::string& filename, bool tx, std::vector<CCaptureRecord>* records);
+
+private:
+	std::string        m_filename;
+	FILE*              m_fp;
+	CMutex             m_mutex;
+	unsigned long long m_start;
+};
+
+// Plays back the received datagrams of a capture file on the same
+// channels. It switches CClock to virtual time, which the bridge advances
+// by calling sleep() where it would otherwise sleep, so a record is read
+// once the virtual time reaches its capture timestamp and every run of the
+// same capture sees the same timeline, however fast the host is.
+class CReplay {
+public:
+	CReplay(const std::string& filename);
+	~CReplay();
+
+	bool open();
+
+	void start();
+
+	// Advance the virtual time in place of CThread::sleep()
+	void sleep(unsigned int ms);
+
+	int read(unsigned char channel, unsigned char* buffer, unsigned int length, in_addr& address, unsigned int& port);
+
+	bool isFinished() const;
+
+	// Virtual time since start() in milliseconds
+	unsigned int getElapsed() const;
+
+private:
+	std::string                 m_filename;
+	std::vector<CCaptureRecord> m_records[CAPTURE_CHANNELS];
+	std::atomic<unsigned int>   m_ptrs[CAPTURE_CHANNELS];
+	unsigned long long          m_start;
+};
+
+#endif
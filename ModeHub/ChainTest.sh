@@ -0,0 +1,126 @@
+#!/bin/sh
+#
+# Compares ModeHub with the bridges it replaces on the YSF to NXDN path.
+# HubBench stands in for the YSF reflector and the NXDN gateway and times
+# the same calls through ModeHub, then through YSF2DMR logged into
+# DMR2NXDN as its DMR master. The CPU time each program used while the
+# calls ran is taken from /proc. YSF2DMR and DMR2NXDN must have been built
+# in their own directories first.
+#
+# Usage: ChainTest.sh [calls] [call length secs]
+
+CALLS=${1:-5}
+LENGTH=${2:-10}
+
+DIR=$(cd "$(dirname "$0")" && pwd)
+WORK=$(mktemp -d /tmp/modehub-chain.XXXXXX)
+
+YSF2DMR="$DIR/../YSF2DMR/YSF2DMR"
+DMR2NXDN="$DIR/../DMR2NXDN/DMR2NXDN"
+
+# The Id lookup files that come with DMR2NXDN
+IDS="$DIR/../DMR2NXDN"
+
+for PROGRAM in "$DIR/ModeHub" "$DIR/HubBench" "$YSF2DMR" "$DMR2NXDN"; do
+	if [ ! -x "$PROGRAM" ]; then
+		echo "$PROGRAM has not been built"
+		exit 1
+	fi
+done
+
+YSF_PORT=42098
+NXDN_PORT=14098
+DMR_PORT=62098
+RPT_PORT=62099
+
+GAP=3
+
+# The DMR login takes over ten seconds
+WAIT=20
+
+# The user and system clock ticks of a process so far
+ticks()
+{
+	cut -d ' ' -f 14,15 "/proc/$1/stat" | awk '{ print $1 + $2 }'
+}
+
+sed -e "s/^DstPort=42000/DstPort=$YSF_PORT/" \
+    -e "s/^DstPort=14020/DstPort=$NXDN_PORT/" \
+    -e "/^\[DMR Network\]/,/^$/s/^Enable=1/Enable=0/" \
+    -e "/^\[P25 Network\]/,/^$/s/^Enable=1/Enable=0/" \
+    -e "s#^File=/usr/local/etc/DMRIds.dat#File=$IDS/DMRIds.dat#" \
+    -e "s#^File=/usr/local/etc/NXDN.csv#File=$IDS/NXDN.csv#" \
+    -e "s#^FilePath=.*#FilePath=$WORK#" \
+    -e "s/^Mode=.*/Mode=0/" \
+    "$DIR/ModeHub.ini" > "$WORK/ModeHub.ini"
+
+sed -e "s/^DstPort=42000/DstPort=$YSF_PORT/" \
+    -e "s/^Daemon=1/Daemon=0/" \
+    -e "s/^EnableWiresX=.*/EnableWiresX=0/" \
+    -e "s/^StartupPC=.*/StartupPC=0/" \
+    -e "s/^EnableUnlink=.*/EnableUnlink=0/" \
+    -e "s/^Address=84.232.5.113/Address=127.0.0.1/" \
+    -e "s/^Port=62031/Port=$DMR_PORT/" \
+    -e "s/^# Local=62032/Local=$RPT_PORT/" \
+    -e "s#^TGListFile=.*#TGListFile=$DIR/../YSF2DMR/TGList-DMR.txt#" \
+    -e "s#^File=/usr/local/etc/DMRIds.dat#File=$IDS/DMRIds.dat#" \
+    -e "s#^FilePath=.*#FilePath=$WORK#" \
+    -e "s/^FileLevel=.*/FileLevel=1/" \
+    -e "/^\[aprs.fi\]/,/^$/s/^Enable=1/Enable=0/" \
+    -e "s/^Mode=.*/Mode=0/" \
+    "$DIR/../YSF2DMR/YSF2DMR.ini" > "$WORK/YSF2DMR.ini"
+
+sed -e "s/^GatewayPort=14020/GatewayPort=$NXDN_PORT/" \
+    -e "s/^LocalPort=14021/LocalPort=$((NXDN_PORT + 1))/" \
+    -e "s/^RptPort=62032/RptPort=$RPT_PORT/" \
+    -e "s/^LocalPort=62031/LocalPort=$DMR_PORT/" \
+    -e "s#^File=DMRIds.dat#File=$IDS/DMRIds.dat#" \
+    -e "s#^File=NXDN.csv#File=$IDS/NXDN.csv#" \
+    -e "s#^FilePath=.*#FilePath=$WORK#" \
+    -e "s/^Mode=.*/Mode=0/" \
+    "$DIR/../DMR2NXDN/DMR2NXDN.ini" > "$WORK/DMR2NXDN.ini"
+
+cd "$WORK" || exit 1
+
+echo "ModeHub, YSF to NXDN in one process"
+
+"$DIR/HubBench" -y $YSF_PORT -n $NXDN_PORT -c $CALLS -l $LENGTH -g $GAP -w $WAIT > hub.out 2>&1 &
+BENCH=$!
+"$DIR/ModeHub" "$WORK/ModeHub.ini" > modehub.out 2>&1 &
+HUB=$!
+
+sleep $WAIT
+HUB_START=$(ticks $HUB)
+wait $BENCH
+HUB_TICKS=$(($(ticks $HUB) - HUB_START))
+
+kill -TERM $HUB
+wait $HUB
+
+echo "YSF2DMR logged into DMR2NXDN"
+
+"$DIR/HubBench" -y $YSF_PORT -n $NXDN_PORT -c $CALLS -l $LENGTH -g $GAP -w $WAIT > chain.out 2>&1 &
+BENCH=$!
+"$DMR2NXDN" "$WORK/DMR2NXDN.ini" > dmr2nxdn.out 2>&1 &
+MASTER=$!
+sleep 1
+"$YSF2DMR" "$WORK/YSF2DMR.ini" > ysf2dmr.out 2>&1 &
+BRIDGE=$!
+
+sleep $((WAIT - 1))
+BRIDGE_START=$(ticks $BRIDGE)
+MASTER_START=$(ticks $MASTER)
+wait $BENCH
+BRIDGE_TICKS=$(($(ticks $BRIDGE) - BRIDGE_START))
+MASTER_TICKS=$(($(ticks $MASTER) - MASTER_START))
+
+kill -TERM $BRIDGE $MASTER
+wait $BRIDGE $MASTER
+
+TICK=$((1000 / $(getconf CLK_TCK)))
+
+grep -h "calls, .* AMBE frames" hub.out | sed -e 's/^.*[0-9] \([0-9]* calls\)/ModeHub: \1/'
+grep -h "calls, .* AMBE frames" chain.out | sed -e 's/^.*[0-9] \([0-9]* calls\)/Chain: \1/'
+echo "CPU during the calls: ModeHub $((HUB_TICKS * TICK))ms, YSF2DMR $((BRIDGE_TICKS * TICK))ms + DMR2NXDN $((MASTER_TICKS * TICK))ms"
+
+echo "Logs are in $WORK"
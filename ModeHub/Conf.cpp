@@ -0,0 +1,584 @@
+/*
+ *   Copyright (C) 2019 by Manuel Sanchez EA7EE
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "Conf.h"
+#include "Log.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cctype>
+
+const int BUFFER_SIZE = 500;
+
+enum SECTION {
+	SECTION_NONE,
+	SECTION_GENERAL,
+	SECTION_INFO,
+	SECTION_YSF_NETWORK,
+	SECTION_DMR_NETWORK,
+	SECTION_NXDN_NETWORK,
+	SECTION_P25_NETWORK,
+	SECTION_DMRID_LOOKUP,
+	SECTION_NXDNID_LOOKUP,
+	SECTION_LOG,
+	SECTION_CAPTURE
+};
+
+CConf::CConf(const std::string& file) :
+m_file(file),
+m_callsign(),
+m_daemon(false),
+m_routes(),
+m_rxFrequency(0U),
+m_txFrequency(0U),
+m_power(0U),
+m_latitude(0.0F),
+m_longitude(0.0F),
+m_height(0),
+m_location(),
+m_description(),
+m_url(),
+m_ysfEnabled(false),
+m_ysfDstAddress(),
+m_ysfDstPort(0U),
+m_ysfLocalAddress(),
+m_ysfLocalPort(0U),
+m_ysfNetworkDebug(false),
+m_dmrEnabled(false),
+m_dmrId(0U),
+m_dmrDstId(9990U),
+m_dmrPC(true),
+m_dmrNetworkAddress(),
+m_dmrNetworkPort(0U),
+m_dmrNetworkLocal(0U),
+m_dmrNetworkPassword(),
+m_dmrNetworkOptions(),
+m_dmrNetworkDebug(false),
+m_dmrNetworkJitter(500U),
+m_nxdnEnabled(false),
+m_nxdnId(65519U),
+m_nxdnTG(20U),
+m_nxdnDstAddress(),
+m_nxdnDstPort(0U),
+m_nxdnLocalAddress(),
+m_nxdnLocalPort(0U),
+m_nxdnNetworkDebug(false),
+m_p25Enabled(false),
+m_p25Id(0U),
+m_p25TG(10100U),
+m_p25DstAddress(),
+m_p25DstPort(0U),
+m_p25LocalAddress(),
+m_p25LocalPort(0U),
+m_p25NetworkCoalesce(false),
+m_p25NetworkDebug(false),
+m_dmrIdLookupFile(),
+m_dmrIdLookupTime(0U),
+m_nxdnIdLookupFile(),
+m_nxdnIdLookupTime(0U),
+m_logDisplayLevel(0U),
+m_logFileLevel(0U),
+m_logFilePath(),
+m_logFileRoot(),
+m_captureMode(0U),
+m_captureFile(),
+m_captureOutput()
+{
+}
+
+CConf::~CConf()
+{
+}
+
+bool CConf::read()
+{
+	FILE* fp = ::fopen(m_file.c_str(), "rt");
+	if (fp == NULL) {
+		::fprintf(stderr, "Couldn't open the .ini file - %s\n", m_file.c_str());
+		return false;
+	}
+
+	SECTION section = SECTION_NONE;
+
+	char buffer[BUFFER_SIZE];
+	while (::fgets(buffer, BUFFER_SIZE, fp) != NULL) {
+		if (buffer[0U] == '#')
+			continue;
+
+		if (buffer[0U] == '[') {
+			if (::strncmp(buffer, "[General]", 9U) == 0)
+				section = SECTION_GENERAL;
+			else if (::strncmp(buffer, "[Info]", 6U) == 0)
+				section = SECTION_INFO;
+			else if (::strncmp(buffer, "[YSF Network]", 13U) == 0)
+				section = SECTION_YSF_NETWORK;
+			else if (::strncmp(buffer, "[DMR Network]", 13U) == 0)
+				section = SECTION_DMR_NETWORK;
+			else if (::strncmp(buffer, "[NXDN Network]", 14U) == 0)
+				section = SECTION_NXDN_NETWORK;
+			else if (::strncmp(buffer, "[P25 Network]", 13U) == 0)
+				section = SECTION_P25_NETWORK;
+			else if (::strncmp(buffer, "[DMR Id Lookup]", 15U) == 0)
+				section = SECTION_DMRID_LOOKUP;
+			else if (::strncmp(buffer, "[NXDN Id Lookup]", 16U) == 0)
+				section = SECTION_NXDNID_LOOKUP;
+			else if (::strncmp(buffer, "[Log]", 5U) == 0)
+				section = SECTION_LOG;
+			else if (::strncmp(buffer, "[Capture]", 9U) == 0)
+				section = SECTION_CAPTURE;
+			else
+				section = SECTION_NONE;
+
+			continue;
+		}
+
+		char* key   = ::strtok(buffer, " \t=\r\n");
+		if (key == NULL)
+			continue;
+
+		char* value = ::strtok(NULL, "\r\n");
+		if (value == NULL)
+			continue;
+
+		// Remove quotes from the value
+		size_t len = ::strlen(value);
+		if (len > 1U && *value == '"' && value[len - 1U] == '"') {
+			value[len - 1U] = '\0';
+			value++;
+		}
+
+		if (section == SECTION_GENERAL) {
+			if (::strcmp(key, "Callsign") == 0) {
+				// Convert the callsign to upper case
+				for (unsigned int i = 0U; value[i] != 0; i++)
+					value[i] = ::toupper(value[i]);
+				m_callsign = value;
+			} else if (::strcmp(key, "Daemon") == 0)
+				m_daemon = ::atoi(value) == 1;
+			else if (::strcmp(key, "Routes") == 0)
+				m_routes = value;
+		} else if (section == SECTION_INFO) {
+			if (::strcmp(key, "RXFrequency") == 0)
+				m_rxFrequency = (unsigned int)::atoi(value);
+			else if (::strcmp(key, "TXFrequency") == 0)
+				m_txFrequency = (unsigned int)::atoi(value);
+			else if (::strcmp(key, "Power") == 0)
+				m_power = (unsigned int)::atoi(value);
+			else if (::strcmp(key, "Latitude") == 0)
+				m_latitude = float(::atof(value));
+			else if (::strcmp(key, "Longitude") == 0)
+				m_longitude = float(::atof(value));
+			else if (::strcmp(key, "Height") == 0)
+				m_height = ::atoi(value);
+			else if (::strcmp(key, "Location") == 0)
+				m_location = value;
+			else if (::strcmp(key, "Description") == 0)
+				m_description = value;
+			else if (::strcmp(key, "URL") == 0)
+				m_url = value;
+		} else if (section == SECTION_YSF_NETWORK) {
+			if (::strcmp(key, "Enable") == 0)
+				m_ysfEnabled = ::atoi(value) == 1;
+			else if (::strcmp(key, "DstAddress") == 0)
+				m_ysfDstAddress = value;
+			else if (::strcmp(key, "DstPort") == 0)
+				m_ysfDstPort = (unsigned int)::atoi(value);
+			else if (::strcmp(key, "LocalAddress") == 0)
+				m_ysfLocalAddress = value;
+			else if (::strcmp(key, "LocalPort") == 0)
+				m_ysfLocalPort = (unsigned int)::atoi(value);
+			else if (::strcmp(key, "Debug") == 0)
+				m_ysfNetworkDebug = ::atoi(value) == 1;
+		} else if (section == SECTION_DMR_NETWORK) {
+			if (::strcmp(key, "Enable") == 0)
+				m_dmrEnabled = ::atoi(value) == 1;
+			else if (::strcmp(key, "Id") == 0)
+				m_dmrId = (unsigned int)::atoi(value);
+			else if (::strcmp(key, "StartupDstId") == 0)
+				m_dmrDstId = (unsigned int)::atoi(value);
+			else if (::strcmp(key, "StartupPC") == 0)
+				m_dmrPC = ::atoi(value) == 1;
+			else if (::strcmp(key, "Address") == 0)
+				m_dmrNetworkAddress = value;
+			else if (::strcmp(key, "Port") == 0)
+				m_dmrNetworkPort = (unsigned int)::atoi(value);
+			else if (::strcmp(key, "Local") == 0)
+				m_dmrNetworkLocal = (unsigned int)::atoi(value);
+			else if (::strcmp(key, "Password") == 0)
+				m_dmrNetworkPassword = value;
+			else if (::strcmp(key, "Options") == 0)
+				m_dmrNetworkOptions = value;
+			else if (::strcmp(key, "Debug") == 0)
+				m_dmrNetworkDebug = ::atoi(value) == 1;
+			else if (::strcmp(key, "Jitter") == 0)
+				m_dmrNetworkJitter = (unsigned int)::atoi(value);
+		} else if (section == SECTION_NXDN_NETWORK) {
+			if (::strcmp(key, "Enable") == 0)
+				m_nxdnEnabled = ::atoi(value) == 1;
+			else if (::strcmp(key, "Id") == 0)
+				m_nxdnId = (unsigned int)::atoi(value);
+			else if (::strcmp(key, "TG") == 0)
+				m_nxdnTG = (unsigned int)::atoi(value);
+			else if (::strcmp(key, "DstAddress") == 0)
+				m_nxdnDstAddress = value;
+			else if (::strcmp(key, "DstPort") == 0)
+				m_nxdnDstPort = (unsigned int)::atoi(value);
+			else if (::strcmp(key, "LocalAddress") == 0)
+				m_nxdnLocalAddress = value;
+			else if (::strcmp(key, "LocalPort") == 0)
+				m_nxdnLocalPort = (unsigned int)::atoi(value);
+			else if (::strcmp(key, "Debug") == 0)
+				m_nxdnNetworkDebug = ::atoi(value) == 1;
+		} else if (section == SECTION_P25_NETWORK) {
+			if (::strcmp(key, "Enable") == 0)
+				m_p25Enabled = ::atoi(value) == 1;
+			else if (::strcmp(key, "Id") == 0)
+				m_p25Id = (unsigned int)::atoi(value);
+			else if (::strcmp(key, "TG") == 0)
+				m_p25TG = (unsigned int)::atoi(value);
+			else if (::strcmp(key, "DstAddress") == 0)
+				m_p25DstAddress = value;
+			else if (::strcmp(key, "DstPort") == 0)
+				m_p25DstPort = (unsigned int)::atoi(value);
+			else if (::strcmp(key, "LocalAddress") == 0)
+				m_p25LocalAddress = value;
+			else if (::strcmp(key, "LocalPort") == 0)
+				m_p25LocalPort = (unsigned int)::atoi(value);
+			else if (::strcmp(key, "Coalesce") == 0)
+				m_p25NetworkCoalesce = ::atoi(value) == 1;
+			else if (::strcmp(key, "Debug") == 0)
+				m_p25NetworkDebug = ::atoi(value) == 1;
+		} else if (section == SECTION_DMRID_LOOKUP) {
+			if (::strcmp(key, "File") == 0)
+				m_dmrIdLookupFile = value;
+			else if (::strcmp(key, "Time") == 0)
+				m_dmrIdLookupTime = (unsigned int)::atoi(value);
+		} else if (section == SECTION_NXDNID_LOOKUP) {
+			if (::strcmp(key, "File") == 0)
+				m_nxdnIdLookupFile = value;
+			else if (::strcmp(key, "Time") == 0)
+				m_nxdnIdLookupTime = (unsigned int)::atoi(value);
+		} else if (section == SECTION_LOG) {
+			if (::strcmp(key, "DisplayLevel") == 0)
+				m_logDisplayLevel = (unsigned int)::atoi(value);
+			else if (::strcmp(key, "FileLevel") == 0)
+				m_logFileLevel = (unsigned int)::atoi(value);
+			else if (::strcmp(key, "FilePath") == 0)
+				m_logFilePath = value;
+			else if (::strcmp(key, "FileRoot") == 0)
+				m_logFileRoot = value;
+		} else if (section == SECTION_CAPTURE) {
+			if (::strcmp(key, "Mode") == 0)
+				m_captureMode = (unsigned int)::atoi(value);
+			else if (::strcmp(key, "File") == 0)
+				m_captureFile = value;
+			else if (::strcmp(key, "Output") == 0)
+				m_captureOutput = value;
+		}
+	}
+
+	::fclose(fp);
+
+	return true;
+}
+
+std::string CConf::getCallsign() const
+{
+	return m_callsign;
+}
+
+bool CConf::getDaemon() const
+{
+	return m_daemon;
+}
+
+std::string CConf::getRoutes() const
+{
+	return m_routes;
+}
+
+unsigned int CConf::getRxFrequency() const
+{
+	return m_rxFrequency;
+}
+
+unsigned int CConf::getTxFrequency() const
+{
+	return m_txFrequency;
+}
+
+unsigned int CConf::getPower() const
+{
+	return m_power;
+}
+
+float CConf::getLatitude() const
+{
+	return m_latitude;
+}
+
+float CConf::getLongitude() const
+{
+	return m_longitude;
+}
+
+int CConf::getHeight() const
+{
+	return m_height;
+}
+
+std::string CConf::getLocation() const
+{
+	return m_location;
+}
+
+std::string CConf::getDescription() const
+{
+	return m_description;
+}
+
+std::string CConf::getURL() const
+{
+	return m_url;
+}
+
+bool CConf::getYSFEnabled() const
+{
+	return m_ysfEnabled;
+}
+
+std::string CConf::getYSFDstAddress() const
+{
+	return m_ysfDstAddress;
+}
+
+unsigned int CConf::getYSFDstPort() const
+{
+	return m_ysfDstPort;
+}
+
+std::string CConf::getYSFLocalAddress() const
+{
+	return m_ysfLocalAddress;
+}
+
+unsigned int CConf::getYSFLocalPort() const
+{
+	return m_ysfLocalPort;
+}
+
+bool CConf::getYSFNetworkDebug() const
+{
+	return m_ysfNetworkDebug;
+}
+
+bool CConf::getDMREnabled() const
+{
+	return m_dmrEnabled;
+}
+
+unsigned int CConf::getDMRId() const
+{
+	return m_dmrId;
+}
+
+unsigned int CConf::getDMRDstId() const
+{
+	return m_dmrDstId;
+}
+
+bool CConf::getDMRPC() const
+{
+	return m_dmrPC;
+}
+
+std::string CConf::getDMRNetworkAddress() const
+{
+	return m_dmrNetworkAddress;
+}
+
+unsigned int CConf::getDMRNetworkPort() const
+{
+	return m_dmrNetworkPort;
+}
+
+unsigned int CConf::getDMRNetworkLocal() const
+{
+	return m_dmrNetworkLocal;
+}
+
+std::string CConf::getDMRNetworkPassword() const
+{
+	return m_dmrNetworkPassword;
+}
+
+std::string CConf::getDMRNetworkOptions() const
+{
+	return m_dmrNetworkOptions;
+}
+
+bool CConf::getDMRNetworkDebug() const
+{
+	return m_dmrNetworkDebug;
+}
+
+unsigned int CConf::getDMRNetworkJitter() const
+{
+	return m_dmrNetworkJitter;
+}
+
+bool CConf::getNXDNEnabled() const
+{
+	return m_nxdnEnabled;
+}
+
+unsigned int CConf::getNXDNId() const
+{
+	return m_nxdnId;
+}
+
+unsigned int CConf::getNXDNTG() const
+{
+	return m_nxdnTG;
+}
+
+std::string CConf::getNXDNDstAddress() const
+{
+	return m_nxdnDstAddress;
+}
+
+unsigned int CConf::getNXDNDstPort() const
+{
+	return m_nxdnDstPort;
+}
+
+std::string CConf::getNXDNLocalAddress() const
+{
+	return m_nxdnLocalAddress;
+}
+
+unsigned int CConf::getNXDNLocalPort() const
+{
+	return m_nxdnLocalPort;
+}
+
+bool CConf::getNXDNNetworkDebug() const
+{
+	return m_nxdnNetworkDebug;
+}
+
+bool CConf::getP25Enabled() const
+{
+	return m_p25Enabled;
+}
+
+unsigned int CConf::getP25Id() const
+{
+	return m_p25Id;
+}
+
+unsigned int CConf::getP25TG() const
+{
+	return m_p25TG;
+}
+
+std::string CConf::getP25DstAddress() const
+{
+	return m_p25DstAddress;
+}
+
+unsigned int CConf::getP25DstPort() const
+{
+	return m_p25DstPort;
+}
+
+std::string CConf::getP25LocalAddress() const
+{
+	return m_p25LocalAddress;
+}
+
+unsigned int CConf::getP25LocalPort() const
+{
+	return m_p25LocalPort;
+}
+
+bool CConf::getP25NetworkCoalesce() const
+{
+	return m_p25NetworkCoalesce;
+}
+
+bool CConf::getP25NetworkDebug() const
+{
+	return m_p25NetworkDebug;
+}
+
+std::string CConf::getDMRIdLookupFile() const
+{
+	return m_dmrIdLookupFile;
+}
+
+unsigned int CConf::getDMRIdLookupTime() const
+{
+	return m_dmrIdLookupTime;
+}
+
+std::string CConf::getNXDNIdLookupFile() const
+{
+	return m_nxdnIdLookupFile;
+}
+
+unsigned int CConf::getNXDNIdLookupTime() const
+{
+	return m_nxdnIdLookupTime;
+}
+
+unsigned int CConf::getLogDisplayLevel() const
+{
+	return m_logDisplayLevel;
+}
+
+unsigned int CConf::getLogFileLevel() const
+{
+	return m_logFileLevel;
+}
+
+std::string CConf::getLogFilePath() const
+{
+	return m_logFilePath;
+}
+
+std::string CConf::getLogFileRoot() const
+{
+	return m_logFileRoot;
+}
+
+unsigned int CConf::getCaptureMode() const
+{
+	return m_captureMode;
+}
+
+std::string CConf::getCaptureFile() const
+{
+	return m_captureFile;
+}
+
+std::string CConf::getCaptureOutput() const
+{
+	return m_captureOutput;
+}
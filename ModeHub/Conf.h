@@ -0,0 +1,180 @@
+/*
+ *   Copyright (C) 2019 by Manuel Sanchez EA7EE
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#if !defined(CONF_H)
+#define	CONF_H
+
+#include <string>
+
+class CConf
+{
+public:
+  CConf(const std::string& file);
+  ~CConf();
+
+  bool read();
+
+  // The General section
+  std::string  getCallsign() const;
+  bool         getDaemon() const;
+  std::string  getRoutes() const;
+
+  // The Info section
+  unsigned int getRxFrequency() const;
+  unsigned int getTxFrequency() const;
+  unsigned int getPower() const;
+  float        getLatitude() const;
+  float        getLongitude() const;
+  int          getHeight() const;
+  std::string  getLocation() const;
+  std::string  getDescription() const;
+  std::string  getURL() const;
+
+  // The YSF Network section
+  bool         getYSFEnabled() const;
+  std::string  getYSFDstAddress() const;
+  unsigned int getYSFDstPort() const;
+  std::string  getYSFLocalAddress() const;
+  unsigned int getYSFLocalPort() const;
+  bool         getYSFNetworkDebug() const;
+
+  // The DMR Network section
+  bool         getDMREnabled() const;
+  unsigned int getDMRId() const;
+  unsigned int getDMRDstId() const;
+  bool         getDMRPC() const;
+  std::string  getDMRNetworkAddress() const;
+  unsigned int getDMRNetworkPort() const;
+  unsigned int getDMRNetworkLocal() const;
+  std::string  getDMRNetworkPassword() const;
+  std::string  getDMRNetworkOptions() const;
+  bool         getDMRNetworkDebug() const;
+  unsigned int getDMRNetworkJitter() const;
+
+  // The NXDN Network section
+  bool         getNXDNEnabled() const;
+  unsigned int getNXDNId() const;
+  unsigned int getNXDNTG() const;
+  std::string  getNXDNDstAddress() const;
+  unsigned int getNXDNDstPort() const;
+  std::string  getNXDNLocalAddress() const;
+  unsigned int getNXDNLocalPort() const;
+  bool         getNXDNNetworkDebug() const;
+
+  // The P25 Network section
+  bool         getP25Enabled() const;
+  unsigned int getP25Id() const;
+  unsigned int getP25TG() const;
+  std::string  getP25DstAddress() const;
+  unsigned int getP25DstPort() const;
+  std::string  getP25LocalAddress() const;
+  unsigned int getP25LocalPort() const;
+  bool         getP25NetworkCoalesce() const;
+  bool         getP25NetworkDebug() const;
+
+  // The DMR Id Lookup section
+  std::string  getDMRIdLookupFile() const;
+  unsigned int getDMRIdLookupTime() const;
+
+  // The NXDN Id Lookup section
+  std::string  getNXDNIdLookupFile() const;
+  unsigned int getNXDNIdLookupTime() const;
+
+  // The Log section
+  unsigned int getLogDisplayLevel() const;
+  unsigned int getLogFileLevel() const;
+  std::string  getLogFilePath() const;
+  std::string  getLogFileRoot() const;
+
+  // The Capture section
+  unsigned int getCaptureMode() const;
+  std::string  getCaptureFile() const;
+  std::string  getCaptureOutput() const;
+
+private:
+  std::string  m_file;
+
+  std::string  m_callsign;
+  bool         m_daemon;
+  std::string  m_routes;
+
+  unsigned int m_rxFrequency;
+  unsigned int m_txFrequency;
+  unsigned int m_power;
+  float        m_latitude;
+  float        m_longitude;
+  int          m_height;
+  std::string  m_location;
+  std::string  m_description;
+  std::string  m_url;
+
+  bool         m_ysfEnabled;
+  std::string  m_ysfDstAddress;
+  unsigned int m_ysfDstPort;
+  std::string  m_ysfLocalAddress;
+  unsigned int m_ysfLocalPort;
+  bool         m_ysfNetworkDebug;
+
+  bool         m_dmrEnabled;
+  unsigned int m_dmrId;
+  unsigned int m_dmrDstId;
+  bool         m_dmrPC;
+  std::string  m_dmrNetworkAddress;
+  unsigned int m_dmrNetworkPort;
+  unsigned int m_dmrNetworkLocal;
+  std::string  m_dmrNetworkPassword;
+  std::string  m_dmrNetworkOptions;
+  bool         m_dmrNetworkDebug;
+  unsigned int m_dmrNetworkJitter;
+
+  bool         m_nxdnEnabled;
+  unsigned int m_nxdnId;
+  unsigned int m_nxdnTG;
+  std::string  m_nxdnDstAddress;
+  unsigned int m_nxdnDstPort;
+  std::string  m_nxdnLocalAddress;
+  unsigned int m_nxdnLocalPort;
+  bool         m_nxdnNetworkDebug;
+
+  bool         m_p25Enabled;
+  unsigned int m_p25Id;
+  unsigned int m_p25TG;
+  std::string  m_p25DstAddress;
+  unsigned int m_p25DstPort;
+  std::string  m_p25LocalAddress;
+  unsigned int m_p25LocalPort;
+  bool         m_p25NetworkCoalesce;
+  bool         m_p25NetworkDebug;
+
+  std::string  m_dmrIdLookupFile;
+  unsigned int m_dmrIdLookupTime;
+
+  std::string  m_nxdnIdLookupFile;
+  unsigned int m_nxdnIdLookupTime;
+
+  unsigned int m_logDisplayLevel;
+  unsigned int m_logFileLevel;
+  std::string  m_logFilePath;
+  std::string  m_logFileRoot;
+
+  unsigned int m_captureMode;
+  std::string  m_captureFile;
+  std::string  m_captureOutput;
+};
+
+#endif
@@ -16,28 +16,31 @@
  *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
  */
 
-#ifndef	Hamming_H
-#define	Hamming_H
+#if !defined(DMREMB_H)
+#define DMREMB_H
 
-class CHamming {
+class CDMREMB
+{
 public:
-	static void encode15113_1(bool* d);
-	static bool decode15113_1(bool* d);
+	CDMREMB();
+	~CDMREMB();
 
-	static void encode15113_2(bool* d);
-	static bool decode15113_2(bool* d);
+	void putData(const unsigned char* data);
+	void getData(unsigned char* data) const;
 
-	static void encode1393(bool* d);
-	static bool decode1393(bool* d);
+	unsigned char getColorCode() const;
+	void setColorCode(unsigned char code);
 
-	static void encode1063(bool* d);
-	static bool decode1063(bool* d);
+	bool getPI() const;
+	void setPI(bool pi);
 
-	static void encode16114(bool* d);
-	static bool decode16114(bool* d);
+	unsigned char getLCSS() const;
+	void setLCSS(unsigned char lcss);
 
-	static void encode17123(bool* d);
-	static bool decode17123(bool* d);
+private:
+	unsigned char m_colorCode;
+	bool          m_PI;
+	unsigned char m_LCSS;
 };
 
 #endif
@@ -0,0 +1,316 @@
+/*
+ *   Copyright (C) 2015,2016,2017 by Jonathan Naylor G4KLX
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "DMREmbeddedData.h"
+
+#include "Hamming.h"
+#include "Utils.h"
+#include "CRC.h"
+
+#include <cstdio>
+#include <cassert>
+#include <cstring>
+#include <cstdint>
+
+// The 128 bits are sent downwards in columns of the 8 x 16 bit matrix, so
+// each byte of the four fragments is one column, and turning the columns
+// into rows, and back, is two 8 x 8 bit transposes.
+static uint64_t transpose8(uint64_t x)
+{
+	uint64_t t;
+
+	t = (x ^ (x >> 7))  & 0x00AA00AA00AA00AAULL;
+	x = x ^ t ^ (t << 7);
+
+	t = (x ^ (x >> 14)) & 0x0000CCCC0000CCCCULL;
+	x = x ^ t ^ (t << 14);
+
+	t = (x ^ (x >> 28)) & 0x00000000F0F0F0F0ULL;
+	x = x ^ t ^ (t << 28);
+
+	return x;
+}
+
+static void columnsToRows(const unsigned int* columns, unsigned int* rows)
+{
+	uint64_t left  = transpose8((uint64_t(columns[0U]) << 32) | columns[1U]);
+	uint64_t right = transpose8((uint64_t(columns[2U]) << 32) | columns[3U]);
+
+	for (unsigned int i = 0U; i < 8U; i++) {
+		unsigned int shift = 56U - i * 8U;
+		rows[i] = (((left >> shift) & 0xFFU) << 8) | ((right >> shift) & 0xFFU);
+	}
+}
+
+static void rowsToColumns(const unsigned int* rows, unsigned int* columns)
+{
+	uint64_t left  = 0U;
+	uint64_t right = 0U;
+
+	for (unsigned int i = 0U; i < 8U; i++) {
+		left  = (left << 8)  | ((rows[i] >> 8) & 0xFFU);
+		right = (right << 8) | ((rows[i] >> 0) & 0xFFU);
+	}
+
+	left  = transpose8(left);
+	right = transpose8(right);
+
+	columns[0U] = (unsigned int)(left >> 32);
+	columns[1U] = (unsigned int)(left & 0xFFFFFFFFU);
+	columns[2U] = (unsigned int)(right >> 32);
+	columns[3U] = (unsigned int)(right & 0xFFFFFFFFU);
+}
+
+CDMREmbeddedData::CDMREmbeddedData() :
+m_state(LCS_NONE),
+m_FLCO(FLCO_GROUP),
+m_valid(false)
+{
+	::memset(m_raw, 0x00U, sizeof(m_raw));
+	::memset(m_data, 0x00U, sizeof(m_data));
+}
+
+CDMREmbeddedData::~CDMREmbeddedData()
+{
+}
+
+// Add LC data (which may consist of 4 blocks) to the data store
+bool CDMREmbeddedData::addData(const unsigned char* data, unsigned char lcss)
+{
+	assert(data != NULL);
+
+	// The 32 bits of embedded signalling between the two halves of the EMB
+	unsigned int fragment = ((data[14U] & 0x0FU) << 28) | (data[15U] << 20) | (data[16U] << 12) | (data[17U] << 4) | ((data[18U] >> 4) & 0x0FU);
+
+	// Is this the first block of a 4 block embedded LC ?
+	if (lcss == 1U) {
+		m_raw[0U] = fragment;
+
+		// Show we are ready for the next LC block
+		m_state = LCS_FIRST;
+		m_valid = false;
+
+		return false;
+	}
+
+	// Is this the 2nd block of a 4 block embedded LC ?
+	if (lcss == 3U && m_state == LCS_FIRST) {
+		m_raw[1U] = fragment;
+
+		// Show we are ready for the next LC block
+		m_state = LCS_SECOND;
+
+		return false;
+	}
+
+	// Is this the 3rd block of a 4 block embedded LC ?
+	if (lcss == 3U && m_state == LCS_SECOND) {
+		m_raw[2U] = fragment;
+
+		// Show we are ready for the final LC block
+		m_state = LCS_THIRD;
+
+		return false;
+	}
+
+	// Is this the final block of a 4 block embedded LC ?
+	if (lcss == 2U && m_state == LCS_THIRD)	{
+		m_raw[3U] = fragment;
+
+		// Show that we're not ready for any more data
+		m_state = LCS_NONE;
+
+		// Process the complete data block
+		decodeEmbeddedData();
+		if (m_valid)
+			encodeEmbeddedData();
+
+		return m_valid;
+	}
+
+	return false;
+}
+
+void CDMREmbeddedData::setLC(const CDMRLC& lc)
+{
+	lc.getData(m_data);
+
+	m_FLCO  = lc.getFLCO();
+	m_valid = true;
+
+	encodeEmbeddedData();
+}
+
+void CDMREmbeddedData::encodeEmbeddedData()
+{
+	unsigned int crc;
+	CCRC::encodeFiveBit(m_data, crc);
+
+	// Rows of 11 data bits, the last five rows carry one bit of the CRC in
+	// place of the last data bit. Hamming (16,11,4) each row except the last
+	// one, which holds the parity bits for each column.
+	unsigned int rows[8U];
+	rows[7U] = 0U;
+
+	unsigned int acc  = 0U;
+	unsigned int bits = 0U;
+	unsigned int pos  = 0U;
+	for (unsigned int a = 0U; a < 7U; a++) {
+		unsigned int count = (a < 2U) ? 11U : 10U;
+
+		while (bits < count) {
+			acc = (acc << 8) | m_data[pos++];
+			bits += 8U;
+		}
+
+		bits -= count;
+		unsigned int value = (acc >> bits) & ((1U << count) - 1U);
+
+		if (a >= 2U)
+			value = (value << 1) | ((crc >> (6U - a)) & 0x01U);
+
+		rows[a] = CHamming::encode16114(value);
+		rows[7U] ^= rows[a];
+	}
+
+	// The data is packed downwards in columns
+	rowsToColumns(rows, m_raw);
+}
+
+unsigned char CDMREmbeddedData::getData(unsigned char* data, unsigned char n) const
+{
+	assert(data != NULL);
+
+	if (n >= 1U && n < 5U) {
+		n--;
+
+		unsigned int fragment = m_raw[n];
+
+		data[14U] = (data[14U] & 0xF0U) | ((fragment >> 28) & 0x0FU);
+		data[15U] = fragment >> 20;
+		data[16U] = fragment >> 12;
+		data[17U] = fragment >> 4;
+		data[18U] = (data[18U] & 0x0FU) | ((fragment << 4) & 0xF0U);
+
+		switch (n) {
+		case 0U:
+			return 1U;
+		case 3U:
+			return 2U;
+		default:
+			return 3U;
+		}
+	} else {
+		data[14U] &= 0xF0U;
+		data[15U]  = 0x00U;
+		data[16U]  = 0x00U;
+		data[17U]  = 0x00U;
+		data[18U] &= 0x0FU;
+
+		return 0U;
+	}
+}
+
+// Unpack and error check an embedded LC
+void CDMREmbeddedData::decodeEmbeddedData()
+{
+	// The data is unpacked downwards in columns into 16 bit rows
+	unsigned int rows[8U];
+	columnsToRows(m_raw, rows);
+
+	// Hamming (16,11,4) check each row except the last one
+	for (unsigned int a = 0U; a < 7U; a++) {
+		if (!CHamming::decode16114(rows[a]))
+			return;
+	}
+
+	// Check the parity bits
+	if ((rows[0U] ^ rows[1U] ^ rows[2U] ^ rows[3U] ^ rows[4U] ^ rows[5U] ^ rows[6U] ^ rows[7U]) != 0U)
+		return;
+
+	// We have passed the Hamming check so extract the actual payload and
+	// the 5 bit CRC, which is the last data bit of the last five rows
+	unsigned int crc  = 0U;
+	unsigned int acc  = 0U;
+	unsigned int bits = 0U;
+	unsigned int pos  = 0U;
+	for (unsigned int a = 0U; a < 7U; a++) {
+		unsigned int count = (a < 2U) ? 11U : 10U;
+
+		acc = (acc << count) | (rows[a] >> (16U - count));
+		bits += count;
+
+		while (bits >= 8U) {
+			bits -= 8U;
+			m_data[pos++] = acc >> bits;
+		}
+
+		if (a >= 2U)
+			crc = (crc << 1) | ((rows[a] >> 5) & 0x01U);
+	}
+
+	// Now CRC check this
+	if (!CCRC::checkFiveBit(m_data, crc))
+		return;
+
+	m_valid = true;
+
+	// Extract the FLCO
+	m_FLCO = FLCO(m_data[0U] & 0x3FU);
+}
+
+bool CDMREmbeddedData::getLC(CDMRLC& lc) const
+{
+	if (!m_valid)
+		return false;
+
+	if (m_FLCO != FLCO_GROUP && m_FLCO != FLCO_USER_USER)
+		return false;
+
+	lc = CDMRLC(m_data);
+
+	return true;
+}
+
+bool CDMREmbeddedData::isValid() const
+{
+	return m_valid;
+}
+
+FLCO CDMREmbeddedData::getFLCO() const
+{
+	return m_FLCO;
+}
+
+void CDMREmbeddedData::reset()
+{
+	m_state = LCS_NONE;
+	m_valid = false;
+}
+
+bool CDMREmbeddedData::getRawData(unsigned char* data) const
+{
+	assert(data != NULL);
+
+	if (!m_valid)
+		return false;
+
+	::memcpy(data, m_data, 9U);
+
+	return true;
+}
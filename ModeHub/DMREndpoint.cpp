@@ -0,0 +1,291 @@
+/*
+ *   Copyright (C) 2019 by Manuel Sanchez EA7EE
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "DMREndpoint.h"
+#include "AMBEFrame.h"
+#include "DMRData.h"
+#include "Defines.h"
+#include "Sync.h"
+#include "Log.h"
+
+#include <cstdio>
+#include <cassert>
+#include <cstring>
+
+const unsigned int DMR_FRAME_PER = 55U;
+
+const unsigned int DMR_SLOT = 2U;
+
+const unsigned int DMR_LC_CACHE_SIZE = 16U;
+
+// The frames of one voice burst
+const unsigned int DMR_BURST_FRAMES = 3U;
+
+CDMREndpoint::CDMREndpoint(CDMRNetwork* network, CDMRLookup* lookup, unsigned int defaultId, unsigned int dstId, bool pc) :
+CEndpoint(MODE_DMR, "DMR", DMR_BURST_FRAMES),
+m_network(network),
+m_lookup(lookup),
+m_defaultId(defaultId),
+m_dstId(dstId),
+m_flco(pc ? FLCO_USER_USER : FLCO_GROUP),
+m_colorCode(1U),
+m_lcCache(DMR_LC_CACHE_SIZE),
+m_lc(),
+m_watchdog(1000U, 0U, 1500U),
+m_txWatch(),
+m_rxActive(false),
+m_rxSync(false),
+m_rxLastDT(0U),
+m_rxFrames(0U),
+m_txSrcId(0U),
+m_txSeqNo(0U),
+m_txN(0U)
+{
+	assert(network != NULL);
+	assert(lookup != NULL);
+}
+
+CDMREndpoint::~CDMREndpoint()
+{
+	delete m_network;
+}
+
+bool CDMREndpoint::open()
+{
+	bool ret = m_network->open();
+	if (!ret)
+		return false;
+
+	m_network->enable(true);
+
+	m_txWatch.start();
+
+	return true;
+}
+
+void CDMREndpoint::close()
+{
+	m_network->close();
+}
+
+bool CDMREndpoint::hasCodec(HUB_CODEC codec) const
+{
+	return codec == HC_AMBE;
+}
+
+int CDMREndpoint::getFd() const
+{
+	return m_network->getFd();
+}
+
+void CDMREndpoint::clock(unsigned int ms)
+{
+	m_network->clock(ms);
+
+	readNetwork(ms);
+
+	if (m_txWatch.elapsed() > DMR_FRAME_PER)
+		writeNetwork();
+}
+
+void CDMREndpoint::readNetwork(unsigned int ms)
+{
+	CDMRData data;
+
+	while (m_network->read(data)) {
+		unsigned int srcId = data.getSrcId();
+		unsigned int dstId = data.getDstId();
+		FLCO flco = data.getFLCO();
+		unsigned char dataType = data.getDataType();
+
+		if (!data.isMissing()) {
+			m_watchdog.start();
+
+			if (dataType == DT_TERMINATOR_WITH_LC) {
+				if (m_rxActive) {
+					LogMessage("DMR, received end of voice transmission, %.1f seconds", float(m_rxFrames) / 16.667F);
+					putEOT();
+				}
+
+				endCall();
+			} else if (dataType == DT_VOICE_LC_HEADER && dataType != m_rxLastDT) {
+				startCall(srcId, dstId, flco, false);
+			}
+
+			if (dataType == DT_VOICE_SYNC)
+				m_rxSync = true;
+
+			if ((dataType == DT_VOICE_SYNC || dataType == DT_VOICE) && m_rxSync) {
+				if (!m_rxActive)
+					startCall(srcId, dstId, flco, true);
+
+				unsigned char burst[DMR_FRAME_LENGTH_BYTES];
+				data.getData(burst);
+
+				for (unsigned int i = 0U; i < DMR_BURST_FRAMES; i++)
+					putAMBE(CAMBEFrame::decodeDMR(burst, i));
+
+				m_rxFrames++;
+			}
+		} else if ((dataType == DT_VOICE_SYNC || dataType == DT_VOICE) && m_rxActive) {
+			// The jitter buffer gives a missing burst as silence
+			unsigned char burst[DMR_FRAME_LENGTH_BYTES];
+			data.getData(burst);
+
+			for (unsigned int i = 0U; i < DMR_BURST_FRAMES; i++)
+				putAMBE(CAMBEFrame::decodeDMR(burst, i));
+
+			m_rxFrames++;
+		}
+
+		m_rxLastDT = dataType;
+	}
+
+	m_watchdog.clock(ms);
+	if (m_watchdog.isRunning() && m_watchdog.hasExpired()) {
+		if (m_rxActive) {
+			LogMessage("DMR, network watchdog has expired, %.1f seconds", float(m_rxFrames) / 16.667F);
+			putEOT();
+		}
+
+		endCall();
+	}
+}
+
+void CDMREndpoint::startCall(unsigned int srcId, unsigned int dstId, FLCO flco, bool late)
+{
+	CHubCall call;
+	call.m_codec  = HC_AMBE;
+	call.m_mode   = MODE_DMR;
+	call.m_source = m_lookup->findCS(srcId);
+	call.m_srcId  = srcId;
+	call.m_dstId  = dstId;
+
+	LogMessage("DMR, %s from %s to %s%u", late ? "late entry" : "received header", call.m_source.c_str(), flco == FLCO_GROUP ? "TG " : "", dstId);
+
+	putHeader(call);
+
+	m_rxActive = true;
+	m_rxFrames = 0U;
+	m_rxSync   = late;
+}
+
+void CDMREndpoint::endCall()
+{
+	m_network->reset(DMR_SLOT);
+	m_watchdog.stop();
+
+	m_rxActive = false;
+	m_rxSync   = false;
+	m_rxFrames = 0U;
+}
+
+void CDMREndpoint::writeNetwork()
+{
+	CHubFrame frames[DMR_BURST_FRAMES];
+	unsigned char burst[DMR_FRAME_LENGTH_BYTES];
+
+	unsigned int tag = getTx(frames);
+
+	if (tag == TAG_HEADER) {
+		m_txSrcId = findId(m_txCall);
+		m_txSeqNo = 0U;
+		m_txN     = 0U;
+
+		// Sync, SlotType and Full LC, encoded once per LC
+		m_lc = m_lcCache.get(m_colorCode, m_flco, m_txSrcId, m_dstId);
+		m_lc.getHeader(burst);
+
+		for (unsigned int i = 0U; i < 3U; i++)
+			writeBurst(DT_VOICE_LC_HEADER, 0U, burst);
+
+		m_txWatch.start();
+	} else if (tag == TAG_EOT) {
+		// Fill the superframe with silence
+		while (m_txN != 0U) {
+			::memcpy(burst, DMR_SILENCE_DATA, DMR_FRAME_LENGTH_BYTES);
+			m_lc.getEmbedded(burst, m_txN);
+
+			writeBurst(DT_VOICE, m_txN, burst);
+
+			m_txN = (m_txN + 1U) % 6U;
+		}
+
+		m_lcCache.get(m_colorCode, m_flco, m_txSrcId, m_dstId).getTerminator(burst);
+
+		writeBurst(DT_TERMINATOR_WITH_LC, 0U, burst);
+
+		m_txWatch.start();
+	} else if (tag == TAG_DATA) {
+		for (unsigned int i = 0U; i < DMR_BURST_FRAMES; i++)
+			CAMBEFrame::encodeDMR(frames[i].m_ambe, burst, i);
+
+		if (m_txN == 0U) {
+			CSync::addDMRAudioSync(burst, false);
+
+			// Pick up the Embedded LC for this superframe
+			m_lc = m_lcCache.get(m_colorCode, m_flco, m_txSrcId, m_dstId);
+
+			writeBurst(DT_VOICE_SYNC, 0U, burst);
+		} else {
+			// Add the Embedded LC and EMB
+			m_lc.getEmbedded(burst, m_txN);
+
+			writeBurst(DT_VOICE, m_txN, burst);
+		}
+
+		m_txN = (m_txN + 1U) % 6U;
+		m_txWatch.start();
+	}
+}
+
+void CDMREndpoint::writeBurst(unsigned char dataType, unsigned int n, const unsigned char* data)
+{
+	assert(data != NULL);
+
+	CDMRData dmrData;
+	dmrData.setSlotNo(DMR_SLOT);
+	dmrData.setSrcId(m_txSrcId);
+	dmrData.setDstId(m_dstId);
+	dmrData.setFLCO(m_flco);
+	dmrData.setN(n);
+	dmrData.setSeqNo(m_txSeqNo);
+	dmrData.setBER(0U);
+	dmrData.setRSSI(0U);
+	dmrData.setDataType(dataType);
+	dmrData.setData(data);
+
+	m_network->write(dmrData);
+
+	m_txSeqNo++;
+}
+
+unsigned int CDMREndpoint::findId(const CHubCall& call) const
+{
+	// P25 shares the DMR id space
+	if ((call.m_mode == MODE_DMR || call.m_mode == MODE_P25) && call.m_srcId != 0U)
+		return call.m_srcId;
+
+	unsigned int id = m_lookup->findID(call.m_source);
+	if (id == 0U) {
+		LogMessage("DMR, no id found for %s, using the default %u", call.m_source.c_str(), m_defaultId);
+		return m_defaultId;
+	}
+
+	return id;
+}
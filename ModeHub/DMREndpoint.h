@@ -0,0 +1,71 @@
+/*
+ *   Copyright (C) 2019 by Manuel Sanchez EA7EE
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#ifndef DMREndpoint_H
+#define DMREndpoint_H
+
+#include "Endpoint.h"
+#include "DMRLCCache.h"
+#include "DMRNetwork.h"
+#include "DMRLookup.h"
+#include "StopWatch.h"
+#include "Timer.h"
+
+// A Homebrew DMR master, or a DMRGateway, on slot 2
+class CDMREndpoint : public CEndpoint {
+public:
+	CDMREndpoint(CDMRNetwork* network, CDMRLookup* lookup, unsigned int defaultId, unsigned int dstId, bool pc);
+	virtual ~CDMREndpoint();
+
+	virtual bool open();
+	virtual void close();
+
+	virtual bool hasCodec(HUB_CODEC codec) const;
+
+	virtual int getFd() const;
+
+	virtual void clock(unsigned int ms);
+
+private:
+	CDMRNetwork*  m_network;
+	CDMRLookup*   m_lookup;
+	unsigned int  m_defaultId;
+	unsigned int  m_dstId;
+	FLCO          m_flco;
+	unsigned char m_colorCode;
+	CDMRLCCache   m_lcCache;
+	CDMRLCBursts  m_lc;
+	CTimer        m_watchdog;
+	CStopWatch    m_txWatch;
+	bool          m_rxActive;
+	bool          m_rxSync;
+	unsigned char m_rxLastDT;
+	unsigned int  m_rxFrames;
+	unsigned int  m_txSrcId;
+	unsigned int  m_txSeqNo;
+	unsigned int  m_txN;
+
+	void readNetwork(unsigned int ms);
+	void writeNetwork();
+	void writeBurst(unsigned char dataType, unsigned int n, const unsigned char* data);
+	void startCall(unsigned int srcId, unsigned int dstId, FLCO flco, bool late);
+	void endCall();
+	unsigned int findId(const CHubCall& call) const;
+};
+
+#endif
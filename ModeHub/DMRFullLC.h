@@ -0,0 +1,42 @@
+/*
+ *   Copyright (C) 2015,2016 by Jonathan Naylor G4KLX
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#ifndef DMRFullLC_H
+#define DMRFullLC_H
+
+#include "DMRLC.h"
+#include "DMRSlotType.h"
+
+#include "BPTC19696.h"
+
+class CDMRFullLC
+{
+public:
+	CDMRFullLC();
+	~CDMRFullLC();
+
+	CDMRLC* decode(const unsigned char* data, unsigned char type);
+
+	void encode(const CDMRLC& lc, unsigned char* data, unsigned char type);
+
+private:
+	CBPTC19696 m_bptc;
+};
+
+#endif
+
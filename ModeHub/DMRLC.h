@@ -1,6 +1,5 @@
 /*
  *   Copyright (C) 2015,2016 by Jonathan Naylor G4KLX
- *   Copyright (C) 2018 by Andy Uribe CA6JAU
  *
  *   This program is free software; you can redistribute it and/or modify
  *   it under the terms of the GNU General Public License as published by
@@ -17,24 +16,47 @@
  *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
  */
 
-#if !defined(CRC_H)
-#define	CRC_H
+#if !defined(DMRLC_H)
+#define DMRLC_H
 
-class CCRC
+#include "DMRDefines.h"
+
+class CDMRLC
 {
 public:
-	static bool checkFiveBit(bool* in, unsigned int tcrc);
-	static void encodeFiveBit(const bool* in, unsigned int& tcrc);
+	CDMRLC(FLCO flco, unsigned int srcId, unsigned int dstId);
+	CDMRLC(const unsigned char* bytes);
+	CDMRLC(const bool* bits);
+	CDMRLC();
+	~CDMRLC();
+
+	void getData(unsigned char* bytes) const;
+	void getData(bool* bits) const;
+
+	bool getPF() const;
+	void setPF(bool pf);
 
-	static void addCCITT161(unsigned char* in, unsigned int length);
-	static void addCCITT162(unsigned char* in, unsigned int length);
+	FLCO getFLCO() const;
+	void setFLCO(FLCO flco);
 
-	static bool checkCCITT161(const unsigned char* in, unsigned int length);
-	static bool checkCCITT162(const unsigned char* in, unsigned int length);
+	unsigned char getFID() const;
+	void setFID(unsigned char fid);
 
-	static unsigned char crc8(const unsigned char* in, unsigned int length);
+	unsigned int getSrcId() const;
+	void setSrcId(unsigned int id);
 
-	static unsigned char addCRC(const unsigned char* in, unsigned int length);
+	unsigned int getDstId() const;
+	void setDstId(unsigned int id);
+
+private:
+	bool          m_PF;
+	bool          m_R;
+	FLCO          m_FLCO;
+	unsigned char m_FID;
+	unsigned char m_options;
+	unsigned int  m_srcId;
+	unsigned int  m_dstId;
 };
 
 #endif
+
@@ -0,0 +1,73 @@
+/*
+ *   Copyright (C) 2019 by Manuel Sanchez EA7EE
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#ifndef DMRLCCache_H
+#define DMRLCCache_H
+
+#include "DMRDefines.h"
+
+#include <list>
+
+// The fully encoded bursts that only depend on the link control of a
+// call: the voice header and terminator with their sync and slot type,
+// and the embedded LC with its EMB for voice frames B to F.
+class CDMRLCBursts {
+public:
+	CDMRLCBursts();
+	~CDMRLCBursts();
+
+	void encode(unsigned char colorCode, FLCO flco, unsigned int srcId, unsigned int dstId);
+
+	bool isFor(unsigned char colorCode, FLCO flco, unsigned int srcId, unsigned int dstId) const;
+
+	void getHeader(unsigned char* data) const;
+	void getTerminator(unsigned char* data) const;
+
+	// Write the embedded signalling and EMB of voice frame n, 1 to 5
+	void getEmbedded(unsigned char* data, unsigned int n) const;
+
+private:
+	unsigned char m_colorCode;
+	FLCO          m_flco;
+	unsigned int  m_srcId;
+	unsigned int  m_dstId;
+	unsigned char m_header[DMR_FRAME_LENGTH_BYTES];
+	unsigned char m_terminator[DMR_FRAME_LENGTH_BYTES];
+	unsigned char m_embedded[5U][7U];
+};
+
+// Small LRU of encoded bursts, so that repeated calls from the same
+// source to the same destination need no BPTC, RS or Hamming work.
+class CDMRLCCache {
+public:
+	CDMRLCCache(unsigned int size);
+	~CDMRLCCache();
+
+	const CDMRLCBursts& get(unsigned char colorCode, FLCO flco, unsigned int srcId, unsigned int dstId);
+
+	unsigned int getHits() const;
+	unsigned int getMisses() const;
+
+private:
+	unsigned int            m_size;
+	std::list<CDMRLCBursts> m_entries;
+	unsigned int            m_hits;
+	unsigned int            m_misses;
+};
+
+#endif
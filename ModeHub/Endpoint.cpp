@@ -0,0 +1,179 @@
+/*
+ *   Copyright (C) 2019 by Manuel Sanchez EA7EE
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "Endpoint.h"
+#include "AMBEFrame.h"
+#include "Defines.h"
+
+#include <cstdio>
+#include <cassert>
+#include <cstring>
+
+CEndpoint::CEndpoint(unsigned char mode, const char* name, unsigned int frames) :
+m_mode(mode),
+m_name(name),
+m_frames(frames),
+m_rxCall(),
+m_txCall(),
+m_rx(500U, "Endpoint RX"),
+m_tx(500U, "Endpoint TX"),
+m_txN(0U)
+{
+	assert(name != NULL);
+	assert(frames > 0U);
+
+	m_rxCall.m_codec = HC_AMBE;
+	m_rxCall.m_mode  = mode;
+	m_rxCall.m_srcId = 0U;
+	m_rxCall.m_dstId = 0U;
+
+	m_txCall = m_rxCall;
+}
+
+CEndpoint::~CEndpoint()
+{
+}
+
+unsigned char CEndpoint::getMode() const
+{
+	return m_mode;
+}
+
+const char* CEndpoint::getName() const
+{
+	return m_name;
+}
+
+bool CEndpoint::read(CHubFrame& frame)
+{
+	if (m_rx.isEmpty())
+		return false;
+
+	m_rx.getData(&frame, 1U);
+
+	return true;
+}
+
+const CHubCall& CEndpoint::getCall() const
+{
+	return m_rxCall;
+}
+
+void CEndpoint::writeHeader(const CHubCall& call)
+{
+	m_txCall = call;
+
+	CHubFrame frame;
+	::memset(&frame, 0x00U, sizeof(CHubFrame));
+	frame.m_tag = TAG_HEADER;
+
+	m_tx.addData(&frame, 1U);
+	m_txN = 0U;
+}
+
+void CEndpoint::writeData(const CHubFrame& frame)
+{
+	m_tx.addData(&frame, 1U);
+	m_txN++;
+}
+
+void CEndpoint::writeEOT()
+{
+	CHubFrame frame;
+	::memset(&frame, 0x00U, sizeof(CHubFrame));
+
+	// Pad the last network frame with silence
+	frame.m_tag  = TAG_DATA;
+	frame.m_ambe = CAMBEFrame::SILENCE;
+	::memcpy(frame.m_imbe, CIMBEFrame::SILENCE, IMBE_FRAME_LENGTH);
+
+	while ((m_txN % m_frames) != 0U) {
+		m_tx.addData(&frame, 1U);
+		m_txN++;
+	}
+
+	frame.m_tag = TAG_EOT;
+	m_tx.addData(&frame, 1U);
+}
+
+void CEndpoint::putHeader(const CHubCall& call)
+{
+	m_rxCall = call;
+	m_rxCall.m_mode = m_mode;
+
+	CHubFrame frame;
+	::memset(&frame, 0x00U, sizeof(CHubFrame));
+	frame.m_tag = TAG_HEADER;
+
+	m_rx.addData(&frame, 1U);
+}
+
+void CEndpoint::putAMBE(uint64_t ambe)
+{
+	CHubFrame frame;
+	::memset(&frame, 0x00U, sizeof(CHubFrame));
+	frame.m_tag  = TAG_DATA;
+	frame.m_ambe = ambe;
+
+	m_rx.addData(&frame, 1U);
+}
+
+void CEndpoint::putIMBE(const unsigned char* imbe)
+{
+	assert(imbe != NULL);
+
+	CHubFrame frame;
+	::memset(&frame, 0x00U, sizeof(CHubFrame));
+	frame.m_tag = TAG_DATA;
+	::memcpy(frame.m_imbe, imbe, IMBE_FRAME_LENGTH);
+
+	m_rx.addData(&frame, 1U);
+}
+
+void CEndpoint::putEOT()
+{
+	CHubFrame frame;
+	::memset(&frame, 0x00U, sizeof(CHubFrame));
+	frame.m_tag = TAG_EOT;
+
+	m_rx.addData(&frame, 1U);
+}
+
+unsigned int CEndpoint::getTx(CHubFrame* frames)
+{
+	assert(frames != NULL);
+
+	if (m_tx.isEmpty())
+		return TAG_NODATA;
+
+	m_tx.peek(frames, 1U);
+
+	if (frames[0U].m_tag != TAG_DATA) {
+		m_tx.getData(frames, 1U);
+		return frames[0U].m_tag;
+	}
+
+	// A stream is always padded to whole network frames before its
+	// terminator, so only the frames still to come can be missing.
+	if (m_tx.dataSize() < m_frames)
+		return TAG_NODATA;
+
+	m_tx.getData(frames, m_frames);
+
+	return TAG_DATA;
+}
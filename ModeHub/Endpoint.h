@@ -0,0 +1,80 @@
+/*
+ *   Copyright (C) 2019 by Manuel Sanchez EA7EE
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#ifndef Endpoint_H
+#define Endpoint_H
+
+#include "HubFrame.h"
+#include "RingBuffer.h"
+
+// One network the hub is connected to. Each mode turns what it receives
+// into a stream of canonical frames for the hub to route, and packs what
+// the hub routes to it back into its own network frames, paced at the
+// rate of its mode.
+class CEndpoint {
+public:
+	CEndpoint(unsigned char mode, const char* name, unsigned int frames);
+	virtual ~CEndpoint();
+
+	unsigned char getMode() const;
+	const char*   getName() const;
+
+	virtual bool open() = 0;
+	virtual void close() = 0;
+
+	virtual bool hasCodec(HUB_CODEC codec) const = 0;
+
+	// The socket the hub waits on for incoming data
+	virtual int getFd() const = 0;
+
+	// Read the network and send whatever is due
+	virtual void clock(unsigned int ms) = 0;
+
+	// The next entry of the stream being received. When it is a header
+	// the call it starts is in getCall().
+	bool read(CHubFrame& frame);
+	const CHubCall& getCall() const;
+
+	// Queue a stream from another endpoint for sending
+	void writeHeader(const CHubCall& call);
+	void writeData(const CHubFrame& frame);
+	void writeEOT();
+
+protected:
+	unsigned char          m_mode;
+	const char*            m_name;
+	unsigned int           m_frames;
+	CHubCall               m_rxCall;
+	CHubCall               m_txCall;
+
+	void putHeader(const CHubCall& call);
+	void putAMBE(uint64_t ambe);
+	void putIMBE(const unsigned char* imbe);
+	void putEOT();
+
+	// The next thing to send: TAG_HEADER, TAG_EOT, TAG_DATA with as many
+	// voice frames as one network frame holds, or TAG_NODATA.
+	unsigned int getTx(CHubFrame* frames);
+
+private:
+	CRingBuffer<CHubFrame> m_rx;
+	CRingBuffer<CHubFrame> m_tx;
+	unsigned int           m_txN;
+};
+
+#endif
@@ -0,0 +1,375 @@
+/*
+ *   Copyright (C) 2019 by Manuel Sanchez EA7EE
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+// Times YSF V/D mode 2 calls on their way out as NXDN. It stands in for
+// both the YSF reflector and the NXDN gateway, numbers every AMBE frame it
+// sends in the low bits of c and finds the numbers again in the NXDN voice,
+// so the same figures come out of ModeHub and of YSF2DMR chained to
+// DMR2NXDN, whatever either of them drops or pads.
+
+#include "YSFDefines.h"
+#include "YSFPayload.h"
+#include "AMBEFrame.h"
+#include "UDPSocket.h"
+#include "YSFFICH.h"
+#include "Clock.h"
+#include "Sync.h"
+#include "Log.h"
+
+#if !defined(_WIN32) && !defined(_WIN64)
+#include <sys/select.h>
+#include <signal.h>
+#endif
+
+#include <cassert>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+const unsigned int YSFD_LENGTH   = 155U;
+const unsigned int NXDN_LENGTH   = 102U;
+const unsigned int BUFFER_LENGTH = 200U;
+
+// In microseconds, as CClock counts
+const unsigned long long FRAME_PERIOD = 100000ULL;
+
+const unsigned int AMBE_PER_YSF  = 5U;
+const unsigned int AMBE_PER_NXDN = 4U;
+
+// The number goes in the low 12 bits of c, 0 is left for the padding
+const unsigned int TAG_MASK      = 0xFFFU;
+const unsigned int MAX_FRAMES    = TAG_MASK / AMBE_PER_YSF;
+
+static bool end = false;
+
+#if !defined(_WIN32) && !defined(_WIN64)
+static void sig_handler(int signum)
+{
+	end = true;
+}
+#endif
+
+struct CCallStats {
+	CCallStats(unsigned int frames) :
+	m_sent(frames * AMBE_PER_YSF + 1U, 0ULL),
+	m_received(frames * AMBE_PER_YSF + 1U, false),
+	m_firstSent(0ULL),
+	m_firstReceived(0ULL),
+	m_frames(0U),
+	m_latencyTotal(0ULL),
+	m_latencyMax(0ULL)
+	{
+	}
+
+	std::vector<unsigned long long> m_sent;
+	std::vector<bool>               m_received;
+	unsigned long long              m_firstSent;
+	unsigned long long              m_firstReceived;
+	unsigned int                    m_frames;
+	unsigned long long              m_latencyTotal;
+	unsigned long long              m_latencyMax;
+};
+
+static void usage()
+{
+	::fprintf(stderr, "Usage: HubBench [-y ysf port] [-n nxdn port] [-c calls] [-l call length secs] [-g gap secs] [-w wait secs]\n");
+}
+
+static void buildFrame(unsigned char* data, unsigned int frame, unsigned int frames)
+{
+	assert(data != NULL);
+
+	bool first = frame == 0U;
+	bool last  = frame == (frames + 1U);
+
+	::memset(data, 0x00U, YSFD_LENGTH);
+
+	::memcpy(data + 0U,  "YSFD", 4U);
+	::memcpy(data + 4U,  "HUBBENCH  ", YSF_CALLSIGN_LENGTH);
+	::memcpy(data + 14U, "BENCH     ", YSF_CALLSIGN_LENGTH);
+	::memcpy(data + 24U, "ALL       ", YSF_CALLSIGN_LENGTH);
+	data[34U] = ((frame & 0x7FU) << 1) | (last ? 0x01U : 0x00U);
+
+	unsigned char* p = data + 35U;
+
+	CSync::addYSFSync(p);
+
+	CYSFFICH fich;
+	fich.setCS(2U);
+	fich.setFN(0U);
+	fich.setFT(7U);
+	fich.setBN(0U);
+	fich.setBT(0U);
+	fich.setDev(false);
+	fich.setSQL(false);
+	fich.setSQ(0U);
+	fich.setVoIP(true);
+	fich.setMR(YSF_MR_BUSY);
+	fich.setDT(YSF_DT_VD_MODE2);
+
+	CYSFPayload payload;
+
+	if (first || last) {
+		fich.setFI(first ? YSF_FI_HEADER : YSF_FI_TERMINATOR);
+
+		unsigned char csd1[20U], csd2[20U];
+		::memset(csd1, '*', YSF_CALLSIGN_LENGTH);
+		::memcpy(csd1 + YSF_CALLSIGN_LENGTH, "BENCH     ", YSF_CALLSIGN_LENGTH);
+		::memset(csd2, ' ', YSF_CALLSIGN_LENGTH + YSF_CALLSIGN_LENGTH);
+
+		payload.writeHeader(p, csd1, csd2);
+	} else {
+		unsigned int fn = (frame - 1U) % 8U;
+		fich.setFI(YSF_FI_COMMUNICATIONS);
+		fich.setFN(fn);
+
+		unsigned char* vch = p + YSF_SYNC_LENGTH_BYTES + YSF_FICH_LENGTH_BYTES;
+		for (unsigned int i = 0U; i < AMBE_PER_YSF; i++) {
+			unsigned int tag = (frame - 1U) * AMBE_PER_YSF + i + 1U;
+			CAMBEFrame::encodeYSF(CAMBEFrame::SILENCE ^ tag, vch + 5U + i * 18U);
+		}
+
+		if (fn == 1U)
+			payload.writeVDMode2Data(p, (const unsigned char*)"BENCH     ");
+		else
+			payload.writeVDMode2Data(p, (const unsigned char*)"ALL       ");
+	}
+
+	fich.encode(p);
+}
+
+static void processNXDN(CCallStats* call, const unsigned char* data, unsigned long long now)
+{
+	assert(data != NULL);
+
+	// Only the voice bodies, the header and terminator carry no AMBE
+	if (call == NULL || data[38U] != 0x10U)
+		return;
+
+	for (unsigned int i = 0U; i < AMBE_PER_NXDN; i++) {
+		uint64_t diff = CAMBEFrame::decodeNXDN(data + 45U, i) ^ CAMBEFrame::SILENCE;
+		if (diff == 0U || (diff & ~uint64_t(TAG_MASK)) != 0U)
+			continue;
+
+		unsigned int tag = (unsigned int)diff;
+		if (tag >= call->m_sent.size() || call->m_sent[tag] == 0ULL || call->m_received[tag])
+			continue;
+
+		if (call->m_firstReceived == 0ULL)
+			call->m_firstReceived = now;
+
+		unsigned long long latency = now - call->m_sent[tag];
+		call->m_received[tag] = true;
+		call->m_frames++;
+		call->m_latencyTotal += latency;
+		if (latency > call->m_latencyMax)
+			call->m_latencyMax = latency;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	unsigned int ysfPort    = 42000U;
+	unsigned int nxdnPort   = 14020U;
+	unsigned int calls      = 5U;
+	unsigned int callLength = 10U;
+	unsigned int gap        = 3U;
+	unsigned int wait       = 2U;
+
+	for (int currentArg = 1; currentArg < argc; currentArg++) {
+		std::string arg = argv[currentArg];
+		if (arg.length() != 2U || arg.at(0U) != '-' || (currentArg + 1) >= argc) {
+			usage();
+			return 1;
+		}
+
+		const char* value = argv[++currentArg];
+		switch (arg.at(1U)) {
+			case 'y': ysfPort    = (unsigned int)::atoi(value); break;
+			case 'n': nxdnPort   = (unsigned int)::atoi(value); break;
+			case 'c': calls      = (unsigned int)::atoi(value); break;
+			case 'l': callLength = (unsigned int)::atoi(value); break;
+			case 'g': gap        = (unsigned int)::atoi(value); break;
+			case 'w': wait       = (unsigned int)::atoi(value); break;
+			default:
+				usage();
+				return 1;
+		}
+	}
+
+	unsigned int frames = callLength * 10U;
+	if (calls == 0U || frames == 0U || frames > MAX_FRAMES || gap == 0U) {
+		usage();
+		return 1;
+	}
+
+#if !defined(_WIN32) && !defined(_WIN64)
+	::signal(SIGINT,  sig_handler);
+	::signal(SIGTERM, sig_handler);
+#endif
+
+	::LogInitialise(".", "HubBench", 0U, 1U);
+
+	CUDPSocket ysfSocket("127.0.0.1", ysfPort);
+	CUDPSocket nxdnSocket("127.0.0.1", nxdnPort);
+	if (!ysfSocket.open() || !nxdnSocket.open()) {
+		LogError("Cannot open the YSF or NXDN port");
+		::LogFinalise();
+		return 1;
+	}
+
+	LogMessage("HubBench started, %u calls of %us every %us on YSF %u to NXDN %u", calls, callLength, callLength + gap, ysfPort, nxdnPort);
+
+	std::vector<CCallStats*> stats;
+
+	bool linked = false;
+	in_addr gatewayAddress;
+	unsigned int gatewayPort = 0U;
+
+	unsigned long long start     = CClock::getTime();
+	unsigned long long nextCall  = start + wait * 1000000ULL;
+	unsigned long long nextFrame = 0ULL;
+	unsigned long long stopTime  = 0ULL;
+	unsigned int frame = 0U;
+	bool active = false;
+
+	unsigned char buffer[BUFFER_LENGTH];
+
+	while (!end) {
+		unsigned long long now = CClock::getTime();
+
+		// The last call is given one more gap for its voice to come out
+		if (stopTime > 0ULL && now >= stopTime)
+			break;
+
+		if (!active && linked && stopTime == 0ULL && now >= nextCall) {
+			stats.push_back(new CCallStats(frames));
+			active    = true;
+			frame     = 0U;
+			nextFrame = now;
+			nextCall  = now + (callLength + gap) * 1000000ULL;
+		}
+
+		while (active && now >= nextFrame) {
+			buildFrame(buffer, frame, frames);
+			ysfSocket.write(buffer, YSFD_LENGTH, gatewayAddress, gatewayPort);
+
+			CCallStats* call = stats.back();
+			unsigned long long sent = CClock::getTime();
+			if (frame > 0U && frame <= frames) {
+				if (call->m_firstSent == 0ULL)
+					call->m_firstSent = sent;
+
+				for (unsigned int i = 0U; i < AMBE_PER_YSF; i++)
+					call->m_sent[(frame - 1U) * AMBE_PER_YSF + i + 1U] = sent;
+			}
+
+			frame++;
+			nextFrame += FRAME_PERIOD;
+
+			if (frame > (frames + 1U)) {
+				active = false;
+				if (stats.size() == calls)
+					stopTime = now + gap * 1000000ULL;
+			}
+		}
+
+		fd_set fds;
+		FD_ZERO(&fds);
+		FD_SET(ysfSocket.getFd(), &fds);
+		FD_SET(nxdnSocket.getFd(), &fds);
+		int maxFd = ysfSocket.getFd() > nxdnSocket.getFd() ? ysfSocket.getFd() : nxdnSocket.getFd();
+
+		struct timeval tv;
+		tv.tv_sec  = 0;
+		tv.tv_usec = 1000;
+		::select(maxFd + 1, &fds, NULL, NULL, &tv);
+
+		in_addr address;
+		unsigned int port;
+		int length;
+
+		while ((length = ysfSocket.read(buffer, BUFFER_LENGTH, address, port)) > 0) {
+			if (length != 14 || ::memcmp(buffer, "YSFP", 4U) != 0)
+				continue;
+
+			if (!linked) {
+				LogMessage("Gateway linked from %s:%u", ::inet_ntoa(address), port);
+				gatewayAddress = address;
+				gatewayPort    = port;
+				linked = true;
+			}
+
+			::memcpy(buffer + 4U, "HUBBENCH  ", YSF_CALLSIGN_LENGTH);
+			ysfSocket.write(buffer, 14U, address, port);
+		}
+
+		while ((length = nxdnSocket.read(buffer, BUFFER_LENGTH, address, port)) > 0) {
+			if (length == int(NXDN_LENGTH) && ::memcmp(buffer, "ICOM", 4U) == 0)
+				processNXDN(stats.empty() ? NULL : stats.back(), buffer, CClock::getTime());
+		}
+	}
+
+	ysfSocket.close();
+	nxdnSocket.close();
+
+	unsigned int sent = 0U, received = 0U, answered = 0U;
+	unsigned long long firstTotal = 0ULL, firstMax = 0ULL, latencyTotal = 0ULL, latencyMax = 0ULL;
+
+	for (unsigned int n = 0U; n < stats.size(); n++) {
+		CCallStats* call = stats[n];
+
+		unsigned int callSent = 0U;
+		for (unsigned int i = 1U; i < call->m_sent.size(); i++) {
+			if (call->m_sent[i] > 0ULL)
+				callSent++;
+		}
+
+		if (call->m_frames > 0U) {
+			unsigned long long first = call->m_firstReceived - call->m_firstSent;
+			LogMessage("Call %u: %u of %u AMBE frames received, first voice %.1fms, latency mean %.1fms max %.1fms", n + 1U, call->m_frames, callSent,
+				double(first) / 1000.0, double(call->m_latencyTotal) / double(call->m_frames) / 1000.0, double(call->m_latencyMax) / 1000.0);
+
+			answered++;
+			firstTotal += first;
+			if (first > firstMax)
+				firstMax = first;
+			latencyTotal += call->m_latencyTotal;
+			if (call->m_latencyMax > latencyMax)
+				latencyMax = call->m_latencyMax;
+		} else {
+			LogMessage("Call %u: 0 of %u AMBE frames received", n + 1U, callSent);
+		}
+
+		sent     += callSent;
+		received += call->m_frames;
+
+		delete call;
+	}
+
+	if (answered > 0U)
+		LogMessage("%u calls, %u of %u AMBE frames received, first voice mean %.1fms max %.1fms, latency mean %.1fms max %.1fms", (unsigned int)stats.size(), received, sent,
+			double(firstTotal) / double(answered) / 1000.0, double(firstMax) / 1000.0, double(latencyTotal) / double(received) / 1000.0, double(latencyMax) / 1000.0);
+	else
+		LogMessage("%u calls, 0 of %u AMBE frames received", (unsigned int)stats.size(), sent);
+
+	::LogFinalise();
+
+	return received > 0U ? 0 : 1;
+}
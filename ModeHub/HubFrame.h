@@ -0,0 +1,54 @@
+/*
+ *   Copyright (C) 2019 by Manuel Sanchez EA7EE
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#ifndef HubFrame_H
+#define HubFrame_H
+
+#include "IMBEFrame.h"
+
+#include <cstdint>
+#include <string>
+
+// The vocoders the hub carries. Frames are moved, never transcoded, so a
+// stream only reaches the endpoints that carry its codec.
+enum HUB_CODEC {
+	HC_AMBE,		// AMBE+2: DMR, YSF V/D mode 2 and NXDN
+	HC_IMBE			// IMBE: YSF voice FR mode and P25
+};
+
+// One entry of an endpoint queue: a header, a terminator, or a 20 ms
+// voice frame in the canonical form of its codec.
+class CHubFrame {
+public:
+	unsigned char m_tag;
+	uint64_t      m_ambe;
+	unsigned char m_imbe[IMBE_FRAME_LENGTH];
+};
+
+// Who a stream is from and to. The source id is in the id space of the
+// mode it came from, the other modes find their own from the callsign.
+class CHubCall {
+public:
+	HUB_CODEC     m_codec;
+	unsigned char m_mode;
+	std::string   m_source;
+	unsigned int  m_srcId;
+	unsigned int  m_dstId;
+};
+
+#endif
@@ -0,0 +1,217 @@
+/*
+ *   Copyright (C) 2019 by Manuel Sanchez EA7EE
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "IMBEFrame.h"
+#include "Golay24128.h"
+#include "Hamming.h"
+#include "ECCTables.h"
+
+#include <cstdio>
+#include <cassert>
+#include <cstdint>
+
+constexpr unsigned int IMBE_INTERLEAVE[] = {
+	0,  7, 12, 19, 24, 31, 36, 43, 48, 55, 60, 67, 72, 79, 84, 91,  96, 103, 108, 115, 120, 127, 132, 139,
+	1,  6, 13, 18, 25, 30, 37, 42, 49, 54, 61, 66, 73, 78, 85, 90,  97, 102, 109, 114, 121, 126, 133, 138,
+	2,  9, 14, 21, 26, 33, 38, 45, 50, 57, 62, 69, 74, 81, 86, 93,  98, 105, 110, 117, 122, 129, 134, 141,
+	3,  8, 15, 20, 27, 32, 39, 44, 51, 56, 63, 68, 75, 80, 87, 92,  99, 104, 111, 116, 123, 128, 135, 140,
+	4, 11, 16, 23, 28, 35, 40, 47, 52, 59, 64, 71, 76, 83, 88, 95, 100, 107, 112, 119, 124, 131, 136, 143,
+	5, 10, 17, 22, 29, 34, 41, 46, 53, 58, 65, 70, 77, 82, 89, 94, 101, 106, 113, 118, 125, 130, 137, 142};
+
+const unsigned char CIMBEFrame::SILENCE[] = {0x04U, 0x0CU, 0xFDU, 0x7BU, 0xFBU, 0x7DU, 0xF2U, 0x7BU, 0x3DU, 0x9EU, 0x44};
+
+// The 144 bits of a VCH, both as sent and de-interleaved, are handled as
+// five 32 bit words, most significant bit first.
+const unsigned int IMBE_WORDS = 5U;
+
+const unsigned int IMBE_NIBBLES = 36U;
+
+// For each nibble of the input and each of its values, the bits it sets in
+// the output, so interleaving is 36 lookups rather than 144 single bits.
+static constexpr CECCTable<unsigned int, IMBE_NIBBLES * 16U * IMBE_WORDS> makePermutationTable(bool interleave)
+{
+	CECCTable<unsigned int, IMBE_NIBBLES * 16U * IMBE_WORDS> table = {};
+
+	for (unsigned int i = 0U; i < 144U; i++) {
+		unsigned int from = interleave ? i : IMBE_INTERLEAVE[i];
+		unsigned int to   = interleave ? IMBE_INTERLEAVE[i] : i;
+
+		unsigned int nibble = from / 4U;
+		unsigned int shift  = 3U - (from % 4U);
+
+		for (unsigned int value = 0U; value < 16U; value++) {
+			if ((value >> shift) & 0x01U)
+				table.m_data[(nibble * 16U + value) * IMBE_WORDS + to / 32U] |= 0x80000000U >> (to % 32U);
+		}
+	}
+
+	return table;
+}
+
+// The 114 bit whitening vector for each value of c0, packed into four words
+static constexpr CECCTable<unsigned int, 4096U * 4U> makeWhiteningTable()
+{
+	CECCTable<unsigned int, 4096U * 4U> table = {};
+
+	for (unsigned int c0 = 0U; c0 < 4096U; c0++) {
+		unsigned int p = 16U * c0;
+		for (unsigned int i = 0U; i < 114U; i++) {
+			p = (173U * p + 13849U) % 65536U;
+			if (p >= 32768U)
+				table.m_data[c0 * 4U + i / 32U] |= 0x80000000U >> (i % 32U);
+		}
+	}
+
+	return table;
+}
+
+static constexpr CECCTable<unsigned int, IMBE_NIBBLES * 16U * IMBE_WORDS> INTERLEAVE_TABLE   = makePermutationTable(true);
+static constexpr CECCTable<unsigned int, IMBE_NIBBLES * 16U * IMBE_WORDS> DEINTERLEAVE_TABLE = makePermutationTable(false);
+static constexpr CECCTable<unsigned int, 4096U * 4U> WHITENING_TABLE = makeWhiteningTable();
+
+static_assert(INTERLEAVE_TABLE.checksum() == 0x4A45F6FDU, "INTERLEAVE_TABLE has changed");
+static_assert(DEINTERLEAVE_TABLE.checksum() == 0x5245DBC5U, "DEINTERLEAVE_TABLE has changed");
+static_assert(WHITENING_TABLE.checksum() == 0xB0788A05U, "WHITENING_TABLE has changed");
+
+static void bytesToWords(const unsigned char* bytes, unsigned int length, unsigned int* words)
+{
+	for (unsigned int i = 0U; i < IMBE_WORDS; i++)
+		words[i] = 0U;
+
+	for (unsigned int i = 0U; i < length; i++)
+		words[i / 4U] |= bytes[i] << (24U - (i % 4U) * 8U);
+}
+
+static void wordsToBytes(const unsigned int* words, unsigned int length, unsigned char* bytes)
+{
+	for (unsigned int i = 0U; i < length; i++)
+		bytes[i] = words[i / 4U] >> (24U - (i % 4U) * 8U);
+}
+
+static unsigned int getBits(const unsigned int* words, unsigned int pos, unsigned int length)
+{
+	unsigned int n = pos / 32U;
+
+	uint64_t value = uint64_t(words[n]) << 32;
+	if (n + 1U < IMBE_WORDS)
+		value |= words[n + 1U];
+
+	return (unsigned int)(value >> (64U - (pos % 32U) - length)) & ((1U << length) - 1U);
+}
+
+static void setBits(unsigned int* words, unsigned int pos, unsigned int length, unsigned int bits)
+{
+	unsigned int n = pos / 32U;
+
+	uint64_t value = uint64_t(bits) << (64U - (pos % 32U) - length);
+
+	words[n] |= (unsigned int)(value >> 32);
+	if (n + 1U < IMBE_WORDS)
+		words[n + 1U] |= (unsigned int)value;
+}
+
+static void permute(const CECCTable<unsigned int, IMBE_NIBBLES * 16U * IMBE_WORDS>& table, const unsigned int* in, unsigned int* out)
+{
+	for (unsigned int i = 0U; i < IMBE_WORDS; i++)
+		out[i] = 0U;
+
+	for (unsigned int i = 0U; i < IMBE_NIBBLES; i++) {
+		unsigned int value = (in[i / 8U] >> (28U - (i % 8U) * 4U)) & 0x0FU;
+
+		const unsigned int* bits = &table[(i * 16U + value) * IMBE_WORDS];
+		for (unsigned int j = 0U; j < IMBE_WORDS; j++)
+			out[j] |= bits[j];
+	}
+}
+
+// The whitening vector covers bits 23 to 136
+static void whiten(unsigned int* bits, unsigned int c0)
+{
+	const unsigned int* prn = &WHITENING_TABLE[c0 * 4U];
+
+	bits[0U] ^= prn[0U] >> 23;
+	bits[1U] ^= (prn[0U] << 9) | (prn[1U] >> 23);
+	bits[2U] ^= (prn[1U] << 9) | (prn[2U] >> 23);
+	bits[3U] ^= (prn[2U] << 9) | (prn[3U] >> 23);
+	bits[4U] ^= prn[3U] << 9;
+}
+
+void CIMBEFrame::decodeYSF(const unsigned char* vch, unsigned char* imbe)
+{
+	assert(vch != NULL);
+	assert(imbe != NULL);
+
+	unsigned int frame[IMBE_WORDS];
+	bytesToWords(vch, 18U, frame);
+
+	// De-interleave
+	unsigned int bit[IMBE_WORDS];
+	permute(DEINTERLEAVE_TABLE, frame, bit);
+
+	// Four (23,12) Golay words at bits 0, 23, 46 and 69, three (15,11)
+	// Hamming words at bits 92, 107 and 122, and seven unprotected bits at 137
+
+	// c0
+	unsigned int c0data = getBits(bit, 0U, 12U);
+
+	// De-whiten some bits
+	whiten(bit, c0data);
+
+	unsigned int out[IMBE_WORDS] = {0U};
+	setBits(out, 0U,  12U, c0data);
+	setBits(out, 12U, 12U, getBits(bit, 23U,  12U));
+	setBits(out, 24U, 12U, getBits(bit, 46U,  12U));
+	setBits(out, 36U, 12U, getBits(bit, 69U,  12U));
+	setBits(out, 48U, 11U, getBits(bit, 92U,  11U));
+	setBits(out, 59U, 11U, getBits(bit, 107U, 11U));
+	setBits(out, 70U, 11U, getBits(bit, 122U, 11U));
+	setBits(out, 81U, 7U,  getBits(bit, 137U, 7U));
+
+	wordsToBytes(out, IMBE_FRAME_LENGTH, imbe);
+}
+
+void CIMBEFrame::encodeYSF(const unsigned char* imbe, unsigned char* vch)
+{
+	assert(imbe != NULL);
+	assert(vch != NULL);
+
+	unsigned int in[IMBE_WORDS];
+	bytesToWords(imbe, IMBE_FRAME_LENGTH, in);
+
+	unsigned int c0 = getBits(in, 0U, 12U);
+
+	// encode23127() returns the codeword shifted up by one bit
+	unsigned int bit[IMBE_WORDS] = {0U};
+	setBits(bit, 0U,   23U, CGolay24128::encode23127(c0) >> 1);
+	setBits(bit, 23U,  23U, CGolay24128::encode23127(getBits(in, 12U, 12U)) >> 1);
+	setBits(bit, 46U,  23U, CGolay24128::encode23127(getBits(in, 24U, 12U)) >> 1);
+	setBits(bit, 69U,  23U, CGolay24128::encode23127(getBits(in, 36U, 12U)) >> 1);
+	setBits(bit, 92U,  15U, CHamming::encode15113_1(getBits(in, 48U, 11U)));
+	setBits(bit, 107U, 15U, CHamming::encode15113_1(getBits(in, 59U, 11U)));
+	setBits(bit, 122U, 15U, CHamming::encode15113_1(getBits(in, 70U, 11U)));
+	setBits(bit, 137U, 7U,  getBits(in, 81U, 7U));
+
+	// Whiten some bits
+	whiten(bit, c0);
+
+	// Interleave
+	unsigned int frame[IMBE_WORDS];
+	permute(INTERLEAVE_TABLE, bit, frame);
+
+	wordsToBytes(frame, 18U, vch);
+}
@@ -0,0 +1,37 @@
+/*
+ *   Copyright (C) 2019 by Manuel Sanchez EA7EE
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#ifndef IMBEFrame_H
+#define IMBEFrame_H
+
+// The 88 bits of one unpacked 20 ms IMBE frame, as carried by the P25
+// voice records and, with its FEC, by a YSF voice FR mode VCH.
+const unsigned int IMBE_FRAME_LENGTH = 11U;
+
+class CIMBEFrame {
+public:
+	// An 18 byte YSF voice FR mode VCH, interleaved and whitened as sent.
+	// The Golay and Hamming codes are not checked.
+	static void decodeYSF(const unsigned char* vch, unsigned char* imbe);
+	static void encodeYSF(const unsigned char* imbe, unsigned char* vch);
+
+	// The silence frame that calls are padded with
+	static const unsigned char SILENCE[IMBE_FRAME_LENGTH];
+};
+
+#endif
@@ -0,0 +1,683 @@
+/*
+ *   Copyright (C) 2019 by Manuel Sanchez EA7EE
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "ModeHub.h"
+#include "YSFEndpoint.h"
+#include "DMREndpoint.h"
+#include "NXDNEndpoint.h"
+#include "P25Endpoint.h"
+#include "YSFNetwork.h"
+#include "DMRNetwork.h"
+#include "NXDNNetwork.h"
+#include "P25Network.h"
+#include "UDPSocket.h"
+#include "StopWatch.h"
+#include "Version.h"
+#include "Thread.h"
+#include "Log.h"
+
+#if defined(_WIN32) || defined(_WIN64)
+#include <Windows.h>
+#else
+#include <sys/select.h>
+#include <sys/time.h>
+#include <unistd.h>
+#include <signal.h>
+#include <fcntl.h>
+#include <pwd.h>
+#endif
+
+// The longest the hub waits on its sockets before clocking the endpoints
+#define HUB_WAIT_MS         5U
+
+#if defined(_WIN32) || defined(_WIN64)
+const char* DEFAULT_INI_FILE = "ModeHub.ini";
+#else
+const char* DEFAULT_INI_FILE = "/etc/ModeHub.ini";
+#endif
+
+const char* HEADER1 = "This software is for use on amateur radio networks only,";
+const char* HEADER2 = "it is to be used for educational purposes only. Its use on";
+const char* HEADER3 = "commercial networks is strictly prohibited.";
+const char* HEADER4 = "Copyright(C) 2019 by EA7EE, CA6JAU, G4KLX and others";
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <clocale>
+#include <cassert>
+
+int end = 0;
+
+#if !defined(_WIN32) && !defined(_WIN64)
+void sig_handler(int signo)
+{
+	if (signo == SIGTERM) {
+		end = 1;
+		::fprintf(stdout, "Received SIGTERM\n");
+	}
+}
+#endif
+
+int main(int argc, char** argv)
+{
+	const char* iniFile = DEFAULT_INI_FILE;
+	if (argc > 1) {
+		for (int currentArg = 1; currentArg < argc; ++currentArg) {
+			std::string arg = argv[currentArg];
+			if ((arg == "-v") || (arg == "--version")) {
+				::fprintf(stdout, "ModeHub version %s\n", VERSION);
+				return 0;
+			} else if (arg.substr(0, 1) == "-") {
+				::fprintf(stderr, "Usage: ModeHub [-v|--version] [filename]\n");
+				return 1;
+			} else {
+				iniFile = argv[currentArg];
+			}
+		}
+	}
+
+#if !defined(_WIN32) && !defined(_WIN64)
+	// Capture SIGTERM to finish gracelessly
+	if (signal(SIGTERM, sig_handler) == SIG_ERR)
+		::fprintf(stdout, "Can't catch SIGTERM\n");
+#endif
+
+	CModeHub* hub = new CModeHub(std::string(iniFile));
+
+	int ret = hub->run();
+
+	delete hub;
+
+	return ret;
+}
+
+static unsigned char findMode(const std::string& name)
+{
+	if (name == "YSF")
+		return MODE_YSF;
+	else if (name == "DMR")
+		return MODE_DMR;
+	else if (name == "NXDN")
+		return MODE_NXDN;
+	else if (name == "P25")
+		return MODE_P25;
+	else
+		return MODE_IDLE;
+}
+
+CModeHub::CModeHub(const std::string& configFile) :
+m_conf(configFile),
+m_callsign(),
+m_dmrLookup(NULL),
+m_nxdnLookup(NULL),
+m_endpoints(),
+m_source(NULL),
+m_targets(),
+m_watchdog(1000U, 0U, 1500U),
+m_capture(NULL),
+m_replay(NULL)
+{
+	::memset(m_routes, 0x00U, sizeof(m_routes));
+}
+
+CModeHub::~CModeHub()
+{
+}
+
+int CModeHub::run()
+{
+	bool ret = m_conf.read();
+	if (!ret) {
+		::fprintf(stderr, "ModeHub: cannot read the .ini file\n");
+		return 1;
+	}
+
+	setlocale(LC_ALL, "C");
+
+	unsigned int logDisplayLevel = m_conf.getLogDisplayLevel();
+
+#if !defined(_WIN32) && !defined(_WIN64)
+	if(m_conf.getDaemon())
+		logDisplayLevel = 0U;
+#endif
+
+#if !defined(_WIN32) && !defined(_WIN64)
+	bool m_daemon = m_conf.getDaemon();
+	if (m_daemon) {
+		// Create new process
+		pid_t pid = ::fork();
+		if (pid == -1) {
+			::fprintf(stderr, "Couldn't fork() , exiting\n");
+			return -1;
+		} else if (pid != 0)
+			exit(EXIT_SUCCESS);
+
+		// Create new session and process group
+		if (::setsid() == -1) {
+			::fprintf(stderr, "Couldn't setsid(), exiting\n");
+			return -1;
+		}
+
+		// Set the working directory to the root directory
+		if (::chdir("/") == -1) {
+			::fprintf(stderr, "Couldn't cd /, exiting\n");
+			return -1;
+		}
+
+		// If we are currently root...
+		if (getuid() == 0) {
+			struct passwd* user = ::getpwnam("mmdvm");
+			if (user == NULL) {
+				::fprintf(stderr, "Could not get the mmdvm user, exiting\n");
+				return -1;
+			}
+
+			uid_t mmdvm_uid = user->pw_uid;
+			gid_t mmdvm_gid = user->pw_gid;
+
+			// Set user and group ID's to mmdvm:mmdvm
+			if (setgid(mmdvm_gid) != 0) {
+				::fprintf(stderr, "Could not set mmdvm GID, exiting\n");
+				return -1;
+			}
+
+			if (setuid(mmdvm_uid) != 0) {
+				::fprintf(stderr, "Could not set mmdvm UID, exiting\n");
+				return -1;
+			}
+
+			// Double check it worked (AKA Paranoia)
+			if (setuid(0) != -1) {
+				::fprintf(stderr, "It's possible to regain root - something is wrong!, exiting\n");
+				return -1;
+			}
+		}
+	}
+#endif
+
+	ret = ::LogInitialise(m_conf.getLogFilePath(), m_conf.getLogFileRoot(), m_conf.getLogFileLevel(), logDisplayLevel);
+	if (!ret) {
+		::fprintf(stderr, "ModeHub: unable to open the log file\n");
+		return 1;
+	}
+
+#if !defined(_WIN32) && !defined(_WIN64)
+	if (m_daemon) {
+		::close(STDIN_FILENO);
+		::close(STDOUT_FILENO);
+		::close(STDERR_FILENO);
+	}
+#endif
+
+	LogInfo(HEADER1);
+	LogInfo(HEADER2);
+	LogInfo(HEADER3);
+	LogInfo(HEADER4);
+
+	m_callsign = m_conf.getCallsign();
+
+	unsigned int captureMode = m_conf.getCaptureMode();
+	if (captureMode == 1U) {
+		m_capture = new CCapture(m_conf.getCaptureFile());
+		if (!m_capture->open()) {
+			::LogFinalise();
+			return 1;
+		}
+	} else if (captureMode == 2U) {
+		m_replay = new CReplay(m_conf.getCaptureFile());
+		m_capture = new CCapture(m_conf.getCaptureOutput());
+		if (!m_replay->open() || !m_capture->open()) {
+			::LogFinalise();
+			return 1;
+		}
+
+		m_replay->start();
+	}
+
+	std::string lookupFile  = m_conf.getDMRIdLookupFile();
+	unsigned int reloadTime = m_conf.getDMRIdLookupTime();
+
+	m_dmrLookup = new CDMRLookup(lookupFile, reloadTime);
+	m_dmrLookup->read();
+
+	lookupFile = m_conf.getNXDNIdLookupFile();
+	reloadTime = m_conf.getNXDNIdLookupTime();
+
+	m_nxdnLookup = new CNXDNLookup(lookupFile, reloadTime);
+	m_nxdnLookup->read();
+
+	ret = readRoutes();
+	if (ret && m_conf.getYSFEnabled())
+		ret = createYSFEndpoint();
+	if (ret && m_conf.getDMREnabled())
+		ret = createDMREndpoint();
+	if (ret && m_conf.getNXDNEnabled())
+		ret = createNXDNEndpoint();
+	if (ret && m_conf.getP25Enabled())
+		ret = createP25Endpoint();
+
+	if (ret && m_endpoints.size() < 2U) {
+		LogError("At least two networks must be enabled");
+		ret = false;
+	}
+
+	if (ret)
+		checkRoutes();
+
+	if (ret) {
+		CStopWatch stopWatch;
+		stopWatch.start();
+
+		CTimer replayTimer(1000U, 2U);
+
+		LogMessage("Starting ModeHub-%s", VERSION);
+
+		while (end == 0) {
+			unsigned int ms = stopWatch.elapsed();
+			stopWatch.start();
+
+			for (std::vector<CEndpoint*>::const_iterator it = m_endpoints.begin(); it != m_endpoints.end(); ++it)
+				(*it)->clock(ms);
+
+			// What was routed goes out on the next pass rather than after the wait
+			bool routed = false;
+			for (std::vector<CEndpoint*>::const_iterator it = m_endpoints.begin(); it != m_endpoints.end(); ++it) {
+				CHubFrame frame;
+				while ((*it)->read(frame))
+					routed |= route(*it, frame);
+			}
+
+			m_watchdog.clock(ms);
+			if (m_source != NULL && m_watchdog.isRunning() && m_watchdog.hasExpired()) {
+				LogMessage("%s stream lost, releasing the hub", m_source->getName());
+				endCall();
+			}
+
+			if (m_replay != NULL && m_replay->isFinished()) {
+				if (!replayTimer.isRunning())
+					replayTimer.start();
+
+				replayTimer.clock(ms);
+				if (replayTimer.hasExpired()) {
+					LogMessage("Replay finished, %u ms of traffic in %.3f s of CPU", m_replay->getElapsed(), double(CThread::getCPUTime()) / 1000000.0);
+					end = 1;
+				}
+			}
+
+			// A replay has no sockets to wait on, its time only moves here
+			if (m_replay != NULL)
+				m_replay->sleep(routed ? 1U : HUB_WAIT_MS);
+			else if (!routed)
+				wait(HUB_WAIT_MS);
+		}
+	}
+
+	for (std::vector<CEndpoint*>::const_iterator it = m_endpoints.begin(); it != m_endpoints.end(); ++it) {
+		(*it)->close();
+		delete *it;
+	}
+
+	m_dmrLookup->stop();
+	m_nxdnLookup->stop();
+
+	if (m_capture != NULL) {
+		m_capture->close();
+		delete m_capture;
+	}
+
+	delete m_replay;
+
+	::LogFinalise();
+
+	return ret ? 0 : 1;
+}
+
+bool CModeHub::createYSFEndpoint()
+{
+	std::string dstAddress   = m_conf.getYSFDstAddress();
+	unsigned int dstPort     = m_conf.getYSFDstPort();
+	std::string localAddress = m_conf.getYSFLocalAddress();
+	unsigned int localPort   = m_conf.getYSFLocalPort();
+	bool debug               = m_conf.getYSFNetworkDebug();
+
+	LogMessage("YSF Network Parameters");
+	LogMessage("    Destination: %s:%u", dstAddress.c_str(), dstPort);
+	LogMessage("    Local: %s:%u", localAddress.c_str(), localPort);
+
+	CYSFNetwork* network = new CYSFNetwork(localAddress, localPort, m_callsign, debug);
+	network->setCapture(m_capture, m_replay);
+	network->setDestination(CUDPSocket::lookup(dstAddress), dstPort);
+
+	CEndpoint* endpoint = new CYSFEndpoint(network);
+	if (!endpoint->open()) {
+		LogError("Cannot open the YSF network port");
+		delete endpoint;
+		return false;
+	}
+
+	m_endpoints.push_back(endpoint);
+
+	return true;
+}
+
+bool CModeHub::createDMREndpoint()
+{
+	std::string address   = m_conf.getDMRNetworkAddress();
+	unsigned int port     = m_conf.getDMRNetworkPort();
+	unsigned int local    = m_conf.getDMRNetworkLocal();
+	std::string password  = m_conf.getDMRNetworkPassword();
+	bool debug            = m_conf.getDMRNetworkDebug();
+	unsigned int jitter   = m_conf.getDMRNetworkJitter();
+	unsigned int id       = m_conf.getDMRId();
+	unsigned int dstId    = m_conf.getDMRDstId();
+	bool pc               = m_conf.getDMRPC();
+
+	unsigned int defaultId;
+	if (id > 99999999U)
+		defaultId = id / 100U;
+	else if (id > 9999999U)
+		defaultId = id / 10U;
+	else
+		defaultId = id;
+
+	LogMessage("DMR Network Parameters");
+	LogMessage("    ID: %u", id);
+	LogMessage("    Default SrcID: %u", defaultId);
+	LogMessage("    Startup DstID: %s%u", pc ? "" : "TG ", dstId);
+	LogMessage("    Address: %s", address.c_str());
+	LogMessage("    Port: %u", port);
+	if (local > 0U)
+		LogMessage("    Local: %u", local);
+	else
+		LogMessage("    Local: random");
+	LogMessage("    Jitter: %ums", jitter);
+
+	CDMRNetwork* network = new CDMRNetwork(address, port, local, id, password, false, VERSION, debug, false, true, HWT_MMDVM, jitter);
+	network->setCapture(m_capture, m_replay);
+
+	std::string options = m_conf.getDMRNetworkOptions();
+	if (!options.empty()) {
+		LogMessage("    Options: %s", options.c_str());
+		network->setOptions(options);
+	}
+
+	unsigned int rxFrequency = m_conf.getRxFrequency();
+	unsigned int txFrequency = m_conf.getTxFrequency();
+	unsigned int power       = m_conf.getPower();
+	float latitude           = m_conf.getLatitude();
+	float longitude          = m_conf.getLongitude();
+	int height               = m_conf.getHeight();
+	std::string location     = m_conf.getLocation();
+	std::string description  = m_conf.getDescription();
+	std::string url          = m_conf.getURL();
+
+	LogMessage("Info Parameters");
+	LogMessage("    Callsign: %s", m_callsign.c_str());
+	LogMessage("    RX Frequency: %uHz", rxFrequency);
+	LogMessage("    TX Frequency: %uHz", txFrequency);
+	LogMessage("    Power: %uW", power);
+	LogMessage("    Latitude: %fdeg N", latitude);
+	LogMessage("    Longitude: %fdeg E", longitude);
+	LogMessage("    Height: %um", height);
+	LogMessage("    Location: \"%s\"", location.c_str());
+	LogMessage("    Description: \"%s\"", description.c_str());
+	LogMessage("    URL: \"%s\"", url.c_str());
+
+	network->setConfig(m_callsign, rxFrequency, txFrequency, power, 1U, latitude, longitude, height, location, description, url);
+
+	CEndpoint* endpoint = new CDMREndpoint(network, m_dmrLookup, defaultId, dstId, pc);
+	if (!endpoint->open()) {
+		LogError("Cannot open DMR Network");
+		delete endpoint;
+		return false;
+	}
+
+	m_endpoints.push_back(endpoint);
+
+	return true;
+}
+
+bool CModeHub::createNXDNEndpoint()
+{
+	std::string dstAddress   = m_conf.getNXDNDstAddress();
+	unsigned int dstPort     = m_conf.getNXDNDstPort();
+	std::string localAddress = m_conf.getNXDNLocalAddress();
+	unsigned int localPort   = m_conf.getNXDNLocalPort();
+	bool debug               = m_conf.getNXDNNetworkDebug();
+	unsigned int id          = m_conf.getNXDNId();
+	unsigned int tg          = m_conf.getNXDNTG();
+
+	LogMessage("NXDN Network Parameters");
+	LogMessage("    Default SrcID: %u", id);
+	LogMessage("    TG: %u", tg);
+	LogMessage("    Destination: %s:%u", dstAddress.c_str(), dstPort);
+	LogMessage("    Local: %s:%u", localAddress.c_str(), localPort);
+
+	CNXDNNetwork* network = new CNXDNNetwork(localAddress, localPort, dstAddress, dstPort, debug);
+	network->setCapture(m_capture, m_replay);
+
+	CEndpoint* endpoint = new CNXDNEndpoint(network, m_nxdnLookup, id, tg);
+	if (!endpoint->open()) {
+		LogError("Cannot open the NXDN network port");
+		delete endpoint;
+		return false;
+	}
+
+	m_endpoints.push_back(endpoint);
+
+	return true;
+}
+
+bool CModeHub::createP25Endpoint()
+{
+	std::string dstAddress   = m_conf.getP25DstAddress();
+	unsigned int dstPort     = m_conf.getP25DstPort();
+	std::string localAddress = m_conf.getP25LocalAddress();
+	unsigned int localPort   = m_conf.getP25LocalPort();
+	bool coalesce            = m_conf.getP25NetworkCoalesce();
+	bool debug               = m_conf.getP25NetworkDebug();
+	unsigned int id          = m_conf.getP25Id();
+	unsigned int tg          = m_conf.getP25TG();
+
+	LogMessage("P25 Network Parameters");
+	LogMessage("    Default SrcID: %u", id);
+	LogMessage("    TG: %u", tg);
+	LogMessage("    Destination: %s:%u", dstAddress.c_str(), dstPort);
+	LogMessage("    Local: %s:%u", localAddress.c_str(), localPort);
+	LogMessage("    Coalesce: %s", coalesce ? "yes" : "no");
+
+	CP25Network* network = new CP25Network(localAddress, localPort, dstAddress, dstPort, m_callsign, coalesce, debug);
+	network->setCapture(m_capture, m_replay);
+
+	CEndpoint* endpoint = new CP25Endpoint(network, m_dmrLookup, id, tg);
+	if (!endpoint->open()) {
+		LogError("Cannot open the P25 network port");
+		delete endpoint;
+		return false;
+	}
+
+	m_endpoints.push_back(endpoint);
+
+	return true;
+}
+
+bool CModeHub::readRoutes()
+{
+	std::string routes = m_conf.getRoutes();
+
+	// With no list every mode is routed to every other one
+	if (routes.empty()) {
+		for (unsigned int i = 0U; i < HUB_MODES; i++)
+			for (unsigned int j = 0U; j < HUB_MODES; j++)
+				m_routes[i][j] = i != j;
+
+		LogMessage("Routes: all");
+		return true;
+	}
+
+	LogMessage("Routes: %s", routes.c_str());
+
+	std::string::size_type pos = 0U;
+	while (pos < routes.length()) {
+		std::string::size_type next = routes.find(',', pos);
+		if (next == std::string::npos)
+			next = routes.length();
+
+		std::string route = routes.substr(pos, next - pos);
+		pos = next + 1U;
+
+		std::string::size_type dash = route.find('-');
+		if (dash == std::string::npos) {
+			LogError("Invalid route \"%s\"", route.c_str());
+			return false;
+		}
+
+		unsigned char from = findMode(route.substr(0U, dash));
+		unsigned char to   = findMode(route.substr(dash + 1U));
+		if (from == MODE_IDLE || to == MODE_IDLE || from == to) {
+			LogError("Invalid route \"%s\"", route.c_str());
+			return false;
+		}
+
+		m_routes[from][to] = true;
+	}
+
+	return true;
+}
+
+// Nothing is transcoded, so a route between two modes with no vocoder in
+// common, such as DMR to P25, never carries a call
+void CModeHub::checkRoutes() const
+{
+	for (std::vector<CEndpoint*>::const_iterator from = m_endpoints.begin(); from != m_endpoints.end(); ++from) {
+		for (std::vector<CEndpoint*>::const_iterator to = m_endpoints.begin(); to != m_endpoints.end(); ++to) {
+			if (from == to || !m_routes[(*from)->getMode()][(*to)->getMode()])
+				continue;
+
+			bool ambe = (*from)->hasCodec(HC_AMBE) && (*to)->hasCodec(HC_AMBE);
+			bool imbe = (*from)->hasCodec(HC_IMBE) && (*to)->hasCodec(HC_IMBE);
+			if (!ambe && !imbe)
+				LogWarning("Route %s-%s cannot carry any call, the two modes use different vocoders", (*from)->getName(), (*to)->getName());
+		}
+	}
+}
+
+bool CModeHub::route(CEndpoint* endpoint, const CHubFrame& frame)
+{
+	assert(endpoint != NULL);
+
+	// One stream at a time, the others are dropped until it ends
+	if (m_source != NULL && m_source != endpoint)
+		return false;
+
+	switch (frame.m_tag) {
+	case TAG_HEADER:
+		if (m_source != NULL)
+			endCall();
+		startCall(endpoint);
+		return true;
+
+	case TAG_DATA:
+		// Joining a stream that is already running
+		if (m_source == NULL)
+			startCall(endpoint);
+
+		for (std::vector<CEndpoint*>::const_iterator it = m_targets.begin(); it != m_targets.end(); ++it)
+			(*it)->writeData(frame);
+
+		m_watchdog.start();
+		return true;
+
+	case TAG_EOT:
+		if (m_source == NULL)
+			return false;
+		endCall();
+		return true;
+
+	default:
+		return false;
+	}
+}
+
+void CModeHub::startCall(CEndpoint* endpoint)
+{
+	assert(endpoint != NULL);
+
+	const CHubCall& call = endpoint->getCall();
+
+	m_source = endpoint;
+	m_targets.clear();
+
+	for (std::vector<CEndpoint*>::const_iterator it = m_endpoints.begin(); it != m_endpoints.end(); ++it) {
+		CEndpoint* target = *it;
+		if (target == endpoint || !m_routes[endpoint->getMode()][target->getMode()] || !target->hasCodec(call.m_codec))
+			continue;
+
+		target->writeHeader(call);
+		m_targets.push_back(target);
+	}
+
+	LogMessage("%s stream from %s to %u, routed to %u network(s)", endpoint->getName(), call.m_source.c_str(), call.m_dstId, (unsigned int)m_targets.size());
+
+	m_watchdog.start();
+}
+
+void CModeHub::endCall()
+{
+	assert(m_source != NULL);
+
+	for (std::vector<CEndpoint*>::const_iterator it = m_targets.begin(); it != m_targets.end(); ++it)
+		(*it)->writeEOT();
+
+	LogMessage("%s stream ended", m_source->getName());
+
+	m_targets.clear();
+	m_source = NULL;
+
+	m_watchdog.stop();
+}
+
+void CModeHub::wait(unsigned int ms) const
+{
+	fd_set fds;
+	FD_ZERO(&fds);
+
+	int maxFd = -1;
+	for (std::vector<CEndpoint*>::const_iterator it = m_endpoints.begin(); it != m_endpoints.end(); ++it) {
+		int fd = (*it)->getFd();
+		if (fd < 0)
+			continue;
+
+		FD_SET(fd, &fds);
+		if (fd > maxFd)
+			maxFd = fd;
+	}
+
+	if (maxFd < 0) {
+		CThread::sleep(ms);
+		return;
+	}
+
+	struct timeval tv;
+	tv.tv_sec  = 0;
+	tv.tv_usec = ms * 1000;
+
+	// Woken early by anything arriving on one of the networks
+	::select(maxFd + 1, &fds, NULL, NULL, &tv);
+}
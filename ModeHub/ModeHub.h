@@ -0,0 +1,72 @@
+/*
+ *   Copyright (C) 2019 by Manuel Sanchez EA7EE
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#if !defined(MODEHUB_H)
+#define MODEHUB_H
+
+#include "DMRLookup.h"
+#include "NXDNLookup.h"
+#include "HubFrame.h"
+#include "Endpoint.h"
+#include "Defines.h"
+#include "Capture.h"
+#include "Timer.h"
+#include "Conf.h"
+
+#include <string>
+#include <vector>
+
+// The modes are indexed by their MODE_ value
+const unsigned int HUB_MODES = MODE_NXDN + 1U;
+
+class CModeHub
+{
+public:
+	CModeHub(const std::string& configFile);
+	~CModeHub();
+
+	int run();
+
+private:
+	CConf                   m_conf;
+	std::string             m_callsign;
+	CDMRLookup*             m_dmrLookup;
+	CNXDNLookup*            m_nxdnLookup;
+	std::vector<CEndpoint*> m_endpoints;
+	bool                    m_routes[HUB_MODES][HUB_MODES];
+	CEndpoint*              m_source;
+	std::vector<CEndpoint*> m_targets;
+	CTimer                  m_watchdog;
+	CCapture*               m_capture;
+	CReplay*                m_replay;
+
+	bool createYSFEndpoint();
+	bool createDMREndpoint();
+	bool createNXDNEndpoint();
+	bool createP25Endpoint();
+	bool readRoutes();
+	void checkRoutes() const;
+
+	bool route(CEndpoint* endpoint, const CHubFrame& frame);
+	void startCall(CEndpoint* endpoint);
+	void endCall();
+
+	void wait(unsigned int ms) const;
+};
+
+#endif
@@ -1,5 +1,5 @@
 /*
- *   Copyright (C) 2015 by Jonathan Naylor G4KLX
+ *   Copyright (C) 2015,2016 by Jonathan Naylor G4KLX
  *
  *   This program is free software; you can redistribute it and/or modify
  *   it under the terms of the GNU General Public License as published by
@@ -16,17 +16,30 @@
  *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
  */
 
-#ifndef Golay2087_H
-#define Golay2087_H
+#if !defined(MUTEX_H)
+#define	MUTEX_H
 
-class CGolay2087 {
+#if defined(_WIN32) || defined(_WIN64)
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+class CMutex
+{
 public:
-	static void encode(unsigned char* data);
+	CMutex();
+	~CMutex();
 
-	static unsigned char decode(const unsigned char* data);
+	void lock();
+	void unlock();
 
 private:
-	static unsigned int getSyndrome1987(unsigned int pattern);
+#if defined(_WIN32) || defined(_WIN64)
+	HANDLE          m_handle;
+#else
+	pthread_mutex_t m_mutex;
+#endif
 };
 
 #endif
@@ -1,6 +1,5 @@
 /*
- *   Copyright (C) 2015,2016 by Jonathan Naylor G4KLX
- *   Copyright (C) 2018 by Andy Uribe CA6JAU
+ *   Copyright (C) 2018 by Jonathan Naylor G4KLX
  *
  *   This program is free software; you can redistribute it and/or modify
  *   it under the terms of the GNU General Public License as published by
@@ -17,24 +16,27 @@
  *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
  */
 
-#if !defined(CRC_H)
-#define	CRC_H
+#if !defined(NXDNCRC_H)
+#define	NXDNCRC_H
 
-class CCRC
+#include <cstdint>
+
+class CNXDNCRC
 {
 public:
-	static bool checkFiveBit(bool* in, unsigned int tcrc);
-	static void encodeFiveBit(const bool* in, unsigned int& tcrc);
+	static bool checkCRC6(const unsigned char* in, unsigned int length);
+	static void encodeCRC6(unsigned char* in, unsigned int length);
 
-	static void addCCITT161(unsigned char* in, unsigned int length);
-	static void addCCITT162(unsigned char* in, unsigned int length);
+	static bool checkCRC12(const unsigned char* in, unsigned int length);
+	static void encodeCRC12(unsigned char* in, unsigned int length);
 
-	static bool checkCCITT161(const unsigned char* in, unsigned int length);
-	static bool checkCCITT162(const unsigned char* in, unsigned int length);
+	static bool checkCRC15(const unsigned char* in, unsigned int length);
+	static void encodeCRC15(unsigned char* in, unsigned int length);
 
-	static unsigned char crc8(const unsigned char* in, unsigned int length);
-	
-	static unsigned char addCRC(const unsigned char* in, unsigned int length);
+private:
+	static uint8_t  createCRC6(const unsigned char* in, unsigned int length);
+	static uint16_t createCRC12(const unsigned char* in, unsigned int length);
+	static uint16_t createCRC15(const unsigned char* in, unsigned int length);
 };
 
 #endif
@@ -0,0 +1,234 @@
+/*
+ *   Copyright (C) 2009-2016,2018 by Jonathan Naylor G4KLX
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "NXDNConvolution.h"
+
+#include <cstdio>
+#include <cassert>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
+const unsigned char BIT_MASK_TABLE[] = {0x80U, 0x40U, 0x20U, 0x10U, 0x08U, 0x04U, 0x02U, 0x01U};
+
+#define WRITE_BIT1(p,i,b) p[(i)>>3] = (b) ? (p[(i)>>3] | BIT_MASK_TABLE[(i)&7]) : (p[(i)>>3] & ~BIT_MASK_TABLE[(i)&7])
+#define READ_BIT1(p,i)    (p[(i)>>3] & BIT_MASK_TABLE[(i)&7])
+
+const unsigned int NUM_OF_STATES_D2 = 8U;
+const unsigned int NUM_OF_STATES = 16U;
+const int16_t      M = 2 * NXDN_SOFT_ONE;
+const unsigned int K = 5U;
+
+// Path metrics are renormalised once state 0 passes this. The others are
+// within (K - 1) * M of the smallest, so they all stay positive in 16 bits.
+const int16_t RENORMALISE = 0x4000;
+
+CNXDNConvolution::CNXDNConvolution() :
+m_oldMetrics(NULL),
+m_newMetrics(NULL),
+m_dp(NULL)
+{
+}
+
+CNXDNConvolution::~CNXDNConvolution()
+{
+}
+
+void CNXDNConvolution::start()
+{
+	::memset(m_metrics1, 0x00U, NUM_OF_STATES * sizeof(int16_t));
+	::memset(m_metrics2, 0x00U, NUM_OF_STATES * sizeof(int16_t));
+
+	m_oldMetrics = m_metrics1;
+	m_newMetrics = m_metrics2;
+	m_dp = m_decisions;
+}
+
+// Butterfly i takes states i and i + 8 to states 2i and 2i + 1, and its
+// branch metric is the distance of the symbols from the coded bits on
+// the branch. The first coded bit is a 0 for butterflies 0 to 3 and a 1
+// for 4 to 7, the second runs 0, 1, 1, 0 in both halves.
+#if defined(__SSE2__) || defined(_M_X64)
+void CNXDNConvolution::decode(uint8_t s0, uint8_t s1)
+{
+	assert((m_dp - m_decisions) < 300);
+
+	int16_t n0 = NXDN_SOFT_ONE - s0;
+	int16_t n1 = NXDN_SOFT_ONE - s1;
+
+	__m128i metric  = _mm_setr_epi16(s0 + s1, s0 + n1, s0 + n1, s0 + s1, n0 + s1, n0 + n1, n0 + n1, n0 + s1);
+	__m128i inverse = _mm_sub_epi16(_mm_set1_epi16(M), metric);
+
+	__m128i lo = _mm_loadu_si128((const __m128i*)(m_oldMetrics + 0U));
+	__m128i hi = _mm_loadu_si128((const __m128i*)(m_oldMetrics + NUM_OF_STATES_D2));
+
+	__m128i a = _mm_add_epi16(lo, metric);
+	__m128i b = _mm_add_epi16(hi, inverse);
+	__m128i c = _mm_add_epi16(lo, inverse);
+	__m128i d = _mm_add_epi16(hi, metric);
+
+	// Set where the path from the lower state wins, a decision of 0.
+	__m128i lower0 = _mm_cmpgt_epi16(b, a);
+	__m128i lower1 = _mm_cmpgt_epi16(d, c);
+
+	__m128i even = _mm_min_epi16(a, b);
+	__m128i odd  = _mm_min_epi16(c, d);
+
+	lo = _mm_unpacklo_epi16(even, odd);
+	hi = _mm_unpackhi_epi16(even, odd);
+
+	__m128i lower = _mm_packs_epi16(_mm_unpacklo_epi16(lower0, lower1), _mm_unpackhi_epi16(lower0, lower1));
+	uint16_t decisions = uint16_t(~_mm_movemask_epi8(lower));
+
+	if (int16_t(_mm_cvtsi128_si32(lo)) >= RENORMALISE) {
+		__m128i min = _mm_min_epi16(lo, hi);
+		min = _mm_min_epi16(min, _mm_shuffle_epi32(min, 0x4E));
+		min = _mm_min_epi16(min, _mm_shuffle_epi32(min, 0xB1));
+		min = _mm_min_epi16(min, _mm_shufflelo_epi16(min, 0xB1));
+		min = _mm_shuffle_epi32(_mm_shufflelo_epi16(min, 0x00), 0x00);
+
+		lo = _mm_sub_epi16(lo, min);
+		hi = _mm_sub_epi16(hi, min);
+	}
+
+	_mm_storeu_si128((__m128i*)(m_newMetrics + 0U), lo);
+	_mm_storeu_si128((__m128i*)(m_newMetrics + NUM_OF_STATES_D2), hi);
+
+	*m_dp++ = decisions;
+
+	int16_t* tmp = m_oldMetrics;
+	m_oldMetrics = m_newMetrics;
+	m_newMetrics = tmp;
+}
+#else
+const uint8_t BRANCH_TABLE1[] = {0U, 0U, 0U, 0U, 1U, 1U, 1U, 1U};
+const uint8_t BRANCH_TABLE2[] = {0U, 1U, 1U, 0U, 0U, 1U, 1U, 0U};
+
+void CNXDNConvolution::decode(uint8_t s0, uint8_t s1)
+{
+	assert((m_dp - m_decisions) < 300);
+
+	const int16_t distance0[] = { s0, int16_t(NXDN_SOFT_ONE - s0) };
+	const int16_t distance1[] = { s1, int16_t(NXDN_SOFT_ONE - s1) };
+
+	uint16_t decisions = 0U;
+
+	for (unsigned int i = 0U; i < NUM_OF_STATES_D2; i++) {
+		unsigned int j = i * 2U;
+
+		int16_t metric = distance0[BRANCH_TABLE1[i]] + distance1[BRANCH_TABLE2[i]];
+
+		int16_t m0 = m_oldMetrics[i] + metric;
+		int16_t m1 = m_oldMetrics[i + NUM_OF_STATES_D2] + (M - metric);
+		uint16_t decision0 = (m0 >= m1) ? 1U : 0U;
+		m_newMetrics[j + 0U] = decision0 != 0U ? m1 : m0;
+
+		m0 = m_oldMetrics[i] + (M - metric);
+		m1 = m_oldMetrics[i + NUM_OF_STATES_D2] + metric;
+		uint16_t decision1 = (m0 >= m1) ? 1U : 0U;
+		m_newMetrics[j + 1U] = decision1 != 0U ? m1 : m0;
+
+		decisions |= (decision1 << (j + 1U)) | (decision0 << (j + 0U));
+	}
+
+	if (m_newMetrics[0U] >= RENORMALISE) {
+		int16_t min = m_newMetrics[0U];
+		for (unsigned int i = 1U; i < NUM_OF_STATES; i++)
+			min = m_newMetrics[i] < min ? m_newMetrics[i] : min;
+
+		for (unsigned int i = 0U; i < NUM_OF_STATES; i++)
+			m_newMetrics[i] -= min;
+	}
+
+	*m_dp++ = decisions;
+
+	int16_t* tmp = m_oldMetrics;
+	m_oldMetrics = m_newMetrics;
+	m_newMetrics = tmp;
+}
+#endif
+
+void CNXDNConvolution::decode(const uint8_t* symbols, const uint8_t* map, unsigned char* out, unsigned int nBits)
+{
+	assert(symbols != NULL);
+	assert(map != NULL);
+	assert(out != NULL);
+	assert(nBits + K - 1U <= 300U);
+
+	start();
+
+	for (unsigned int i = 0U; i < nBits * 2U; i += 2U) {
+		uint8_t s0 = map[i + 0U] == NXDN_PUNCTURED ? NXDN_SOFT_ERASURE : symbols[map[i + 0U]];
+		uint8_t s1 = map[i + 1U] == NXDN_PUNCTURED ? NXDN_SOFT_ERASURE : symbols[map[i + 1U]];
+
+		decode(s0, s1);
+	}
+
+	// The decision for a bit is only made K - 1 steps later, these steps
+	// feed in the zeros that the encoder would send after the tail.
+	for (unsigned int i = 0U; i < K - 1U; i++)
+		decode(0U, 0U);
+
+	chainback(out, nBits);
+}
+
+void CNXDNConvolution::chainback(unsigned char* out, unsigned int nBits)
+{
+	assert(out != NULL);
+
+	uint32_t state = 0U;
+
+	while (nBits-- > 0) {
+		--m_dp;
+
+		uint32_t  i = state >> (9 - K);
+		uint8_t bit = uint8_t(*m_dp >> i) & 1;
+		state = (bit << 7) | (state >> 1);
+
+		WRITE_BIT1(out, nBits, bit != 0U);
+	}
+}
+
+void CNXDNConvolution::encode(const unsigned char* in, unsigned char* out, unsigned int nBits) const
+{
+	assert(in != NULL);
+	assert(out != NULL);
+	assert(nBits > 0U);
+
+	uint8_t d1 = 0U, d2 = 0U, d3 = 0U, d4 = 0U;
+	uint32_t k = 0U;
+	for (unsigned int i = 0U; i < nBits; i++) {
+		uint8_t d = READ_BIT1(in, i) ? 1U : 0U;
+
+		uint8_t g1 = (d + d3 + d4) & 1;
+		uint8_t g2 = (d + d1 + d2 + d4) & 1;
+
+		d4 = d3;
+		d3 = d2;
+		d2 = d1;
+		d1 = d;
+
+		WRITE_BIT1(out, k, g1 != 0U);
+		k++;
+
+		WRITE_BIT1(out, k, g2 != 0U);
+		k++;
+	}
+}
@@ -0,0 +1,82 @@
+/*
+ *   Copyright (C) 2015,2016,2018 by Jonathan Naylor G4KLX
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#if !defined(NXDNConvolution_H)
+#define  NXDNConvolution_H
+
+#include "ECCTables.h"
+
+#include <cstdint>
+
+// Soft symbols run from 0, a certain 0, to NXDN_SOFT_ONE, a certain 1.
+// Hard bits are given as one of the two ends, and bits removed by the
+// puncturing as NXDN_SOFT_ERASURE, which favours neither.
+const uint8_t NXDN_SOFT_ONE     = 254U;
+const uint8_t NXDN_SOFT_ERASURE = NXDN_SOFT_ONE / 2U;
+
+// Marks an erased position in a depuncturing map.
+const uint8_t NXDN_PUNCTURED = 0xFFU;
+
+class CNXDNConvolution {
+public:
+	CNXDNConvolution();
+	~CNXDNConvolution();
+
+	void start();
+	void decode(uint8_t s0, uint8_t s1);
+	void chainback(unsigned char* out, unsigned int nBits);
+
+	// Decodes a whole punctured block of nBits bits, tail included. Entry n
+	// of map is the index in symbols of coded bit n, or NXDN_PUNCTURED, so
+	// the deinterleaving and depuncturing are done as the symbols are read.
+	void decode(const uint8_t* symbols, const uint8_t* map, unsigned char* out, unsigned int nBits);
+
+	void encode(const unsigned char* in, unsigned char* out, unsigned int nBits) const;
+
+	// Builds the map for decode() from the interleaving table, giving the
+	// transmitted position of each coded bit left after puncturing, and the
+	// sorted list of the punctured positions.
+	template<unsigned int N>
+	static constexpr CECCTable<uint8_t, N> depunctureMap(const unsigned int* interleave, const unsigned int* puncture, unsigned int nPuncture)
+	{
+		CECCTable<uint8_t, N> map = {};
+
+		unsigned int n = 0U;
+		unsigned int index = 0U;
+		for (unsigned int i = 0U; i < N; i++) {
+			if (index < nPuncture && puncture[index] == i) {
+				map.m_data[i] = NXDN_PUNCTURED;
+				index++;
+			} else {
+				map.m_data[i] = uint8_t(interleave[n++]);
+			}
+		}
+
+		return map;
+	}
+
+private:
+	int16_t   m_metrics1[16U];
+	int16_t   m_metrics2[16U];
+	int16_t*  m_oldMetrics;
+	int16_t*  m_newMetrics;
+	uint16_t  m_decisions[300U];
+	uint16_t* m_dp;
+};
+
+#endif
@@ -0,0 +1,209 @@
+/*
+ *   Copyright (C) 2019 by Manuel Sanchez EA7EE
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "NXDNEndpoint.h"
+#include "AMBEFrame.h"
+#include "Defines.h"
+#include "Log.h"
+
+#include <cstdio>
+#include <cassert>
+#include <cstring>
+
+const unsigned int NXDN_FRAME_PER = 75U;
+
+// The LICH, SACCH and four voice frames of a network frame
+const unsigned int NXDN_NET_FRAME_LENGTH = 33U;
+
+const unsigned int NXDN_VCH_FRAMES = 4U;
+
+CNXDNEndpoint::CNXDNEndpoint(CNXDNNetwork* network, CNXDNLookup* lookup, unsigned int defaultId, unsigned int tg) :
+CEndpoint(MODE_NXDN, "NXDN", NXDN_VCH_FRAMES),
+m_network(network),
+m_lookup(lookup),
+m_defaultId(defaultId),
+m_tg(tg),
+m_lcCache(),
+m_watchdog(1000U, 0U, 1500U),
+m_txWatch(),
+m_rxActive(false),
+m_rxSrcId(0U),
+m_rxFrames(0U),
+m_txSrcId(0U),
+m_txCount(0U)
+{
+	assert(network != NULL);
+	assert(lookup != NULL);
+}
+
+CNXDNEndpoint::~CNXDNEndpoint()
+{
+	delete m_network;
+}
+
+bool CNXDNEndpoint::open()
+{
+	bool ret = m_network->open();
+	if (!ret)
+		return false;
+
+	m_txWatch.start();
+
+	return true;
+}
+
+void CNXDNEndpoint::close()
+{
+	m_network->close();
+}
+
+bool CNXDNEndpoint::hasCodec(HUB_CODEC codec) const
+{
+	return codec == HC_AMBE;
+}
+
+int CNXDNEndpoint::getFd() const
+{
+	return m_network->getFd();
+}
+
+void CNXDNEndpoint::clock(unsigned int ms)
+{
+	m_network->clock(ms);
+
+	readNetwork(ms);
+
+	if (m_txWatch.elapsed() > NXDN_FRAME_PER)
+		writeNetwork();
+}
+
+void CNXDNEndpoint::readNetwork(unsigned int ms)
+{
+	unsigned char buffer[NXDN_NET_FRAME_LENGTH];
+
+	while (m_network->read(buffer)) {
+		if ((buffer[0U] == 0x81U || buffer[0U] == 0x83U) && (buffer[5U] == 0x01U || buffer[5U] == 0x08U)) {
+			bool grp = (buffer[7U] & 0x20U) == 0x20U;
+
+			unsigned int srcId = (buffer[8U] << 8) | buffer[9U];
+			unsigned int dstId = (buffer[10U] << 8) | buffer[11U];
+
+			if (!grp || dstId != m_tg)
+				continue;
+
+			m_watchdog.start();
+
+			if (buffer[5U] == 0x01U) {
+				m_rxSrcId = srcId;
+				startCall(srcId, false);
+			} else if (m_rxActive) {
+				LogMessage("NXDN, received end of voice transmission, %.1f seconds", float(m_rxFrames) / 12.5F);
+				putEOT();
+				m_rxActive = false;
+				m_watchdog.stop();
+			}
+		} else {
+			if (!m_rxActive)
+				startCall(m_rxSrcId, true);
+
+			m_watchdog.start();
+
+			for (unsigned int i = 0U; i < NXDN_VCH_FRAMES; i++)
+				putAMBE(CAMBEFrame::decodeNXDN(buffer + 5U, i));
+
+			m_rxFrames++;
+		}
+	}
+
+	m_watchdog.clock(ms);
+	if (m_watchdog.isRunning() && m_watchdog.hasExpired()) {
+		if (m_rxActive) {
+			LogMessage("NXDN, network watchdog has expired, %.1f seconds", float(m_rxFrames) / 12.5F);
+			putEOT();
+			m_rxActive = false;
+		}
+
+		m_watchdog.stop();
+	}
+}
+
+void CNXDNEndpoint::startCall(unsigned int srcId, bool late)
+{
+	CHubCall call;
+	call.m_codec  = HC_AMBE;
+	call.m_mode   = MODE_NXDN;
+	call.m_source = m_lookup->findCS(srcId);
+	call.m_srcId  = srcId;
+	call.m_dstId  = m_tg;
+
+	LogMessage("NXDN, %s from %s to TG %u", late ? "late entry" : "received header", call.m_source.c_str(), m_tg);
+
+	putHeader(call);
+
+	m_rxActive = true;
+	m_rxFrames = 0U;
+}
+
+void CNXDNEndpoint::writeNetwork()
+{
+	CHubFrame frames[NXDN_VCH_FRAMES];
+	unsigned char buffer[NXDN_NET_FRAME_LENGTH];
+
+	unsigned int tag = getTx(frames);
+
+	if (tag == TAG_HEADER) {
+		m_txSrcId = findId(m_txCall);
+		m_txCount = 0U;
+
+		m_lcCache.writeHeader(buffer, m_txSrcId, m_tg);
+		m_network->write(buffer, false);
+
+		m_txWatch.start();
+	} else if (tag == TAG_EOT) {
+		m_lcCache.writeTerminator(buffer, m_txSrcId, m_tg);
+		m_network->write(buffer, false);
+
+		m_txWatch.start();
+	} else if (tag == TAG_DATA) {
+		::memset(buffer, 0x00U, NXDN_NET_FRAME_LENGTH);
+
+		m_lcCache.writeVoice(buffer, m_txCount, m_txSrcId, m_tg);
+
+		for (unsigned int i = 0U; i < NXDN_VCH_FRAMES; i++)
+			CAMBEFrame::encodeNXDN(frames[i].m_ambe, buffer + 5U, i);
+
+		m_network->write(buffer, false);
+
+		m_txCount++;
+		m_txWatch.start();
+	}
+}
+
+unsigned int CNXDNEndpoint::findId(const CHubCall& call) const
+{
+	if (call.m_mode == MODE_NXDN && call.m_srcId != 0U)
+		return call.m_srcId;
+
+	unsigned int id = m_lookup->findID(call.m_source);
+	if (id == 0U) {
+		LogMessage("NXDN, no id found for %s, using the default %u", call.m_source.c_str(), m_defaultId);
+		return m_defaultId;
+	}
+
+	return id;
+}
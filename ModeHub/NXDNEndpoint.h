@@ -0,0 +1,64 @@
+/*
+ *   Copyright (C) 2019 by Manuel Sanchez EA7EE
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#ifndef NXDNEndpoint_H
+#define NXDNEndpoint_H
+
+#include "Endpoint.h"
+#include "NXDNLCCache.h"
+#include "NXDNNetwork.h"
+#include "NXDNLookup.h"
+#include "StopWatch.h"
+#include "Timer.h"
+
+// An NXDNGateway, or MMDVMHost, using the Icom network protocol
+class CNXDNEndpoint : public CEndpoint {
+public:
+	CNXDNEndpoint(CNXDNNetwork* network, CNXDNLookup* lookup, unsigned int defaultId, unsigned int tg);
+	virtual ~CNXDNEndpoint();
+
+	virtual bool open();
+	virtual void close();
+
+	virtual bool hasCodec(HUB_CODEC codec) const;
+
+	virtual int getFd() const;
+
+	virtual void clock(unsigned int ms);
+
+private:
+	CNXDNNetwork* m_network;
+	CNXDNLookup*  m_lookup;
+	unsigned int  m_defaultId;
+	unsigned int  m_tg;
+	CNXDNLCCache  m_lcCache;
+	CTimer        m_watchdog;
+	CStopWatch    m_txWatch;
+	bool          m_rxActive;
+	unsigned int  m_rxSrcId;
+	unsigned int  m_rxFrames;
+	unsigned int  m_txSrcId;
+	unsigned int  m_txCount;
+
+	void readNetwork(unsigned int ms);
+	void writeNetwork();
+	void startCall(unsigned int srcId, bool late);
+	unsigned int findId(const CHubCall& call) const;
+};
+
+#endif
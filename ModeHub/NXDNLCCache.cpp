@@ -0,0 +1,155 @@
+/*
+ *   Copyright (C) 2019 by Manuel Sanchez EA7EE
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "NXDNLCCache.h"
+#include "NXDNDefines.h"
+#include "NXDNLayer3.h"
+#include "NXDNSACCH.h"
+#include "NXDNLICH.h"
+
+#include <cstdio>
+#include <cassert>
+#include <cstring>
+
+const unsigned char SACCH_STRUCTURE[] = { NXDN_SR_1_4, NXDN_SR_2_4, NXDN_SR_3_4, NXDN_SR_4_4 };
+
+CNXDNLCCache::CNXDNLCCache() :
+m_valid(false),
+m_srcId(0U),
+m_dstId(0U),
+m_hits(0U),
+m_misses(0U)
+{
+}
+
+CNXDNLCCache::~CNXDNLCCache()
+{
+}
+
+void CNXDNLCCache::writeHeader(unsigned char* data, unsigned int srcId, unsigned int dstId)
+{
+	assert(data != NULL);
+
+	update(srcId, dstId);
+
+	::memcpy(data, m_header, NXDN_LC_CACHE_HEADER_LENGTH);
+}
+
+void CNXDNLCCache::writeTerminator(unsigned char* data, unsigned int srcId, unsigned int dstId)
+{
+	assert(data != NULL);
+
+	update(srcId, dstId);
+
+	::memcpy(data, m_terminator, NXDN_LC_CACHE_HEADER_LENGTH);
+}
+
+void CNXDNLCCache::writeVoice(unsigned char* data, unsigned int n, unsigned int srcId, unsigned int dstId)
+{
+	assert(data != NULL);
+
+	update(srcId, dstId);
+
+	::memcpy(data, m_voice[n % 4U], NXDN_LC_CACHE_VOICE_LENGTH);
+}
+
+unsigned int CNXDNLCCache::getHits() const
+{
+	return m_hits;
+}
+
+unsigned int CNXDNLCCache::getMisses() const
+{
+	return m_misses;
+}
+
+void CNXDNLCCache::update(unsigned int srcId, unsigned int dstId)
+{
+	srcId &= 0xFFFFU;
+	dstId &= 0xFFFFU;
+
+	if (m_valid && m_srcId == srcId && m_dstId == dstId) {
+		m_hits++;
+		return;
+	}
+
+	m_srcId = srcId;
+	m_dstId = dstId;
+	m_valid = true;
+	m_misses++;
+
+	encodeHeader(m_header, NXDN_MESSAGE_TYPE_VCALL);
+	encodeHeader(m_terminator, NXDN_MESSAGE_TYPE_TX_REL);
+
+	CNXDNLICH lich;
+	lich.setRFCT(NXDN_LICH_RFCT_RDCH);
+	lich.setFCT(NXDN_LICH_USC_SACCH_SS);
+	lich.setOption(NXDN_LICH_STEAL_NONE);
+	lich.setDirection(NXDN_LICH_DIRECTION_INBOUND);
+	unsigned char raw = lich.getRaw();
+
+	CNXDNLayer3 layer3;
+	layer3.setMessageType(NXDN_MESSAGE_TYPE_VCALL);
+	layer3.setSourceUnitId(m_srcId);
+	layer3.setDestinationGroupId(m_dstId);
+	layer3.setGroup(true);
+	layer3.setDataBlocks(0U);
+
+	for (unsigned int i = 0U; i < 4U; i++) {
+		unsigned char message[3U];
+		layer3.encode(message, 18U, i * 18U);
+
+		CNXDNSACCH sacch;
+		sacch.setStructure(SACCH_STRUCTURE[i]);
+		sacch.setData(message);
+		sacch.setRAN(0x01U);
+
+		m_voice[i][0U] = raw;
+		sacch.getRaw(m_voice[i] + 1U);
+	}
+}
+
+void CNXDNLCCache::encodeHeader(unsigned char* data, unsigned char type) const
+{
+	assert(data != NULL);
+
+	CNXDNLICH lich;
+	lich.setRFCT(NXDN_LICH_RFCT_RDCH);
+	lich.setFCT(NXDN_LICH_USC_SACCH_NS);
+	lich.setOption(NXDN_LICH_STEAL_FACCH);
+	lich.setDirection(NXDN_LICH_DIRECTION_INBOUND);
+	data[0U] = lich.getRaw();
+
+	CNXDNSACCH sacch;
+	sacch.setRAN(0x01U);
+	sacch.setStructure(NXDN_SR_SINGLE);
+	sacch.setData(SACCH_IDLE);
+	sacch.getRaw(data + 1U);
+
+	unsigned char layer3data[25U];
+	CNXDNLayer3 layer3;
+	layer3.setMessageType(type);
+	layer3.setSourceUnitId(m_srcId);
+	layer3.setDestinationGroupId(m_dstId);
+	layer3.setGroup(true);
+	layer3.setDataBlocks(0U);
+	layer3.getData(layer3data);
+
+	::memcpy(data + 5U, layer3data, 14U);
+	::memcpy(data + 5U + 14U, layer3data, 14U);
+}
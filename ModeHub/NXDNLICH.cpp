@@ -0,0 +1,189 @@
+/*
+ *   Copyright (C) 2018 by Jonathan Naylor G4KLX
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "NXDNDefines.h"
+#include "NXDNLICH.h"
+
+#include "ECCTables.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cassert>
+#include <cstring>
+
+// On air each LICH bit is followed by a one, the 16 bits starting half way
+// through the third byte of the frame, straight after the frame sync word.
+static_assert(NXDN_FSW_LENGTH_BITS == 20U && NXDN_LICH_LENGTH_BITS == 16U, "the LICH is not where expected");
+
+static constexpr bool lichParity(unsigned int lich)
+{
+	return (lich & 0xF0U) == 0x80U || (lich & 0xF0U) == 0xB0U;
+}
+
+// The 16 bits sent for each LICH value, with its parity bit put right.
+static constexpr CECCTable<uint16_t, 256U> makeEncodeTable()
+{
+	CECCTable<uint16_t, 256U> table = {};
+
+	for (unsigned int lich = 0U; lich < 256U; lich++) {
+		unsigned int value = (lich & 0xFEU) | (lichParity(lich) ? 0x01U : 0x00U);
+
+		unsigned int word = 0U;
+		for (unsigned int i = 0U; i < 8U; i++)
+			word = (word << 2) | (((value >> (7U - i)) & 0x01U) << 1) | 0x01U;
+
+		table.m_data[lich] = uint16_t(word);
+	}
+
+	return table;
+}
+
+// The four LICH bits in a received byte, the ones in bits 7, 5, 3 and 1.
+static constexpr CECCTable<uint8_t, 256U> makeDecodeTable()
+{
+	CECCTable<uint8_t, 256U> table = {};
+
+	for (unsigned int byte = 0U; byte < 256U; byte++)
+		table.m_data[byte] = uint8_t(((byte >> 4) & 0x08U) | ((byte >> 3) & 0x04U) | ((byte >> 2) & 0x02U) | ((byte >> 1) & 0x01U));
+
+	return table;
+}
+
+static constexpr CECCTable<uint16_t, 256U> LICH_ENCODE_TABLE = makeEncodeTable();
+static constexpr CECCTable<uint8_t, 256U>  LICH_DECODE_TABLE = makeDecodeTable();
+
+static_assert(LICH_ENCODE_TABLE.checksum() == 0x51E9FD85U, "LICH_ENCODE_TABLE has changed");
+static_assert(LICH_DECODE_TABLE.checksum() == 0x57B57945U, "LICH_DECODE_TABLE has changed");
+
+CNXDNLICH::CNXDNLICH(const CNXDNLICH& lich) :
+m_lich(NULL)
+{
+	m_lich = new unsigned char[1U];
+	m_lich[0U] = lich.m_lich[0U];
+}
+
+CNXDNLICH::CNXDNLICH() :
+m_lich(NULL)
+{
+	m_lich = new unsigned char[1U];
+}
+
+CNXDNLICH::~CNXDNLICH()
+{
+	delete[] m_lich;
+}
+
+bool CNXDNLICH::decode(const unsigned char* bytes)
+{
+	assert(bytes != NULL);
+
+	unsigned int word = ((bytes[2U] & 0x0FU) << 12) | (bytes[3U] << 4) | (bytes[4U] >> 4);
+
+	m_lich[0U] = (LICH_DECODE_TABLE[word >> 8] << 4) | LICH_DECODE_TABLE[word & 0xFFU];
+
+	bool newParity  = getParity();
+	bool origParity = (m_lich[0U] & 0x01U) == 0x01U;
+
+	return origParity == newParity;
+}
+
+void CNXDNLICH::encode(unsigned char* bytes)
+{
+	assert(bytes != NULL);
+
+	unsigned int word = LICH_ENCODE_TABLE[m_lich[0U]];
+
+	m_lich[0U] = (m_lich[0U] & 0xFEU) | ((word >> 1) & 0x01U);
+
+	bytes[2U] = (bytes[2U] & 0xF0U) | (word >> 12);
+	bytes[3U] = (word >> 4) & 0xFFU;
+	bytes[4U] = (bytes[4U] & 0x0FU) | ((word << 4) & 0xF0U);
+}
+
+unsigned char CNXDNLICH::getRFCT() const
+{
+	return (m_lich[0U] >> 6) & 0x03U;
+}
+
+unsigned char CNXDNLICH::getFCT() const
+{
+	return (m_lich[0U] >> 4) & 0x03U;
+}
+
+unsigned char CNXDNLICH::getOption() const
+{
+	return (m_lich[0U] >> 2) & 0x03U;
+}
+
+unsigned char CNXDNLICH::getDirection() const
+{
+	return (m_lich[0U] >> 1) & 0x01U;
+}
+
+unsigned char CNXDNLICH::getRaw() const
+{
+	bool parity = getParity();
+	if (parity)
+		m_lich[0U] |= 0x01U;
+	else
+		m_lich[0U] &= 0xFEU;
+
+	return m_lich[0U];
+}
+
+void CNXDNLICH::setRFCT(unsigned char rfct)
+{
+	m_lich[0U] &= 0x3FU;
+	m_lich[0U] |= (rfct << 6) & 0xC0U;
+}
+
+void CNXDNLICH::setFCT(unsigned char usc)
+{
+	m_lich[0U] &= 0xCFU;
+	m_lich[0U] |= (usc << 4) & 0x30U;
+}
+
+void CNXDNLICH::setOption(unsigned char option)
+{
+	m_lich[0U] &= 0xF3U;
+	m_lich[0U] |= (option << 2) & 0x0CU;
+}
+
+void CNXDNLICH::setDirection(unsigned char direction)
+{
+	m_lich[0U] &= 0xFDU;
+	m_lich[0U] |= (direction << 1) & 0x02U;
+}
+
+void CNXDNLICH::setRaw(unsigned char lich)
+{
+	m_lich[0U] = lich;
+}
+
+CNXDNLICH& CNXDNLICH::operator=(const CNXDNLICH& lich)
+{
+	if (&lich != this)
+		m_lich[0U] = lich.m_lich[0U];
+
+	return *this;
+}
+
+bool CNXDNLICH::getParity() const
+{
+	return (LICH_ENCODE_TABLE[m_lich[0U]] & 0x02U) == 0x02U;
+}
@@ -0,0 +1,254 @@
+/*
+ *   Copyright (C) 2019 by Manuel Sanchez EA7EE
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "P25Endpoint.h"
+#include "Defines.h"
+#include "Log.h"
+
+#include <cstdio>
+#include <cassert>
+#include <cstring>
+
+const unsigned int P25_FRAME_PER = 15U;
+
+const unsigned char REC80[] = {
+	0x80U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U};
+
+CP25Endpoint::CP25Endpoint(CP25Network* network, CDMRLookup* lookup, unsigned int defaultId, unsigned int tg) :
+CEndpoint(MODE_P25, "P25", 1U),
+m_network(network),
+m_lookup(lookup),
+m_defaultId(defaultId),
+m_tg(tg),
+m_watchdog(1000U, 0U, 1500U),
+m_txWatch(),
+m_rxActive(false),
+m_rxStarted(false),
+m_rxDstId(0U),
+m_rxFrames(0U),
+m_rxHeld(NULL),
+m_rxHeldN(0U),
+m_txSrcId(0U),
+m_txCount(0U),
+m_records(NULL),
+m_ldu(NULL),
+m_lduCount(0U),
+m_lduLength(0U)
+{
+	assert(network != NULL);
+	assert(lookup != NULL);
+
+	m_rxHeld  = new unsigned char[P25_LDU_RECORDS * IMBE_FRAME_LENGTH];
+	m_records = new unsigned char[P25_LDU_RECORDS * P25_LDU_RECORD_MAX_LENGTH];
+	m_ldu     = new unsigned char[(P25_LDU_FRAMES + 1U) * P25_LDU_RECORD_MAX_LENGTH];
+}
+
+CP25Endpoint::~CP25Endpoint()
+{
+	delete m_network;
+	delete[] m_rxHeld;
+	delete[] m_records;
+	delete[] m_ldu;
+}
+
+bool CP25Endpoint::open()
+{
+	bool ret = m_network->open();
+	if (!ret)
+		return false;
+
+	m_txWatch.start();
+
+	return true;
+}
+
+void CP25Endpoint::close()
+{
+	m_network->close();
+}
+
+bool CP25Endpoint::hasCodec(HUB_CODEC codec) const
+{
+	return codec == HC_IMBE;
+}
+
+int CP25Endpoint::getFd() const
+{
+	return m_network->getFd();
+}
+
+void CP25Endpoint::clock(unsigned int ms)
+{
+	readNetwork(ms);
+
+	if (m_txWatch.elapsed() > P25_FRAME_PER)
+		writeNetwork();
+}
+
+void CP25Endpoint::readNetwork(unsigned int ms)
+{
+	unsigned int lengths[P25_LDU_RECORDS];
+	unsigned int records;
+
+	while ((records = m_network->readLDU(m_records, lengths, P25_LDU_RECORDS)) > 0U) {
+		for (unsigned int i = 0U; i < records; i++) {
+			const unsigned char* data = m_records + i * P25_LDU_RECORD_MAX_LENGTH;
+
+			if (data[0U] == 0xF0U || data[0U] == 0xF1U)
+				continue;
+
+			if (data[0U] == 0x80U) {
+				if (m_rxActive) {
+					LogMessage("P25, received end of voice transmission, %.1f seconds", float(m_rxFrames) / 50.0F);
+					putEOT();
+				}
+
+				m_rxActive  = false;
+				m_rxStarted = false;
+				m_rxHeldN   = 0U;
+				m_watchdog.stop();
+				continue;
+			}
+
+			const CP25Record* record = CP25LDU::find(data[0U]);
+			if (record == NULL)
+				continue;
+
+			m_watchdog.start();
+
+			if (m_rxActive) {
+				putIMBE(data + record->m_imbe);
+				m_rxFrames++;
+				continue;
+			}
+
+			// The source is only known from the fifth record of an LDU1, so
+			// the frames before it are held back until the call can start.
+			if (record->m_start)
+				m_rxStarted = true;
+
+			if (record->m_lc == P25_RECORD_LC_DSTID)
+				m_rxDstId = CP25LDU::getId(data);
+
+			::memcpy(m_rxHeld + m_rxHeldN * IMBE_FRAME_LENGTH, data + record->m_imbe, IMBE_FRAME_LENGTH);
+			m_rxHeldN++;
+
+			if (record->m_lc == P25_RECORD_LC_SRCID)
+				startCall(CP25LDU::getId(data));
+			else if (m_rxHeldN == P25_LDU_RECORDS)
+				startCall(0U);
+		}
+	}
+
+	m_watchdog.clock(ms);
+	if (m_watchdog.isRunning() && m_watchdog.hasExpired()) {
+		if (m_rxActive) {
+			LogMessage("P25, network watchdog has expired, %.1f seconds", float(m_rxFrames) / 50.0F);
+			putEOT();
+		}
+
+		m_rxActive  = false;
+		m_rxStarted = false;
+		m_rxHeldN   = 0U;
+		m_watchdog.stop();
+	}
+}
+
+void CP25Endpoint::startCall(unsigned int srcId)
+{
+	CHubCall call;
+	call.m_codec  = HC_IMBE;
+	call.m_mode   = MODE_P25;
+	call.m_source = m_lookup->findCS(srcId);
+	call.m_srcId  = srcId;
+	call.m_dstId  = m_rxDstId;
+
+	LogMessage("P25, %s from %s to TG %u", m_rxStarted ? "received audio" : "late entry", call.m_source.c_str(), m_rxDstId);
+
+	putHeader(call);
+
+	for (unsigned int i = 0U; i < m_rxHeldN; i++)
+		putIMBE(m_rxHeld + i * IMBE_FRAME_LENGTH);
+
+	m_rxActive = true;
+	m_rxFrames = m_rxHeldN;
+	m_rxHeldN  = 0U;
+}
+
+void CP25Endpoint::writeNetwork()
+{
+	CHubFrame frame;
+
+	unsigned int tag = getTx(&frame);
+
+	if (tag == TAG_HEADER) {
+		m_txSrcId = findId(m_txCall);
+		m_txCount = 0U;
+
+		// Anything left of a previous call goes first
+		writeLDU();
+
+		m_txWatch.start();
+	} else if (tag == TAG_EOT) {
+		// The terminator goes out with the rest of the last LDU
+		::memcpy(m_ldu + m_lduLength, REC80, 17U);
+		m_lduLengths[m_lduCount++] = 17U;
+		m_lduLength += 17U;
+		writeLDU();
+
+		m_txWatch.start();
+	} else if (tag == TAG_DATA) {
+		unsigned int n = m_txCount % P25_LDU_RECORDS;
+		unsigned int length = CP25LDU::encode(n, frame.m_imbe, m_txSrcId, m_tg, m_ldu + m_lduLength);
+		m_lduLengths[m_lduCount++] = length;
+		m_lduLength += length;
+
+		// Each LDU is sent once its last record is in
+		if ((n % P25_LDU_FRAMES) == (P25_LDU_FRAMES - 1U))
+			writeLDU();
+
+		m_txCount++;
+		m_txWatch.start();
+	}
+}
+
+void CP25Endpoint::writeLDU()
+{
+	if (m_lduCount == 0U)
+		return;
+
+	m_network->writeLDU(m_ldu, m_lduLengths, m_lduCount);
+
+	m_lduCount  = 0U;
+	m_lduLength = 0U;
+}
+
+unsigned int CP25Endpoint::findId(const CHubCall& call) const
+{
+	// P25 shares the DMR id space
+	if ((call.m_mode == MODE_P25 || call.m_mode == MODE_DMR) && call.m_srcId != 0U)
+		return call.m_srcId;
+
+	unsigned int id = m_lookup->findID(call.m_source);
+	if (id == 0U) {
+		LogMessage("P25, no id found for %s, using the default %u", call.m_source.c_str(), m_defaultId);
+		return m_defaultId;
+	}
+
+	return id;
+}
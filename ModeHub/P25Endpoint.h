@@ -0,0 +1,72 @@
+/*
+ *   Copyright (C) 2019 by Manuel Sanchez EA7EE
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#ifndef P25Endpoint_H
+#define P25Endpoint_H
+
+#include "Endpoint.h"
+#include "P25Network.h"
+#include "DMRLookup.h"
+#include "P25LDU.h"
+#include "StopWatch.h"
+#include "Timer.h"
+
+// A P25Gateway, or MMDVMHost, exchanging LDU voice records
+class CP25Endpoint : public CEndpoint {
+public:
+	CP25Endpoint(CP25Network* network, CDMRLookup* lookup, unsigned int defaultId, unsigned int tg);
+	virtual ~CP25Endpoint();
+
+	virtual bool open();
+	virtual void close();
+
+	virtual bool hasCodec(HUB_CODEC codec) const;
+
+	virtual int getFd() const;
+
+	virtual void clock(unsigned int ms);
+
+private:
+	CP25Network*   m_network;
+	CDMRLookup*    m_lookup;
+	unsigned int   m_defaultId;
+	unsigned int   m_tg;
+	CTimer         m_watchdog;
+	CStopWatch     m_txWatch;
+	bool           m_rxActive;
+	bool           m_rxStarted;
+	unsigned int   m_rxDstId;
+	unsigned int   m_rxFrames;
+	unsigned char* m_rxHeld;
+	unsigned int   m_rxHeldN;
+	unsigned int   m_txSrcId;
+	unsigned int   m_txCount;
+	unsigned char* m_records;
+	unsigned char* m_ldu;
+	unsigned int   m_lduLengths[P25_LDU_FRAMES + 1U];
+	unsigned int   m_lduCount;
+	unsigned int   m_lduLength;
+
+	void readNetwork(unsigned int ms);
+	void writeNetwork();
+	void writeLDU();
+	void startCall(unsigned int srcId);
+	unsigned int findId(const CHubCall& call) const;
+};
+
+#endif
@@ -0,0 +1,141 @@
+/*
+ *   Copyright (C) 2019 by Manuel Sanchez EA7EE
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "P25LDU.h"
+
+#include <cstdio>
+#include <cassert>
+#include <cstring>
+
+const unsigned char REC62[] = {
+	0x62U, 0x02U, 0x02U, 0x0CU, 0x0BU, 0x12U, 0x64U, 0x00U, 0x00U, 0x80U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U,
+	0x00U, 0x00U, 0x00U, 0x00U, 0x00U};
+
+const unsigned char REC63[] = {
+	0x63U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x02U};
+
+const unsigned char REC64[] = {
+	0x64U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x02U};
+
+const unsigned char REC65[] = {
+	0x65U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x02U};
+
+const unsigned char REC66[] = {
+	0x66U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x02U};
+
+const unsigned char REC67[] = {
+	0x67U, 0xF0U, 0x9DU, 0x6AU, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x02U};
+
+const unsigned char REC68[] = {
+	0x68U, 0x19U, 0xD4U, 0x26U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x02U};
+
+const unsigned char REC69[] = {
+	0x69U, 0xE0U, 0xEBU, 0x7BU, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x02U};
+
+const unsigned char REC6A[] = {
+	0x6AU, 0x00U, 0x00U, 0x02U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U};
+
+const unsigned char REC6B[] = {
+	0x6BU, 0x02U, 0x02U, 0x0CU, 0x0BU, 0x12U, 0x64U, 0x00U, 0x00U, 0x80U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U,
+	0x00U, 0x00U, 0x00U, 0x00U, 0x00U};
+
+const unsigned char REC6C[] = {
+	0x6CU, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x02U};
+
+const unsigned char REC6D[] = {
+	0x6DU, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x02U};
+
+const unsigned char REC6E[] = {
+	0x6EU, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x02U};
+
+const unsigned char REC6F[] = {
+	0x6FU, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x02U};
+
+// The algorithm id is set to 0x80, unencrypted
+const unsigned char REC70[] = {
+	0x70U, 0x80U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x02U};
+
+const unsigned char REC71[] = {
+	0x71U, 0xACU, 0xB8U, 0xA4U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x02U};
+
+const unsigned char REC72[] = {
+	0x72U, 0x9BU, 0xDCU, 0x75U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x02U};
+
+const unsigned char REC73[] = {
+	0x73U, 0x00U, 0x00U, 0x02U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U};
+
+// The record types are consecutive, so a record is found by its type
+// less that of the first one.
+const unsigned char P25_LDU_FIRST_TYPE = 0x62U;
+
+const CP25Record P25_LDU[P25_LDU_RECORDS] = {
+	{22U, 10U, true,  P25_RECORD_LC_NONE,  REC62},
+	{14U, 1U,  false, P25_RECORD_LC_NONE,  REC63},
+	{17U, 5U,  false, P25_RECORD_LC_NONE,  REC64},
+	{17U, 5U,  false, P25_RECORD_LC_DSTID, REC65},
+	{17U, 5U,  false, P25_RECORD_LC_SRCID, REC66},
+	{17U, 5U,  false, P25_RECORD_LC_NONE,  REC67},
+	{17U, 5U,  false, P25_RECORD_LC_NONE,  REC68},
+	{17U, 5U,  false, P25_RECORD_LC_NONE,  REC69},
+	{16U, 4U,  false, P25_RECORD_LC_NONE,  REC6A},
+	{22U, 10U, false, P25_RECORD_LC_NONE,  REC6B},
+	{14U, 1U,  false, P25_RECORD_LC_NONE,  REC6C},
+	{17U, 5U,  false, P25_RECORD_LC_NONE,  REC6D},
+	{17U, 5U,  false, P25_RECORD_LC_NONE,  REC6E},
+	{17U, 5U,  false, P25_RECORD_LC_NONE,  REC6F},
+	{17U, 5U,  false, P25_RECORD_LC_NONE,  REC70},
+	{17U, 5U,  false, P25_RECORD_LC_NONE,  REC71},
+	{17U, 5U,  false, P25_RECORD_LC_NONE,  REC72},
+	{16U, 4U,  false, P25_RECORD_LC_NONE,  REC73}};
+
+const CP25Record* CP25LDU::find(unsigned char type)
+{
+	unsigned int n = (unsigned char)(type - P25_LDU_FIRST_TYPE);
+	if (n >= P25_LDU_RECORDS)
+		return NULL;
+
+	return &P25_LDU[n];
+}
+
+unsigned int CP25LDU::getId(const unsigned char* data)
+{
+	assert(data != NULL);
+
+	return (data[1U] << 16) | (data[2U] << 8) | (data[3U] << 0);
+}
+
+unsigned int CP25LDU::encode(unsigned int n, const unsigned char* imbe, unsigned int srcId, unsigned int dstId, unsigned char* data)
+{
+	assert(n < P25_LDU_RECORDS);
+	assert(imbe != NULL);
+	assert(data != NULL);
+
+	const CP25Record& record = P25_LDU[n];
+
+	::memcpy(data, record.m_template, record.m_length);
+	::memcpy(data + record.m_imbe, imbe, P25_IMBE_LENGTH_BYTES);
+
+	if (record.m_lc != P25_RECORD_LC_NONE) {
+		unsigned int id = record.m_lc == P25_RECORD_LC_DSTID ? dstId : srcId;
+		data[1U] = (id >> 16) & 0xFFU;
+		data[2U] = (id >> 8) & 0xFFU;
+		data[3U] = (id >> 0) & 0xFFU;
+	}
+
+	return record.m_length;
+}
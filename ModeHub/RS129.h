@@ -16,17 +16,15 @@
  *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
  */
 
-#ifndef QR1676_H
-#define QR1676_H
+#if !defined(RS129_H)
+#define	RS129_H
 
-class CQR1676 {
+class CRS129
+{
 public:
-	static void encode(unsigned char* data);
+	static bool check(const unsigned char* in);
 
-	static unsigned char decode(const unsigned char* data);
-
-private:
-	static unsigned int getSyndrome1576(unsigned int pattern);
+	static void encode(const unsigned char* msg, unsigned int nbytes, unsigned char* parity);
 };
 
 #endif
@@ -1,5 +1,6 @@
 /*
- *   Copyright (C) 2015 by Jonathan Naylor G4KLX
+ *   Copyright (C) 2015,2016 by Jonathan Naylor G4KLX
+ *   Copyright (C) 2018 by Andy Uribe CA6JAU
  *
  *   This program is free software; you can redistribute it and/or modify
  *   it under the terms of the GNU General Public License as published by
@@ -16,17 +17,20 @@
  *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
  */
 
-#ifndef Golay2087_H
-#define Golay2087_H
+#if !defined(SYNC_H)
+#define	SYNC_H
 
-class CGolay2087 {
+class CSync
+{
 public:
-	static void encode(unsigned char* data);
+	static void addDMRDataSync(unsigned char* data, bool duplex);
+	static void addDMRAudioSync(unsigned char* data, bool duplex);
 
-	static unsigned char decode(const unsigned char* data);
+	static void addNXDNSync(unsigned char* data);
+
+	static void addYSFSync(unsigned char* data);
 
 private:
-	static unsigned int getSyndrome1987(unsigned int pattern);
 };
 
 #endif
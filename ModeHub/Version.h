@@ -1,5 +1,5 @@
 /*
- *   Copyright (C) 2015 by Jonathan Naylor G4KLX
+ *   Copyright (C) 2019 by Manuel Sanchez EA7EE
  *
  *   This program is free software; you can redistribute it and/or modify
  *   it under the terms of the GNU General Public License as published by
@@ -16,17 +16,9 @@
  *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
  */
 
-#ifndef QR1676_H
-#define QR1676_H
+#if !defined(VERSION_H)
+#define	VERSION_H
 
-class CQR1676 {
-public:
-	static void encode(unsigned char* data);
-
-	static unsigned char decode(const unsigned char* data);
-
-private:
-	static unsigned int getSyndrome1576(unsigned int pattern);
-};
+const char* VERSION = "20191020";
 
 #endif
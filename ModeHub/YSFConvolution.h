@@ -16,28 +16,32 @@
  *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
  */
 
-#ifndef	Hamming_H
-#define	Hamming_H
+#if !defined(YSFConvolution_H)
+#define  YSFConvolution_H
 
-class CHamming {
-public:
-	static void encode15113_1(bool* d);
-	static bool decode15113_1(bool* d);
-
-	static void encode15113_2(bool* d);
-	static bool decode15113_2(bool* d);
-
-	static void encode1393(bool* d);
-	static bool decode1393(bool* d);
+#include "YSFConvolution.h"
 
-	static void encode1063(bool* d);
-	static bool decode1063(bool* d);
+#include <cstdint>
 
-	static void encode16114(bool* d);
-	static bool decode16114(bool* d);
-
-	static void encode17123(bool* d);
-	static bool decode17123(bool* d);
+class CYSFConvolution {
+public:
+	CYSFConvolution();
+	~CYSFConvolution();
+
+	void start();
+	void decode(uint8_t s0, uint8_t s1);
+	void chainback(unsigned char* out, unsigned int nBits);
+
+	void encode(const unsigned char* in, unsigned char* out, unsigned int nBits) const;
+
+private:
+	uint16_t* m_metrics1;
+	uint16_t* m_metrics2;
+	uint16_t* m_oldMetrics;
+	uint16_t* m_newMetrics;
+	uint64_t* m_decisions;
+	uint64_t* m_dp;
 };
 
 #endif
+
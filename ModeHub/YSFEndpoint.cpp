@@ -0,0 +1,325 @@
+/*
+ *   Copyright (C) 2019 by Manuel Sanchez EA7EE
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "YSFEndpoint.h"
+#include "AMBEFrame.h"
+#include "YSFPayload.h"
+#include "YSFFICH.h"
+#include "Defines.h"
+#include "Sync.h"
+#include "Log.h"
+
+#include <cstdio>
+#include <cassert>
+#include <cstring>
+
+const unsigned int YSF_FRAME_PER = 90U;
+
+// The frames of one YSF network frame, five VCHs
+const unsigned int YSF_VCH_FRAMES = 5U;
+
+// DT1 and DT2 without GPS info
+const unsigned char DT1_TEMP[] = {0x31, 0x22, 0x62, 0x5F, 0x29, 0x00, 0x00, 0x00, 0x00, 0x00};
+const unsigned char DT2_TEMP[] = {0x00, 0x00, 0x00, 0x00, 0x6C, 0x20, 0x1C, 0x20, 0x03, 0x08};
+
+CYSFEndpoint::CYSFEndpoint(CYSFNetwork* network) :
+CEndpoint(MODE_YSF, "YSF", YSF_VCH_FRAMES),
+m_network(network),
+m_dchCache(),
+m_watchdog(1000U, 0U, 1500U),
+m_txWatch(),
+m_pollTimer(1000U, 5U),
+m_rxActive(false),
+m_rxCodec(HC_AMBE),
+m_rxFrames(0U),
+m_txCount(0U),
+m_txSource(),
+m_buffer(NULL)
+{
+	assert(network != NULL);
+
+	m_buffer = new unsigned char[200U];
+	::memset(m_buffer, 0x00U, 200U);
+}
+
+CYSFEndpoint::~CYSFEndpoint()
+{
+	delete m_network;
+	delete[] m_buffer;
+}
+
+bool CYSFEndpoint::open()
+{
+	bool ret = m_network->open();
+	if (!ret)
+		return false;
+
+	m_txWatch.start();
+	m_pollTimer.start();
+
+	return true;
+}
+
+void CYSFEndpoint::close()
+{
+	m_network->close();
+}
+
+bool CYSFEndpoint::hasCodec(HUB_CODEC) const
+{
+	return true;
+}
+
+int CYSFEndpoint::getFd() const
+{
+	return m_network->getFd();
+}
+
+void CYSFEndpoint::clock(unsigned int ms)
+{
+	m_network->clock(ms);
+
+	readNetwork(ms);
+
+	if (m_txWatch.elapsed() > YSF_FRAME_PER)
+		writeNetwork();
+
+	m_pollTimer.clock(ms);
+	if (m_pollTimer.isRunning() && m_pollTimer.hasExpired()) {
+		m_network->writePoll();
+		m_pollTimer.start();
+	}
+}
+
+void CYSFEndpoint::readNetwork(unsigned int ms)
+{
+	unsigned char buffer[200U];
+
+	while (m_network->read(buffer) > 0U) {
+		if (::memcmp(buffer, "YSFD", 4U) != 0)
+			continue;
+
+		CYSFFICH fich;
+		bool valid = fich.decode(buffer + 35U);
+		if (!valid)
+			continue;
+
+		unsigned char fi = fich.getFI();
+		unsigned char dt = fich.getDT();
+
+		HUB_CODEC codec;
+		if (dt == YSF_DT_VD_MODE2)
+			codec = HC_AMBE;
+		else if (dt == YSF_DT_VOICE_FR_MODE)
+			codec = HC_IMBE;
+		else
+			continue;
+
+		m_watchdog.start();
+
+		if (fi == YSF_FI_HEADER) {
+			CYSFPayload payload;
+			if (payload.processHeaderData(buffer + 35U)) {
+				LogMessage("YSF, received header from %s to %s", payload.getSource().c_str(), payload.getDest().c_str());
+				startCall(payload.getSource(), codec, false);
+			}
+		} else if (fi == YSF_FI_TERMINATOR) {
+			if (m_rxActive) {
+				LogMessage("YSF, received end of voice transmission, %.1f seconds", float(m_rxFrames) / 10.0F);
+				putEOT();
+				m_rxActive = false;
+			}
+
+			m_watchdog.stop();
+		} else if (fi == YSF_FI_COMMUNICATIONS) {
+			if (!m_rxActive || m_rxCodec != codec)
+				startCall(std::string((const char*)(buffer + 14U), YSF_CALLSIGN_LENGTH), codec, true);
+
+			const unsigned char* data = buffer + 35U + YSF_SYNC_LENGTH_BYTES + YSF_FICH_LENGTH_BYTES;
+
+			for (unsigned int j = 0U; j < YSF_VCH_FRAMES; j++) {
+				if (codec == HC_AMBE) {
+					putAMBE(CAMBEFrame::decodeYSF(data + 5U + j * 18U));
+				} else {
+					unsigned char imbe[IMBE_FRAME_LENGTH];
+					CIMBEFrame::decodeYSF(data + j * 18U, imbe);
+					putIMBE(imbe);
+				}
+			}
+
+			m_rxFrames++;
+		}
+	}
+
+	m_watchdog.clock(ms);
+	if (m_watchdog.isRunning() && m_watchdog.hasExpired()) {
+		if (m_rxActive) {
+			LogMessage("YSF, network watchdog has expired, %.1f seconds", float(m_rxFrames) / 10.0F);
+			putEOT();
+			m_rxActive = false;
+		}
+
+		m_watchdog.stop();
+	}
+}
+
+void CYSFEndpoint::startCall(const std::string& source, HUB_CODEC codec, bool late)
+{
+	// The other modes only know the callsign, without any suffix
+	std::string callsign = source;
+	std::string::size_type pos = callsign.find_first_of("-/ ");
+	if (pos != std::string::npos)
+		callsign.resize(pos);
+	if (callsign.empty())
+		callsign = "N0CALL";
+
+	if (late)
+		LogMessage("YSF, late entry from %s", callsign.c_str());
+
+	CHubCall call;
+	call.m_codec  = codec;
+	call.m_mode   = MODE_YSF;
+	call.m_source = callsign;
+	call.m_srcId  = 0U;
+	call.m_dstId  = 0U;
+	putHeader(call);
+
+	m_rxActive = true;
+	m_rxCodec  = codec;
+	m_rxFrames = 0U;
+}
+
+void CYSFEndpoint::writeNetwork()
+{
+	CHubFrame frames[YSF_VCH_FRAMES];
+
+	unsigned int tag = getTx(frames);
+
+	if (tag == TAG_HEADER) {
+		m_txSource = m_txCall.m_source;
+		m_txSource.resize(YSF_CALLSIGN_LENGTH, ' ');
+
+		writeHeaderFrame(YSF_FI_HEADER);
+
+		m_txCount = 1U;
+		m_txWatch.start();
+	} else if (tag == TAG_EOT) {
+		writeHeaderFrame(YSF_FI_TERMINATOR);
+
+		m_txWatch.start();
+	} else if (tag == TAG_DATA) {
+		bool vd2 = m_txCall.m_codec == HC_AMBE;
+
+		unsigned int fn = vd2 ? (m_txCount - 1U) % 8U : 0U;
+
+		::memcpy(m_buffer + 0U, "YSFD", 4U);
+		::memcpy(m_buffer + 4U, m_network->getCallsign().c_str(), YSF_CALLSIGN_LENGTH);
+		::memcpy(m_buffer + 14U, m_txSource.c_str(), YSF_CALLSIGN_LENGTH);
+		::memcpy(m_buffer + 24U, "ALL       ", YSF_CALLSIGN_LENGTH);
+
+		// Add the YSF Sync
+		CSync::addYSFSync(m_buffer + 35U);
+
+		unsigned char* data = m_buffer + 35U + YSF_SYNC_LENGTH_BYTES + YSF_FICH_LENGTH_BYTES;
+
+		if (vd2) {
+			switch (fn) {
+				case 0:
+					m_dchCache.writeVDMode2Data(m_buffer + 35U, fn, (const unsigned char*)"**********");
+					break;
+				case 1:
+					m_dchCache.writeVDMode2Data(m_buffer + 35U, fn, (const unsigned char*)m_txSource.c_str());
+					break;
+				case 2:
+					m_dchCache.writeVDMode2Data(m_buffer + 35U, fn, (const unsigned char*)"ALL       ");
+					break;
+				case 6:
+					m_dchCache.writeVDMode2Data(m_buffer + 35U, fn, DT1_TEMP);
+					break;
+				case 7:
+					m_dchCache.writeVDMode2Data(m_buffer + 35U, fn, DT2_TEMP);
+					break;
+				default:
+					m_dchCache.writeVDMode2Data(m_buffer + 35U, fn, (const unsigned char*)"          ");
+			}
+
+			for (unsigned int j = 0U; j < YSF_VCH_FRAMES; j++)
+				CAMBEFrame::encodeYSF(frames[j].m_ambe, data + 5U + j * 18U);
+		} else {
+			for (unsigned int j = 0U; j < YSF_VCH_FRAMES; j++)
+				CIMBEFrame::encodeYSF(frames[j].m_imbe, data + j * 18U);
+		}
+
+		// Set the FICH
+		CYSFFICH fich;
+		fich.setFI(YSF_FI_COMMUNICATIONS);
+		fich.setCS(2U);
+		fich.setFN(fn);
+		fich.setFT(7U);
+		fich.setDev(0U);
+		fich.setMR(YSF_MR_BUSY);
+		fich.setDT(vd2 ? YSF_DT_VD_MODE2 : YSF_DT_VOICE_FR_MODE);
+		fich.setSQL(0U);
+		fich.setSQ(0U);
+		fich.encode(m_buffer + 35U);
+
+		// Net frame counter
+		m_buffer[34U] = (m_txCount & 0x7FU) << 1;
+
+		m_network->write(m_buffer);
+
+		m_txCount++;
+		m_txWatch.start();
+	}
+}
+
+void CYSFEndpoint::writeHeaderFrame(unsigned char fi)
+{
+	::memcpy(m_buffer + 0U, "YSFD", 4U);
+	::memcpy(m_buffer + 4U, m_network->getCallsign().c_str(), YSF_CALLSIGN_LENGTH);
+	::memcpy(m_buffer + 14U, m_txSource.c_str(), YSF_CALLSIGN_LENGTH);
+	::memcpy(m_buffer + 24U, "ALL       ", YSF_CALLSIGN_LENGTH);
+
+	// Net frame counter, with the end of stream flag on the terminator
+	m_buffer[34U] = (fi == YSF_FI_TERMINATOR) ? (((m_txCount & 0x7FU) << 1) | 0x01U) : 0x00U;
+
+	CSync::addYSFSync(m_buffer + 35U);
+
+	// Set the FICH
+	CYSFFICH fich;
+	fich.setFI(fi);
+	fich.setCS(2U);
+	fich.setFN(0U);
+	fich.setFT(7U);
+	fich.setDev(0U);
+	fich.setMR(2U);
+	fich.setDT(m_txCall.m_codec == HC_AMBE ? YSF_DT_VD_MODE2 : YSF_DT_VOICE_FR_MODE);
+	fich.setSQL(0U);
+	fich.setSQ(0U);
+	fich.encode(m_buffer + 35U);
+
+	unsigned char csd1[20U], csd2[20U];
+	::memset(csd1, '*', YSF_CALLSIGN_LENGTH);
+	::memcpy(csd1 + YSF_CALLSIGN_LENGTH, m_txSource.c_str(), YSF_CALLSIGN_LENGTH);
+	::memset(csd2, ' ', YSF_CALLSIGN_LENGTH + YSF_CALLSIGN_LENGTH);
+
+	CYSFPayload payload;
+	payload.writeHeader(m_buffer + 35U, csd1, csd2);
+
+	m_network->write(m_buffer);
+}
@@ -0,0 +1,65 @@
+/*
+ *   Copyright (C) 2019 by Manuel Sanchez EA7EE
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#ifndef YSFEndpoint_H
+#define YSFEndpoint_H
+
+#include "Endpoint.h"
+#include "YSFDCHCache.h"
+#include "YSFNetwork.h"
+#include "StopWatch.h"
+#include "Timer.h"
+
+#include <string>
+
+// A YSF network: MMDVMHost, YSFGateway or a reflector. V/D mode 2 carries
+// AMBE and voice FR mode IMBE, so this endpoint takes part in both.
+class CYSFEndpoint : public CEndpoint {
+public:
+	CYSFEndpoint(CYSFNetwork* network);
+	virtual ~CYSFEndpoint();
+
+	virtual bool open();
+	virtual void close();
+
+	virtual bool hasCodec(HUB_CODEC codec) const;
+
+	virtual int getFd() const;
+
+	virtual void clock(unsigned int ms);
+
+private:
+	CYSFNetwork*   m_network;
+	CYSFDCHCache   m_dchCache;
+	CTimer         m_watchdog;
+	CStopWatch     m_txWatch;
+	CTimer         m_pollTimer;
+	bool           m_rxActive;
+	HUB_CODEC      m_rxCodec;
+	unsigned int   m_rxFrames;
+	unsigned int   m_txCount;
+	std::string    m_txSource;
+	unsigned char* m_buffer;
+
+	void readNetwork(unsigned int ms);
+	void writeNetwork();
+	void writeHeaderFrame(unsigned char fi);
+	void startCall(const std::string& source, HUB_CODEC codec, bool late);
+};
+
+#endif
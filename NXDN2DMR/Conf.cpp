@@ -34,7 +34,8 @@ enum SECTION {
   SECTION_DMR_NETWORK,
   SECTION_DMRID_LOOKUP,
   SECTION_NXDNID_LOOKUP,
-  SECTION_LOG
+  SECTION_LOG,
+  SECTION_CAPTURE
 };
 
 CConf::CConf(const std::string& file) :
@@ -77,7 +78,10 @@ m_nxdnIdLookupTime(0U),
 m_logDisplayLevel(0U),
 m_logFileLevel(0U),
 m_logFilePath(),
-m_logFileRoot()
+m_logFileRoot(),
+m_captureMode(0U),
+m_captureFile(),
+m_captureOutput()
 {
 }
 
@@ -114,6 +118,8 @@ bool CConf::read()
 				section = SECTION_NXDNID_LOOKUP;
 			else if (::strncmp(buffer, "[Log]", 5U) == 0)
 				section = SECTION_LOG;
+			else if (::strncmp(buffer, "[Capture]", 9U) == 0)
+				section = SECTION_CAPTURE;
 			else
 				section = SECTION_NONE;
 
@@ -225,6 +231,13 @@ bool CConf::read()
 				m_logFileLevel = (unsigned int)::atoi(value);
 			else if (::strcmp(key, "DisplayLevel") == 0)
 				m_logDisplayLevel = (unsigned int)::atoi(value);
+		} else if (section == SECTION_CAPTURE) {
+			if (::strcmp(key, "Mode") == 0)
+				m_captureMode = (unsigned int)::atoi(value);
+			else if (::strcmp(key, "File") == 0)
+				m_captureFile = value;
+			else if (::strcmp(key, "Output") == 0)
+				m_captureOutput = value;
 		}
 	}
 
@@ -427,3 +440,18 @@ std::string CConf::getLogFileRoot() const
 {
   return m_logFileRoot;
 }
+
+unsigned int CConf::getCaptureMode() const
+{
+	return m_captureMode;
+}
+
+std::string CConf::getCaptureFile() const
+{
+	return m_captureFile;
+}
+
+std::string CConf::getCaptureOutput() const
+{
+	return m_captureOutput;
+}
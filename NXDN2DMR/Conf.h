@@ -82,6 +82,11 @@ public:
   std::string  getLogFilePath() const;
   std::string  getLogFileRoot() const;
 
+  // The Capture section
+  unsigned int getCaptureMode() const;
+  std::string  getCaptureFile() const;
+  std::string  getCaptureOutput() const;
+
 private:
   std::string  m_file;
   std::string  m_callsign;
@@ -129,6 +134,10 @@ private:
   std::string  m_logFilePath;
   std::string  m_logFileRoot;
 
+  unsigned int m_captureMode;
+  std::string  m_captureFile;
+  std::string  m_captureOutput;
+
 };
 
 #endif
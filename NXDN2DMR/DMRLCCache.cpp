@@ -0,0 +1,165 @@
+/*
+ *   Copyright (C) 2019 by Manuel Sanchez EA7EE
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "DMRLCCache.h"
+#include "DMREmbeddedData.h"
+#include "DMRSlotType.h"
+#include "DMRFullLC.h"
+#include "DMREMB.h"
+#include "DMRLC.h"
+#include "Sync.h"
+
+#include <cstdio>
+#include <cassert>
+#include <cstring>
+
+// The bits of bytes 13 to 19 that carry the sync or the embedded signalling
+const unsigned char EMBEDDED_MASK[] = {0x0FU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xF0U};
+
+CDMRLCBursts::CDMRLCBursts() :
+m_colorCode(0U),
+m_flco(FLCO_GROUP),
+m_srcId(0U),
+m_dstId(0U)
+{
+	::memset(m_header, 0x00U, DMR_FRAME_LENGTH_BYTES);
+	::memset(m_terminator, 0x00U, DMR_FRAME_LENGTH_BYTES);
+	::memset(m_embedded, 0x00U, sizeof(m_embedded));
+}
+
+CDMRLCBursts::~CDMRLCBursts()
+{
+}
+
+void CDMRLCBursts::encode(unsigned char colorCode, FLCO flco, unsigned int srcId, unsigned int dstId)
+{
+	m_colorCode = colorCode;
+	m_flco      = flco;
+	m_srcId     = srcId;
+	m_dstId     = dstId;
+
+	CDMRLC lc(flco, srcId, dstId);
+	CDMRFullLC fullLC;
+	CDMRSlotType slotType;
+	slotType.setColorCode(colorCode);
+
+	// The sync, slot type and full LC cover the whole burst
+	CSync::addDMRDataSync(m_header, false);
+	slotType.setDataType(DT_VOICE_LC_HEADER);
+	slotType.getData(m_header);
+	fullLC.encode(lc, m_header, DT_VOICE_LC_HEADER);
+
+	CSync::addDMRDataSync(m_terminator, false);
+	slotType.setDataType(DT_TERMINATOR_WITH_LC);
+	slotType.getData(m_terminator);
+	fullLC.encode(lc, m_terminator, DT_TERMINATOR_WITH_LC);
+
+	CDMREmbeddedData embeddedLC;
+	embeddedLC.setLC(lc);
+
+	for (unsigned int n = 1U; n <= 5U; n++) {
+		unsigned char data[DMR_FRAME_LENGTH_BYTES];
+		::memset(data, 0x00U, DMR_FRAME_LENGTH_BYTES);
+
+		unsigned char lcss = embeddedLC.getData(data, n);
+
+		CDMREMB emb;
+		emb.setColorCode(colorCode);
+		emb.setLCSS(lcss);
+		emb.getData(data);
+
+		::memcpy(m_embedded[n - 1U], data + 13U, 7U);
+	}
+}
+
+bool CDMRLCBursts::isFor(unsigned char colorCode, FLCO flco, unsigned int srcId, unsigned int dstId) const
+{
+	return m_colorCode == colorCode && m_flco == flco && m_srcId == srcId && m_dstId == dstId;
+}
+
+void CDMRLCBursts::getHeader(unsigned char* data) const
+{
+	assert(data != NULL);
+
+	::memcpy(data, m_header, DMR_FRAME_LENGTH_BYTES);
+}
+
+void CDMRLCBursts::getTerminator(unsigned char* data) const
+{
+	assert(data != NULL);
+
+	::memcpy(data, m_terminator, DMR_FRAME_LENGTH_BYTES);
+}
+
+void CDMRLCBursts::getEmbedded(unsigned char* data, unsigned int n) const
+{
+	assert(data != NULL);
+	assert(n >= 1U && n <= 5U);
+
+	const unsigned char* embedded = m_embedded[n - 1U];
+
+	for (unsigned int i = 0U; i < 7U; i++)
+		data[i + 13U] = (data[i + 13U] & ~EMBEDDED_MASK[i]) | embedded[i];
+}
+
+CDMRLCCache::CDMRLCCache(unsigned int size) :
+m_size(size),
+m_entries(),
+m_hits(0U),
+m_misses(0U)
+{
+	assert(size > 0U);
+}
+
+CDMRLCCache::~CDMRLCCache()
+{
+}
+
+const CDMRLCBursts& CDMRLCCache::get(unsigned char colorCode, FLCO flco, unsigned int srcId, unsigned int dstId)
+{
+	// The list is kept in most recently used order
+	for (std::list<CDMRLCBursts>::iterator it = m_entries.begin(); it != m_entries.end(); ++it) {
+		if (it->isFor(colorCode, flco, srcId, dstId)) {
+			if (it != m_entries.begin())
+				m_entries.splice(m_entries.begin(), m_entries, it);
+
+			m_hits++;
+			return m_entries.front();
+		}
+	}
+
+	m_misses++;
+
+	if (m_entries.size() >= m_size)
+		m_entries.pop_back();
+
+	m_entries.push_front(CDMRLCBursts());
+	m_entries.front().encode(colorCode, flco, srcId, dstId);
+
+	return m_entries.front();
+}
+
+unsigned int CDMRLCCache::getHits() const
+{
+	return m_hits;
+}
+
+unsigned int CDMRLCCache::getMisses() const
+{
+	return m_misses;
+}
@@ -88,6 +88,8 @@ m_beacon(false)
 	m_id[2U] = id >> 8;
 	m_id[3U] = id >> 0;
 
+	// During a replay the clock is virtual and starts at a fixed point, so
+	// the stream ids repeat from run to run
 	CStopWatch stopWatch;
 	::srand(stopWatch.start());
 
@@ -664,3 +666,8 @@ bool CDMRNetwork::write(const unsigned char* data, unsigned int length)
 
 	return true;
 }
+
+void CDMRNetwork::setCapture(CCapture* capture, CReplay* replay)
+{
+	m_socket.setCapture(capture, replay, CAPTURE_DMR);
+}
@@ -60,6 +60,8 @@ public:
 
 	void close();
 
+	void setCapture(CCapture* capture, CReplay* replay);
+
 private: 
 	in_addr         m_address;
 	unsigned int    m_port;
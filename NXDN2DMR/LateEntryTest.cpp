@@ -0,0 +1,390 @@
+/*
+ *   Copyright (C) 2019 by Manuel Sanchez EA7EE
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+// Feeds NXDN calls joined after their header, at every point of the SACCH
+// superframe, with corrupted fragments, other layer 3 messages and calls
+// that end early, through CNXDNLateEntry and the NXDN receive path of
+// CNXDN2DMR::run(). Checks the IDs it recovers and that the held voice
+// reaches the DMR queue as it would have with the header.
+
+#include "NXDNLateEntry.h"
+#include "NXDNDefines.h"
+#include "NXDNLayer3.h"
+#include "NXDNSACCH.h"
+#include "NXDNLICH.h"
+#include "ModeConv.h"
+#include "Defines.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+const unsigned int CALL_FRAMES   = 48U;
+const unsigned int PACKET_LENGTH = 43U;
+const unsigned int DMR_LENGTH    = 33U;
+
+// The ids of the call in the SACCH, and different ones in the packet
+// fields so that it shows which were used
+const unsigned int SACCH_SRC_ID  = 1234U;
+const unsigned int SACCH_DST_ID  = 65U;
+const unsigned int PACKET_SRC_ID = 4321U;
+const unsigned int PACKET_DST_ID = 56U;
+
+const unsigned char SACCH_STRUCTURE[] = {NXDN_SR_1_4, NXDN_SR_2_4, NXDN_SR_3_4, NXDN_SR_4_4};
+
+static void makePacket(unsigned char* packet, unsigned char usc, unsigned char option, bool end)
+{
+	::memcpy(packet, "NXDND", 5U);
+
+	packet[5U] = (PACKET_SRC_ID >> 8) & 0xFFU;
+	packet[6U] = PACKET_SRC_ID & 0xFFU;
+	packet[7U] = (PACKET_DST_ID >> 8) & 0xFFU;
+	packet[8U] = PACKET_DST_ID & 0xFFU;
+	packet[9U] = 0x01U | (end ? 0x08U : 0x00U);
+
+	CNXDNLICH lich;
+	lich.setRFCT(NXDN_LICH_RFCT_RDCH);
+	lich.setFCT(usc);
+	lich.setOption(option);
+	lich.setDirection(NXDN_LICH_DIRECTION_INBOUND);
+	packet[10U] = lich.getRaw();
+}
+
+// Voice frame n of a call, its SACCH carrying fragment n % 4 of message
+static void makeVoice(unsigned char* packet, unsigned int n, unsigned char message)
+{
+	::memset(packet, 0x00U, PACKET_LENGTH);
+	makePacket(packet, NXDN_LICH_USC_SACCH_SS, NXDN_LICH_STEAL_NONE, false);
+
+	CNXDNLayer3 layer3;
+	layer3.setMessageType(message);
+	layer3.setSourceUnitId(SACCH_SRC_ID);
+	layer3.setDestinationGroupId(SACCH_DST_ID);
+	layer3.setGroup(true);
+	layer3.setDataBlocks(0U);
+
+	unsigned char fragment[3U];
+	layer3.encode(fragment, 18U, (n % 4U) * 18U);
+
+	CNXDNSACCH sacch;
+	sacch.setStructure(SACCH_STRUCTURE[n % 4U]);
+	sacch.setData(fragment);
+	sacch.setRAN(0x01U);
+	sacch.getRaw(packet + 11U);
+
+	// Voice that differs from frame to frame
+	for (unsigned int i = 15U; i < PACKET_LENGTH; i++)
+		packet[i] = (n * 37U + i * 11U) & 0xFFU;
+}
+
+static void makeHeader(unsigned char* packet, bool end)
+{
+	::memset(packet, 0x00U, PACKET_LENGTH);
+	makePacket(packet, NXDN_LICH_USC_SACCH_NS, NXDN_LICH_STEAL_FACCH, end);
+}
+
+class CResult {
+public:
+	bool         m_lateEntry;
+	bool         m_complete;
+	unsigned int m_srcId;
+	unsigned int m_dstId;
+	bool         m_grp;
+	unsigned int m_held;
+};
+
+// The NXDN receive path of CNXDN2DMR::run() and startLateEntry(), less
+// the logging and the DMR network
+class CReceiver {
+public:
+	CReceiver(CModeConv& conv) :
+	m_conv(conv),
+	m_lateEntry(),
+	m_info(false),
+	m_result()
+	{
+		m_result.m_lateEntry = false;
+		m_result.m_complete  = false;
+		m_result.m_srcId     = 0U;
+		m_result.m_dstId     = 0U;
+		m_result.m_grp       = false;
+		m_result.m_held      = 0U;
+	}
+
+	void process(const unsigned char* buffer)
+	{
+		CNXDNLICH lich;
+		unsigned int srcId = (buffer[5U] << 8) | buffer[6U];
+		unsigned int dstId = (buffer[7U] << 8) | buffer[8U];
+		bool end = (buffer[9U] & 0x08) == 0x08;
+		bool grp = (buffer[9U] & 0x01) == 0x01;
+
+		lich.setRaw(buffer[10U]);
+		unsigned char usc = lich.getFCT();
+		unsigned char opt = lich.getOption();
+
+		if (usc == NXDN_LICH_USC_SACCH_NS) {
+			if (end) {
+				if (!m_info && m_lateEntry.getFrames() > 0U)
+					startLateEntry(srcId, dstId, grp, false);
+
+				m_conv.putNXDNEOT();
+				m_info = false;
+				m_lateEntry.reset();
+			} else {
+				m_conv.putNXDNHeader();
+				m_info = true;
+				m_lateEntry.reset();
+			}
+		} else if (opt == NXDN_LICH_STEAL_NONE) {
+			if (m_info) {
+				m_conv.putNXDN(buffer + 10U);
+			} else {
+				bool complete = m_lateEntry.add(buffer + 10U);
+				if (complete || m_lateEntry.isTimedOut()) {
+					if (complete) {
+						const CNXDNLayer3& layer3 = m_lateEntry.getLayer3();
+						srcId = layer3.getSourceUnitId();
+						dstId = layer3.getDestinationGroupId();
+						grp   = layer3.getIsGroup();
+					}
+
+					startLateEntry(srcId, dstId, grp, complete);
+				}
+			}
+		}
+	}
+
+	const CResult& getResult() const
+	{
+		return m_result;
+	}
+
+private:
+	CModeConv&     m_conv;
+	CNXDNLateEntry m_lateEntry;
+	bool           m_info;
+	CResult        m_result;
+
+	void startLateEntry(unsigned int srcId, unsigned int dstId, bool grp, bool complete)
+	{
+		m_result.m_lateEntry = true;
+		m_result.m_complete  = complete;
+		m_result.m_srcId     = srcId;
+		m_result.m_dstId     = dstId;
+		m_result.m_grp       = grp;
+		m_result.m_held      = m_lateEntry.getFrames();
+
+		m_conv.putNXDNHeader();
+		m_info = true;
+
+		for (unsigned int i = 0U; i < m_lateEntry.getFrames(); i++)
+			m_conv.putNXDN(m_lateEntry.getFrame(i));
+
+		m_lateEntry.reset();
+	}
+};
+
+static void drain(CModeConv& conv, std::vector<unsigned char>& output)
+{
+	unsigned char data[DMR_LENGTH];
+
+	for (;;) {
+		::memset(data, 0x00U, DMR_LENGTH);
+		unsigned int tag = conv.getDMR(data);
+		if (tag == TAG_NODATA)
+			break;
+
+		output.push_back(tag);
+		output.insert(output.end(), data, data + DMR_LENGTH);
+	}
+}
+
+// A call of frames voice frames joined at frame join, with the SACCH of
+// the frames in corrupt spoiled. The DMR queue must get what it gets from
+// the same frames with the header, whenever the late entry starts.
+static CResult runCall(unsigned int join, unsigned int frames, unsigned char message, const std::vector<unsigned int>& corrupt, bool& sameAudio)
+{
+	CModeConv lateConv;
+	CModeConv fullConv;
+	CReceiver late(lateConv);
+	CReceiver full(fullConv);
+
+	std::vector<unsigned char> lateOutput, fullOutput;
+
+	unsigned char packet[PACKET_LENGTH];
+	makeHeader(packet, false);
+	full.process(packet);
+
+	for (unsigned int n = join; n < frames; n++) {
+		makeVoice(packet, n, message);
+		full.process(packet);
+
+		for (unsigned int i = 0U; i < corrupt.size(); i++) {
+			if (corrupt[i] == n)
+				packet[12U] ^= 0x10U;
+		}
+
+		late.process(packet);
+
+		drain(lateConv, lateOutput);
+		drain(fullConv, fullOutput);
+	}
+
+	makeHeader(packet, true);
+	late.process(packet);
+	full.process(packet);
+
+	drain(lateConv, lateOutput);
+	drain(fullConv, fullOutput);
+
+	sameAudio = lateOutput == fullOutput;
+
+	return late.getResult();
+}
+
+static bool sacchIds(const CResult& result)
+{
+	return result.m_lateEntry && result.m_complete && result.m_srcId == SACCH_SRC_ID && result.m_dstId == SACCH_DST_ID && result.m_grp;
+}
+
+static bool packetIds(const CResult& result)
+{
+	return result.m_lateEntry && !result.m_complete && result.m_srcId == PACKET_SRC_ID && result.m_dstId == PACKET_DST_ID && result.m_grp;
+}
+
+// The frames held until the first superframe seen from its 1/4 fragment
+static unsigned int expectedHeld(unsigned int join)
+{
+	return ((4U - (join % 4U)) % 4U) + 4U;
+}
+
+int main()
+{
+	std::vector<unsigned int> none;
+	unsigned int failures = 0U;
+	unsigned int failed = 0U;
+
+	// Joined at every frame of the first three superframes
+	unsigned int minHeld = 100U, maxHeld = 0U;
+	for (unsigned int join = 0U; join < 12U; join++) {
+		bool sameAudio;
+		CResult result = runCall(join, CALL_FRAMES, NXDN_MESSAGE_TYPE_VCALL, none, sameAudio);
+
+		if (!sacchIds(result) || result.m_held != expectedHeld(join) || !sameAudio) {
+			::printf("Join at frame %u: complete %d, ids %u to %u, %u frames held, audio %s\n", join, result.m_complete, result.m_srcId, result.m_dstId, result.m_held, sameAudio ? "same" : "differs");
+			failed++;
+		}
+
+		if (result.m_held < minHeld)
+			minHeld = result.m_held;
+		if (result.m_held > maxHeld)
+			maxHeld = result.m_held;
+	}
+
+	::printf("Joins: 12 calls, %u failures, ids from the SACCH after %u to %u frames\n", failed, minHeld, maxHeld);
+
+	failures += failed;
+	failed = 0U;
+
+	// A spoiled fragment costs the superframe it is in, and falls back to
+	// the packet ids when that leaves no whole superframe in eight frames
+	unsigned int spoiled = 0U;
+	unsigned int fallbacks = 0U;
+	for (unsigned int join = 0U; join < 4U; join++) {
+		for (unsigned int bad = join; bad < join + 8U; bad++) {
+			std::vector<unsigned int> corrupt(1U, bad);
+
+			bool sameAudio;
+			CResult result = runCall(join, CALL_FRAMES, NXDN_MESSAGE_TYPE_VCALL, corrupt, sameAudio);
+
+			// The first superframe from its 1/4 fragment, or the next one
+			// if the bad fragment is in it
+			unsigned int start = join + ((4U - (join % 4U)) % 4U);
+			if (bad >= start && bad < start + 4U)
+				start += 4U;
+
+			unsigned int held = start + 4U - join;
+
+			bool ok;
+			if (held <= NXDN_LATE_ENTRY_MAX_FRAMES) {
+				ok = sacchIds(result) && result.m_held == held;
+			} else {
+				ok = packetIds(result) && result.m_held == NXDN_LATE_ENTRY_MAX_FRAMES;
+				fallbacks++;
+			}
+
+			if (!ok || !sameAudio) {
+				::printf("Join at frame %u, frame %u spoiled: complete %d, ids %u to %u, %u frames held, audio %s\n", join, bad, result.m_complete, result.m_srcId, result.m_dstId, result.m_held, sameAudio ? "same" : "differs");
+				failed++;
+			}
+
+			spoiled++;
+		}
+	}
+
+	::printf("Spoiled fragments: %u calls, %u failures, %u fell back to the packet ids\n", spoiled, failed, fallbacks);
+
+	failures += failed;
+	failed = 0U;
+
+	// A layer 3 message that is not a VCALL never completes
+	for (unsigned int join = 0U; join < 4U; join++) {
+		bool sameAudio;
+		CResult result = runCall(join, CALL_FRAMES, NXDN_MESSAGE_TYPE_IDLE, none, sameAudio);
+
+		if (!packetIds(result) || result.m_held != NXDN_LATE_ENTRY_MAX_FRAMES || !sameAudio) {
+			::printf("Join at frame %u without a VCALL: complete %d, ids %u to %u, %u frames held, audio %s\n", join, result.m_complete, result.m_srcId, result.m_dstId, result.m_held, sameAudio ? "same" : "differs");
+			failed++;
+		}
+	}
+
+	::printf("No VCALL: 4 calls, %u failures\n", failed);
+
+	failures += failed;
+	failed = 0U;
+
+	// Calls that end while the voice is held go out at the terminator
+	unsigned int flushed = 0U;
+	for (unsigned int join = 0U; join < 4U; join++) {
+		for (unsigned int frames = 1U; frames < NXDN_LATE_ENTRY_MAX_FRAMES; frames++) {
+			bool sameAudio;
+			CResult result = runCall(join, join + frames, NXDN_MESSAGE_TYPE_VCALL, none, sameAudio);
+
+			bool ok;
+			if (frames >= expectedHeld(join)) {
+				ok = sacchIds(result) && result.m_held == expectedHeld(join);
+			} else {
+				ok = packetIds(result) && result.m_held == frames;
+				flushed++;
+			}
+
+			if (!ok || !sameAudio) {
+				::printf("Join at frame %u, %u frames: complete %d, ids %u to %u, %u frames held, audio %s\n", join, frames, result.m_complete, result.m_srcId, result.m_dstId, result.m_held, sameAudio ? "same" : "differs");
+				failed++;
+			}
+		}
+	}
+
+	::printf("Short calls: 28 calls, %u failures, %u flushed at the terminator\n", failed, flushed);
+
+	failures += failed;
+
+	return failures == 0U ? 0 : 1;
+}
@@ -20,6 +20,8 @@
 #include "Defines.h"
 #include "RingBuffer.h"
 
+#include <cstdint>
+
 #if !defined(MODECONV_H)
 #define MODECONV_H
 
@@ -28,11 +30,11 @@ public:
 	CModeConv();
 	~CModeConv();
 
-	void putDMR(unsigned char* data);
+	void putDMR(const unsigned char* data);
 	void putDMRHeader();
 	void putDMREOT();
 
-	void putNXDN(unsigned char* data);
+	void putNXDN(const unsigned char* data);
 	void putNXDNHeader();
 	void putNXDNEOT();
 
@@ -42,10 +44,9 @@ public:
 private:
 	unsigned int m_nxdnN;
 	unsigned int m_dmrN;
-	CRingBuffer<unsigned char> m_NXDN;
-	CRingBuffer<unsigned char> m_DMR;
-	void encode(const unsigned char* in, unsigned char* out, unsigned int offset) const;
-	void decode(const unsigned char* in, unsigned char* out, unsigned int offset) const;
+	unsigned int m_dmrVoice;
+	CRingBuffer<uint64_t> m_NXDN;
+	CRingBuffer<uint64_t> m_DMR;
 };
 
 #endif
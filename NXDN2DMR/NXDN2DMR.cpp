@@ -37,6 +37,8 @@
 #define XLX_SLOT            2U
 #define XLX_COLOR_CODE      3U
 
+#define DMR_LC_CACHE_SIZE   16U
+
 #if defined(_WIN32) || defined(_WIN64)
 const char* DEFAULT_INI_FILE = "NXDN2DMR.ini";
 #else
@@ -124,16 +126,20 @@ m_nxdnFrame(NULL),
 m_dmrFrame(NULL),
 m_dmrFrames(0U),
 m_nxdnFrames(0U),
-m_EmbeddedLC(),
+m_lcCache(DMR_LC_CACHE_SIZE),
+m_dmrLC(),
 m_dmrflco(FLCO_GROUP),
 m_dmrinfo(false),
 m_nxdninfo(false),
+m_lateEntry(),
 m_xlxmodule(),
 m_xlxConnected(false),
 m_xlxReflectors(NULL),
 m_xlxrefl(0U),
 m_defaultID(65519U),
-m_firstSync(false)
+m_firstSync(false),
+m_capture(NULL),
+m_replay(NULL)
 {
 	m_nxdnFrame = new unsigned char[200U];
 	m_dmrFrame  = new unsigned char[50U];
@@ -253,8 +259,27 @@ int CNXDN2DMR::run()
 	m_xlxReflectors = new CReflectors(fileName, 60U);
 	m_xlxReflectors->load();
 
+	unsigned int captureMode = m_conf.getCaptureMode();
+	if (captureMode == 1U) {
+		m_capture = new CCapture(m_conf.getCaptureFile());
+		if (!m_capture->open()) {
+			::LogFinalise();
+			return 1;
+		}
+	} else if (captureMode == 2U) {
+		m_replay = new CReplay(m_conf.getCaptureFile());
+		m_capture = new CCapture(m_conf.getCaptureOutput());
+		if (!m_replay->open() || !m_capture->open()) {
+			::LogFinalise();
+			return 1;
+		}
+
+		m_replay->start();
+	}
+
 	m_nxdnNetwork = new CNXDNNetwork(localAddress, localPort, m_callsign, debug);
 	m_nxdnNetwork->setDestination(dstAddress, dstPort);
+	m_nxdnNetwork->setCapture(m_capture, m_replay);
 
 	ret = m_nxdnNetwork->open();
 	if (!ret) {
@@ -289,6 +314,7 @@ int CNXDN2DMR::run()
 
 	CTimer networkWatchdog(100U, 0U, 1500U);
 	CTimer pollTimer(1000U, 5U);
+	CTimer replayTimer(1000U, 2U);
 
 	std::string name = m_conf.getDescription();
 
@@ -328,8 +354,8 @@ int CNXDN2DMR::run()
 		while ((len = m_nxdnNetwork->read(buffer)) > 0U) {
 			if (::memcmp(buffer, "NXDND", 5U) == 0U && len == 43U) {
 				CNXDNLICH lich;
-				m_nxdnSrc = (buffer[5U] << 8) | buffer[6U];
-				m_nxdnDst = (buffer[7U] << 8) | buffer[8U];
+				unsigned int srcId = (buffer[5U] << 8) | buffer[6U];
+				unsigned int dstId = (buffer[7U] << 8) | buffer[8U];
 				bool end = (buffer[9U] & 0x08) == 0x08;
 				bool grp = (buffer[9U] & 0x01) == 0x01;
 
@@ -339,36 +365,50 @@ int CNXDN2DMR::run()
 
 				if (usc == NXDN_LICH_USC_SACCH_NS) {
 					if (end) {
+						// A call too short for the SACCH to be read still goes out, with the ids of the terminator
+						if (!m_nxdninfo && m_lateEntry.getFrames() > 0U)
+							startLateEntry(srcId, dstId, grp, false);
+
 						LogMessage("NXDN received end of voice transmission, %.1f seconds", float(m_nxdnFrames) / 12.5F);
 						m_conv.putNXDNEOT();
 						m_nxdnFrames = 0U;
 						m_nxdninfo = false;
+						m_lateEntry.reset();
 					} else {
+						m_nxdnSrc = srcId;
+						m_nxdnDst = dstId;
+
 						std::string netSrc = m_nxdnlookup->findCS(m_nxdnSrc);
 						std::string netDst = m_nxdnlookup->findCS(m_nxdnDst);
-						LogMessage("Received NXDN header from %s to %s%s", netSrc.c_str(), grp ? "TG " : "", netDst.c_str());
+						// The NXDN group flag is only logged, the DMR call type and destination are configured
+						LogMessage("Received NXDN header from %s to %s%s, DMR to %s%u", netSrc.c_str(), grp ? "TG " : "", netDst.c_str(), m_dmrflco == FLCO_GROUP ? "TG " : "", m_dstid);
 
 						m_dmrNetwork->reset(2U);	// OE1KBC fix
 
 						m_conv.putNXDNHeader();
 						m_nxdnFrames = 0U;
 						m_nxdninfo = true;
+						m_lateEntry.reset();
 					}
 				} else {
 					if (opt == NXDN_LICH_STEAL_NONE) {
-						if (!m_nxdninfo) {
-							std::string netSrc = m_nxdnlookup->findCS(m_nxdnSrc);
-							std::string netDst = m_nxdnlookup->findCS(m_nxdnDst);
-							LogMessage("Received NXDN late entry from %s to %s%s", netSrc.c_str(), grp ? "TG " : "", netDst.c_str());
-
-							m_dmrNetwork->reset(2U);	// OE1KBC fix
-
-							m_conv.putNXDNHeader();
-							m_nxdninfo = true;
+						if (m_nxdninfo) {
+							m_conv.putNXDN(buffer + 10U);
+							m_nxdnFrames++;
+						} else {
+							// Hold the voice until the SACCH gives the IDs for the DMR header
+							bool complete = m_lateEntry.add(buffer + 10U);
+							if (complete || m_lateEntry.isTimedOut()) {
+								if (complete) {
+									const CNXDNLayer3& layer3 = m_lateEntry.getLayer3();
+									srcId = layer3.getSourceUnitId();
+									dstId = layer3.getDestinationGroupId();
+									grp   = layer3.getIsGroup();
+								}
+
+								startLateEntry(srcId, dstId, grp, complete);
+							}
 						}
-
-						m_conv.putNXDN(buffer + 10U);
-						m_nxdnFrames++;
 					}
 				}
 			}
@@ -396,20 +436,9 @@ int CNXDN2DMR::run()
 				rx_dmrdata.setRSSI(0U);
 				rx_dmrdata.setDataType(DT_VOICE_LC_HEADER);
 
-				// Add sync
-				CSync::addDMRDataSync(m_dmrFrame, 0);
-
-				// Add SlotType
-				CDMRSlotType slotType;
-				slotType.setColorCode(m_colorcode);
-				slotType.setDataType(DT_VOICE_LC_HEADER);
-				slotType.getData(m_dmrFrame);
-
-				// Full LC
-				CDMRLC dmrLC = CDMRLC(m_dmrflco, m_dmrSrc, m_dstid);
-				CDMRFullLC fullLC;
-				fullLC.encode(dmrLC, m_dmrFrame, DT_VOICE_LC_HEADER);
-				m_EmbeddedLC.setLC(dmrLC);
+				// Sync, SlotType and Full LC, encoded once per LC
+				m_dmrLC = m_lcCache.get(m_colorcode, m_dmrflco, m_dmrSrc, m_dstid);
+				m_dmrLC.getHeader(m_dmrFrame);
 				
 				rx_dmrdata.setData(m_dmrFrame);
 				//CUtils::dump(1U, "DMR data:", m_dmrFrame, 33U);
@@ -430,7 +459,6 @@ int CNXDN2DMR::run()
 				if (n_dmr) {
 					for (unsigned int i = 0U; i < fill; i++) {
 
-						CDMREMB emb;
 						CDMRData rx_dmrdata;
 
 						rx_dmrdata.setSlotNo(2U);
@@ -445,13 +473,8 @@ int CNXDN2DMR::run()
 
 						::memcpy(m_dmrFrame, DMR_SILENCE_DATA, DMR_FRAME_LENGTH_BYTES);
 
-						// Generate the Embedded LC
-						unsigned char lcss = m_EmbeddedLC.getData(m_dmrFrame, n_dmr);
-
-						// Generate the EMB
-						emb.setColorCode(m_colorcode);
-						emb.setLCSS(lcss);
-						emb.getData(m_dmrFrame);
+						// Add the Embedded LC and EMB
+						m_dmrLC.getEmbedded(m_dmrFrame, n_dmr);
 
 						rx_dmrdata.setData(m_dmrFrame);
 
@@ -473,19 +496,8 @@ int CNXDN2DMR::run()
 				rx_dmrdata.setRSSI(0U);
 				rx_dmrdata.setDataType(DT_TERMINATOR_WITH_LC);
 
-				// Add sync
-				CSync::addDMRDataSync(m_dmrFrame, 0);
-
-				// Add SlotType
-				CDMRSlotType slotType;
-				slotType.setColorCode(m_colorcode);
-				slotType.setDataType(DT_TERMINATOR_WITH_LC);
-				slotType.getData(m_dmrFrame);
-
-				// Full LC
-				CDMRLC dmrLC = CDMRLC(m_dmrflco, m_dmrSrc, m_dstid);
-				CDMRFullLC fullLC;
-				fullLC.encode(dmrLC, m_dmrFrame, DT_TERMINATOR_WITH_LC);
+				// Sync, SlotType and Full LC, encoded once per LC
+				m_lcCache.get(m_colorcode, m_dmrflco, m_dmrSrc, m_dstid).getTerminator(m_dmrFrame);
 
 				rx_dmrdata.setData(m_dmrFrame);
 				//CUtils::dump(1U, "DMR data:", m_dmrFrame, 33U);
@@ -494,7 +506,6 @@ int CNXDN2DMR::run()
 				dmrWatch.start();
 			}
 			else if(dmrFrameType == TAG_DATA) {
-				CDMREMB emb;
 				CDMRData rx_dmrdata;
 				unsigned int n_dmr = (dmr_cnt - 3U) % 6U;
 
@@ -511,19 +522,13 @@ int CNXDN2DMR::run()
 					rx_dmrdata.setDataType(DT_VOICE_SYNC);
 					// Add sync
 					CSync::addDMRAudioSync(m_dmrFrame, 0U);
-					// Prepare Full LC data
-					CDMRLC dmrLC = CDMRLC(m_dmrflco, m_dmrSrc, m_dstid);
-					// Configure the Embedded LC
-					m_EmbeddedLC.setLC(dmrLC);
+					// Pick up the Embedded LC for this superframe
+					m_dmrLC = m_lcCache.get(m_colorcode, m_dmrflco, m_dmrSrc, m_dstid);
 				}
 				else {
 					rx_dmrdata.setDataType(DT_VOICE);
-					// Generate the Embedded LC
-					unsigned char lcss = m_EmbeddedLC.getData(m_dmrFrame, n_dmr);
-					// Generate the EMB
-					emb.setColorCode(m_colorcode);
-					emb.setLCSS(lcss);
-					emb.getData(m_dmrFrame);
+					// Add the Embedded LC and EMB
+					m_dmrLC.getEmbedded(m_dmrFrame, n_dmr);
 				}
 
 				rx_dmrdata.setData(m_dmrFrame);
@@ -751,7 +756,21 @@ int CNXDN2DMR::run()
 			pollTimer.start();
 		}
 
-		if (ms < 5U)
+		// Give the conversion time to drain once the replay has run out
+		if (m_replay != NULL && m_replay->isFinished()) {
+			if (!replayTimer.isRunning())
+				replayTimer.start();
+
+			replayTimer.clock(ms);
+			if (replayTimer.hasExpired()) {
+				LogMessage("Replay finished, %u ms of traffic in %.3f s of CPU", m_replay->getElapsed(), double(CThread::getCPUTime()) / 1000000.0);
+				end = 1;
+			}
+		}
+
+		if (m_replay != NULL)
+			m_replay->sleep(5U);
+		else if (ms < 5U)
 			CThread::sleep(5U);
 	}
 
@@ -770,6 +789,13 @@ int CNXDN2DMR::run()
 	if (m_xlxReflectors != NULL)
 		delete m_xlxReflectors;
 
+	if (m_capture != NULL) {
+		m_capture->close();
+		delete m_capture;
+	}
+
+	delete m_replay;
+
 	::LogFinalise();
 
 	return 0;
@@ -814,6 +840,31 @@ unsigned int CNXDN2DMR::truncID(unsigned int id)
 	return newid;
 }
 
+void CNXDN2DMR::startLateEntry(unsigned int srcId, unsigned int dstId, bool grp, bool complete)
+{
+	m_nxdnSrc = srcId;
+	m_nxdnDst = dstId;
+
+	std::string netSrc = m_nxdnlookup->findCS(m_nxdnSrc);
+	std::string netDst = m_nxdnlookup->findCS(m_nxdnDst);
+	// As with the header, grp is only logged and the DMR side uses m_dmrflco and m_dstid
+	LogMessage("Received NXDN late entry from %s to %s%s%s, DMR to %s%u", netSrc.c_str(), grp ? "TG " : "", netDst.c_str(), complete ? "" : ", no SACCH", m_dmrflco == FLCO_GROUP ? "TG " : "", m_dstid);
+
+	m_dmrNetwork->reset(2U);	// OE1KBC fix
+
+	m_conv.putNXDNHeader();
+	m_nxdnFrames = 0U;
+	m_nxdninfo = true;
+
+	// The voice held back while waiting for the SACCH
+	for (unsigned int i = 0U; i < m_lateEntry.getFrames(); i++) {
+		m_conv.putNXDN(m_lateEntry.getFrame(i));
+		m_nxdnFrames++;
+	}
+
+	m_lateEntry.reset();
+}
+
 bool CNXDN2DMR::createDMRNetwork()
 {
 	std::string address   = m_conf.getDMRNetworkAddress();
@@ -874,6 +925,7 @@ bool CNXDN2DMR::createDMRNetwork()
 	LogMessage("    Jitter: %ums", jitter);
 
 	m_dmrNetwork = new CDMRNetwork(address, port, local, m_srcHS, password, duplex, VERSION, debug, slot1, slot2, hwType, jitter);
+	m_dmrNetwork->setCapture(m_capture, m_replay);
 
 	std::string options = m_conf.getDMRNetworkOptions();
 	if (!options.empty()) {
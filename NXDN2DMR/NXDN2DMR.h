@@ -25,12 +25,14 @@
 #include "ModeConv.h"
 #include "DMRNetwork.h"
 #include "DMREmbeddedData.h"
+#include "DMRLCCache.h"
 #include "DMRLC.h"
 #include "DMRFullLC.h"
 #include "DMREMB.h"
 #include "DMRLookup.h"
 #include "NXDNConvolution.h"
 #include "NXDNCRC.h"
+#include "NXDNLateEntry.h"
 #include "NXDNLayer3.h"
 #include "NXDNLICH.h"
 #include "NXDNLookup.h"
@@ -38,6 +40,7 @@
 #include "NXDNNetwork.h"
 #include "Reflectors.h"
 #include "UDPSocket.h"
+#include "Capture.h"
 #include "StopWatch.h"
 #include "Version.h"
 #include "Thread.h"
@@ -88,21 +91,26 @@ private:
 	unsigned char*   m_dmrFrame;
 	unsigned int     m_dmrFrames;
 	unsigned int     m_nxdnFrames;
-	CDMREmbeddedData m_EmbeddedLC;
+	CDMRLCCache      m_lcCache;
+	CDMRLCBursts     m_dmrLC;
 	FLCO             m_dmrflco;
 	bool             m_dmrinfo;
 	bool             m_nxdninfo;
+	CNXDNLateEntry   m_lateEntry;
 	std::string      m_xlxmodule;
 	bool             m_xlxConnected;
 	CReflectors*     m_xlxReflectors;
 	unsigned int     m_xlxrefl;
 	unsigned int     m_defaultID;
 	bool             m_firstSync;
+	CCapture*        m_capture;
+	CReplay*         m_replay;
 
 	bool createDMRNetwork();
 	unsigned int findNXDNID(unsigned int dmrid);
 	unsigned int findDMRID(unsigned int nxdnid);
 	unsigned int truncID(unsigned int id);
+	void startLateEntry(unsigned int srcId, unsigned int dstId, bool grp, bool complete);
 	void writeXLXLink(unsigned int srcId, unsigned int dstId, CDMRNetwork* network);
 };
 
@@ -0,0 +1,183 @@
+/*
+ *   Copyright (C) 2019 by Manuel Sanchez EA7EE
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "NXDNFACCH1.h"
+
+#include "NXDNConvolution.h"
+#include "NXDNDefines.h"
+#include "NXDNCRC.h"
+
+#include <cstdio>
+#include <cassert>
+#include <cstring>
+
+const unsigned char BIT_MASK_TABLE[] = { 0x80U, 0x40U, 0x20U, 0x10U, 0x08U, 0x04U, 0x02U, 0x01U };
+
+#define WRITE_BIT1(p,i,b) p[(i)>>3] = (b) ? (p[(i)>>3] | BIT_MASK_TABLE[(i)&7]) : (p[(i)>>3] & ~BIT_MASK_TABLE[(i)&7])
+#define READ_BIT1(p,i)    (p[(i)>>3] & BIT_MASK_TABLE[(i)&7])
+
+// 80 bits of data, the CRC12 and the tail, coded at rate 1/2 and then
+// every fourth coded bit from the second one is punctured.
+const unsigned int FACCH1_DATA_BITS  = 80U;
+const unsigned int FACCH1_CODED_BITS = 96U;
+const unsigned int FACCH1_PUNCTURED  = FACCH1_CODED_BITS / 2U;
+
+// The bits are sent as 9 rows of 16 columns, read out column by column.
+static constexpr CECCTable<unsigned int, NXDN_FACCH1_LENGTH_BITS> makeInterleaveTable()
+{
+	CECCTable<unsigned int, NXDN_FACCH1_LENGTH_BITS> table = {};
+
+	for (unsigned int i = 0U; i < NXDN_FACCH1_LENGTH_BITS; i++)
+		table.m_data[i] = (i % 9U) * 16U + i / 9U;
+
+	return table;
+}
+
+static constexpr CECCTable<unsigned int, FACCH1_PUNCTURED> makePunctureList()
+{
+	CECCTable<unsigned int, FACCH1_PUNCTURED> table = {};
+
+	for (unsigned int i = 0U; i < FACCH1_PUNCTURED; i++)
+		table.m_data[i] = i * 4U + 1U;
+
+	return table;
+}
+
+static constexpr CECCTable<unsigned int, NXDN_FACCH1_LENGTH_BITS> INTERLEAVE_TABLE = makeInterleaveTable();
+static constexpr CECCTable<unsigned int, FACCH1_PUNCTURED>        PUNCTURE_LIST    = makePunctureList();
+
+static constexpr CECCTable<uint8_t, FACCH1_CODED_BITS * 2U> DEPUNCTURE_MAP = CNXDNConvolution::depunctureMap<FACCH1_CODED_BITS * 2U>(INTERLEAVE_TABLE.m_data, PUNCTURE_LIST.m_data, FACCH1_PUNCTURED);
+
+static_assert(INTERLEAVE_TABLE.checksum() == 0x547C4A35U, "INTERLEAVE_TABLE has changed");
+static_assert(DEPUNCTURE_MAP.checksum() == 0x284B3145U, "DEPUNCTURE_MAP has changed");
+
+CNXDNFACCH1::CNXDNFACCH1(const CNXDNFACCH1& facch) :
+m_data(NULL)
+{
+	m_data = new unsigned char[12U];
+	::memcpy(m_data, facch.m_data, 12U);
+}
+
+CNXDNFACCH1::CNXDNFACCH1() :
+m_data(NULL)
+{
+	m_data = new unsigned char[12U];
+	::memset(m_data, 0x00U, 12U);
+}
+
+CNXDNFACCH1::~CNXDNFACCH1()
+{
+	delete[] m_data;
+}
+
+bool CNXDNFACCH1::decode(const unsigned char* data, unsigned int offset)
+{
+	assert(data != NULL);
+
+	uint8_t symbols[NXDN_FACCH1_LENGTH_BITS];
+
+	for (unsigned int i = 0U; i < NXDN_FACCH1_LENGTH_BITS; i++, offset++)
+		symbols[i] = READ_BIT1(data, offset) ? NXDN_SOFT_ONE : 0U;
+
+	return decodeSoft(symbols);
+}
+
+bool CNXDNFACCH1::decodeSoft(const uint8_t* symbols)
+{
+	assert(symbols != NULL);
+
+	CNXDNConvolution conv;
+	conv.decode(symbols, DEPUNCTURE_MAP.m_data, m_data, FACCH1_CODED_BITS);
+
+	return CNXDNCRC::checkCRC12(m_data, FACCH1_DATA_BITS);
+}
+
+void CNXDNFACCH1::encode(unsigned char* data, unsigned int offset) const
+{
+	assert(data != NULL);
+
+	unsigned char temp1[12U];
+	::memset(temp1, 0x00U, 12U);
+	::memcpy(temp1, m_data, 10U);
+
+	CNXDNCRC::encodeCRC12(temp1, FACCH1_DATA_BITS);
+
+	unsigned char temp2[24U];
+
+	CNXDNConvolution conv;
+	conv.encode(temp1, temp2, FACCH1_CODED_BITS);
+
+	unsigned char temp3[18U];
+
+	unsigned int n = 0U;
+	unsigned int index = 0U;
+	for (unsigned int i = 0U; i < FACCH1_CODED_BITS * 2U; i++) {
+		if (index < FACCH1_PUNCTURED && i == PUNCTURE_LIST[index]) {
+			index++;
+		} else {
+			bool b = READ_BIT1(temp2, i);
+			WRITE_BIT1(temp3, n, b);
+			n++;
+		}
+	}
+
+	for (unsigned int i = 0U; i < NXDN_FACCH1_LENGTH_BITS; i++) {
+		unsigned int n = INTERLEAVE_TABLE[i] + offset;
+		bool b = READ_BIT1(temp3, i);
+		WRITE_BIT1(data, n, b);
+	}
+}
+
+void CNXDNFACCH1::getData(unsigned char* data) const
+{
+	assert(data != NULL);
+
+	::memcpy(data, m_data, 10U);
+}
+
+void CNXDNFACCH1::getRaw(unsigned char* data) const
+{
+	assert(data != NULL);
+
+	::memset(data, 0x00U, 12U);
+	::memcpy(data, m_data, 10U);
+
+	CNXDNCRC::encodeCRC12(data, FACCH1_DATA_BITS);
+}
+
+void CNXDNFACCH1::setData(const unsigned char* data)
+{
+	assert(data != NULL);
+
+	::memcpy(m_data, data, 10U);
+}
+
+void CNXDNFACCH1::setRaw(const unsigned char* data)
+{
+	assert(data != NULL);
+
+	::memcpy(m_data, data, 12U);
+}
+
+CNXDNFACCH1& CNXDNFACCH1::operator=(const CNXDNFACCH1& facch)
+{
+	if (&facch != this)
+		::memcpy(m_data, facch.m_data, 12U);
+
+	return *this;
+}
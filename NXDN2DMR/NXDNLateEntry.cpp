@@ -0,0 +1,103 @@
+/*
+ *   Copyright (C) 2019 by Manuel Sanchez EA7EE
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "NXDNLateEntry.h"
+#include "NXDNDefines.h"
+#include "NXDNCRC.h"
+
+#include <cassert>
+#include <cstring>
+
+const unsigned int SACCH_FRAGMENT_BITS = 18U;
+const unsigned int ALL_FRAGMENTS       = 0x0FU;
+
+CNXDNLateEntry::CNXDNLateEntry() :
+m_layer3(),
+m_count(0U),
+m_fragments(0U)
+{
+}
+
+CNXDNLateEntry::~CNXDNLateEntry()
+{
+}
+
+bool CNXDNLateEntry::add(const unsigned char* frame)
+{
+	assert(frame != NULL);
+
+	if (m_count < NXDN_LATE_ENTRY_MAX_FRAMES) {
+		::memcpy(m_frames[m_count], frame, NXDN_LATE_ENTRY_FRAME_LENGTH);
+		m_count++;
+	}
+
+	const unsigned char* sacch = frame + 1U;
+	if (!CNXDNCRC::checkCRC6(sacch, 26U)) {
+		m_fragments = 0U;
+		return false;
+	}
+
+	// NXDN_SR_1_4 is 3 counting down to NXDN_SR_4_4 as 0
+	unsigned int n = 3U - ((sacch[0U] >> 6) & 0x03U);
+
+	// Only a superframe seen from its first fragment, in order, is used
+	if (n == 0U)
+		m_fragments = 0U;
+	else if (m_fragments != (1U << n) - 1U) {
+		m_fragments = 0U;
+		return false;
+	}
+
+	m_layer3.decode(sacch + 1U, SACCH_FRAGMENT_BITS, n * SACCH_FRAGMENT_BITS);
+	m_fragments |= 1U << n;
+
+	if (m_fragments != ALL_FRAGMENTS)
+		return false;
+
+	m_fragments = 0U;
+
+	return m_layer3.getMessageType() == NXDN_MESSAGE_TYPE_VCALL;
+}
+
+bool CNXDNLateEntry::isTimedOut() const
+{
+	return m_count >= NXDN_LATE_ENTRY_MAX_FRAMES;
+}
+
+const CNXDNLayer3& CNXDNLateEntry::getLayer3() const
+{
+	return m_layer3;
+}
+
+unsigned int CNXDNLateEntry::getFrames() const
+{
+	return m_count;
+}
+
+unsigned char* CNXDNLateEntry::getFrame(unsigned int n)
+{
+	assert(n < m_count);
+
+	return m_frames[n];
+}
+
+void CNXDNLateEntry::reset()
+{
+	m_count     = 0U;
+	m_fragments = 0U;
+}
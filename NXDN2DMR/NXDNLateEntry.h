@@ -0,0 +1,57 @@
+/*
+ *   Copyright (C) 2019 by Manuel Sanchez EA7EE
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#ifndef NXDNLateEntry_H
+#define NXDNLateEntry_H
+
+#include "NXDNLayer3.h"
+
+const unsigned int NXDN_LATE_ENTRY_FRAME_LENGTH = 33U;		// LICH, SACCH and voice
+const unsigned int NXDN_LATE_ENTRY_MAX_FRAMES   = 8U;		// Two SACCH superframes
+
+// When a call is joined after its header the layer 3 VCALL message is
+// only available from the voice frames, split over the SACCH of four
+// consecutive frames. The fragments are collected here as they arrive
+// and the voice frames are held back until the message is complete, or
+// until two superframes have gone by without one, so that the header
+// can go out first with the right IDs without losing any audio.
+class CNXDNLateEntry {
+public:
+	CNXDNLateEntry();
+	~CNXDNLateEntry();
+
+	// Returns true once a complete VCALL message has been assembled.
+	bool add(const unsigned char* frame);
+
+	bool isTimedOut() const;
+
+	const CNXDNLayer3& getLayer3() const;
+
+	unsigned int getFrames() const;
+	unsigned char* getFrame(unsigned int n);
+
+	void reset();
+
+private:
+	CNXDNLayer3   m_layer3;
+	unsigned char m_frames[NXDN_LATE_ENTRY_MAX_FRAMES][NXDN_LATE_ENTRY_FRAME_LENGTH];
+	unsigned int  m_count;
+	unsigned int  m_fragments;
+};
+
+#endif
@@ -179,3 +179,8 @@ void CNXDNNetwork::close()
 
 	LogMessage("Closing NXDN network connection");
 }
+
+void CNXDNNetwork::setCapture(CCapture* capture, CReplay* replay)
+{
+	m_socket.setCapture(capture, replay, CAPTURE_NXDN);
+}
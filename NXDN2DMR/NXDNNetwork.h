@@ -46,6 +46,8 @@ public:
 
 	void close();
 
+	void setCapture(CCapture* capture, CReplay* replay);
+
 private:
 	CUDPSocket      m_socket;
 	std::string     m_callsign;
@@ -19,6 +19,8 @@
 #if !defined(NXDNSACCH_H)
 #define	NXDNSACCH_H
 
+#include <cstdint>
+
 class CNXDNSACCH {
 public:
 	CNXDNSACCH(const CNXDNSACCH& sacch);
@@ -27,6 +29,9 @@ public:
 
 	bool decode(const unsigned char* data);
 
+	// The NXDN_SACCH_LENGTH_BITS soft symbols of the SACCH, in the order sent.
+	bool decodeSoft(const uint8_t* symbols);
+
 	void encode(unsigned char* data) const;
 
 	unsigned char getRAN() const;
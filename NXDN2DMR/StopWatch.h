@@ -38,12 +38,9 @@ public:
 
 private:
 #if defined(_WIN32) || defined(_WIN64)
-	LARGE_INTEGER  m_frequencyS;
-	LARGE_INTEGER  m_frequencyMS;
-	LARGE_INTEGER  m_start;
-#else
-	unsigned long long m_startMS;
+	LARGE_INTEGER      m_frequencyMS;
 #endif
+	unsigned long long m_startMS;
 };
 
 #endif
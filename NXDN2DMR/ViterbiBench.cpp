@@ -0,0 +1,716 @@
+/*
+ *   Copyright (C) 2019 by Manuel Sanchez EA7EE
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+// Checks the add-compare-select of CNXDNConvolution against the scalar one
+// and against 32 bit metrics that are never renormalised, then the SACCH
+// and FACCH1 decoders against the hard decision ones they replaced, on
+// clean and noisy frames, and times them.
+
+#include "NXDNConvolution.h"
+#include "NXDNDefines.h"
+#include "NXDNFACCH1.h"
+#include "NXDNSACCH.h"
+#include "NXDNCRC.h"
+#include "Clock.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+
+const unsigned int ACS_BLOCKS   = 200000U;
+const unsigned int ACS_STEPS    = 296U;
+const unsigned int CHECK_FRAMES = 200000U;
+const unsigned int BENCH_FRAMES = 200000U;
+
+const double PI = 3.14159265358979323846;
+
+const unsigned char BIT_MASK_TABLE[] = {0x80U, 0x40U, 0x20U, 0x10U, 0x08U, 0x04U, 0x02U, 0x01U};
+
+#define WRITE_BIT1(p,i,b) p[(i)>>3] = (b) ? (p[(i)>>3] | BIT_MASK_TABLE[(i)&7]) : (p[(i)>>3] & ~BIT_MASK_TABLE[(i)&7])
+#define READ_BIT1(p,i)    (p[(i)>>3] & BIT_MASK_TABLE[(i)&7])
+
+#if defined(__SSE2__) || defined(_M_X64)
+const char* ACS_NAME = "SSE2";
+#else
+const char* ACS_NAME = "scalar";
+#endif
+
+const unsigned int NUM_OF_STATES_D2 = 8U;
+const unsigned int NUM_OF_STATES    = 16U;
+const unsigned int K                = 5U;
+
+// The scalar add-compare-select of NXDNConvolution.cpp. With 16 bit
+// metrics it renormalises as that does, with 32 bit ones it never needs to.
+template <typename T, bool RENORMALISE>
+class CReferenceViterbi {
+public:
+	void start()
+	{
+		::memset(m_metrics1, 0x00U, sizeof(m_metrics1));
+		::memset(m_metrics2, 0x00U, sizeof(m_metrics2));
+
+		m_oldMetrics = m_metrics1;
+		m_newMetrics = m_metrics2;
+		m_dp = m_decisions;
+		m_renormalised = 0U;
+	}
+
+	void decode(uint8_t s0, uint8_t s1)
+	{
+		static const uint8_t BRANCH_TABLE1[] = {0U, 0U, 0U, 0U, 1U, 1U, 1U, 1U};
+		static const uint8_t BRANCH_TABLE2[] = {0U, 1U, 1U, 0U, 0U, 1U, 1U, 0U};
+
+		const T M = 2 * NXDN_SOFT_ONE;
+		const T distance0[] = { s0, T(NXDN_SOFT_ONE - s0) };
+		const T distance1[] = { s1, T(NXDN_SOFT_ONE - s1) };
+
+		uint16_t decisions = 0U;
+
+		for (unsigned int i = 0U; i < NUM_OF_STATES_D2; i++) {
+			unsigned int j = i * 2U;
+
+			T metric = distance0[BRANCH_TABLE1[i]] + distance1[BRANCH_TABLE2[i]];
+
+			T m0 = m_oldMetrics[i] + metric;
+			T m1 = m_oldMetrics[i + NUM_OF_STATES_D2] + (M - metric);
+			uint16_t decision0 = (m0 >= m1) ? 1U : 0U;
+			m_newMetrics[j + 0U] = decision0 != 0U ? m1 : m0;
+
+			m0 = m_oldMetrics[i] + (M - metric);
+			m1 = m_oldMetrics[i + NUM_OF_STATES_D2] + metric;
+			uint16_t decision1 = (m0 >= m1) ? 1U : 0U;
+			m_newMetrics[j + 1U] = decision1 != 0U ? m1 : m0;
+
+			decisions |= (decision1 << (j + 1U)) | (decision0 << (j + 0U));
+		}
+
+		if (RENORMALISE && m_newMetrics[0U] >= 0x4000) {
+			T min = m_newMetrics[0U];
+			for (unsigned int i = 1U; i < NUM_OF_STATES; i++)
+				min = m_newMetrics[i] < min ? m_newMetrics[i] : min;
+
+			for (unsigned int i = 0U; i < NUM_OF_STATES; i++)
+				m_newMetrics[i] -= min;
+
+			m_renormalised++;
+		}
+
+		*m_dp++ = decisions;
+
+		T* tmp = m_oldMetrics;
+		m_oldMetrics = m_newMetrics;
+		m_newMetrics = tmp;
+	}
+
+	void chainback(unsigned char* out, unsigned int nBits)
+	{
+		uint32_t state = 0U;
+
+		while (nBits-- > 0) {
+			--m_dp;
+
+			uint32_t  i = state >> (9 - K);
+			uint8_t bit = uint8_t(*m_dp >> i) & 1;
+			state = (bit << 7) | (state >> 1);
+
+			WRITE_BIT1(out, nBits, bit != 0U);
+		}
+	}
+
+	// The metrics less the smallest, which renormalising must not change
+	void getRelative(int32_t* metrics) const
+	{
+		T min = m_oldMetrics[0U];
+		for (unsigned int i = 1U; i < NUM_OF_STATES; i++)
+			min = m_oldMetrics[i] < min ? m_oldMetrics[i] : min;
+
+		for (unsigned int i = 0U; i < NUM_OF_STATES; i++)
+			metrics[i] = int32_t(m_oldMetrics[i] - min);
+	}
+
+	unsigned int getRenormalised() const
+	{
+		return m_renormalised;
+	}
+
+private:
+	T            m_metrics1[NUM_OF_STATES];
+	T            m_metrics2[NUM_OF_STATES];
+	T*           m_oldMetrics;
+	T*           m_newMetrics;
+	uint16_t     m_decisions[300U];
+	uint16_t*    m_dp;
+	unsigned int m_renormalised;
+};
+
+// CNXDNConvolution as it was before soft decisions, coded bits 0 and 2
+// with 1 for an erasure
+class COldConvolution {
+public:
+	void start()
+	{
+		::memset(m_metrics1, 0x00U, sizeof(m_metrics1));
+		::memset(m_metrics2, 0x00U, sizeof(m_metrics2));
+
+		m_oldMetrics = m_metrics1;
+		m_newMetrics = m_metrics2;
+		m_dp = m_decisions;
+	}
+
+	void decode(uint8_t s0, uint8_t s1)
+	{
+		static const uint8_t BRANCH_TABLE1[] = {0U, 0U, 0U, 0U, 2U, 2U, 2U, 2U};
+		static const uint8_t BRANCH_TABLE2[] = {0U, 2U, 2U, 0U, 0U, 2U, 2U, 0U};
+
+		const uint32_t M = 4U;
+
+		*m_dp = 0U;
+
+		for (uint8_t i = 0U; i < NUM_OF_STATES_D2; i++) {
+			uint8_t j = i * 2U;
+
+			uint16_t metric = std::abs(BRANCH_TABLE1[i] - s0) + std::abs(BRANCH_TABLE2[i] - s1);
+
+			uint16_t m0 = m_oldMetrics[i] + metric;
+			uint16_t m1 = m_oldMetrics[i + NUM_OF_STATES_D2] + (M - metric);
+			uint8_t decision0 = (m0 >= m1) ? 1U : 0U;
+			m_newMetrics[j + 0U] = decision0 != 0U ? m1 : m0;
+
+			m0 = m_oldMetrics[i] + (M - metric);
+			m1 = m_oldMetrics[i + NUM_OF_STATES_D2] + metric;
+			uint8_t decision1 = (m0 >= m1) ? 1U : 0U;
+			m_newMetrics[j + 1U] = decision1 != 0U ? m1 : m0;
+
+			*m_dp |= (uint64_t(decision1) << (j + 1U)) | (uint64_t(decision0) << (j + 0U));
+		}
+
+		++m_dp;
+
+		uint16_t* tmp = m_oldMetrics;
+		m_oldMetrics = m_newMetrics;
+		m_newMetrics = tmp;
+	}
+
+	void chainback(unsigned char* out, unsigned int nBits)
+	{
+		uint32_t state = 0U;
+
+		while (nBits-- > 0) {
+			--m_dp;
+
+			uint32_t  i = state >> (9 - K);
+			uint8_t bit = uint8_t(*m_dp >> i) & 1;
+			state = (bit << 7) | (state >> 1);
+
+			WRITE_BIT1(out, nBits, bit != 0U);
+		}
+	}
+
+private:
+	uint16_t  m_metrics1[NUM_OF_STATES];
+	uint16_t  m_metrics2[NUM_OF_STATES];
+	uint16_t* m_oldMetrics;
+	uint16_t* m_newMetrics;
+	uint64_t  m_decisions[300U];
+	uint64_t* m_dp;
+};
+
+const unsigned int SACCH_INTERLEAVE_TABLE[] = {
+	0U, 5U, 10U, 15U, 20U, 25U, 30U, 35U, 40U, 45U, 50U, 55U,
+	1U, 6U, 11U, 16U, 21U, 26U, 31U, 36U, 41U, 46U, 51U, 56U,
+	2U, 7U, 12U, 17U, 22U, 27U, 32U, 37U, 42U, 47U, 52U, 57U,
+	3U, 8U, 13U, 18U, 23U, 28U, 33U, 38U, 43U, 48U, 53U, 58U,
+	4U, 9U, 14U, 19U, 24U, 29U, 34U, 39U, 44U, 49U, 54U, 59U
+};
+
+const unsigned int SACCH_PUNCTURE_LIST[] = { 5U, 11U, 17U, 23U, 29U, 35U, 41U, 47U, 53U, 59U, 65U, 71U };
+
+// CNXDNSACCH::decode() as it was. The loop ends before the last punctured
+// position, which the zeros of the tail then filled as a hard 0. With
+// erasedTail it is an erasure, as it now is.
+static bool oldSACCH(const unsigned char* data, unsigned char* out, bool erasedTail)
+{
+	unsigned char temp1[8U];
+
+	for (unsigned int i = 0U; i < NXDN_SACCH_LENGTH_BITS; i++) {
+		unsigned int n = SACCH_INTERLEAVE_TABLE[i] + NXDN_FSW_LENGTH_BITS + NXDN_LICH_LENGTH_BITS;
+		bool b = READ_BIT1(data, n);
+		WRITE_BIT1(temp1, i, b);
+	}
+
+	uint8_t temp2[90U];
+
+	unsigned int n = 0U;
+	unsigned int index = 0U;
+	for (unsigned int i = 0U; i < NXDN_SACCH_LENGTH_BITS; i++) {
+		if (n == SACCH_PUNCTURE_LIST[index]) {
+			temp2[n++] = 1U;
+			index++;
+		}
+
+		bool b = READ_BIT1(temp1, i);
+		temp2[n++] = b ? 2U : 0U;
+	}
+
+	for (unsigned int i = 0U; i < 8U; i++) {
+		temp2[n++] = 0U;
+	}
+
+	if (erasedTail)
+		temp2[71U] = 1U;
+
+	COldConvolution conv;
+	conv.start();
+
+	n = 0U;
+	for (unsigned int i = 0U; i < 40U; i++) {
+		uint8_t s0 = temp2[n++];
+		uint8_t s1 = temp2[n++];
+
+		conv.decode(s0, s1);
+	}
+
+	conv.chainback(out, 36U);
+
+	return CNXDNCRC::checkCRC6(out, 26U);
+}
+
+// NXDN2DMR had no FACCH1 decoder before. This is the hard decision one
+// written the way the SACCH one above was.
+static bool oldFACCH1(const unsigned char* data, unsigned int offset, unsigned char* out)
+{
+	unsigned char temp1[18U];
+
+	for (unsigned int i = 0U; i < NXDN_FACCH1_LENGTH_BITS; i++) {
+		unsigned int n = (i % 9U) * 16U + i / 9U + offset;
+		bool b = READ_BIT1(data, n);
+		WRITE_BIT1(temp1, i, b);
+	}
+
+	uint8_t temp2[210U];
+
+	unsigned int n = 0U;
+	for (unsigned int i = 0U; i < NXDN_FACCH1_LENGTH_BITS; i++) {
+		if ((n % 4U) == 1U)
+			temp2[n++] = 1U;
+
+		bool b = READ_BIT1(temp1, i);
+		temp2[n++] = b ? 2U : 0U;
+	}
+
+	for (unsigned int i = 0U; i < 8U; i++) {
+		temp2[n++] = 0U;
+	}
+
+	COldConvolution conv;
+	conv.start();
+
+	n = 0U;
+	for (unsigned int i = 0U; i < 100U; i++) {
+		uint8_t s0 = temp2[n++];
+		uint8_t s1 = temp2[n++];
+
+		conv.decode(s0, s1);
+	}
+
+	conv.chainback(out, 96U);
+
+	return CNXDNCRC::checkCRC12(out, 80U);
+}
+
+static double gaussian()
+{
+	double u1 = (double(::rand()) + 1.0) / (double(RAND_MAX) + 2.0);
+	double u2 = (double(::rand()) + 1.0) / (double(RAND_MAX) + 2.0);
+
+	return ::sqrt(-2.0 * ::log(u1)) * ::cos(2.0 * PI * u2);
+}
+
+// Antipodal bits with white noise at snr dB Es/N0, as soft symbols and as
+// the hard bits a slicer would give. No noise at all when snr is negative.
+static void addNoise(const unsigned char* bits, unsigned int offset, unsigned int length, double snr, uint8_t* soft, unsigned char* hard)
+{
+	double sigma = snr < 0.0 ? 0.0 : ::sqrt(1.0 / (2.0 * ::pow(10.0, snr / 10.0)));
+
+	for (unsigned int i = 0U; i < length; i++) {
+		double y = (READ_BIT1(bits, offset + i) ? 1.0 : -1.0) + sigma * gaussian();
+
+		double s = ::floor((y + 1.0) * NXDN_SOFT_ONE / 2.0 + 0.5);
+		soft[i] = s < 0.0 ? 0U : (s > NXDN_SOFT_ONE ? NXDN_SOFT_ONE : uint8_t(s));
+
+		WRITE_BIT1(hard, offset + i, y > 0.0);
+	}
+}
+
+static unsigned int checkACS()
+{
+	CNXDNConvolution conv;
+	CReferenceViterbi<int16_t, true>  scalar;
+	CReferenceViterbi<int32_t, false> wide;
+
+	unsigned int failures = 0U;
+	unsigned int renormalised = 0U;
+
+	for (unsigned int n = 0U; n < ACS_BLOCKS; n++) {
+		conv.start();
+		scalar.start();
+		wide.start();
+
+		bool metricsDiffer = false;
+
+		for (unsigned int i = 0U; i < ACS_STEPS; i++) {
+			uint8_t s0, s1;
+
+			// Random soft, hard and erased symbols, and runs of worst case
+			// symbols that push the metrics up as fast as they can go
+			switch (n % 4U) {
+			case 0U:
+				s0 = ::rand() % (NXDN_SOFT_ONE + 1U);
+				s1 = ::rand() % (NXDN_SOFT_ONE + 1U);
+				break;
+			case 1U:
+				s0 = (::rand() & 0x01U) ? NXDN_SOFT_ONE : 0U;
+				s1 = (::rand() & 0x01U) ? NXDN_SOFT_ONE : 0U;
+				break;
+			case 2U:
+				s0 = (::rand() % 3U) * NXDN_SOFT_ERASURE;
+				s1 = (::rand() % 3U) * NXDN_SOFT_ERASURE;
+				break;
+			default:
+				s0 = NXDN_SOFT_ERASURE + (::rand() & 0x01U);
+				s1 = NXDN_SOFT_ERASURE - (::rand() & 0x01U);
+				break;
+			}
+
+			conv.decode(s0, s1);
+			scalar.decode(s0, s1);
+			wide.decode(s0, s1);
+
+			int32_t metrics16[NUM_OF_STATES], metrics32[NUM_OF_STATES];
+			scalar.getRelative(metrics16);
+			wide.getRelative(metrics32);
+
+			if (::memcmp(metrics16, metrics32, sizeof(metrics16)) != 0)
+				metricsDiffer = true;
+		}
+
+		renormalised += scalar.getRenormalised();
+
+		unsigned char out1[40U], out2[40U], out3[40U];
+		conv.chainback(out1, ACS_STEPS);
+		scalar.chainback(out2, ACS_STEPS);
+		wide.chainback(out3, ACS_STEPS);
+
+		unsigned int bytes = ACS_STEPS / 8U;
+		if (metricsDiffer || ::memcmp(out1, out2, bytes) != 0 || ::memcmp(out1, out3, bytes) != 0) {
+			if (failures < 5U)
+				::printf("ACS block %u differs%s\n", n, metricsDiffer ? " in the metrics" : "");
+			failures++;
+		}
+	}
+
+	::printf("ACS: %u blocks of %u steps checked, %s and scalar against 32 bit metrics, %u renormalisations, %u differences\n", ACS_BLOCKS, ACS_STEPS, ACS_NAME, renormalised, failures);
+
+	return failures;
+}
+
+// Old and new are compared on the bits they decode and on the CRC result.
+// The counts are of frames that passed the CRC, and of those that passed
+// with the wrong bits.
+class CChannelCounts {
+public:
+	CChannelCounts() :
+	m_differences(0U),
+	m_tailDifferences(0U),
+	m_oldPassed(0U),
+	m_hardPassed(0U),
+	m_softPassed(0U),
+	m_oldWrong(0U),
+	m_hardWrong(0U),
+	m_softWrong(0U)
+	{
+	}
+
+	unsigned int m_differences;
+	unsigned int m_tailDifferences;
+	unsigned int m_oldPassed;
+	unsigned int m_hardPassed;
+	unsigned int m_softPassed;
+	unsigned int m_oldWrong;
+	unsigned int m_hardWrong;
+	unsigned int m_softWrong;
+};
+
+static void printCounts(const char* name, double snr, const CChannelCounts& counts)
+{
+	char level[20U];
+	if (snr < 0.0)
+		::snprintf(level, sizeof(level), "clean");
+	else
+		::snprintf(level, sizeof(level), "%.0f dB", snr);
+
+	double frames = double(CHECK_FRAMES);
+	::printf("%s %s: %u frames checked, %u differences", name, level, CHECK_FRAMES, counts.m_differences);
+	if (counts.m_tailDifferences > 0U)
+		::printf(" (%u against the old tail)", counts.m_tailDifferences);
+	::printf(", passed old %.3f hard %.3f soft %.3f, wrong %u/%u/%u\n",
+		double(counts.m_oldPassed) / frames, double(counts.m_hardPassed) / frames, double(counts.m_softPassed) / frames,
+		counts.m_oldWrong, counts.m_hardWrong, counts.m_softWrong);
+}
+
+static unsigned int checkSACCH(double snr)
+{
+	CChannelCounts counts;
+
+	for (unsigned int n = 0U; n < CHECK_FRAMES; n++) {
+		unsigned char sent[4U];
+		for (unsigned int i = 0U; i < 4U; i++)
+			sent[i] = ::rand();
+
+		CNXDNSACCH sacch;
+		sacch.setRaw(sent);
+
+		unsigned char frame[NXDN_FRAME_LENGTH_BYTES];
+		::memset(frame, 0x00U, NXDN_FRAME_LENGTH_BYTES);
+		sacch.encode(frame);
+		sacch.getRaw(sent);
+
+		const unsigned int offset = NXDN_FSW_LENGTH_BITS + NXDN_LICH_LENGTH_BITS;
+
+		uint8_t soft[NXDN_SACCH_LENGTH_BITS];
+		unsigned char hard[NXDN_FRAME_LENGTH_BYTES];
+		::memcpy(hard, frame, NXDN_FRAME_LENGTH_BYTES);
+		addNoise(frame, offset, NXDN_SACCH_LENGTH_BITS, snr, soft, hard);
+
+		unsigned char old[5U], oldTail[5U], decoded[4U];
+		bool oldValid  = oldSACCH(hard, old, true);
+		bool tailValid = oldSACCH(hard, oldTail, false);
+
+		CNXDNSACCH hardSACCH;
+		bool hardValid = hardSACCH.decode(hard);
+		hardSACCH.getRaw(decoded);
+
+		CNXDNSACCH softSACCH;
+		bool softValid = softSACCH.decodeSoft(soft);
+		unsigned char softDecoded[4U];
+		softSACCH.getRaw(softDecoded);
+
+		// The 26 data bits, getRaw() recomputes the CRC
+		bool same = oldValid == hardValid && ::memcmp(old, decoded, 3U) == 0 && (old[3U] & 0xC0U) == (decoded[3U] & 0xC0U);
+		if (!same) {
+			if (counts.m_differences < 5U)
+				::printf("SACCH frame %u differs\n", n);
+			counts.m_differences++;
+		}
+
+		bool tailSame = tailValid == hardValid && ::memcmp(oldTail, decoded, 3U) == 0 && (oldTail[3U] & 0xC0U) == (decoded[3U] & 0xC0U);
+		if (!tailSame)
+			counts.m_tailDifferences++;
+
+		if (tailValid) {
+			counts.m_oldPassed++;
+			if (::memcmp(oldTail, sent, 3U) != 0 || (oldTail[3U] & 0xC0U) != (sent[3U] & 0xC0U))
+				counts.m_oldWrong++;
+		}
+
+		if (hardValid) {
+			counts.m_hardPassed++;
+			if (::memcmp(decoded, sent, 4U) != 0)
+				counts.m_hardWrong++;
+		}
+
+		if (softValid) {
+			counts.m_softPassed++;
+			if (::memcmp(softDecoded, sent, 4U) != 0)
+				counts.m_softWrong++;
+		}
+	}
+
+	printCounts("SACCH", snr, counts);
+
+	return counts.m_differences;
+}
+
+static unsigned int checkFACCH1(double snr)
+{
+	CChannelCounts counts;
+
+	const unsigned int offset = NXDN_FSW_LICH_SACCH_LENGTH_BITS;
+
+	for (unsigned int n = 0U; n < CHECK_FRAMES; n++) {
+		unsigned char sent[10U];
+		for (unsigned int i = 0U; i < 10U; i++)
+			sent[i] = ::rand();
+
+		CNXDNFACCH1 facch;
+		facch.setData(sent);
+
+		unsigned char frame[NXDN_FRAME_LENGTH_BYTES];
+		::memset(frame, 0x00U, NXDN_FRAME_LENGTH_BYTES);
+		facch.encode(frame, offset);
+
+		uint8_t soft[NXDN_FACCH1_LENGTH_BITS];
+		unsigned char hard[NXDN_FRAME_LENGTH_BYTES];
+		::memcpy(hard, frame, NXDN_FRAME_LENGTH_BYTES);
+		addNoise(frame, offset, NXDN_FACCH1_LENGTH_BITS, snr, soft, hard);
+
+		unsigned char old[12U], decoded[10U], softDecoded[10U];
+		bool oldValid = oldFACCH1(hard, offset, old);
+
+		CNXDNFACCH1 hardFACCH;
+		bool hardValid = hardFACCH.decode(hard, offset);
+		hardFACCH.getData(decoded);
+
+		CNXDNFACCH1 softFACCH;
+		bool softValid = softFACCH.decodeSoft(soft);
+		softFACCH.getData(softDecoded);
+
+		if (oldValid != hardValid || ::memcmp(old, decoded, 10U) != 0) {
+			if (counts.m_differences < 5U)
+				::printf("FACCH1 frame %u differs\n", n);
+			counts.m_differences++;
+		}
+
+		if (oldValid) {
+			counts.m_oldPassed++;
+			if (::memcmp(old, sent, 10U) != 0)
+				counts.m_oldWrong++;
+		}
+
+		if (hardValid) {
+			counts.m_hardPassed++;
+			if (::memcmp(decoded, sent, 10U) != 0)
+				counts.m_hardWrong++;
+		}
+
+		if (softValid) {
+			counts.m_softPassed++;
+			if (::memcmp(softDecoded, sent, 10U) != 0)
+				counts.m_softWrong++;
+		}
+	}
+
+	printCounts("FACCH1", snr, counts);
+
+	return counts.m_differences;
+}
+
+int main()
+{
+	::srand(4600U);
+
+	unsigned int failures = checkACS();
+
+	const double SNRS[] = { -1.0, 7.0, 5.0, 3.0, 1.0 };
+	for (unsigned int i = 0U; i < 5U; i++) {
+		failures += checkSACCH(SNRS[i]);
+		failures += checkFACCH1(SNRS[i]);
+	}
+
+	// Noisy frames, so the decoders take the same paths as on the air
+	unsigned char (*frames)[NXDN_FRAME_LENGTH_BYTES] = new unsigned char[BENCH_FRAMES][NXDN_FRAME_LENGTH_BYTES];
+	uint8_t (*symbols)[NXDN_FACCH1_LENGTH_BITS] = new uint8_t[BENCH_FRAMES][NXDN_FACCH1_LENGTH_BITS];
+
+	for (unsigned int n = 0U; n < BENCH_FRAMES; n++) {
+		unsigned char data[10U];
+		for (unsigned int i = 0U; i < 10U; i++)
+			data[i] = ::rand();
+
+		::memset(frames[n], 0x00U, NXDN_FRAME_LENGTH_BYTES);
+
+		CNXDNSACCH sacch;
+		sacch.setRaw(data);
+		sacch.encode(frames[n]);
+
+		CNXDNFACCH1 facch;
+		facch.setData(data);
+		facch.encode(frames[n], NXDN_FSW_LICH_SACCH_LENGTH_BITS);
+
+		unsigned char clean[NXDN_FRAME_LENGTH_BYTES];
+		::memcpy(clean, frames[n], NXDN_FRAME_LENGTH_BYTES);
+		addNoise(clean, NXDN_FSW_LICH_SACCH_LENGTH_BITS, NXDN_FACCH1_LENGTH_BITS, 5.0, symbols[n], frames[n]);
+	}
+
+	// The sum keeps the compiler from dropping the decodes
+	unsigned int sum = 0U;
+	unsigned char out[12U];
+
+	unsigned long long start = CClock::getTime();
+	for (unsigned int n = 0U; n < BENCH_FRAMES; n++)
+		sum += oldSACCH(frames[n], out, true) ? 1U : 0U;
+	unsigned long long oldSACCHTime = CClock::getTime() - start;
+
+	CNXDNSACCH sacch;
+	start = CClock::getTime();
+	for (unsigned int n = 0U; n < BENCH_FRAMES; n++)
+		sum -= sacch.decode(frames[n]) ? 1U : 0U;
+	unsigned long long newSACCHTime = CClock::getTime() - start;
+
+	start = CClock::getTime();
+	for (unsigned int n = 0U; n < BENCH_FRAMES; n++)
+		sum += oldFACCH1(frames[n], NXDN_FSW_LICH_SACCH_LENGTH_BITS, out) ? 1U : 0U;
+	unsigned long long oldFACCH1Time = CClock::getTime() - start;
+
+	CNXDNFACCH1 facch;
+	start = CClock::getTime();
+	for (unsigned int n = 0U; n < BENCH_FRAMES; n++)
+		sum -= facch.decode(frames[n], NXDN_FSW_LICH_SACCH_LENGTH_BITS) ? 1U : 0U;
+	unsigned long long newFACCH1Time = CClock::getTime() - start;
+
+	unsigned int softPassed = 0U;
+	start = CClock::getTime();
+	for (unsigned int n = 0U; n < BENCH_FRAMES; n++)
+		softPassed += facch.decodeSoft(symbols[n]) ? 1U : 0U;
+	unsigned long long softFACCH1Time = CClock::getTime() - start;
+
+	// The ACS on its own, over the same soft symbols
+	CNXDNConvolution conv;
+	CReferenceViterbi<int16_t, true> scalar;
+
+	start = CClock::getTime();
+	for (unsigned int n = 0U; n < BENCH_FRAMES; n++) {
+		conv.start();
+		for (unsigned int i = 0U; i < NXDN_FACCH1_LENGTH_BITS; i += 2U)
+			conv.decode(symbols[n][i], symbols[n][i + 1U]);
+		conv.chainback(out, 72U);
+		sum += out[0U];
+	}
+	unsigned long long convTime = CClock::getTime() - start;
+
+	start = CClock::getTime();
+	for (unsigned int n = 0U; n < BENCH_FRAMES; n++) {
+		scalar.start();
+		for (unsigned int i = 0U; i < NXDN_FACCH1_LENGTH_BITS; i += 2U)
+			scalar.decode(symbols[n][i], symbols[n][i + 1U]);
+		scalar.chainback(out, 72U);
+		sum -= out[0U];
+	}
+	unsigned long long scalarTime = CClock::getTime() - start;
+
+	delete[] frames;
+	delete[] symbols;
+
+	double perFrame = 1000.0 / BENCH_FRAMES;
+	double perStep  = perFrame / (NXDN_FACCH1_LENGTH_BITS / 2U);
+	::printf("SACCH: %.1f ns/frame old, %.1f ns/frame new\n", double(oldSACCHTime) * perFrame, double(newSACCHTime) * perFrame);
+	::printf("FACCH1: %.1f ns/frame old, %.1f ns/frame new, %.1f ns/frame soft (%u of %u passed at 5 dB)\n", double(oldFACCH1Time) * perFrame, double(newFACCH1Time) * perFrame, double(softFACCH1Time) * perFrame, softPassed, BENCH_FRAMES);
+	::printf("ACS: %.2f ns/step %s, %.2f ns/step scalar\n", double(convTime) * perStep, ACS_NAME, double(scalarTime) * perStep);
+
+	return (failures == 0U && sum == 0U) ? 0 : 1;
+}
@@ -19,25 +19,65 @@
 
 #include "BPTC19696.h"
 
-#include "Hamming.h"
-#include "Utils.h"
+#include "ECCTables.h"
 
 #include <cstdio>
 #include <cassert>
 #include <cstring>
 
-CBPTC19696::CBPTC19696() :
-m_rawData(NULL),
-m_deInterData(NULL)
+// Where each of the 195 matrix bits, taken row by row, is in the 33 byte
+// burst, as the byte number times eight plus the shift of the bit in that
+// byte. The matrix position a + 1 (position 0 is the unused R(3)) is sent
+// as bit (a * 181) % 196 of the 196 BPTC bits, of which the first 98 are at
+// the start of the burst and the rest follow the sync/slot type.
+static constexpr CECCTable<uint16_t, 195U> makeInterleaveTable()
 {
-	m_rawData     = new bool[196];
-	m_deInterData = new bool[196];
+	CECCTable<uint16_t, 195U> table = {};
+
+	for (unsigned int i = 0U; i < 195U; i++) {
+		unsigned int bit = ((i + 1U) * 181U) % 196U;
+		if (bit >= 98U)
+			bit += 68U;
+
+		table.m_data[i] = uint16_t((bit & ~0x07U) | (7U - (bit & 0x07U)));
+	}
+
+	return table;
+}
+
+static constexpr CECCTable<uint16_t, 195U> INTERLEAVE_TABLE = makeInterleaveTable();
+
+// Hamming (15,11,3) check equations for a row, data and check bits
+const uint16_t ROW_CHECK[] = {0x7AC8U, 0x3D64U, 0x1EB2U, 0x7591U};
+
+// Bit to correct in a row for each syndrome
+const uint16_t ROW_ERROR[] = {0x0000U, 0x0008U, 0x0004U, 0x0040U, 0x0002U, 0x0200U, 0x0020U, 0x0800U,
+							  0x0001U, 0x4000U, 0x0100U, 0x2000U, 0x0010U, 0x0080U, 0x0400U, 0x1000U};
+
+// Hamming (13,9,3) syndromes and the row that each one corrects in a column
+const unsigned int COLUMN_ERRORS = 13U;
+const unsigned char COLUMN_SYNDROME[] = {0x01U, 0x02U, 0x04U, 0x08U, 0x0FU, 0x07U, 0x0EU, 0x05U, 0x0AU, 0x0DU, 0x03U, 0x06U, 0x0CU};
+const unsigned char COLUMN_ROW[]      = {9U,    10U,   11U,   12U,   0U,    1U,    2U,    3U,    4U,    5U,    6U,    7U,    8U};
+
+const uint16_t ROW_MASK = 0x7FFFU;
+
+static unsigned int parity(unsigned int value)
+{
+	value ^= value >> 8;
+	value ^= value >> 4;
+	value ^= value >> 2;
+	value ^= value >> 1;
+
+	return value & 0x01U;
+}
+
+CBPTC19696::CBPTC19696()
+{
+	::memset(m_rows, 0x00U, sizeof(m_rows));
 }
 
 CBPTC19696::~CBPTC19696()
 {
-	delete[] m_rawData;
-	delete[] m_deInterData;
 }
 
 // The main decode function
@@ -46,12 +86,9 @@ void CBPTC19696::decode(const unsigned char* in, unsigned char* out)
 	assert(in != NULL);
 	assert(out != NULL);
 
-	//  Get the raw binary
+	//  Get the raw binary and deinterleave it
 	decodeExtractBinary(in);
 
-	// Deinterleave
-	decodeDeInterleave();
-
 	// Error check
 	decodeErrorCheck();
 
@@ -71,63 +108,21 @@ void CBPTC19696::encode(const unsigned char* in, unsigned char* out)
 	// Error check
 	encodeErrorCheck();
 
-	// Deinterleave
-	encodeInterleave();
-
-	//  Get the raw binary
+	//  Interleave and get the raw binary
 	encodeExtractBinary(out);
 }
 
 void CBPTC19696::decodeExtractBinary(const unsigned char* in)
 {
-	// First block
-	CUtils::byteToBitsBE(in[0U],  m_rawData + 0U);
-	CUtils::byteToBitsBE(in[1U],  m_rawData + 8U);
-	CUtils::byteToBitsBE(in[2U],  m_rawData + 16U);
-	CUtils::byteToBitsBE(in[3U],  m_rawData + 24U);
-	CUtils::byteToBitsBE(in[4U],  m_rawData + 32U);
-	CUtils::byteToBitsBE(in[5U],  m_rawData + 40U);
-	CUtils::byteToBitsBE(in[6U],  m_rawData + 48U);
-	CUtils::byteToBitsBE(in[7U],  m_rawData + 56U);
-	CUtils::byteToBitsBE(in[8U],  m_rawData + 64U);
-	CUtils::byteToBitsBE(in[9U],  m_rawData + 72U);
-	CUtils::byteToBitsBE(in[10U], m_rawData + 80U);
-	CUtils::byteToBitsBE(in[11U], m_rawData + 88U);
-	CUtils::byteToBitsBE(in[12U], m_rawData + 96U);
-
-	// Handle the two bits
-	bool bits[8U];
-	CUtils::byteToBitsBE(in[20U], bits);
-	m_rawData[98U] = bits[6U];
-	m_rawData[99U] = bits[7U];
-
-	// Second block
-	CUtils::byteToBitsBE(in[21U], m_rawData + 100U);
-	CUtils::byteToBitsBE(in[22U], m_rawData + 108U);
-	CUtils::byteToBitsBE(in[23U], m_rawData + 116U);
-	CUtils::byteToBitsBE(in[24U], m_rawData + 124U);
-	CUtils::byteToBitsBE(in[25U], m_rawData + 132U);
-	CUtils::byteToBitsBE(in[26U], m_rawData + 140U);
-	CUtils::byteToBitsBE(in[27U], m_rawData + 148U);
-	CUtils::byteToBitsBE(in[28U], m_rawData + 156U);
-	CUtils::byteToBitsBE(in[29U], m_rawData + 164U);
-	CUtils::byteToBitsBE(in[30U], m_rawData + 172U);
-	CUtils::byteToBitsBE(in[31U], m_rawData + 180U);
-	CUtils::byteToBitsBE(in[32U], m_rawData + 188U);
-}
+	const uint16_t* pos = &INTERLEAVE_TABLE[0U];
 
-// Deinterleave the raw data
-void CBPTC19696::decodeDeInterleave()
-{
-	for (unsigned int i = 0U; i < 196U; i++)
-		m_deInterData[i] = false;
-
-	// The first bit is R(3) which is not used so can be ignored
-	for (unsigned int a = 0U; a < 196U; a++)	{
-		// Calculate the interleave sequence
-		unsigned int interleaveSequence = (a * 181U) % 196U;
-		// Shuffle the data
-		m_deInterData[a] = m_rawData[interleaveSequence];
+	for (unsigned int r = 0U; r < 13U; r++) {
+		uint16_t row = 0U;
+
+		for (unsigned int c = 0U; c < 15U; c++, pos++)
+			row = (row << 1) | ((in[*pos >> 3] >> (*pos & 0x07U)) & 0x01U);
+
+		m_rows[r] = row;
 	}
 }
 
@@ -139,209 +134,118 @@ void CBPTC19696::decodeErrorCheck()
 	do {
 		fixing = false;
 
-		// Run through each of the 15 columns
-		bool col[13U];
-		for (unsigned int c = 0U; c < 15U; c++) {
-			unsigned int pos = c + 1U;
-			for (unsigned int a = 0U; a < 13U; a++) {
-				col[a] = m_deInterData[pos];
-				pos = pos + 15U;
-			}
-
-			if (CHamming::decode1393(col)) {
-				unsigned int pos = c + 1U;
-				for (unsigned int a = 0U; a < 13U; a++) {
-					m_deInterData[pos] = col[a];
-					pos = pos + 15U;
-				}
-
+		// The columns are checked all at once, bit c of each syndrome word
+		// belongs to column c
+		const uint16_t* d = m_rows;
+		uint16_t s0 = d[0] ^ d[1] ^ d[3] ^ d[5] ^ d[6] ^ d[9];
+		uint16_t s1 = d[0] ^ d[1] ^ d[2] ^ d[4] ^ d[6] ^ d[7] ^ d[10];
+		uint16_t s2 = d[0] ^ d[1] ^ d[2] ^ d[3] ^ d[5] ^ d[7] ^ d[8] ^ d[11];
+		uint16_t s3 = d[0] ^ d[2] ^ d[4] ^ d[5] ^ d[8] ^ d[12];
+
+		for (unsigned int i = 0U; i < COLUMN_ERRORS; i++) {
+			unsigned char n = COLUMN_SYNDROME[i];
+
+			uint16_t columns = ROW_MASK;
+			columns &= (n & 0x01U) ? s0 : uint16_t(~s0);
+			columns &= (n & 0x02U) ? s1 : uint16_t(~s1);
+			columns &= (n & 0x04U) ? s2 : uint16_t(~s2);
+			columns &= (n & 0x08U) ? s3 : uint16_t(~s3);
+
+			if (columns != 0U) {
+				m_rows[COLUMN_ROW[i]] ^= columns;
 				fixing = true;
 			}
 		}
 
 		// Run through each of the 9 rows containing data
 		for (unsigned int r = 0U; r < 9U; r++) {
-			unsigned int pos = (r * 15U) + 1U;
-			if (CHamming::decode15113_2(m_deInterData + pos))
+			unsigned int n = 0U;
+			for (unsigned int i = 0U; i < 4U; i++)
+				n |= parity(m_rows[r] & ROW_CHECK[i]) << i;
+
+			if (n != 0U) {
+				m_rows[r] ^= ROW_ERROR[n];
 				fixing = true;
+			}
 		}
 
 		count++;
 	} while (fixing && count < 5U);
 }
 
-// Extract the 96 bits of payload
+// Extract the 96 bits of payload, eight from the first row and eleven from
+// each of the next eight
 void CBPTC19696::decodeExtractData(unsigned char* data) const
 {
-	bool bData[96U];
-	unsigned int pos = 0U;
-	for (unsigned int a = 4U; a <= 11U; a++, pos++)
-		bData[pos] = m_deInterData[a];
-
-	for (unsigned int a = 16U; a <= 26U; a++, pos++)
-		bData[pos] = m_deInterData[a];
-
-	for (unsigned int a = 31U; a <= 41U; a++, pos++)
-		bData[pos] = m_deInterData[a];
-
-	for (unsigned int a = 46U; a <= 56U; a++, pos++)
-		bData[pos] = m_deInterData[a];
-
-	for (unsigned int a = 61U; a <= 71U; a++, pos++)
-		bData[pos] = m_deInterData[a];
-
-	for (unsigned int a = 76U; a <= 86U; a++, pos++)
-		bData[pos] = m_deInterData[a];
-
-	for (unsigned int a = 91U; a <= 101U; a++, pos++)
-		bData[pos] = m_deInterData[a];
-
-	for (unsigned int a = 106U; a <= 116U; a++, pos++)
-		bData[pos] = m_deInterData[a];
-
-	for (unsigned int a = 121U; a <= 131U; a++, pos++)
-		bData[pos] = m_deInterData[a];
-
-	CUtils::bitsToByteBE(bData + 0U,  data[0U]);
-	CUtils::bitsToByteBE(bData + 8U,  data[1U]);
-	CUtils::bitsToByteBE(bData + 16U, data[2U]);
-	CUtils::bitsToByteBE(bData + 24U, data[3U]);
-	CUtils::bitsToByteBE(bData + 32U, data[4U]);
-	CUtils::bitsToByteBE(bData + 40U, data[5U]);
-	CUtils::bitsToByteBE(bData + 48U, data[6U]);
-	CUtils::bitsToByteBE(bData + 56U, data[7U]);
-	CUtils::bitsToByteBE(bData + 64U, data[8U]);
-	CUtils::bitsToByteBE(bData + 72U, data[9U]);
-	CUtils::bitsToByteBE(bData + 80U, data[10U]);
-	CUtils::bitsToByteBE(bData + 88U, data[11U]);
+	data[0U] = (m_rows[0U] >> 4) & 0xFFU;
+
+	unsigned int n = 1U;
+	unsigned int bits = 0U;
+	uint32_t acc = 0U;
+	for (unsigned int r = 1U; r < 9U; r++) {
+		acc = (acc << 11) | ((m_rows[r] >> 4) & 0x7FFU);
+		bits += 11U;
+
+		while (bits >= 8U) {
+			bits -= 8U;
+			data[n++] = (acc >> bits) & 0xFFU;
+		}
+	}
 }
 
-// Extract the 96 bits of payload
-void CBPTC19696::encodeExtractData(const unsigned char* in) const
+// Place the 96 bits of payload in the matrix, the three reserved bits of
+// the first row are left as zero
+void CBPTC19696::encodeExtractData(const unsigned char* in)
 {
-	bool bData[96U];
-	CUtils::byteToBitsBE(in[0U],  bData + 0U);
-	CUtils::byteToBitsBE(in[1U],  bData + 8U);
-	CUtils::byteToBitsBE(in[2U],  bData + 16U);
-	CUtils::byteToBitsBE(in[3U],  bData + 24U);
-	CUtils::byteToBitsBE(in[4U],  bData + 32U);
-	CUtils::byteToBitsBE(in[5U],  bData + 40U);
-	CUtils::byteToBitsBE(in[6U],  bData + 48U);
-	CUtils::byteToBitsBE(in[7U],  bData + 56U);
-	CUtils::byteToBitsBE(in[8U],  bData + 64U);
-	CUtils::byteToBitsBE(in[9U],  bData + 72U);
-	CUtils::byteToBitsBE(in[10U], bData + 80U);
-	CUtils::byteToBitsBE(in[11U], bData + 88U);
-
-	for (unsigned int i = 0U; i < 196U; i++)
-		m_deInterData[i] = false;
-
-	unsigned int pos = 0U;
-	for (unsigned int a = 4U; a <= 11U; a++, pos++)
-		m_deInterData[a] = bData[pos];
-
-	for (unsigned int a = 16U; a <= 26U; a++, pos++)
-		m_deInterData[a] = bData[pos];
-
-	for (unsigned int a = 31U; a <= 41U; a++, pos++)
-		m_deInterData[a] = bData[pos];
-
-	for (unsigned int a = 46U; a <= 56U; a++, pos++)
-		m_deInterData[a] = bData[pos];
-
-	for (unsigned int a = 61U; a <= 71U; a++, pos++)
-		m_deInterData[a] = bData[pos];
-
-	for (unsigned int a = 76U; a <= 86U; a++, pos++)
-		m_deInterData[a] = bData[pos];
-
-	for (unsigned int a = 91U; a <= 101U; a++, pos++)
-		m_deInterData[a] = bData[pos];
-
-	for (unsigned int a = 106U; a <= 116U; a++, pos++)
-		m_deInterData[a] = bData[pos];
-
-	for (unsigned int a = 121U; a <= 131U; a++, pos++)
-		m_deInterData[a] = bData[pos];
-}
+	::memset(m_rows, 0x00U, sizeof(m_rows));
 
-// Check each row with a Hamming (15,11,3) code and each column with a Hamming (13,9,3) code
-void CBPTC19696::encodeErrorCheck()
-{
+	m_rows[0U] = uint16_t(in[0U]) << 4;
 
-	// Run through each of the 9 rows containing data
-	for (unsigned int r = 0U; r < 9U; r++) {
-		unsigned int pos = (r * 15U) + 1U;
-		CHamming::encode15113_2(m_deInterData + pos);
-	}
-
-	// Run through each of the 15 columns
-	bool col[13U];
-	for (unsigned int c = 0U; c < 15U; c++) {
-		unsigned int pos = c + 1U;
-		for (unsigned int a = 0U; a < 13U; a++) {
-			col[a] = m_deInterData[pos];
-			pos = pos + 15U;
+	unsigned int n = 1U;
+	unsigned int bits = 0U;
+	uint32_t acc = 0U;
+	for (unsigned int r = 1U; r < 9U; r++) {
+		while (bits < 11U) {
+			acc = (acc << 8) | in[n++];
+			bits += 8U;
 		}
 
-		CHamming::encode1393(col);
-
-		pos = c + 1U;
-		for (unsigned int a = 0U; a < 13U; a++) {
-			m_deInterData[pos] = col[a];
-			pos = pos + 15U;
-		}
+		bits -= 11U;
+		m_rows[r] = uint16_t(((acc >> bits) & 0x7FFU) << 4);
 	}
 }
 
-// Interleave the raw data
-void CBPTC19696::encodeInterleave()
+// Add the Hamming (15,11,3) check bits to each row and the Hamming (13,9,3) check bits to each column
+void CBPTC19696::encodeErrorCheck()
 {
-	for (unsigned int i = 0U; i < 196U; i++)
-		m_rawData[i] = false;
-
-	// The first bit is R(3) which is not used so can be ignored
-	for (unsigned int a = 0U; a < 196U; a++)	{
-		// Calculate the interleave sequence
-		unsigned int interleaveSequence = (a * 181U) % 196U;
-		// Unshuffle the data
-		m_rawData[interleaveSequence] = m_deInterData[a];
+	// Run through each of the 9 rows containing data
+	for (unsigned int r = 0U; r < 9U; r++) {
+		for (unsigned int i = 0U; i < 4U; i++)
+			m_rows[r] |= parity(m_rows[r] & ROW_CHECK[i] & 0x7FF0U) << (3U - i);
 	}
+
+	// The four check rows cover all 15 columns at once
+	uint16_t* d = m_rows;
+	d[9U]  = d[0] ^ d[1] ^ d[3] ^ d[5] ^ d[6];
+	d[10U] = d[0] ^ d[1] ^ d[2] ^ d[4] ^ d[6] ^ d[7];
+	d[11U] = d[0] ^ d[1] ^ d[2] ^ d[3] ^ d[5] ^ d[7] ^ d[8];
+	d[12U] = d[0] ^ d[2] ^ d[4] ^ d[5] ^ d[8];
 }
 
-void CBPTC19696::encodeExtractBinary(unsigned char* data)
+void CBPTC19696::encodeExtractBinary(unsigned char* data) const
 {
-	// First block
-	CUtils::bitsToByteBE(m_rawData + 0U,  data[0U]);
-	CUtils::bitsToByteBE(m_rawData + 8U,  data[1U]);
-	CUtils::bitsToByteBE(m_rawData + 16U, data[2U]);
-	CUtils::bitsToByteBE(m_rawData + 24U, data[3U]);
-	CUtils::bitsToByteBE(m_rawData + 32U, data[4U]);
-	CUtils::bitsToByteBE(m_rawData + 40U, data[5U]);
-	CUtils::bitsToByteBE(m_rawData + 48U, data[6U]);
-	CUtils::bitsToByteBE(m_rawData + 56U, data[7U]);
-	CUtils::bitsToByteBE(m_rawData + 64U, data[8U]);
-	CUtils::bitsToByteBE(m_rawData + 72U, data[9U]);
-	CUtils::bitsToByteBE(m_rawData + 80U, data[10U]);
-	CUtils::bitsToByteBE(m_rawData + 88U, data[11U]);
-
-	// Handle the two bits
-	unsigned char byte;
-	CUtils::bitsToByteBE(m_rawData + 96U, byte);
-	data[12U] = (data[12U] & 0x3FU) | ((byte >> 0) & 0xC0U);
-	data[20U] = (data[20U] & 0xFCU) | ((byte >> 4) & 0x03U);
-
-	// Second block
-	CUtils::bitsToByteBE(m_rawData + 100U,  data[21U]);
-	CUtils::bitsToByteBE(m_rawData + 108U,  data[22U]);
-	CUtils::bitsToByteBE(m_rawData + 116U,  data[23U]);
-	CUtils::bitsToByteBE(m_rawData + 124U,  data[24U]);
-	CUtils::bitsToByteBE(m_rawData + 132U,  data[25U]);
-	CUtils::bitsToByteBE(m_rawData + 140U,  data[26U]);
-	CUtils::bitsToByteBE(m_rawData + 148U,  data[27U]);
-	CUtils::bitsToByteBE(m_rawData + 156U,  data[28U]);
-	CUtils::bitsToByteBE(m_rawData + 164U,  data[29U]);
-	CUtils::bitsToByteBE(m_rawData + 172U,  data[30U]);
-	CUtils::bitsToByteBE(m_rawData + 180U,  data[31U]);
-	CUtils::bitsToByteBE(m_rawData + 188U,  data[32U]);
+	// Clear the 196 BPTC bits, this also sends the unused R(3) as zero
+	::memset(data + 0U, 0x00U, 12U);
+	data[12U] &= 0x3FU;
+	data[20U] &= 0xFCU;
+	::memset(data + 21U, 0x00U, 12U);
+
+	const uint16_t* pos = &INTERLEAVE_TABLE[0U];
+
+	for (unsigned int r = 0U; r < 13U; r++) {
+		unsigned int row = m_rows[r];
+
+		for (unsigned int c = 0U; c < 15U; c++, pos++)
+			data[*pos >> 3] |= ((row >> (14U - c)) & 0x01U) << (*pos & 0x07U);
+	}
 }
@@ -0,0 +1,216 @@
+/*
+ *   Copyright (C) 2019 by Manuel Sanchez EA7EE
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+// Checks the slicing-by-8 CCITT-16 and CRC-8 kernels against the byte at a
+// time loops they replaced and a bitwise reference, then times all three.
+
+#include "ECCTables.h"
+#include "Clock.h"
+#include "CRC.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+const unsigned int CHECK_BUFFERS = 200000U;
+const unsigned int MAX_LENGTH    = 1030U;
+const unsigned int BENCH_LENGTHS[] = {6U, 64U, 1024U};
+const unsigned int BENCH_BYTES   = 64U * 1024U * 1024U;
+
+static constexpr CECCTable<uint8_t, 256U>  CRC8_TABLE     = CECCTables::crc<uint8_t>(0x07U, false);
+static constexpr CECCTable<uint16_t, 256U> CCITT16_TABLE1 = CECCTables::crc<uint16_t>(0x8408U, true);
+static constexpr CECCTable<uint16_t, 256U> CCITT16_TABLE2 = CECCTables::crc<uint16_t>(0x1021U, false);
+
+// The byte at a time loops of CRC.cpp before the slicing kernels
+static uint16_t oldCCITT161(const unsigned char* in, unsigned int length)
+{
+	union {
+		uint16_t crc16;
+		uint8_t  crc8[2U];
+	};
+
+	crc16 = 0xFFFFU;
+
+	for (unsigned int i = 0U; i < length; i++)
+		crc16 = uint16_t(crc8[1U]) ^ CCITT16_TABLE1[crc8[0U] ^ in[i]];
+
+	return ~crc16;
+}
+
+static uint16_t oldCCITT162(const unsigned char* in, unsigned int length)
+{
+	union {
+		uint16_t crc16;
+		uint8_t  crc8[2U];
+	};
+
+	crc16 = 0U;
+
+	for (unsigned i = 0U; i < length; i++)
+		crc16 = (uint16_t(crc8[0U]) << 8) ^ CCITT16_TABLE2[crc8[1U] ^ in[i]];
+
+	return ~crc16;
+}
+
+static uint8_t oldCRC8(const unsigned char* in, unsigned int length)
+{
+	uint8_t crc = 0U;
+
+	for (unsigned int i = 0U; i < length; i++)
+		crc = CRC8_TABLE[crc ^ in[i]];
+
+	return crc;
+}
+
+// One bit at a time, straight from the polynomials
+static uint16_t bitCCITT161(const unsigned char* in, unsigned int length)
+{
+	uint16_t crc = 0xFFFFU;
+	for (unsigned int i = 0U; i < length; i++) {
+		crc ^= in[i];
+		for (unsigned int j = 0U; j < 8U; j++)
+			crc = (crc & 0x0001U) ? ((crc >> 1) ^ 0x8408U) : (crc >> 1);
+	}
+
+	return ~crc;
+}
+
+static uint16_t bitCCITT162(const unsigned char* in, unsigned int length)
+{
+	uint16_t crc = 0x0000U;
+	for (unsigned int i = 0U; i < length; i++) {
+		crc ^= uint16_t(in[i]) << 8;
+		for (unsigned int j = 0U; j < 8U; j++)
+			crc = (crc & 0x8000U) ? ((crc << 1) ^ 0x1021U) : (crc << 1);
+	}
+
+	return ~crc;
+}
+
+static uint8_t bitCRC8(const unsigned char* in, unsigned int length)
+{
+	uint8_t crc = 0x00U;
+	for (unsigned int i = 0U; i < length; i++) {
+		crc ^= in[i];
+		for (unsigned int j = 0U; j < 8U; j++)
+			crc = (crc & 0x80U) ? ((crc << 1) ^ 0x07U) : (crc << 1);
+	}
+
+	return crc;
+}
+
+// The CRC CCRC appends, in the byte order each variant uses
+static uint16_t newCCITT161(unsigned char* buffer, unsigned int length)
+{
+	CCRC::addCCITT161(buffer, length + 2U);
+	return buffer[length + 0U] | (buffer[length + 1U] << 8);
+}
+
+static uint16_t newCCITT162(unsigned char* buffer, unsigned int length)
+{
+	CCRC::addCCITT162(buffer, length + 2U);
+	return buffer[length + 1U] | (buffer[length + 0U] << 8);
+}
+
+int main()
+{
+	unsigned char* buffer = new unsigned char[BENCH_BYTES + 2U];
+
+	::srand(1021U);
+
+	unsigned int failures = 0U;
+	for (unsigned int n = 0U; n < CHECK_BUFFERS; n++) {
+		unsigned int length = 1U + (::rand() % MAX_LENGTH);
+		for (unsigned int i = 0U; i < length; i++)
+			buffer[i] = ::rand();
+
+		uint16_t crc1 = bitCCITT161(buffer, length);
+		uint16_t crc2 = bitCCITT162(buffer, length);
+		uint8_t  crc8 = bitCRC8(buffer, length);
+
+		bool ok = oldCCITT161(buffer, length) == crc1 && oldCCITT162(buffer, length) == crc2 && oldCRC8(buffer, length) == crc8;
+		ok = ok && CCRC::crc8(buffer, length) == crc8;
+		ok = ok && newCCITT161(buffer, length) == crc1 && CCRC::checkCCITT161(buffer, length + 2U);
+		ok = ok && newCCITT162(buffer, length) == crc2 && CCRC::checkCCITT162(buffer, length + 2U);
+
+		if (!ok) {
+			if (failures < 5U)
+				::printf("Buffer %u of %u bytes differs\n", n, length);
+			failures++;
+		}
+	}
+
+	::printf("CRC: %u buffers of 1 to %u bytes checked, %u differences\n", CHECK_BUFFERS, MAX_LENGTH, failures);
+
+	for (unsigned int i = 0U; i < BENCH_BYTES; i++)
+		buffer[i] = ::rand();
+
+	// The sum keeps the compiler from dropping the CRCs
+	unsigned int sum = 0U;
+
+	for (unsigned int n = 0U; n < sizeof(BENCH_LENGTHS) / sizeof(unsigned int); n++) {
+		unsigned int length = BENCH_LENGTHS[n];
+		unsigned int calls  = BENCH_BYTES / length;
+
+		unsigned long long times[6U];
+
+		unsigned long long start = CClock::getTime();
+		for (unsigned int i = 0U; i < calls; i++)
+			sum += oldCCITT161(buffer + i * length, length);
+		times[0U] = CClock::getTime() - start;
+
+		start = CClock::getTime();
+		for (unsigned int i = 0U; i < calls; i++)
+			sum += oldCCITT162(buffer + i * length, length);
+		times[1U] = CClock::getTime() - start;
+
+		start = CClock::getTime();
+		for (unsigned int i = 0U; i < calls; i++)
+			sum += oldCRC8(buffer + i * length, length);
+		times[2U] = CClock::getTime() - start;
+
+		// The check functions take the two CRC bytes after the data as well
+		start = CClock::getTime();
+		for (unsigned int i = 0U; i < calls; i++)
+			sum += CCRC::checkCCITT161(buffer + i * length, length + 2U);
+		times[3U] = CClock::getTime() - start;
+
+		start = CClock::getTime();
+		for (unsigned int i = 0U; i < calls; i++)
+			sum += CCRC::checkCCITT162(buffer + i * length, length + 2U);
+		times[4U] = CClock::getTime() - start;
+
+		start = CClock::getTime();
+		for (unsigned int i = 0U; i < calls; i++)
+			sum += CCRC::crc8(buffer + i * length, length);
+		times[5U] = CClock::getTime() - start;
+
+		double perCall = 1000.0 / double(calls);
+		::printf("%4u bytes: CCITT-16/1 %.1f -> %.1f ns, CCITT-16/2 %.1f -> %.1f ns, CRC-8 %.1f -> %.1f ns\n", length,
+			double(times[0U]) * perCall, double(times[3U]) * perCall,
+			double(times[1U]) * perCall, double(times[4U]) * perCall,
+			double(times[2U]) * perCall, double(times[5U]) * perCall);
+	}
+
+	delete[] buffer;
+
+	::printf("Checksum %08X\n", sum);
+
+	return failures == 0U ? 0 : 1;
+}
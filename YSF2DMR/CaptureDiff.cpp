@@ -0,0 +1,141 @@
+/*
+ *   Copyright (C) 2019 by Manuel Sanchez EA7EE
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "CaptureDiff.h"
+#include "Log.h"
+
+#include <cstdio>
+#include <cstring>
+
+// Differences listed per channel before only counting them
+const unsigned int MAX_REPORTS = 5U;
+
+const char* CHANNEL_NAMES[] = {"YSF", "DMR", "NXDN", "P25"};
+
+static void usage()
+{
+	::fprintf(stderr, "Usage: CaptureDiff [-t] <expected capture> <actual capture>\n");
+}
+
+int main(int argc, char** argv)
+{
+	bool timing = false;
+
+	int currentArg = 1;
+	if (currentArg < argc && ::strcmp(argv[currentArg], "-t") == 0) {
+		timing = true;
+		currentArg++;
+	}
+
+	if ((argc - currentArg) != 2) {
+		usage();
+		return 2;
+	}
+
+	::LogInitialise(".", "CaptureDiff", 0U, 1U);
+
+	CCaptureDiff diff(argv[currentArg], argv[currentArg + 1], timing);
+
+	int ret = diff.run();
+
+	::LogFinalise();
+
+	return ret;
+}
+
+CCaptureDiff::CCaptureDiff(const std::string& expected, const std::string& actual, bool timing) :
+m_expected(expected),
+m_actual(actual),
+m_timing(timing)
+{
+}
+
+CCaptureDiff::~CCaptureDiff()
+{
+}
+
+int CCaptureDiff::run()
+{
+	std::vector<CCaptureRecord> expected[CAPTURE_CHANNELS];
+	std::vector<CCaptureRecord> actual[CAPTURE_CHANNELS];
+
+	if (!CCapture::load(m_expected, true, expected) || !CCapture::load(m_actual, true, actual))
+		return 2;
+
+	unsigned int differences = 0U;
+	for (unsigned int i = 0U; i < CAPTURE_CHANNELS; i++)
+		differences += compare(i, expected[i], actual[i]);
+
+	if (differences > 0U) {
+		::fprintf(stdout, "%u differences\n", differences);
+		return 1;
+	}
+
+	::fprintf(stdout, "Identical\n");
+
+	return 0;
+}
+
+unsigned int CCaptureDiff::compare(unsigned int channel, const std::vector<CCaptureRecord>& expected, const std::vector<CCaptureRecord>& actual) const
+{
+	if (expected.empty() && actual.empty())
+		return 0U;
+
+	unsigned int differences = 0U;
+	unsigned long long maxSkew = 0ULL;
+
+	unsigned int count = expected.size() < actual.size() ? expected.size() : actual.size();
+	for (unsigned int i = 0U; i < count; i++) {
+		const CCaptureRecord& a = expected[i];
+		const CCaptureRecord& b = actual[i];
+
+		unsigned long long skew = a.m_time > b.m_time ? a.m_time - b.m_time : b.m_time - a.m_time;
+		if (skew > maxSkew)
+			maxSkew = skew;
+
+		bool same = a.m_data == b.m_data && a.m_port == b.m_port && a.m_address.s_addr == b.m_address.s_addr;
+		if (same && (!m_timing || skew == 0ULL))
+			continue;
+
+		if (differences < MAX_REPORTS) {
+			if (a.m_data.size() != b.m_data.size()) {
+				::fprintf(stdout, "%s #%u: length %u != %u\n", CHANNEL_NAMES[channel], i, (unsigned int)a.m_data.size(), (unsigned int)b.m_data.size());
+			} else if (a.m_data != b.m_data) {
+				unsigned int offset = 0U;
+				while (a.m_data[offset] == b.m_data[offset])
+					offset++;
+				::fprintf(stdout, "%s #%u: byte %u 0x%02X != 0x%02X\n", CHANNEL_NAMES[channel], i, offset, a.m_data[offset], b.m_data[offset]);
+			} else if (!same) {
+				::fprintf(stdout, "%s #%u: destination differs\n", CHANNEL_NAMES[channel], i);
+			} else {
+				::fprintf(stdout, "%s #%u: time %llu us != %llu us\n", CHANNEL_NAMES[channel], i, a.m_time, b.m_time);
+			}
+		}
+
+		differences++;
+	}
+
+	if (expected.size() != actual.size()) {
+		::fprintf(stdout, "%s: %u datagrams != %u\n", CHANNEL_NAMES[channel], (unsigned int)expected.size(), (unsigned int)actual.size());
+		differences++;
+	}
+
+	::fprintf(stdout, "%s: %u datagrams compared, %u differences, max time skew %llu us\n", CHANNEL_NAMES[channel], count, differences, maxSkew);
+
+	return differences;
+}
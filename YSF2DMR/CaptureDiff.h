@@ -0,0 +1,46 @@
+/*
+ *   Copyright (C) 2019 by Manuel Sanchez EA7EE
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#if !defined(CaptureDiff_H)
+#define CaptureDiff_H
+
+#include "Capture.h"
+
+#include <string>
+#include <vector>
+
+// Compares what two runs sent, normally the outputs of two replays of the
+// same capture. Datagrams must match byte for byte, in order, on every
+// channel; the timestamps are only compared when asked to.
+class CCaptureDiff {
+public:
+	CCaptureDiff(const std::string& expected, const std::string& actual, bool timing);
+	~CCaptureDiff();
+
+	// 0 when the runs are identical, 1 when they differ, 2 on error
+	int run();
+
+private:
+	std::string m_expected;
+	std::string m_actual;
+	bool        m_timing;
+
+	unsigned int compare(unsigned int channel, const std::vector<CCaptureRecord>& expected, const std::vector<CCaptureRecord>& actual) const;
+};
+
+#endif
@@ -36,7 +36,9 @@ enum SECTION {
   SECTION_DMRID_LOOKUP,
   SECTION_LOG,
   SECTION_APRS_FI,
-  SECTION_STORAGE
+  SECTION_STORAGE,
+  SECTION_METRICS,
+  SECTION_CAPTURE
 };
 
 CConf::CConf(const std::string& file) :
@@ -84,6 +86,7 @@ m_logDisplayLevel(0U),
 m_logFileLevel(0U),
 m_logFilePath(),
 m_logFileRoot(),
+m_logLatencyTime(0U),
 m_aprsEnabled(false),
 m_aprsServer(),
 m_aprsPort(0U),
@@ -101,7 +104,14 @@ m_BeaconTime(0U),
 m_SaveAMBE(false),
 m_tgListReload(30U),
 m_AMBECompA(0U),
-m_AMBECompB(0U)
+m_AMBECompB(0U),
+m_metricsEnabled(false),
+m_metricsAddress("127.0.0.1"),
+m_metricsPort(42080U),
+m_metricsPath(),
+m_captureMode(0U),
+m_captureFile(),
+m_captureOutput()
 {
 }
 
@@ -139,6 +149,10 @@ bool CConf::read()
 		  section = SECTION_APRS_FI;
 	  else if (::strncmp(buffer, "[Storage]", 5U) == 0)
 		  section = SECTION_STORAGE;
+	  else if (::strncmp(buffer, "[Metrics]", 9U) == 0)
+		  section = SECTION_METRICS;
+	  else if (::strncmp(buffer, "[Capture]", 9U) == 0)
+		  section = SECTION_CAPTURE;
 	  else
         section = SECTION_NONE;
 
@@ -262,6 +276,8 @@ bool CConf::read()
 			m_logFileLevel = (unsigned int)::atoi(value);
 		else if (::strcmp(key, "DisplayLevel") == 0)
 			m_logDisplayLevel = (unsigned int)::atoi(value);
+		else if (::strcmp(key, "LatencyTime") == 0)
+			m_logLatencyTime = (unsigned int)::atoi(value);
 	} else if (section == SECTION_APRS_FI) {
 		if (::strcmp(key, "AprsCallsign") == 0) {
 			// Convert the callsign to upper case
@@ -304,6 +320,22 @@ bool CConf::read()
 			m_AMBECompA = (unsigned int)::atoi(value);
 		else if (::strcmp(key, "AMBECompB") == 0)
 			m_AMBECompB = (unsigned int)::atoi(value);
+	} else if (section == SECTION_METRICS) {
+		if (::strcmp(key, "Enable") == 0)
+			m_metricsEnabled = ::atoi(value) == 1;
+		else if (::strcmp(key, "Address") == 0)
+			m_metricsAddress = value;
+		else if (::strcmp(key, "Port") == 0)
+			m_metricsPort = (unsigned int)::atoi(value);
+		else if (::strcmp(key, "Path") == 0)
+			m_metricsPath = value;
+	} else if (section == SECTION_CAPTURE) {
+		if (::strcmp(key, "Mode") == 0)
+			m_captureMode = (unsigned int)::atoi(value);
+		else if (::strcmp(key, "File") == 0)
+			m_captureFile = value;
+		else if (::strcmp(key, "Output") == 0)
+			m_captureOutput = value;
 		}
   }
 
@@ -592,6 +624,11 @@ std::string CConf::getLogFileRoot() const
   return m_logFileRoot;
 }
 
+unsigned int CConf::getLogLatencyTime() const
+{
+	return m_logLatencyTime;
+}
+
 unsigned int CConf::getTimeoutTime() const
 {
 	return m_TimeoutTime;
@@ -621,3 +658,38 @@ unsigned int CConf::getAMBECompB() const
 {
 	return m_AMBECompB;
 }
+
+bool CConf::getMetricsEnabled() const
+{
+	return m_metricsEnabled;
+}
+
+std::string CConf::getMetricsAddress() const
+{
+	return m_metricsAddress;
+}
+
+unsigned int CConf::getMetricsPort() const
+{
+	return m_metricsPort;
+}
+
+std::string CConf::getMetricsPath() const
+{
+	return m_metricsPath;
+}
+
+unsigned int CConf::getCaptureMode() const
+{
+	return m_captureMode;
+}
+
+std::string CConf::getCaptureFile() const
+{
+	return m_captureFile;
+}
+
+std::string CConf::getCaptureOutput() const
+{
+	return m_captureOutput;
+}
@@ -85,6 +85,7 @@ public:
   unsigned int getLogFileLevel() const;
   std::string  getLogFilePath() const;
   std::string  getLogFileRoot() const;
+  unsigned int getLogLatencyTime() const;
 
   // The aprs.fi section
   bool         getAPRSEnabled() const;
@@ -108,6 +109,17 @@ public:
   unsigned int getAMBECompA() const;
   unsigned int getAMBECompB() const;
 
+  // The Metrics section
+  bool         getMetricsEnabled() const;
+  std::string  getMetricsAddress() const;
+  unsigned int getMetricsPort() const;
+  std::string  getMetricsPath() const;
+
+  // The Capture section
+  unsigned int getCaptureMode() const;
+  std::string  getCaptureFile() const;
+  std::string  getCaptureOutput() const;
+
 private:
   std::string  m_file;
   std::string  m_callsign;
@@ -158,6 +170,7 @@ private:
   unsigned int m_logFileLevel;
   std::string  m_logFilePath;
   std::string  m_logFileRoot;
+  unsigned int m_logLatencyTime;
 
   bool         m_aprsEnabled;
   std::string  m_aprsServer;
@@ -180,6 +193,15 @@ private:
   unsigned int m_AMBECompA;
   unsigned int m_AMBECompB;
 
+  bool         m_metricsEnabled;
+  std::string  m_metricsAddress;
+  unsigned int m_metricsPort;
+  std::string  m_metricsPath;
+
+  unsigned int m_captureMode;
+  std::string  m_captureFile;
+  std::string  m_captureOutput;
+
 };
 
 #endif
@@ -18,6 +18,7 @@
 */
 
 #include "DMRLookup.h"
+#include "StopWatch.h"
 #include "Timer.h"
 #include "Log.h"
 
@@ -33,7 +34,11 @@ m_reloadTime(reloadTime),
 m_table(),
 m_cstable(),
 m_mutex(),
-m_stop(false)
+m_stop(false),
+m_hits(0U),
+m_misses(0U),
+m_loads(0U),
+m_loadTime(0U)
 {
 }
 
@@ -94,7 +99,9 @@ std::string CDMRLookup::findCS(unsigned int id)
 
 	try {
 		callsign = m_table.at(id);
+		m_hits++;
 	} catch (...) {
+		m_misses++;
 		char text[10U];
 		::sprintf(text, "%u", id);
 		callsign = std::string(text);
@@ -113,7 +120,9 @@ unsigned int CDMRLookup::findID(std::string cs)
 
 	try {
 		dmrID = m_cstable.at(cs);
+		m_hits++;
 	} catch (...) {
+		m_misses++;
 		dmrID = 0U;
 	}
 
@@ -133,6 +142,18 @@ bool CDMRLookup::exists(unsigned int id)
 	return found;
 }
 
+void CDMRLookup::getStats(unsigned int& hits, unsigned int& misses, unsigned int& loads, unsigned int& loadTime)
+{
+	m_mutex.lock();
+
+	hits     = m_hits;
+	misses   = m_misses;
+	loads    = m_loads;
+	loadTime = m_loadTime;
+
+	m_mutex.unlock();
+}
+
 bool CDMRLookup::load()
 {
 	FILE* fp = ::fopen(m_filename.c_str(), "rt");
@@ -141,6 +162,9 @@ bool CDMRLookup::load()
 		return false;
 	}
 
+	CStopWatch stopWatch;
+	stopWatch.start();
+
 	m_mutex.lock();
 
 	// Remove the old entries
@@ -165,6 +189,9 @@ bool CDMRLookup::load()
 		}
 	}
 
+	m_loads++;
+	m_loadTime = stopWatch.elapsed();
+
 	m_mutex.unlock();
 
 	::fclose(fp);
@@ -40,6 +40,8 @@ public:
 
 	bool exists(unsigned int id);
 
+	void getStats(unsigned int& hits, unsigned int& misses, unsigned int& loads, unsigned int& loadTime);
+
 	void stop();
 
 private:
@@ -49,6 +51,10 @@ private:
 	std::unordered_map<std::string, unsigned int> m_cstable;
 	CMutex                                        m_mutex;
 	bool                                          m_stop;
+	unsigned int                                  m_hits;
+	unsigned int                                  m_misses;
+	unsigned int                                  m_loads;
+	unsigned int                                  m_loadTime;
 
 	bool load();
 };
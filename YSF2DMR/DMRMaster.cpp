@@ -0,0 +1,670 @@
+/*
+ *   Copyright (C) 2019 by Manuel Sanchez EA7EE
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "DMRMaster.h"
+#include "DMRSlotType.h"
+#include "DMRDefines.h"
+#include "DMRFullLC.h"
+#include "StopWatch.h"
+#include "DMREMB.h"
+#include "SHA256.h"
+#include "Thread.h"
+#include "Timer.h"
+#include "Sync.h"
+#include "Log.h"
+
+#if !defined(_WIN32) && !defined(_WIN64)
+#include <signal.h>
+#endif
+
+#include <cassert>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+
+const unsigned int DMRD_LENGTH     = 55U;
+const unsigned int FRAME_PERIOD    = 60U;
+const unsigned int PEER_TIMEOUT    = 60000U;
+const unsigned int STREAM_TIMEOUT  = 1000U;
+const unsigned int BUFFER_LENGTH   = 500U;
+const unsigned int DMR_COLOR_CODE  = 1U;
+
+static bool end = false;
+
+#if !defined(_WIN32) && !defined(_WIN64)
+static void sig_handler(int signum)
+{
+	end = true;
+}
+#endif
+
+static void usage()
+{
+	::fprintf(stderr, "Usage: DMRMaster [-p port] [-w password] [-s srcid] [-d tg] [-c call secs] [-l call length secs]\n");
+	::fprintf(stderr, "                 [-x loss %%] [-j jitter ms] [-r reorder %%] [-k kick secs] [-i stats secs] [-t run secs]\n");
+}
+
+int main(int argc, char** argv)
+{
+	unsigned int port       = 62031U;
+	std::string  password   = "passw0rd";
+	unsigned int srcId      = 1234567U;
+	unsigned int dstId      = 9U;
+	unsigned int callTime   = 30U;
+	unsigned int callLength = 10U;
+	unsigned int loss       = 0U;
+	unsigned int jitter     = 0U;
+	unsigned int reorder    = 0U;
+	unsigned int kickTime   = 0U;
+	unsigned int statsTime  = 10U;
+	unsigned int runTime    = 0U;
+
+	for (int currentArg = 1; currentArg < argc; currentArg++) {
+		std::string arg = argv[currentArg];
+		if (arg.length() != 2U || arg.at(0U) != '-' || (currentArg + 1) >= argc) {
+			usage();
+			return 1;
+		}
+
+		const char* value = argv[++currentArg];
+		switch (arg.at(1U)) {
+			case 'p': port       = (unsigned int)::atoi(value); break;
+			case 'w': password   = value;                       break;
+			case 's': srcId      = (unsigned int)::atoi(value); break;
+			case 'd': dstId      = (unsigned int)::atoi(value); break;
+			case 'c': callTime   = (unsigned int)::atoi(value); break;
+			case 'l': callLength = (unsigned int)::atoi(value); break;
+			case 'x': loss       = (unsigned int)::atoi(value); break;
+			case 'j': jitter     = (unsigned int)::atoi(value); break;
+			case 'r': reorder    = (unsigned int)::atoi(value); break;
+			case 'k': kickTime   = (unsigned int)::atoi(value); break;
+			case 'i': statsTime  = (unsigned int)::atoi(value); break;
+			case 't': runTime    = (unsigned int)::atoi(value); break;
+			default:
+				usage();
+				return 1;
+		}
+	}
+
+#if !defined(_WIN32) && !defined(_WIN64)
+	::signal(SIGINT,  sig_handler);
+	::signal(SIGTERM, sig_handler);
+#endif
+
+	::LogInitialise(".", "DMRMaster", 0U, 1U);
+
+	CDMRMaster master(port, password, srcId, dstId, callTime, callLength, loss, jitter, reorder, kickTime, statsTime, runTime);
+
+	int ret = master.run();
+
+	::LogFinalise();
+
+	return ret;
+}
+
+CMasterPeer::CMasterPeer(unsigned int id) :
+m_id(id),
+m_address(),
+m_port(0U),
+m_status(PS_DISCONNECTED),
+m_salt(),
+m_callsign(),
+m_options(),
+m_lastPing(0ULL),
+m_nextCall(0ULL),
+m_logins(0U),
+m_authFailures(0U),
+m_pings(0U),
+m_calls(0U),
+m_txFrames(0U),
+m_txDropped(0U),
+m_rxFrames(0U),
+m_rxStreams(0U),
+m_rxLost(0U),
+m_rxReordered(0U),
+m_lastStreamId(0U),
+m_lastSeqNo(0U),
+m_lastRxTime(0ULL),
+m_rxGapTotal(0ULL),
+m_rxGapCount(0U),
+m_rxGapMax(0U),
+m_rxEmbeddedLC(),
+m_rxLCs(0U),
+m_rxLCWrong(0U)
+{
+}
+
+CDMRMaster::CDMRMaster(unsigned int port, const std::string& password, unsigned int srcId, unsigned int dstId, unsigned int callTime, unsigned int callLength, unsigned int loss, unsigned int jitter, unsigned int reorder, unsigned int kickTime, unsigned int statsTime, unsigned int runTime) :
+m_socket(port),
+m_password(password),
+m_srcId(srcId),
+m_dstId(dstId),
+m_callTime(callTime),
+m_callLength(callLength),
+m_loss(loss),
+m_jitter(jitter),
+m_reorder(reorder),
+m_kickTime(kickTime),
+m_statsTime(statsTime),
+m_runTime(runTime),
+m_peers(),
+m_pending(),
+m_embeddedLC()
+{
+	assert(port > 0U);
+	assert(loss <= 100U);
+	assert(reorder <= 100U);
+}
+
+CDMRMaster::~CDMRMaster()
+{
+	for (std::map<unsigned int, CMasterPeer*>::iterator it = m_peers.begin(); it != m_peers.end(); ++it)
+		delete it->second;
+}
+
+int CDMRMaster::run()
+{
+	if (!m_socket.open()) {
+		LogError("Cannot open the master port");
+		return 1;
+	}
+
+	::srand((unsigned int)::time(NULL));
+
+	LogMessage("DMR master stand-in started, calls every %us for %us to TG %u, loss %u%%, jitter %ums, reorder %u%%", m_callTime, m_callLength, m_dstId, m_loss, m_jitter, m_reorder);
+
+	CStopWatch stopWatch;
+	stopWatch.start();
+
+	CTimer kickTimer(1000U, m_kickTime);
+	CTimer statsTimer(1000U, m_statsTime);
+	CTimer runTimer(1000U, m_runTime);
+	kickTimer.start();
+	statsTimer.start();
+	runTimer.start();
+
+	unsigned long long now  = 0ULL;
+	unsigned long long last = 0ULL;
+
+	unsigned char buffer[BUFFER_LENGTH];
+
+	while (!end) {
+		now = stopWatch.elapsed();
+		unsigned int ms = (unsigned int)(now - last);
+		last = now;
+
+		in_addr address;
+		unsigned int port;
+		int length;
+		while ((length = m_socket.read(buffer, BUFFER_LENGTH, address, port)) > 0)
+			processPacket(buffer, length, address, port, now);
+
+		for (std::map<unsigned int, CMasterPeer*>::iterator it = m_peers.begin(); it != m_peers.end(); ++it) {
+			CMasterPeer* peer = it->second;
+			if (peer->m_status == PS_DISCONNECTED)
+				continue;
+
+			if ((now - peer->m_lastPing) > PEER_TIMEOUT) {
+				LogWarning("Peer %u has timed out", peer->m_id);
+				peer->m_status = PS_DISCONNECTED;
+				continue;
+			}
+
+			if (peer->m_status == PS_RUNNING && m_callTime > 0U && now >= peer->m_nextCall) {
+				startCall(peer, now);
+				peer->m_nextCall = now + m_callTime * 1000ULL;
+			}
+		}
+
+		sendPending(now);
+
+		kickTimer.clock(ms);
+		if (kickTimer.isRunning() && kickTimer.hasExpired()) {
+			kickPeers();
+			kickTimer.start();
+		}
+
+		statsTimer.clock(ms);
+		if (statsTimer.isRunning() && statsTimer.hasExpired()) {
+			writeStats();
+			statsTimer.start();
+		}
+
+		runTimer.clock(ms);
+		if (runTimer.isRunning() && runTimer.hasExpired())
+			end = true;
+
+		CThread::sleep(1U);
+	}
+
+	writeStats();
+
+	for (std::map<unsigned int, CMasterPeer*>::iterator it = m_peers.begin(); it != m_peers.end(); ++it) {
+		if (it->second->m_status != PS_DISCONNECTED)
+			writeReply("MSTCL", it->second);
+	}
+
+	m_socket.close();
+
+	return 0;
+}
+
+void CDMRMaster::processPacket(const unsigned char* data, unsigned int length, const in_addr& address, unsigned int port, unsigned long long now)
+{
+	assert(data != NULL);
+
+	if (length == 8U && ::memcmp(data, "RPTL", 4U) == 0) {
+		unsigned int id = (data[4U] << 24) | (data[5U] << 16) | (data[6U] << 8) | (data[7U] << 0);
+
+		CMasterPeer* peer = NULL;
+		std::map<unsigned int, CMasterPeer*>::iterator it = m_peers.find(id);
+		if (it == m_peers.end()) {
+			peer = new CMasterPeer(id);
+			m_peers[id] = peer;
+		} else {
+			peer = it->second;
+		}
+
+		peer->m_address  = address;
+		peer->m_port     = port;
+		peer->m_status   = PS_WAITING_AUTHORISATION;
+		peer->m_lastPing = now;
+		peer->m_logins++;
+
+		for (unsigned int i = 0U; i < 4U; i++)
+			peer->m_salt[i] = ::rand();
+
+		LogMessage("Peer %u login from %s:%u", id, ::inet_ntoa(address), port);
+
+		writeReply("RPTACK", peer, peer->m_salt, 4U);
+		return;
+	}
+
+	CMasterPeer* peer = NULL;
+	if (length >= 11U && ::memcmp(data, "RPTPING", 7U) == 0)
+		peer = findPeer(data, 7U, address, port);
+	else if (length >= 9U && ::memcmp(data, "RPTCL", 5U) == 0)
+		peer = findPeer(data, 5U, address, port);
+	else if (length == DMRD_LENGTH && ::memcmp(data, "DMRD", 4U) == 0)
+		peer = findPeer(data, 11U, address, port);
+	else if (length >= 8U)
+		peer = findPeer(data, 4U, address, port);
+
+	if (peer == NULL || peer->m_status == PS_DISCONNECTED) {
+		// Unknown peers are told to start again, as a real master does
+		if (length >= 8U) {
+			unsigned char nak[10U];
+			::memcpy(nak + 0U, "MSTNAK", 6U);
+			::memcpy(nak + 6U, data + (::memcmp(data, "DMRD", 4U) == 0 ? 11U : 4U), 4U);
+			m_socket.write(nak, 10U, address, port);
+		}
+		return;
+	}
+
+	peer->m_lastPing = now;
+
+	if (::memcmp(data, "RPTK", 4U) == 0 && length == 40U) {
+		if (peer->m_status != PS_WAITING_AUTHORISATION)
+			return;
+
+		size_t size = m_password.size();
+
+		unsigned char* in = new unsigned char[size + 4U];
+		::memcpy(in, peer->m_salt, 4U);
+		for (size_t i = 0U; i < size; i++)
+			in[i + 4U] = m_password.at(i);
+
+		unsigned char hash[32U];
+		CSHA256 sha256;
+		sha256.buffer(in, (unsigned int)(size + 4U), hash);
+
+		delete[] in;
+
+		if (::memcmp(hash, data + 8U, 32U) != 0) {
+			LogWarning("Peer %u failed authorisation", peer->m_id);
+			peer->m_authFailures++;
+			peer->m_status = PS_DISCONNECTED;
+			writeReply("MSTNAK", peer);
+			return;
+		}
+
+		peer->m_status = PS_WAITING_CONFIG;
+		writeReply("RPTACK", peer);
+	} else if (::memcmp(data, "RPTC", 4U) == 0 && length == 302U) {
+		if (peer->m_status != PS_WAITING_CONFIG)
+			return;
+
+		char callsign[9U];
+		::memcpy(callsign, data + 8U, 8U);
+		callsign[8U] = 0x00;
+		for (unsigned int i = 7U; i > 0U && callsign[i] == ' '; i--)
+			callsign[i] = 0x00;
+
+		peer->m_callsign = callsign;
+		peer->m_status   = PS_RUNNING;
+		peer->m_nextCall = now + 1000U;
+
+		LogMessage("Peer %u (%s) logged in", peer->m_id, peer->m_callsign.c_str());
+
+		writeReply("RPTACK", peer);
+	} else if (::memcmp(data, "RPTO", 4U) == 0) {
+		peer->m_options = std::string((const char*)data + 8U, length - 8U);
+		writeReply("RPTACK", peer);
+	} else if (::memcmp(data, "RPTPING", 7U) == 0) {
+		peer->m_pings++;
+		writeReply("MSTPONG", peer);
+	} else if (::memcmp(data, "RPTCL", 5U) == 0) {
+		LogMessage("Peer %u has closed the connection", peer->m_id);
+		peer->m_status = PS_DISCONNECTED;
+	} else if (::memcmp(data, "DMRD", 4U) == 0) {
+		if (peer->m_status == PS_RUNNING)
+			processData(peer, data, length, now);
+	}
+}
+
+void CDMRMaster::processData(CMasterPeer* peer, const unsigned char* data, unsigned int length, unsigned long long now)
+{
+	assert(peer != NULL);
+	assert(data != NULL);
+
+	unsigned char seqNo   = data[4U];
+	unsigned int streamId = (data[16U] << 24) | (data[17U] << 16) | (data[18U] << 8) | (data[19U] << 0);
+
+	peer->m_rxFrames++;
+
+	// Peers may keep the stream id between calls, so a pause also starts a new stream
+	if (streamId != peer->m_lastStreamId || (now - peer->m_lastRxTime) > STREAM_TIMEOUT) {
+		peer->m_rxStreams++;
+		peer->m_lastStreamId = streamId;
+		peer->m_lastSeqNo    = seqNo;
+	} else {
+		// m_lastSeqNo is the highest sequence number seen. One from the past is a
+		// late frame, counted as lost when the gap was seen and recovered now.
+		// Headers are sent twice with the same number and are neither.
+		unsigned char diff = seqNo - (unsigned char)(peer->m_lastSeqNo + 1U);
+		if (seqNo != peer->m_lastSeqNo) {
+			if (diff < 128U) {
+				peer->m_rxLost   += diff;
+				peer->m_lastSeqNo = seqNo;
+			} else {
+				peer->m_rxReordered++;
+				if (peer->m_rxLost > 0U)
+					peer->m_rxLost--;
+			}
+		}
+
+		unsigned int gap = (unsigned int)(now - peer->m_lastRxTime);
+		peer->m_rxGapTotal += gap;
+		peer->m_rxGapCount++;
+		if (gap > peer->m_rxGapMax)
+			peer->m_rxGapMax = gap;
+	}
+
+	peer->m_lastRxTime = now;
+
+	processEmbeddedLC(peer, data);
+}
+
+void CDMRMaster::processEmbeddedLC(CMasterPeer* peer, const unsigned char* data)
+{
+	assert(peer != NULL);
+	assert(data != NULL);
+
+	// Only the voice bursts between the syncs carry the embedded LC
+	if ((data[15U] & 0x30U) != 0x00U)
+		return;
+
+	CDMREMB emb;
+	emb.putData(data + 20U);
+
+	if (!peer->m_rxEmbeddedLC.addData(data + 20U, emb.getLCSS()))
+		return;
+
+	unsigned int srcId = (data[5U] << 16) | (data[6U] << 8) | (data[7U] << 0);
+	unsigned int dstId = (data[8U] << 16) | (data[9U] << 8) | (data[10U] << 0);
+	FLCO flco = (data[15U] & 0x40U) == 0x40U ? FLCO_USER_USER : FLCO_GROUP;
+
+	peer->m_rxLCs++;
+
+	CDMRLC lc;
+	if (!peer->m_rxEmbeddedLC.getLC(lc) || lc.getFLCO() != flco || lc.getSrcId() != srcId || lc.getDstId() != dstId) {
+		if (peer->m_rxLCWrong == 0U)
+			LogWarning("Peer %u sent an embedded LC that does not match the header, %u to %u", peer->m_id, srcId, dstId);
+		peer->m_rxLCWrong++;
+	}
+}
+
+void CDMRMaster::startCall(CMasterPeer* peer, unsigned long long now)
+{
+	assert(peer != NULL);
+
+	unsigned int streamId = ::rand() + 1U;
+	unsigned char seqNo   = 0U;
+
+	peer->m_calls++;
+
+	CDMRLC lc(FLCO_GROUP, m_srcId, m_dstId);
+	m_embeddedLC.setLC(lc);
+
+	unsigned char frame[DMR_FRAME_LENGTH_BYTES];
+
+	// Voice LC header, sent twice as MMDVMHost does
+	CSync::addDMRDataSync(frame, false);
+
+	CDMRSlotType slotType;
+	slotType.setColorCode(DMR_COLOR_CODE);
+	slotType.setDataType(DT_VOICE_LC_HEADER);
+	slotType.getData(frame);
+
+	CDMRFullLC fullLC;
+	fullLC.encode(lc, frame, DT_VOICE_LC_HEADER);
+
+	unsigned long long due = now;
+	queueFrame(peer, due, streamId, seqNo++, DT_VOICE_LC_HEADER, 0U, frame);
+	queueFrame(peer, due, streamId, seqNo++, DT_VOICE_LC_HEADER, 0U, frame);
+
+	// Whole superframes of silence
+	unsigned int frames = ((m_callLength * 1000U / FRAME_PERIOD) + 5U) / 6U * 6U;
+	for (unsigned int i = 0U; i < frames; i++) {
+		unsigned char n = i % 6U;
+
+		::memcpy(frame, DMR_SILENCE_DATA, DMR_FRAME_LENGTH_BYTES);
+
+		if (n == 0U) {
+			CSync::addDMRAudioSync(frame, false);
+		} else {
+			unsigned char lcss = m_embeddedLC.getData(frame, n);
+
+			CDMREMB emb;
+			emb.setColorCode(DMR_COLOR_CODE);
+			emb.setLCSS(lcss);
+			emb.getData(frame);
+		}
+
+		due += FRAME_PERIOD;
+		queueFrame(peer, due, streamId, seqNo++, n == 0U ? DT_VOICE_SYNC : DT_VOICE, n, frame);
+	}
+
+	CSync::addDMRDataSync(frame, false);
+
+	slotType.setDataType(DT_TERMINATOR_WITH_LC);
+	slotType.getData(frame);
+
+	fullLC.encode(lc, frame, DT_TERMINATOR_WITH_LC);
+
+	due += FRAME_PERIOD;
+	queueFrame(peer, due, streamId, seqNo++, DT_TERMINATOR_WITH_LC, 0U, frame);
+}
+
+void CDMRMaster::queueFrame(CMasterPeer* peer, unsigned long long due, unsigned int streamId, unsigned char seqNo, unsigned char dataType, unsigned char n, const unsigned char* frame)
+{
+	assert(peer != NULL);
+	assert(frame != NULL);
+
+	if (m_loss > 0U && (unsigned int)(::rand() % 100) < m_loss) {
+		peer->m_txDropped++;
+		return;
+	}
+
+	if (m_jitter > 0U)
+		due += ::rand() % (m_jitter + 1U);
+
+	// Holding a frame back for one period swaps it with the next one
+	if (m_reorder > 0U && (unsigned int)(::rand() % 100) < m_reorder)
+		due += FRAME_PERIOD;
+
+	CMasterPacket packet;
+	packet.m_id = peer->m_id;
+
+	unsigned char* buffer = packet.m_data;
+	::memset(buffer, 0x00U, DMRD_LENGTH);
+
+	::memcpy(buffer + 0U, "DMRD", 4U);
+
+	buffer[4U]  = seqNo;
+
+	buffer[5U]  = m_srcId >> 16;
+	buffer[6U]  = m_srcId >> 8;
+	buffer[7U]  = m_srcId >> 0;
+
+	buffer[8U]  = m_dstId >> 16;
+	buffer[9U]  = m_dstId >> 8;
+	buffer[10U] = m_dstId >> 0;
+
+	buffer[11U] = peer->m_id >> 24;
+	buffer[12U] = peer->m_id >> 16;
+	buffer[13U] = peer->m_id >> 8;
+	buffer[14U] = peer->m_id >> 0;
+
+	// Slot 2, group call
+	buffer[15U] = 0x80U;
+	if (dataType == DT_VOICE_SYNC)
+		buffer[15U] |= 0x10U;
+	else if (dataType == DT_VOICE)
+		buffer[15U] |= n;
+	else
+		buffer[15U] |= (0x20U | dataType);
+
+	buffer[16U] = streamId >> 24;
+	buffer[17U] = streamId >> 16;
+	buffer[18U] = streamId >> 8;
+	buffer[19U] = streamId >> 0;
+
+	::memcpy(buffer + 20U, frame, DMR_FRAME_LENGTH_BYTES);
+
+	m_pending.insert(std::pair<unsigned long long, CMasterPacket>(due, packet));
+}
+
+void CDMRMaster::sendPending(unsigned long long now)
+{
+	while (!m_pending.empty() && m_pending.begin()->first <= now) {
+		const CMasterPacket& packet = m_pending.begin()->second;
+
+		std::map<unsigned int, CMasterPeer*>::iterator it = m_peers.find(packet.m_id);
+		if (it != m_peers.end() && it->second->m_status == PS_RUNNING) {
+			m_socket.write(packet.m_data, DMRD_LENGTH, it->second->m_address, it->second->m_port);
+			it->second->m_txFrames++;
+		}
+
+		m_pending.erase(m_pending.begin());
+	}
+}
+
+void CDMRMaster::kickPeers()
+{
+	unsigned int count = 0U;
+
+	for (std::map<unsigned int, CMasterPeer*>::iterator it = m_peers.begin(); it != m_peers.end(); ++it) {
+		CMasterPeer* peer = it->second;
+		if (peer->m_status == PS_DISCONNECTED)
+			continue;
+
+		writeReply("MSTCL", peer);
+		peer->m_status = PS_DISCONNECTED;
+		count++;
+	}
+
+	LogMessage("Closed the connection to %u peers", count);
+}
+
+void CDMRMaster::writeStats() const
+{
+	unsigned int running = 0U;
+	unsigned int txTotal = 0U;
+	unsigned int rxTotal = 0U;
+
+	for (std::map<unsigned int, CMasterPeer*>::const_iterator it = m_peers.begin(); it != m_peers.end(); ++it) {
+		const CMasterPeer* peer = it->second;
+
+		if (peer->m_status == PS_RUNNING)
+			running++;
+
+		txTotal += peer->m_txFrames;
+		rxTotal += peer->m_rxFrames;
+
+		float gapMean = peer->m_rxGapCount > 0U ? float(peer->m_rxGapTotal) / float(peer->m_rxGapCount) : 0.0F;
+
+		LogMessage("Peer %u (%s): logins %u, auth failures %u, pings %u, calls %u, tx %u (dropped %u), rx %u in %u streams, lost %u, reordered %u, gap mean %.1fms max %ums, embedded LCs %u (%u wrong)",
+			peer->m_id, peer->m_callsign.c_str(), peer->m_logins, peer->m_authFailures, peer->m_pings, peer->m_calls,
+			peer->m_txFrames, peer->m_txDropped, peer->m_rxFrames, peer->m_rxStreams, peer->m_rxLost, peer->m_rxReordered, gapMean, peer->m_rxGapMax, peer->m_rxLCs, peer->m_rxLCWrong);
+	}
+
+	LogMessage("%u peers, %u logged in, %u frames sent, %u frames received", (unsigned int)m_peers.size(), running, txTotal, rxTotal);
+}
+
+void CDMRMaster::writeReply(const char* type, const CMasterPeer* peer, const unsigned char* extra, unsigned int extraLength)
+{
+	assert(type != NULL);
+	assert(peer != NULL);
+
+	unsigned char buffer[20U];
+
+	unsigned int length = ::strlen(type);
+	::memcpy(buffer, type, length);
+
+	if (extra != NULL) {
+		::memcpy(buffer + length, extra, extraLength);
+		length += extraLength;
+	} else {
+		buffer[length++] = peer->m_id >> 24;
+		buffer[length++] = peer->m_id >> 16;
+		buffer[length++] = peer->m_id >> 8;
+		buffer[length++] = peer->m_id >> 0;
+	}
+
+	m_socket.write(buffer, length, peer->m_address, peer->m_port);
+}
+
+CMasterPeer* CDMRMaster::findPeer(const unsigned char* data, unsigned int offset, const in_addr& address, unsigned int port) const
+{
+	assert(data != NULL);
+
+	unsigned int id = (data[offset + 0U] << 24) | (data[offset + 1U] << 16) | (data[offset + 2U] << 8) | (data[offset + 3U] << 0);
+
+	std::map<unsigned int, CMasterPeer*>::const_iterator it = m_peers.find(id);
+	if (it == m_peers.end())
+		return NULL;
+
+	// A peer may only talk from the address it logged in from
+	CMasterPeer* peer = it->second;
+	if (peer->m_address.s_addr != address.s_addr || peer->m_port != port)
+		return NULL;
+
+	return peer;
+}
@@ -0,0 +1,118 @@
+/*
+ *   Copyright (C) 2019 by Manuel Sanchez EA7EE
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#if !defined(DMRMaster_H)
+#define DMRMaster_H
+
+#include "DMREmbeddedData.h"
+#include "UDPSocket.h"
+#include "DMRLC.h"
+
+#include <string>
+#include <map>
+
+enum PEER_STATUS {
+	PS_DISCONNECTED,
+	PS_WAITING_AUTHORISATION,
+	PS_WAITING_CONFIG,
+	PS_RUNNING
+};
+
+class CMasterPeer {
+public:
+	CMasterPeer(unsigned int id);
+
+	unsigned int       m_id;
+	in_addr            m_address;
+	unsigned int       m_port;
+	PEER_STATUS        m_status;
+	unsigned char      m_salt[4U];
+	std::string        m_callsign;
+	std::string        m_options;
+	unsigned long long m_lastPing;
+	unsigned long long m_nextCall;
+	unsigned int       m_logins;
+	unsigned int       m_authFailures;
+	unsigned int       m_pings;
+	unsigned int       m_calls;
+	unsigned int       m_txFrames;
+	unsigned int       m_txDropped;
+	unsigned int       m_rxFrames;
+	unsigned int       m_rxStreams;
+	unsigned int       m_rxLost;
+	unsigned int       m_rxReordered;
+	unsigned int       m_lastStreamId;
+	unsigned char      m_lastSeqNo;
+	unsigned long long m_lastRxTime;
+	unsigned long long m_rxGapTotal;
+	unsigned int       m_rxGapCount;
+	unsigned int       m_rxGapMax;
+	CDMREmbeddedData   m_rxEmbeddedLC;
+	unsigned int       m_rxLCs;
+	unsigned int       m_rxLCWrong;
+};
+
+class CMasterPacket {
+public:
+	unsigned int  m_id;
+	unsigned char m_data[55U];
+};
+
+// Stand-in for a Homebrew DMR master (BrandMeister, DMR+ ...) to load
+// test CDMRNetwork without a live master. It accepts any number of
+// repeater logins, injects synthetic voice calls to every logged in peer
+// with optional loss, jitter and reordering, and reports the traffic
+// coming back from the peers, checking the embedded LC of their voice
+// bursts against the ids in the DMRD header.
+class CDMRMaster {
+public:
+	CDMRMaster(unsigned int port, const std::string& password, unsigned int srcId, unsigned int dstId, unsigned int callTime, unsigned int callLength, unsigned int loss, unsigned int jitter, unsigned int reorder, unsigned int kickTime, unsigned int statsTime, unsigned int runTime);
+	~CDMRMaster();
+
+	int run();
+
+private:
+	CUDPSocket                                        m_socket;
+	std::string                                       m_password;
+	unsigned int                                      m_srcId;
+	unsigned int                                      m_dstId;
+	unsigned int                                      m_callTime;
+	unsigned int                                      m_callLength;
+	unsigned int                                      m_loss;
+	unsigned int                                      m_jitter;
+	unsigned int                                      m_reorder;
+	unsigned int                                      m_kickTime;
+	unsigned int                                      m_statsTime;
+	unsigned int                                      m_runTime;
+	std::map<unsigned int, CMasterPeer*>              m_peers;
+	std::multimap<unsigned long long, CMasterPacket>  m_pending;
+	CDMREmbeddedData                                  m_embeddedLC;
+
+	void processPacket(const unsigned char* data, unsigned int length, const in_addr& address, unsigned int port, unsigned long long now);
+	void processData(CMasterPeer* peer, const unsigned char* data, unsigned int length, unsigned long long now);
+	void processEmbeddedLC(CMasterPeer* peer, const unsigned char* data);
+	void startCall(CMasterPeer* peer, unsigned long long now);
+	void queueFrame(CMasterPeer* peer, unsigned long long due, unsigned int streamId, unsigned char seqNo, unsigned char dataType, unsigned char n, const unsigned char* frame);
+	void sendPending(unsigned long long now);
+	void kickPeers();
+	void writeStats() const;
+	void writeReply(const char* type, const CMasterPeer* peer, const unsigned char* extra = NULL, unsigned int extraLength = 0U);
+	CMasterPeer* findPeer(const unsigned char* data, unsigned int offset, const in_addr& address, unsigned int port) const;
+};
+
+#endif
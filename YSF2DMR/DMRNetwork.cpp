@@ -63,7 +63,8 @@ m_height(0),
 m_location(),
 m_description(),
 m_url(),
-m_beacon(false)
+m_beacon(false),
+m_mutex()
 {
 	assert(!address.empty());
 	assert(port > 0U);
@@ -88,6 +89,8 @@ m_beacon(false)
 	m_id[2U] = id >> 8;
 	m_id[3U] = id >> 0;
 
+	// During a replay the clock is virtual and starts at a fixed point, so
+	// the stream ids repeat from run to run
 	CStopWatch stopWatch;
 	::srand(stopWatch.start());
 
@@ -141,10 +144,21 @@ bool CDMRNetwork::open()
 
 void CDMRNetwork::enable(bool enabled)
 {
+	m_mutex.lock();
 	m_enabled = enabled;
+	m_mutex.unlock();
 }
 
 bool CDMRNetwork::read(CDMRData& data)
+{
+	m_mutex.lock();
+	bool ret = readData(data);
+	m_mutex.unlock();
+
+	return ret;
+}
+
+bool CDMRNetwork::readData(CDMRData& data)
 {
 	if (m_status != RUNNING)
 		return false;
@@ -198,6 +212,15 @@ bool CDMRNetwork::read(CDMRData& data)
 }
 
 bool CDMRNetwork::write(const CDMRData& data)
+{
+	m_mutex.lock();
+	bool ret = writeData(data);
+	m_mutex.unlock();
+
+	return ret;
+}
+
+bool CDMRNetwork::writeData(const CDMRData& data)
 {
 	if (m_status != RUNNING)
 		return false;
@@ -330,6 +353,13 @@ void CDMRNetwork::close()
 }
 
 void CDMRNetwork::clock(unsigned int ms)
+{
+	m_mutex.lock();
+	clockNetwork(ms);
+	m_mutex.unlock();
+}
+
+void CDMRNetwork::clockNetwork(unsigned int ms)
 {
 	m_delayBuffers[1U]->clock(ms);
 	m_delayBuffers[2U]->clock(ms);
@@ -476,6 +506,8 @@ void CDMRNetwork::reset(unsigned int slotNo)
 {
 	assert(slotNo == 1U || slotNo == 2U);
 
+	m_mutex.lock();
+
 	if (slotNo == 1U) {
 		m_delayBuffers[1U]->reset();
 		m_streamId[0U] = ::rand() + 1U;
@@ -483,11 +515,39 @@ void CDMRNetwork::reset(unsigned int slotNo)
 		m_delayBuffers[2U]->reset();
 		m_streamId[1U] = ::rand() + 1U;
 	}
+
+	m_mutex.unlock();
 }
 
 bool CDMRNetwork::isConnected() const
 {
-	return m_status == RUNNING;
+	m_mutex.lock();
+	bool connected = m_status == RUNNING;
+	m_mutex.unlock();
+
+	return connected;
+}
+
+unsigned int CDMRNetwork::getStatus() const
+{
+	m_mutex.lock();
+	unsigned int status = (unsigned int)m_status;
+	m_mutex.unlock();
+
+	return status;
+}
+
+void CDMRNetwork::getDelayStats(unsigned int slotNo, unsigned int& depth, unsigned int& missing, unsigned int& overflows)
+{
+	assert(slotNo == 1U || slotNo == 2U);
+
+	m_mutex.lock();
+
+	depth     = m_delayBuffers[slotNo]->getDepth();
+	missing   = m_delayBuffers[slotNo]->getMissing();
+	overflows = m_delayBuffers[slotNo]->getOverflows();
+
+	m_mutex.unlock();
 }
 
 void CDMRNetwork::receiveData(const unsigned char* data, unsigned int length)
@@ -664,3 +724,8 @@ bool CDMRNetwork::write(const unsigned char* data, unsigned int length)
 
 	return true;
 }
+
+void CDMRNetwork::setCapture(CCapture* capture, CReplay* replay)
+{
+	m_socket.setCapture(capture, replay, CAPTURE_DMR);
+}
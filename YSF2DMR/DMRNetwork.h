@@ -24,6 +24,7 @@
 #include "Timer.h"
 #include "DMRData.h"
 #include "Defines.h"
+#include "Mutex.h"
 
 #include <string>
 #include <cstdint>
@@ -58,8 +59,14 @@ public:
 
 	bool isConnected() const;
 
+	unsigned int getStatus() const;
+
+	void getDelayStats(unsigned int slotNo, unsigned int& depth, unsigned int& missing, unsigned int& overflows);
+
 	void close();
 
+	void setCapture(CCapture* capture, CReplay* replay);
+
 private:
 	in_addr         m_address;
 	unsigned int    m_port;
@@ -107,6 +114,12 @@ private:
 
 	bool           m_beacon;
 
+	mutable CMutex m_mutex;
+
+	bool readData(CDMRData& data);
+	bool writeData(const CDMRData& data);
+	void clockNetwork(unsigned int ms);
+
 	bool writeLogin();
 	bool writeAuthorisation();
 	bool writeOptions();
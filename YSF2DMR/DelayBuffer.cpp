@@ -35,6 +35,7 @@ m_stopWatch(),
 m_running(false),
 m_buffer(5000U, name.c_str()),
 m_outputCount(0U),
+m_missing(0U),
 m_lastData(NULL),
 m_lastDataLength(0U),
 m_lastDataValid(false)
@@ -127,6 +128,7 @@ B_STATUS CDelayBuffer::getData(unsigned char* data, unsigned int& length)
 		length = m_lastDataLength;
 
 		m_outputCount++;
+		m_missing++;
 
 		return BS_MISSING;
 	}
@@ -157,3 +159,18 @@ void CDelayBuffer::clock(unsigned int ms)
 		}
 	}
 }
+
+unsigned int CDelayBuffer::getDepth() const
+{
+	return m_buffer.dataSize() / m_blockSize;
+}
+
+unsigned int CDelayBuffer::getMissing() const
+{
+	return m_missing;
+}
+
+unsigned int CDelayBuffer::getOverflows() const
+{
+	return m_buffer.getOverflows();
+}
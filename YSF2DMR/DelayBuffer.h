@@ -39,6 +39,12 @@ public:
 
 	void clock(unsigned int ms);
 
+	unsigned int getDepth() const;
+
+	unsigned int getMissing() const;
+
+	unsigned int getOverflows() const;
+
 private:
 	std::string  m_name;
 	unsigned int m_blockSize;
@@ -49,6 +55,7 @@ private:
 	bool         m_running;
 	CRingBuffer<unsigned char> m_buffer;
 	unsigned int m_outputCount;
+	unsigned int m_missing;
 
 	unsigned char* m_lastData;
 	unsigned int   m_lastDataLength;
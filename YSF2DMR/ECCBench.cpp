@@ -0,0 +1,388 @@
+/*
+ *   Copyright (C) 2019 by Manuel Sanchez EA7EE
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+// Checks the table driven QR (16,7,6), Golay (20,8) and packed Hamming
+// decoders against the ones they replaced over every received word, and
+// the EMB against the corrected QR result, then times both of each.
+
+#include "Golay2087.h"
+#include "ECCTables.h"
+#include "Hamming.h"
+#include "QR1676.h"
+#include "DMREMB.h"
+#include "Clock.h"
+
+#include <cstdio>
+#include <cstring>
+
+const unsigned int BENCH_ROUNDS = 20U;
+
+#define X14             0x00004000   /* vector representation of X^{14} */
+#define X8              0x00000100   /* vector representation of X^{8} */
+#define MASK7           0xffffff00   /* auxiliary vector for testing */
+#define GENPOL_1676     0x00000139   /* generator polinomial, g(x) */
+
+#define X18             0x00040000   /* vector representation of X^{18} */
+#define X11             0x00000800   /* vector representation of X^{11} */
+#define MASK8           0xfffff800   /* auxiliary vector for testing */
+#define GENPOL_2087     0x00000c75   /* generator polinomial, g(x) */
+
+// The error patterns did not change, only the way the syndrome is found
+static constexpr CECCTable<unsigned int, 256U>  DECODING_TABLE_1576 = CECCTables::decoding<256U>(15U, GENPOL_1676, 8U, 4U);
+static constexpr CECCTable<unsigned int, 2048U> DECODING_TABLE_1987 = CECCTables::decoding<2048U>(19U, GENPOL_2087, 11U, 5U);
+
+// The syndromes as QR1676.cpp and Golay2087.cpp computed them before the tables
+static unsigned int getSyndrome1576(unsigned int pattern)
+{
+	unsigned int aux = X14;
+
+	if (pattern >= X8) {
+		while (pattern & MASK7) {
+			while (!(aux & pattern))
+				aux = aux >> 1;
+
+			pattern ^= (aux / X8) * GENPOL_1676;
+		}
+	}
+
+	return pattern;
+}
+
+static unsigned int getSyndrome1987(unsigned int pattern)
+{
+	unsigned int aux = X18;
+
+	if (pattern >= X11) {
+		while (pattern & MASK8) {
+			while (!(aux & pattern))
+				aux = aux >> 1;
+
+			pattern ^= (aux / X11) * GENPOL_2087;
+		}
+	}
+
+	return pattern;
+}
+
+static unsigned char oldDecode1676(const unsigned char* data)
+{
+	unsigned int code = (data[0U] << 7) + (data[1U] >> 1);
+	unsigned int syndrome = getSyndrome1576(code);
+	unsigned int error_pattern = DECODING_TABLE_1576[syndrome];
+
+	code ^= error_pattern;
+
+	return code >> 7;
+}
+
+static unsigned char oldDecode2087(const unsigned char* data)
+{
+	unsigned int code = (data[0U] << 11) + (data[1U] << 3) + (data[2U] >> 5);
+	unsigned int syndrome = getSyndrome1987(code);
+	unsigned int error_pattern = DECODING_TABLE_1987[syndrome];
+
+	if (error_pattern != 0x00U)
+		code ^= error_pattern;
+
+	return code >> 11;
+}
+
+// The EMB sits in the middle of a voice burst, either side of the sync
+static void putEMB(unsigned int word, unsigned char* burst)
+{
+	::memset(burst, 0x00U, 33U);
+
+	burst[13U] = (word >> 12) & 0x0FU;
+	burst[14U] = ((word >> 8) << 4) & 0xF0U;
+	burst[18U] = (word >> 4) & 0x0FU;
+	burst[19U] = (word << 4) & 0xF0U;
+}
+
+static unsigned int checkQR1676()
+{
+	unsigned int failures = 0U;
+
+	for (unsigned int word = 0U; word < 0x10000U; word++) {
+		unsigned char data[2U];
+		data[0U] = word >> 8;
+		data[1U] = word & 0xFFU;
+
+		if (oldDecode1676(data) != CQR1676::decode(data)) {
+			if (failures < 5U)
+				::printf("QR (16,7,6) word %04X differs\n", word);
+			failures++;
+		}
+	}
+
+	::printf("QR (16,7,6): %u words checked, %u differences\n", 0x10000U, failures);
+
+	return failures;
+}
+
+static unsigned int checkGolay2087()
+{
+	unsigned int failures = 0U;
+
+	for (unsigned int word = 0U; word < 0x100000U; word++) {
+		unsigned char data[3U];
+		data[0U] = word >> 12;
+		data[1U] = (word >> 4) & 0xFFU;
+		data[2U] = (word << 4) & 0xF0U;
+
+		if (oldDecode2087(data) != CGolay2087::decode(data)) {
+			if (failures < 5U)
+				::printf("Golay (20,8) word %05X differs\n", word);
+			failures++;
+		}
+	}
+
+	::printf("Golay (20,8): %u words checked, %u differences\n", 0x100000U, failures);
+
+	return failures;
+}
+
+// The EMB used to take its fields from the received bits, whatever the
+// QR decoder made of them. Now they must be the corrected ones.
+static unsigned int checkEMB()
+{
+	unsigned int failures = 0U;
+	unsigned int changed  = 0U;
+
+	for (unsigned int word = 0U; word < 0x10000U; word++) {
+		unsigned char burst[33U];
+		putEMB(word, burst);
+
+		CDMREMB emb;
+		emb.putData(burst);
+
+		unsigned char data[2U];
+		data[0U] = word >> 8;
+		data[1U] = word & 0xFFU;
+		unsigned char code = oldDecode1676(data);
+
+		bool same = emb.getColorCode() == ((code >> 4) & 0x0FU) && emb.getPI() == ((code & 0x08U) == 0x08U) && emb.getLCSS() == ((code >> 1) & 0x03U);
+		if (!same) {
+			if (failures < 5U)
+				::printf("EMB word %04X differs\n", word);
+			failures++;
+		}
+
+		if (((data[0U] >> 1) & 0x7FU) != ((code >> 1) & 0x7FU))
+			changed++;
+	}
+
+	// Every EMB with up to two bit errors, the parity bit included
+	unsigned int wrong = 0U;
+	unsigned int oldWrong = 0U;
+	unsigned int cases = 0U;
+
+	for (unsigned int value = 0U; value < 128U; value++) {
+		unsigned char data[2U];
+		data[0U] = value << 1;
+		data[1U] = 0x00U;
+		CQR1676::encode(data);
+
+		unsigned int sent = (data[0U] << 8) | data[1U];
+
+		for (unsigned int i = 0U; i <= 16U; i++) {
+			for (unsigned int j = i; j <= 16U; j++) {
+				if (j == i && i != 16U)
+					continue;
+
+				unsigned int word = sent;
+				if (i < 16U)
+					word ^= 1U << i;
+				if (j < 16U)
+					word ^= 1U << j;
+
+				unsigned char burst[33U];
+				putEMB(word, burst);
+
+				CDMREMB emb;
+				emb.putData(burst);
+
+				unsigned int got = (emb.getColorCode() << 3) | (emb.getPI() ? 0x04U : 0x00U) | emb.getLCSS();
+				if (got != value)
+					wrong++;
+
+				if (((word >> 9) & 0x7FU) != value)
+					oldWrong++;
+
+				cases++;
+			}
+		}
+	}
+
+	::printf("EMB: %u words checked, %u differences, %u now corrected\n", 0x10000U, failures, changed);
+	::printf("EMB with up to two bit errors: %u cases, %u wrong, %u wrong before\n", cases, wrong, oldWrong);
+
+	return failures + wrong;
+}
+
+// Packed codeword from the bool array, d[0] the most significant bit
+static unsigned int pack(const bool* d, unsigned int n)
+{
+	unsigned int code = 0U;
+
+	for (unsigned int i = 0U; i < n; i++)
+		code = (code << 1) | (d[i] ? 1U : 0U);
+
+	return code;
+}
+
+static void unpack(unsigned int code, bool* d, unsigned int n)
+{
+	for (unsigned int i = 0U; i < n; i++)
+		d[i] = ((code >> (n - 1U - i)) & 0x01U) == 0x01U;
+}
+
+// The bool versions are the decoders the packed ones replaced, and are
+// still used by their old callers
+static unsigned int checkHamming(const char* name, unsigned int n, unsigned int k, void (*oldEncode)(bool*), bool (*oldDecode)(bool*), unsigned int (*newEncode)(unsigned int), bool (*newDecode)(unsigned int&))
+{
+	unsigned int failures = 0U;
+
+	for (unsigned int word = 0U; word < (1U << n); word++) {
+		bool d[17U];
+		unpack(word, d, n);
+		bool oldResult = oldDecode(d);
+
+		unsigned int code = word;
+		bool newResult = newDecode(code);
+
+		if (oldResult != newResult || pack(d, n) != code) {
+			if (failures < 5U)
+				::printf("Hamming %s word %05X differs\n", name, word);
+			failures++;
+		}
+	}
+
+	for (unsigned int data = 0U; data < (1U << k); data++) {
+		bool d[17U];
+		unpack(data << (n - k), d, n);
+		oldEncode(d);
+
+		if (pack(d, n) != newEncode(data)) {
+			if (failures < 5U)
+				::printf("Hamming %s data %04X encodes differently\n", name, data);
+			failures++;
+		}
+	}
+
+	::printf("Hamming %s: %u words and %u data checked, %u differences\n", name, 1U << n, 1U << k, failures);
+
+	return failures;
+}
+
+static void benchHamming(const char* name, unsigned int n, bool (*oldDecode)(bool*), bool (*newDecode)(unsigned int&))
+{
+	unsigned int words = 1U << n;
+
+	bool (*d)[17U] = new bool[words][17U];
+	for (unsigned int word = 0U; word < words; word++)
+		unpack(word, d[word], n);
+
+	// The sum keeps the compiler from dropping the decodes
+	unsigned int sum = 0U;
+
+	unsigned long long start = CClock::getTime();
+	for (unsigned int round = 0U; round < BENCH_ROUNDS; round++) {
+		for (unsigned int word = 0U; word < words; word++) {
+			bool temp[17U];
+			::memcpy(temp, d[word], n);
+			sum += oldDecode(temp) ? 1U : 0U;
+		}
+	}
+	unsigned long long oldTime = CClock::getTime() - start;
+
+	start = CClock::getTime();
+	for (unsigned int round = 0U; round < BENCH_ROUNDS; round++) {
+		for (unsigned int word = 0U; word < words; word++) {
+			unsigned int code = word;
+			sum -= newDecode(code) ? 1U : 0U;
+		}
+	}
+	unsigned long long newTime = CClock::getTime() - start;
+
+	delete[] d;
+
+	double perWord = 1000.0 / (double(words) * BENCH_ROUNDS);
+	::printf("Hamming %s: %.1f ns/word bool, %.1f ns/word packed%s\n", name, double(oldTime) * perWord, double(newTime) * perWord, sum == 0U ? "" : " (results differ)");
+}
+
+int main()
+{
+	unsigned int failures = 0U;
+
+	failures += checkQR1676();
+	failures += checkGolay2087();
+	failures += checkEMB();
+
+	failures += checkHamming("(15,11,3) 1", 15U, 11U, CHamming::encode15113_1, CHamming::decode15113_1, CHamming::encode15113_1, CHamming::decode15113_1);
+	failures += checkHamming("(15,11,3) 2", 15U, 11U, CHamming::encode15113_2, CHamming::decode15113_2, CHamming::encode15113_2, CHamming::decode15113_2);
+	failures += checkHamming("(13,9,3)", 13U, 9U, CHamming::encode1393, CHamming::decode1393, CHamming::encode1393, CHamming::decode1393);
+	failures += checkHamming("(10,6,3)", 10U, 6U, CHamming::encode1063, CHamming::decode1063, CHamming::encode1063, CHamming::decode1063);
+	failures += checkHamming("(16,11,4)", 16U, 11U, CHamming::encode16114, CHamming::decode16114, CHamming::encode16114, CHamming::decode16114);
+	failures += checkHamming("(17,12,3)", 17U, 12U, CHamming::encode17123, CHamming::decode17123, CHamming::encode17123, CHamming::decode17123);
+
+	// The sum keeps the compiler from dropping the decodes
+	unsigned int sum = 0U;
+
+	unsigned long long start = CClock::getTime();
+	for (unsigned int round = 0U; round < BENCH_ROUNDS; round++) {
+		for (unsigned int word = 0U; word < 0x10000U; word++) {
+			unsigned char data[2U] = { (unsigned char)(word >> 8), (unsigned char)(word & 0xFFU) };
+			sum += oldDecode1676(data);
+		}
+	}
+	unsigned long long oldQR = CClock::getTime() - start;
+
+	start = CClock::getTime();
+	for (unsigned int round = 0U; round < BENCH_ROUNDS; round++) {
+		for (unsigned int word = 0U; word < 0x10000U; word++) {
+			unsigned char data[2U] = { (unsigned char)(word >> 8), (unsigned char)(word & 0xFFU) };
+			sum -= CQR1676::decode(data);
+		}
+	}
+	unsigned long long newQR = CClock::getTime() - start;
+
+	start = CClock::getTime();
+	for (unsigned int word = 0U; word < 0x100000U; word++) {
+		unsigned char data[3U] = { (unsigned char)(word >> 12), (unsigned char)((word >> 4) & 0xFFU), (unsigned char)((word << 4) & 0xF0U) };
+		sum += oldDecode2087(data);
+	}
+	unsigned long long oldGolay = CClock::getTime() - start;
+
+	start = CClock::getTime();
+	for (unsigned int word = 0U; word < 0x100000U; word++) {
+		unsigned char data[3U] = { (unsigned char)(word >> 12), (unsigned char)((word >> 4) & 0xFFU), (unsigned char)((word << 4) & 0xF0U) };
+		sum -= CGolay2087::decode(data);
+	}
+	unsigned long long newGolay = CClock::getTime() - start;
+
+	double perQR    = 1000.0 / (double(0x10000U) * BENCH_ROUNDS);
+	double perGolay = 1000.0 / double(0x100000U);
+	::printf("QR (16,7,6): %.1f ns/word division, %.1f ns/word table\n", double(oldQR) * perQR, double(newQR) * perQR);
+	::printf("Golay (20,8): %.1f ns/word division, %.1f ns/word table\n", double(oldGolay) * perGolay, double(newGolay) * perGolay);
+
+	benchHamming("(15,11,3) 2", 15U, CHamming::decode15113_2, CHamming::decode15113_2);
+	benchHamming("(13,9,3)", 13U, CHamming::decode1393, CHamming::decode1393);
+	benchHamming("(16,11,4)", 16U, CHamming::decode16114, CHamming::decode16114);
+
+	return (failures == 0U && sum == 0U) ? 0 : 1;
+}
@@ -0,0 +1,568 @@
+/*
+ *   Copyright (C) 2019 by Manuel Sanchez EA7EE
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+// Checks the packed CDMREmbeddedData against the bool array class it
+// replaced, on clean LCs, LCs with bit errors and bursts with random LCSS,
+// then times encoding and decoding a whole LC with both.
+
+#include "DMREmbeddedData.h"
+#include "DMRDefines.h"
+#include "Hamming.h"
+#include "DMRLC.h"
+#include "Clock.h"
+#include "Utils.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+const unsigned int CHECK_LCS    = 200000U;
+const unsigned int CHECK_BURSTS = 1000000U;
+const unsigned int BENCH_LCS    = 500000U;
+
+// CCRC::checkFiveBit() and encodeFiveBit() as they were on bool arrays
+static void oldEncodeFiveBit(const bool* in, unsigned int& tcrc)
+{
+	unsigned short total = 0U;
+	for (unsigned int i = 0U; i < 72U; i += 8U) {
+		unsigned char c;
+		CUtils::bitsToByteBE(in + i, c);
+		total += c;
+	}
+
+	total %= 31U;
+
+	tcrc = total;
+}
+
+static bool oldCheckFiveBit(bool* in, unsigned int tcrc)
+{
+	unsigned int crc;
+	oldEncodeFiveBit(in, crc);
+
+	return crc == tcrc;
+}
+
+// CDMREmbeddedData as it was before the LC was packed
+class COldEmbeddedData
+{
+public:
+	COldEmbeddedData() :
+	m_raw(NULL),
+	m_state(LCS_NONE),
+	m_data(NULL),
+	m_FLCO(FLCO_GROUP),
+	m_valid(false)
+	{
+		m_raw  = new bool[128U];
+		m_data = new bool[72U];
+	}
+
+	~COldEmbeddedData()
+	{
+		delete[] m_raw;
+		delete[] m_data;
+	}
+
+	bool addData(const unsigned char* data, unsigned char lcss)
+	{
+		bool rawData[40U];
+		CUtils::byteToBitsBE(data[14U], rawData + 0U);
+		CUtils::byteToBitsBE(data[15U], rawData + 8U);
+		CUtils::byteToBitsBE(data[16U], rawData + 16U);
+		CUtils::byteToBitsBE(data[17U], rawData + 24U);
+		CUtils::byteToBitsBE(data[18U], rawData + 32U);
+
+		if (lcss == 1U) {
+			for (unsigned int a = 0U; a < 32U; a++)
+				m_raw[a] = rawData[a + 4U];
+
+			m_state = LCS_FIRST;
+			m_valid = false;
+
+			return false;
+		}
+
+		if (lcss == 3U && m_state == LCS_FIRST) {
+			for (unsigned int a = 0U; a < 32U; a++)
+				m_raw[a + 32U] = rawData[a + 4U];
+
+			m_state = LCS_SECOND;
+
+			return false;
+		}
+
+		if (lcss == 3U && m_state == LCS_SECOND) {
+			for (unsigned int a = 0U; a < 32U; a++)
+				m_raw[a + 64U] = rawData[a + 4U];
+
+			m_state = LCS_THIRD;
+
+			return false;
+		}
+
+		if (lcss == 2U && m_state == LCS_THIRD)	{
+			for (unsigned int a = 0U; a < 32U; a++)
+				m_raw[a + 96U] = rawData[a + 4U];
+
+			m_state = LCS_NONE;
+
+			decodeEmbeddedData();
+			if (m_valid)
+				encodeEmbeddedData();
+
+			return m_valid;
+		}
+
+		return false;
+	}
+
+	CDMRLC* getLC() const
+	{
+		if (!m_valid)
+			return NULL;
+
+		if (m_FLCO != FLCO_GROUP && m_FLCO != FLCO_USER_USER)
+			return NULL;
+
+		return new CDMRLC(m_data);
+	}
+
+	void setLC(const CDMRLC& lc)
+	{
+		lc.getData(m_data);
+
+		m_FLCO  = lc.getFLCO();
+		m_valid = true;
+
+		encodeEmbeddedData();
+	}
+
+	unsigned char getData(unsigned char* data, unsigned char n) const
+	{
+		if (n >= 1U && n < 5U) {
+			n--;
+
+			bool bits[40U];
+			::memset(bits, 0x00U, 40U * sizeof(bool));
+			::memcpy(bits + 4U, m_raw + n * 32U, 32U * sizeof(bool));
+
+			unsigned char bytes[5U];
+			CUtils::bitsToByteBE(bits + 0U,  bytes[0U]);
+			CUtils::bitsToByteBE(bits + 8U,  bytes[1U]);
+			CUtils::bitsToByteBE(bits + 16U, bytes[2U]);
+			CUtils::bitsToByteBE(bits + 24U, bytes[3U]);
+			CUtils::bitsToByteBE(bits + 32U, bytes[4U]);
+
+			data[14U] = (data[14U] & 0xF0U) | (bytes[0U] & 0x0FU);
+			data[15U] = bytes[1U];
+			data[16U] = bytes[2U];
+			data[17U] = bytes[3U];
+			data[18U] = (data[18U] & 0x0FU) | (bytes[4U] & 0xF0U);
+
+			switch (n) {
+			case 0U:
+				return 1U;
+			case 3U:
+				return 2U;
+			default:
+				return 3U;
+			}
+		} else {
+			data[14U] &= 0xF0U;
+			data[15U]  = 0x00U;
+			data[16U]  = 0x00U;
+			data[17U]  = 0x00U;
+			data[18U] &= 0x0FU;
+
+			return 0U;
+		}
+	}
+
+	bool getRawData(unsigned char* data) const
+	{
+		if (!m_valid)
+			return false;
+
+		for (unsigned int i = 0U; i < 9U; i++)
+			CUtils::bitsToByteBE(m_data + i * 8U, data[i]);
+
+		return true;
+	}
+
+	bool isValid() const
+	{
+		return m_valid;
+	}
+
+	FLCO getFLCO() const
+	{
+		return m_FLCO;
+	}
+
+private:
+	bool*        m_raw;
+	LC_STATE     m_state;
+	bool*        m_data;
+	FLCO         m_FLCO;
+	bool         m_valid;
+
+	void decodeEmbeddedData()
+	{
+		unsigned int rows[8U] = {0U, 0U, 0U, 0U, 0U, 0U, 0U, 0U};
+
+		unsigned int b = 0U;
+		for (unsigned int a = 0U; a < 128U; a++) {
+			if (m_raw[a])
+				rows[b >> 4] |= 0x8000U >> (b & 0x0FU);
+			b += 16U;
+			if (b > 127U)
+				b -= 127U;
+		}
+
+		for (unsigned int a = 0U; a < 7U; a++) {
+			if (!CHamming::decode16114(rows[a]))
+				return;
+		}
+
+		if ((rows[0U] ^ rows[1U] ^ rows[2U] ^ rows[3U] ^ rows[4U] ^ rows[5U] ^ rows[6U] ^ rows[7U]) != 0U)
+			return;
+
+		unsigned int crc = 0U;
+
+		b = 0U;
+		for (unsigned int a = 0U; a < 7U; a++) {
+			unsigned int count = (a < 2U) ? 11U : 10U;
+
+			for (unsigned int i = 0U; i < count; i++, b++)
+				m_data[b] = ((rows[a] >> (15U - i)) & 0x01U) == 0x01U;
+
+			if (a >= 2U)
+				crc = (crc << 1) | ((rows[a] >> 5) & 0x01U);
+		}
+
+		if (!oldCheckFiveBit(m_data, crc))
+			return;
+
+		m_valid = true;
+
+		unsigned char flco;
+		CUtils::bitsToByteBE(m_data + 0U, flco);
+		m_FLCO = FLCO(flco & 0x3FU);
+	}
+
+	void encodeEmbeddedData()
+	{
+		unsigned int crc;
+		oldEncodeFiveBit(m_data, crc);
+
+		unsigned int rows[8U];
+		rows[7U] = 0U;
+
+		unsigned int b = 0U;
+		for (unsigned int a = 0U; a < 7U; a++) {
+			unsigned int count = (a < 2U) ? 11U : 10U;
+
+			unsigned int value = 0U;
+			for (unsigned int i = 0U; i < count; i++, b++)
+				value = (value << 1) | (m_data[b] ? 0x01U : 0x00U);
+
+			if (a >= 2U)
+				value = (value << 1) | ((crc >> (6U - a)) & 0x01U);
+
+			rows[a] = CHamming::encode16114(value);
+			rows[7U] ^= rows[a];
+		}
+
+		b = 0U;
+		for (unsigned int a = 0U; a < 128U; a++) {
+			m_raw[a] = ((rows[b >> 4] >> (15U - (b & 0x0FU))) & 0x01U) == 0x01U;
+			b += 16U;
+			if (b > 127U)
+				b -= 127U;
+		}
+	}
+};
+
+static CDMRLC randomLC()
+{
+	unsigned char bytes[9U];
+	for (unsigned int i = 0U; i < 9U; i++)
+		bytes[i] = ::rand();
+
+	// Mostly group and private calls, the only ones getLC() hands out
+	switch (::rand() % 4U) {
+	case 0U:
+		break;
+	case 1U:
+		bytes[0U] = (bytes[0U] & 0xC0U) | FLCO_USER_USER;
+		break;
+	default:
+		bytes[0U] = (bytes[0U] & 0xC0U) | FLCO_GROUP;
+		break;
+	}
+
+	return CDMRLC(bytes);
+}
+
+static bool sameLC(const CDMRLC* expected, bool valid, const CDMRLC& actual)
+{
+	if (expected == NULL)
+		return !valid;
+
+	if (!valid)
+		return false;
+
+	unsigned char a[9U], b[9U];
+	expected->getData(a);
+	actual.getData(b);
+
+	return ::memcmp(a, b, 9U) == 0;
+}
+
+// Both must agree on everything they report after each burst
+static bool sameState(const COldEmbeddedData& old, const CDMREmbeddedData& packed)
+{
+	if (old.isValid() != packed.isValid())
+		return false;
+
+	if (!old.isValid())
+		return true;
+
+	if (old.getFLCO() != packed.getFLCO())
+		return false;
+
+	unsigned char a[9U], b[9U];
+	bool oldRaw = old.getRawData(a);
+	bool newRaw = packed.getRawData(b);
+	if (oldRaw != newRaw || (oldRaw && ::memcmp(a, b, 9U) != 0))
+		return false;
+
+	CDMRLC* oldLC = old.getLC();
+	CDMRLC lc;
+	bool valid = packed.getLC(lc);
+	bool same = sameLC(oldLC, valid, lc);
+	delete oldLC;
+
+	return same;
+}
+
+static unsigned int checkEncode()
+{
+	unsigned int failures = 0U;
+
+	for (unsigned int i = 0U; i < CHECK_LCS; i++) {
+		CDMRLC lc = randomLC();
+
+		COldEmbeddedData old;
+		old.setLC(lc);
+
+		CDMREmbeddedData packed;
+		packed.setLC(lc);
+
+		bool same = sameState(old, packed);
+
+		for (unsigned char n = 0U; n < 6U; n++) {
+			unsigned char a[DMR_FRAME_LENGTH_BYTES], b[DMR_FRAME_LENGTH_BYTES];
+			for (unsigned int j = 0U; j < DMR_FRAME_LENGTH_BYTES; j++)
+				a[j] = b[j] = ::rand();
+
+			if (old.getData(a, n) != packed.getData(b, n) || ::memcmp(a, b, DMR_FRAME_LENGTH_BYTES) != 0)
+				same = false;
+		}
+
+		if (!same)
+			failures++;
+	}
+
+	::printf("Encode: %u LCs checked, %u differences\n", CHECK_LCS, failures);
+
+	return failures;
+}
+
+// The four bursts of an LC with up to three bit errors in the 128 bits
+static unsigned int checkDecode()
+{
+	unsigned int failures = 0U;
+	unsigned int valid[4U] = {0U, 0U, 0U, 0U};
+
+	for (unsigned int i = 0U; i < CHECK_LCS; i++) {
+		CDMRLC lc = randomLC();
+
+		CDMREmbeddedData encoder;
+		encoder.setLC(lc);
+
+		unsigned char bursts[4U][DMR_FRAME_LENGTH_BYTES];
+		unsigned char lcss[4U];
+		for (unsigned char n = 0U; n < 4U; n++) {
+			for (unsigned int j = 0U; j < DMR_FRAME_LENGTH_BYTES; j++)
+				bursts[n][j] = ::rand();
+			lcss[n] = encoder.getData(bursts[n], n + 1U);
+		}
+
+		unsigned int errors = i % 4U;
+		for (unsigned int e = 0U; e < errors; e++) {
+			unsigned int pos = ::rand() % 128U;
+			unsigned int bit = (pos % 32U) + 4U;
+			bursts[pos / 32U][14U + bit / 8U] ^= 0x80U >> (bit % 8U);
+		}
+
+		COldEmbeddedData old;
+		CDMREmbeddedData packed;
+
+		bool same = true;
+		for (unsigned int n = 0U; n < 4U; n++) {
+			if (old.addData(bursts[n], lcss[n]) != packed.addData(bursts[n], lcss[n]))
+				same = false;
+			if (!sameState(old, packed))
+				same = false;
+		}
+
+		if (packed.isValid())
+			valid[errors]++;
+
+		if (!same)
+			failures++;
+	}
+
+	::printf("Decode: %u LCs checked, %u differences, valid with 0/1/2/3 errors %u/%u/%u/%u\n", CHECK_LCS, failures, valid[0U], valid[1U], valid[2U], valid[3U]);
+
+	return failures;
+}
+
+// Random bursts and LCSS, with the odd real LC, to walk the state machine
+static unsigned int checkStream()
+{
+	COldEmbeddedData old;
+	CDMREmbeddedData packed;
+	CDMREmbeddedData encoder;
+
+	unsigned int failures = 0U;
+	unsigned int decoded = 0U;
+
+	for (unsigned int i = 0U; i < CHECK_BURSTS; i++) {
+		unsigned char burst[DMR_FRAME_LENGTH_BYTES];
+		for (unsigned int j = 0U; j < DMR_FRAME_LENGTH_BYTES; j++)
+			burst[j] = ::rand();
+
+		unsigned char lcss = ::rand() % 4U;
+		if ((i % 16U) < 4U) {
+			if ((i % 16U) == 0U)
+				encoder.setLC(randomLC());
+			lcss = encoder.getData(burst, (i % 16U) + 1U);
+		}
+
+		bool oldResult = old.addData(burst, lcss);
+		bool newResult = packed.addData(burst, lcss);
+
+		if (newResult)
+			decoded++;
+
+		if (oldResult != newResult || !sameState(old, packed))
+			failures++;
+	}
+
+	::printf("Stream: %u bursts checked, %u differences, %u LCs decoded\n", CHECK_BURSTS, failures, decoded);
+
+	return failures;
+}
+
+int main()
+{
+	::srand(4000U);
+
+	unsigned int failures = 0U;
+
+	failures += checkEncode();
+	failures += checkDecode();
+	failures += checkStream();
+
+	CDMRLC* lcs = new CDMRLC[64U];
+	for (unsigned int i = 0U; i < 64U; i++)
+		lcs[i] = CDMRLC(FLCO_GROUP, ::rand() & 0xFFFFFFU, ::rand() & 0xFFFFFFU);
+
+	unsigned char (*bursts)[4U][DMR_FRAME_LENGTH_BYTES] = new unsigned char[64U][4U][DMR_FRAME_LENGTH_BYTES];
+	for (unsigned int i = 0U; i < 64U; i++) {
+		CDMREmbeddedData encoder;
+		encoder.setLC(lcs[i]);
+		for (unsigned char n = 0U; n < 4U; n++) {
+			::memset(bursts[i][n], 0x00U, DMR_FRAME_LENGTH_BYTES);
+			encoder.getData(bursts[i][n], n + 1U);
+		}
+	}
+
+	static const unsigned char LCSS[] = {1U, 3U, 3U, 2U};
+
+	unsigned char frame[DMR_FRAME_LENGTH_BYTES];
+	::memset(frame, 0x00U, DMR_FRAME_LENGTH_BYTES);
+
+	// The sum keeps the compiler from dropping the work
+	unsigned int sum = 0U;
+
+	COldEmbeddedData oldData;
+	CDMREmbeddedData newData;
+
+	unsigned long long start = CClock::getTime();
+	for (unsigned int i = 0U; i < BENCH_LCS; i++) {
+		oldData.setLC(lcs[i % 64U]);
+		for (unsigned char n = 1U; n < 5U; n++)
+			sum += oldData.getData(frame, n) + frame[16U];
+	}
+	unsigned long long oldEncode = CClock::getTime() - start;
+
+	start = CClock::getTime();
+	for (unsigned int i = 0U; i < BENCH_LCS; i++) {
+		newData.setLC(lcs[i % 64U]);
+		for (unsigned char n = 1U; n < 5U; n++)
+			sum -= newData.getData(frame, n) + frame[16U];
+	}
+	unsigned long long newEncode = CClock::getTime() - start;
+
+	start = CClock::getTime();
+	for (unsigned int i = 0U; i < BENCH_LCS; i++) {
+		for (unsigned int n = 0U; n < 4U; n++)
+			oldData.addData(bursts[i % 64U][n], LCSS[n]);
+
+		CDMRLC* lc = oldData.getLC();
+		if (lc != NULL) {
+			sum += lc->getSrcId();
+			delete lc;
+		}
+	}
+	unsigned long long oldDecode = CClock::getTime() - start;
+
+	start = CClock::getTime();
+	for (unsigned int i = 0U; i < BENCH_LCS; i++) {
+		for (unsigned int n = 0U; n < 4U; n++)
+			newData.addData(bursts[i % 64U][n], LCSS[n]);
+
+		CDMRLC lc;
+		if (newData.getLC(lc))
+			sum -= lc.getSrcId();
+	}
+	unsigned long long newDecode = CClock::getTime() - start;
+
+	delete[] lcs;
+	delete[] bursts;
+
+	double perLC = 1000.0 / BENCH_LCS;
+	::printf("Encode: %.1f ns/LC bool, %.1f ns/LC packed\n", double(oldEncode) * perLC, double(newEncode) * perLC);
+	::printf("Decode: %.1f ns/LC bool, %.1f ns/LC packed\n", double(oldDecode) * perLC, double(newDecode) * perLC);
+
+	return (failures == 0U && sum == 0U) ? 0 : 1;
+}
@@ -0,0 +1,229 @@
+/*
+ *   Copyright (C) 2019 by Manuel Sanchez EA7EE
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+// Checks the FICHs CYSFFICH::encode() copies out of its cache against the
+// full encoder it used to run for every frame, then times both on a call
+// and on FICHs that never repeat.
+
+#include "YSFConvolution.h"
+#include "YSFDefines.h"
+#include "Golay24128.h"
+#include "YSFFICH.h"
+#include "Clock.h"
+#include "CRC.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+const unsigned int CHECK_FICHS  = 1000000U;
+const unsigned int BENCH_FRAMES = 2000000U;
+const unsigned int FRAME_LENGTH = YSF_SYNC_LENGTH_BYTES + YSF_FICH_LENGTH_BYTES;
+
+const unsigned char BIT_MASK_TABLE[] = {0x80U, 0x40U, 0x20U, 0x10U, 0x08U, 0x04U, 0x02U, 0x01U};
+
+#define WRITE_BIT1(p,i,b) p[(i)>>3] = (b) ? (p[(i)>>3] | BIT_MASK_TABLE[(i)&7]) : (p[(i)>>3] & ~BIT_MASK_TABLE[(i)&7])
+#define READ_BIT1(p,i)    (p[(i)>>3] & BIT_MASK_TABLE[(i)&7])
+
+const unsigned int INTERLEAVE_TABLE[] = {
+   0U, 40U,  80U, 120U, 160U,
+   2U, 42U,  82U, 122U, 162U,
+   4U, 44U,  84U, 124U, 164U,
+   6U, 46U,  86U, 126U, 166U,
+   8U, 48U,  88U, 128U, 168U,
+  10U, 50U,  90U, 130U, 170U,
+  12U, 52U,  92U, 132U, 172U,
+  14U, 54U,  94U, 134U, 174U,
+  16U, 56U,  96U, 136U, 176U,
+  18U, 58U,  98U, 138U, 178U,
+  20U, 60U, 100U, 140U, 180U,
+  22U, 62U, 102U, 142U, 182U,
+  24U, 64U, 104U, 144U, 184U,
+  26U, 66U, 106U, 146U, 186U,
+  28U, 68U, 108U, 148U, 188U,
+  30U, 70U, 110U, 150U, 190U,
+  32U, 72U, 112U, 152U, 192U,
+  34U, 74U, 114U, 154U, 194U,
+  36U, 76U, 116U, 156U, 196U,
+  38U, 78U, 118U, 158U, 198U};
+
+// CYSFFICH::encode() as it was before the cache
+static void oldEncode(const unsigned char* in, unsigned char* bytes)
+{
+	unsigned char fich[6U];
+	::memcpy(fich, in, 4U);
+
+	// Skip the sync bytes
+	bytes += YSF_SYNC_LENGTH_BYTES;
+
+	CCRC::addCCITT162(fich, 6U);
+
+	unsigned int b0 = ((fich[0U] << 4) & 0xFF0U) | ((fich[1U] >> 4) & 0x00FU);
+	unsigned int b1 = ((fich[1U] << 8) & 0xF00U) | ((fich[2U] >> 0) & 0x0FFU);
+	unsigned int b2 = ((fich[3U] << 4) & 0xFF0U) | ((fich[4U] >> 4) & 0x00FU);
+	unsigned int b3 = ((fich[4U] << 8) & 0xF00U) | ((fich[5U] >> 0) & 0x0FFU);
+
+	unsigned int c0 = CGolay24128::encode24128(b0);
+	unsigned int c1 = CGolay24128::encode24128(b1);
+	unsigned int c2 = CGolay24128::encode24128(b2);
+	unsigned int c3 = CGolay24128::encode24128(b3);
+
+	unsigned char conv[13U];
+	conv[0U]  = (c0 >> 16) & 0xFFU;
+	conv[1U]  = (c0 >> 8) & 0xFFU;
+	conv[2U]  = (c0 >> 0) & 0xFFU;
+	conv[3U]  = (c1 >> 16) & 0xFFU;
+	conv[4U]  = (c1 >> 8) & 0xFFU;
+	conv[5U]  = (c1 >> 0) & 0xFFU;
+	conv[6U]  = (c2 >> 16) & 0xFFU;
+	conv[7U]  = (c2 >> 8) & 0xFFU;
+	conv[8U]  = (c2 >> 0) & 0xFFU;
+	conv[9U]  = (c3 >> 16) & 0xFFU;
+	conv[10U] = (c3 >> 8) & 0xFFU;
+	conv[11U] = (c3 >> 0) & 0xFFU;
+	conv[12U] = 0x00U;
+
+	CYSFConvolution convolution;
+	unsigned char convolved[25U];
+	convolution.encode(conv, convolved, 100U);
+
+	unsigned int j = 0U;
+	for (unsigned int i = 0U; i < 100U; i++) {
+		unsigned int n = INTERLEAVE_TABLE[i];
+
+		bool s0 = READ_BIT1(convolved, j) != 0U;
+		j++;
+
+		bool s1 = READ_BIT1(convolved, j) != 0U;
+		j++;
+
+		WRITE_BIT1(bytes, n, s0);
+
+		n++;
+		WRITE_BIT1(bytes, n, s1);
+	}
+}
+
+static bool checkFICH(const unsigned char* fich)
+{
+	unsigned char expected[FRAME_LENGTH], actual[FRAME_LENGTH];
+
+	// Both must leave the sync bytes alone
+	for (unsigned int i = 0U; i < FRAME_LENGTH; i++)
+		expected[i] = actual[i] = ::rand();
+
+	oldEncode(fich, expected);
+
+	CYSFFICH encoder;
+	encoder.load(fich);
+	encoder.encode(actual);
+
+	return ::memcmp(expected, actual, FRAME_LENGTH) == 0;
+}
+
+int main()
+{
+	::srand(3600U);
+
+	unsigned char fich[4U];
+
+	unsigned int failures = 0U;
+	for (unsigned int n = 0U; n < CHECK_FICHS; n++) {
+		// Mostly call-like FICHs that hit the cache, the rest random misses
+		if ((n % 4U) == 0U) {
+			for (unsigned int i = 0U; i < 4U; i++)
+				fich[i] = ::rand();
+		} else {
+			fich[0U] = 0x60U;
+			fich[1U] = ((n % 8U) << 3) | 0x07U;
+			fich[2U] = 0x12U;
+			fich[3U] = ::rand() & 0x01U;
+		}
+
+		if (!checkFICH(fich)) {
+			if (failures < 5U)
+				::printf("FICH %02X %02X %02X %02X differs\n", fich[0U], fich[1U], fich[2U], fich[3U]);
+			failures++;
+		}
+	}
+
+	::printf("FICH: %u FICHs checked, %u differences\n", CHECK_FICHS, failures);
+
+	unsigned char (*call)[4U]   = new unsigned char[8U][4U];
+	unsigned char (*random)[4U] = new unsigned char[BENCH_FRAMES][4U];
+
+	// A V/D mode 2 call, where only FN changes
+	for (unsigned int n = 0U; n < 8U; n++) {
+		call[n][0U] = 0x60U;
+		call[n][1U] = (n << 3) | 0x07U;
+		call[n][2U] = 0x12U;
+		call[n][3U] = 0x00U;
+	}
+
+	for (unsigned int n = 0U; n < BENCH_FRAMES; n++) {
+		for (unsigned int i = 0U; i < 4U; i++)
+			random[n][i] = ::rand();
+	}
+
+	unsigned char frame[FRAME_LENGTH];
+	::memset(frame, 0x00U, FRAME_LENGTH);
+
+	// The sum keeps the compiler from dropping the encodes
+	unsigned int sum = 0U;
+
+	unsigned long long start = CClock::getTime();
+	for (unsigned int n = 0U; n < BENCH_FRAMES; n++) {
+		oldEncode(call[n % 8U], frame);
+		sum += frame[YSF_SYNC_LENGTH_BYTES];
+	}
+	unsigned long long oldCall = CClock::getTime() - start;
+
+	CYSFFICH encoder;
+
+	start = CClock::getTime();
+	for (unsigned int n = 0U; n < BENCH_FRAMES; n++) {
+		encoder.load(call[n % 8U]);
+		encoder.encode(frame);
+		sum -= frame[YSF_SYNC_LENGTH_BYTES];
+	}
+	unsigned long long newCall = CClock::getTime() - start;
+
+	start = CClock::getTime();
+	for (unsigned int n = 0U; n < BENCH_FRAMES; n++) {
+		oldEncode(random[n], frame);
+		sum += frame[YSF_SYNC_LENGTH_BYTES];
+	}
+	unsigned long long oldRandom = CClock::getTime() - start;
+
+	start = CClock::getTime();
+	for (unsigned int n = 0U; n < BENCH_FRAMES; n++) {
+		encoder.load(random[n]);
+		encoder.encode(frame);
+		sum -= frame[YSF_SYNC_LENGTH_BYTES];
+	}
+	unsigned long long newRandom = CClock::getTime() - start;
+
+	delete[] call;
+	delete[] random;
+
+	double perFrame = 1000.0 / BENCH_FRAMES;
+	::printf("Call FICHs: %.1f ns/frame encoded, %.1f ns/frame cached\n", double(oldCall) * perFrame, double(newCall) * perFrame);
+	::printf("Random FICHs: %.1f ns/frame encoded, %.1f ns/frame cached\n", double(oldRandom) * perFrame, double(newRandom) * perFrame);
+
+	return (failures == 0U && sum == 0U) ? 0 : 1;
+}
@@ -0,0 +1,128 @@
+/*
+ *   Copyright (C) 2019 by Manuel Sanchez EA7EE
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#ifndef FrameQueue_H
+#define FrameQueue_H
+
+#include <cassert>
+#include <atomic>
+
+// Bounded single producer / single consumer queue used between the
+// pipeline threads. One thread may call addData() and one other thread
+// may call getData(), no locking is needed between them. Items are
+// preallocated, so T must be default constructible and assignable.
+template<class T> class CFrameQueue {
+public:
+	CFrameQueue(unsigned int length, const char* name) :
+	m_length(length + 1U),
+	m_name(name),
+	m_buffer(NULL),
+	m_iPtr(0U),
+	m_oPtr(0U),
+	m_overflows(0U)
+	{
+		assert(length > 0U);
+		assert(name != NULL);
+
+		m_buffer = new T[m_length];
+	}
+
+	~CFrameQueue()
+	{
+		delete[] m_buffer;
+	}
+
+	bool addData(const T& item)
+	{
+		unsigned int iPtr = m_iPtr.load(std::memory_order_relaxed);
+
+		unsigned int next = iPtr + 1U;
+		if (next == m_length)
+			next = 0U;
+
+		if (next == m_oPtr.load(std::memory_order_acquire)) {
+			m_overflows.fetch_add(1U, std::memory_order_relaxed);
+			return false;
+		}
+
+		m_buffer[iPtr] = item;
+
+		m_iPtr.store(next, std::memory_order_release);
+
+		return true;
+	}
+
+	bool getData(T& item)
+	{
+		unsigned int oPtr = m_oPtr.load(std::memory_order_relaxed);
+
+		if (oPtr == m_iPtr.load(std::memory_order_acquire))
+			return false;
+
+		item = m_buffer[oPtr];
+
+		unsigned int next = oPtr + 1U;
+		if (next == m_length)
+			next = 0U;
+
+		m_oPtr.store(next, std::memory_order_release);
+
+		return true;
+	}
+
+	bool isEmpty() const
+	{
+		return m_oPtr.load(std::memory_order_acquire) == m_iPtr.load(std::memory_order_acquire);
+	}
+
+	bool hasData() const
+	{
+		return !isEmpty();
+	}
+
+	unsigned int dataSize() const
+	{
+		unsigned int iPtr = m_iPtr.load(std::memory_order_acquire);
+		unsigned int oPtr = m_oPtr.load(std::memory_order_acquire);
+
+		if (iPtr >= oPtr)
+			return iPtr - oPtr;
+		else
+			return m_length - (oPtr - iPtr);
+	}
+
+	unsigned int getOverflows() const
+	{
+		return m_overflows.load(std::memory_order_relaxed);
+	}
+
+	const char* getName() const
+	{
+		return m_name;
+	}
+
+private:
+	unsigned int              m_length;
+	const char*               m_name;
+	T*                        m_buffer;
+	std::atomic<unsigned int> m_iPtr;
+	std::atomic<unsigned int> m_oPtr;
+	std::atomic<unsigned int> m_overflows;
+};
+
+#endif
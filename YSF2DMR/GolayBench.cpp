@@ -0,0 +1,118 @@
+/*
+ *   Copyright (C) 2019 by Manuel Sanchez EA7EE
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+// Checks the table driven Golay (23,12) syndrome against the bitwise long
+// division it replaced over every 23 bit word, then times both decoders.
+
+#include "Golay24128.h"
+#include "Clock.h"
+
+#include <cstdio>
+
+const unsigned int WORDS_23127 = 1U << 23;
+const unsigned int BENCH_ROUNDS = 4U;
+
+#define X22             0x00400000   /* vector representation of X^{22} */
+#define X11             0x00000800   /* vector representation of X^{11} */
+#define MASK12          0xfffff800   /* auxiliary vector for testing */
+#define GENPOL          0x00000c75   /* generator polinomial, g(x) */
+
+// The syndrome as Golay24128.cpp computed it before the table
+static unsigned int get_syndrome_23127(unsigned int pattern)
+{
+	unsigned int aux = X22;
+
+	if (pattern >= X11) {
+		while (pattern & MASK12) {
+			while (!(aux & pattern))
+				aux = aux >> 1;
+
+			pattern ^= (aux / X11) * GENPOL;
+		}
+	}
+
+	return pattern;
+}
+
+static unsigned int DECODING_TABLE[2048U];
+
+// Every error of up to three bits has its own syndrome
+static void makeDecodingTable()
+{
+	for (unsigned int i = 0U; i < 23U; i++) {
+		for (unsigned int j = i; j < 23U; j++) {
+			for (unsigned int k = j; k < 23U; k++) {
+				unsigned int pattern = (1U << i) | (1U << j) | (1U << k);
+				DECODING_TABLE[get_syndrome_23127(pattern)] = pattern;
+			}
+		}
+	}
+
+	DECODING_TABLE[0U] = 0U;
+}
+
+static unsigned int decode23127(unsigned int code)
+{
+	unsigned int syndrome = get_syndrome_23127(code);
+	unsigned int error_pattern = DECODING_TABLE[syndrome];
+
+	code ^= error_pattern;
+
+	return code >> 11;
+}
+
+int main()
+{
+	makeDecodingTable();
+
+	unsigned int failures = 0U;
+	for (unsigned int code = 0U; code < WORDS_23127; code++) {
+		unsigned int expected = decode23127(code);
+		unsigned int actual   = CGolay24128::decode23127(code);
+		if (expected != actual) {
+			if (failures < 5U)
+				::printf("%06X: decoded %03X, expected %03X\n", code, actual, expected);
+			failures++;
+		}
+	}
+
+	::printf("Golay (23,12): %u words checked, %u differences\n", WORDS_23127, failures);
+
+	// The sums keep the compiler from dropping the decodes
+	unsigned int sum = 0U;
+
+	unsigned long long start = CClock::getTime();
+	for (unsigned int n = 0U; n < BENCH_ROUNDS; n++) {
+		for (unsigned int code = 0U; code < WORDS_23127; code++)
+			sum += decode23127(code);
+	}
+	unsigned long long division = CClock::getTime() - start;
+
+	start = CClock::getTime();
+	for (unsigned int n = 0U; n < BENCH_ROUNDS; n++) {
+		for (unsigned int code = 0U; code < WORDS_23127; code++)
+			sum -= CGolay24128::decode23127(code);
+	}
+	unsigned long long table = CClock::getTime() - start;
+
+	double words = double(WORDS_23127) * BENCH_ROUNDS;
+	::printf("Long division: %.2f ns/word\n", double(division) * 1000.0 / words);
+	::printf("Syndrome table: %.2f ns/word (%.1fx)\n", double(table) * 1000.0 / words, double(division) / double(table));
+
+	return (failures == 0U && sum == 0U) ? 0 : 1;
+}
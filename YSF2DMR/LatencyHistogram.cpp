@@ -0,0 +1,138 @@
+/*
+ *   Copyright (C) 2019 by Manuel Sanchez EA7EE
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "LatencyHistogram.h"
+#include "Log.h"
+
+#include <cassert>
+
+const unsigned int SUB_BUCKET_BITS  = 6U;
+const unsigned int SUB_BUCKET_COUNT = 1U << SUB_BUCKET_BITS;
+const unsigned int SUB_BUCKET_HALF  = SUB_BUCKET_COUNT / 2U;
+const unsigned int BUCKET_COUNT     = (32U - SUB_BUCKET_BITS + 1U) * SUB_BUCKET_HALF + SUB_BUCKET_HALF;
+
+static unsigned int getIndex(unsigned int value)
+{
+	if (value < SUB_BUCKET_COUNT)
+		return value;
+
+	unsigned int msb = 31U;
+	while ((value & (1U << msb)) == 0U)
+		msb--;
+
+	unsigned int shift = msb - (SUB_BUCKET_BITS - 1U);
+
+	return shift * SUB_BUCKET_HALF + (value >> shift);
+}
+
+// The highest value that falls into the bucket
+static unsigned int getValue(unsigned int index)
+{
+	if (index < SUB_BUCKET_COUNT)
+		return index;
+
+	unsigned int shift = index / SUB_BUCKET_HALF - 1U;
+	unsigned long long sub = index - shift * SUB_BUCKET_HALF;
+
+	unsigned long long value = ((sub + 1ULL) << shift) - 1ULL;
+	if (value > 0xFFFFFFFFULL)
+		value = 0xFFFFFFFFULL;
+
+	return (unsigned int)value;
+}
+
+CLatencyHistogram::CLatencyHistogram(const std::string& name) :
+m_name(name),
+m_counts(NULL),
+m_count(0U),
+m_max(0U),
+m_sum(0ULL)
+{
+	m_counts = new std::atomic<unsigned int>[BUCKET_COUNT];
+
+	reset();
+}
+
+CLatencyHistogram::~CLatencyHistogram()
+{
+	delete[] m_counts;
+}
+
+void CLatencyHistogram::add(unsigned int us)
+{
+	unsigned int index = getIndex(us);
+	assert(index < BUCKET_COUNT);
+
+	m_counts[index].fetch_add(1U, std::memory_order_relaxed);
+	m_count.fetch_add(1U, std::memory_order_relaxed);
+	m_sum.fetch_add(us, std::memory_order_relaxed);
+
+	unsigned int max = m_max.load(std::memory_order_relaxed);
+	while (us > max && !m_max.compare_exchange_weak(max, us, std::memory_order_relaxed))
+		;
+}
+
+unsigned int CLatencyHistogram::getCount() const
+{
+	return m_count.load(std::memory_order_relaxed);
+}
+
+unsigned int CLatencyHistogram::getPercentile(float percentile) const
+{
+	unsigned int count = getCount();
+	if (count == 0U)
+		return 0U;
+
+	unsigned long long target = (unsigned long long)((percentile / 100.0F) * float(count) + 0.5F);
+	if (target == 0ULL)
+		target = 1ULL;
+
+	unsigned long long total = 0ULL;
+	for (unsigned int i = 0U; i < BUCKET_COUNT; i++) {
+		total += m_counts[i].load(std::memory_order_relaxed);
+		if (total >= target)
+			return getValue(i);
+	}
+
+	return m_max.load(std::memory_order_relaxed);
+}
+
+void CLatencyHistogram::dump() const
+{
+	unsigned int count = getCount();
+	if (count == 0U) {
+		LogMessage("Latency %s: no frames", m_name.c_str());
+		return;
+	}
+
+	float mean = float(m_sum.load(std::memory_order_relaxed)) / float(count);
+
+	LogMessage("Latency %s: %u frames, mean %.1f ms, p50 %.1f ms, p90 %.1f ms, p99 %.1f ms, p99.9 %.1f ms, max %.1f ms", m_name.c_str(), count,
+		mean / 1000.0F, float(getPercentile(50.0F)) / 1000.0F, float(getPercentile(90.0F)) / 1000.0F, float(getPercentile(99.0F)) / 1000.0F,
+		float(getPercentile(99.9F)) / 1000.0F, float(m_max.load(std::memory_order_relaxed)) / 1000.0F);
+}
+
+void CLatencyHistogram::reset()
+{
+	for (unsigned int i = 0U; i < BUCKET_COUNT; i++)
+		m_counts[i].store(0U, std::memory_order_relaxed);
+
+	m_count.store(0U, std::memory_order_relaxed);
+	m_max.store(0U, std::memory_order_relaxed);
+	m_sum.store(0ULL, std::memory_order_relaxed);
+}
@@ -0,0 +1,51 @@
+/*
+ *   Copyright (C) 2019 by Manuel Sanchez EA7EE
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#if !defined(LATENCYHISTOGRAM_H)
+#define	LATENCYHISTOGRAM_H
+
+#include <string>
+#include <atomic>
+
+// HDR style log-linear histogram of microsecond values. Every power of two
+// is split into 32 sub-buckets, so any recorded value is known to within
+// about 3%. add() is lock-free and may be called from any thread.
+class CLatencyHistogram {
+public:
+	CLatencyHistogram(const std::string& name);
+	~CLatencyHistogram();
+
+	void add(unsigned int us);
+
+	unsigned int getCount() const;
+
+	unsigned int getPercentile(float percentile) const;
+
+	void dump() const;
+
+	void reset();
+
+private:
+	std::string                     m_name;
+	std::atomic<unsigned int>*      m_counts;
+	std::atomic<unsigned int>       m_count;
+	std::atomic<unsigned int>       m_max;
+	std::atomic<unsigned long long> m_sum;
+};
+
+#endif
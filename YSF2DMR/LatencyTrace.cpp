@@ -0,0 +1,66 @@
+/*
+ *   Copyright (C) 2019 by Manuel Sanchez EA7EE
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "LatencyTrace.h"
+#include "Clock.h"
+
+CLatencyTrace::CLatencyTrace(const std::string& name) :
+m_put(name + " ingress->put"),
+m_get(name + " ingress->get"),
+m_egress(name + " ingress->egress")
+{
+}
+
+CLatencyTrace::~CLatencyTrace()
+{
+}
+
+unsigned long long CLatencyTrace::getTime()
+{
+	return CClock::getTime();
+}
+
+void CLatencyTrace::add(LATENCY_POINT point, unsigned long long ingress)
+{
+	if (ingress == 0ULL)
+		return;
+
+	unsigned long long now = getTime();
+	unsigned long long us = now > ingress ? now - ingress : 0ULL;
+	if (us > 0xFFFFFFFFULL)
+		us = 0xFFFFFFFFULL;
+
+	switch (point) {
+		case LP_CONV_PUT:
+			m_put.add((unsigned int)us);
+			break;
+		case LP_CONV_GET:
+			m_get.add((unsigned int)us);
+			break;
+		default:
+			m_egress.add((unsigned int)us);
+			break;
+	}
+}
+
+void CLatencyTrace::dump() const
+{
+	m_put.dump();
+	m_get.dump();
+	m_egress.dump();
+}
@@ -0,0 +1,51 @@
+/*
+ *   Copyright (C) 2019 by Manuel Sanchez EA7EE
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#if !defined(LATENCYTRACE_H)
+#define	LATENCYTRACE_H
+
+#include "LatencyHistogram.h"
+
+#include <string>
+
+enum LATENCY_POINT {
+	LP_CONV_PUT,
+	LP_CONV_GET,
+	LP_EGRESS
+};
+
+// Per direction latency, every point is measured from the time the frame
+// was read from the ingress socket. A zero ingress time is not traced.
+class CLatencyTrace {
+public:
+	CLatencyTrace(const std::string& name);
+	~CLatencyTrace();
+
+	static unsigned long long getTime();
+
+	void add(LATENCY_POINT point, unsigned long long ingress);
+
+	void dump() const;
+
+private:
+	CLatencyHistogram m_put;
+	CLatencyHistogram m_get;
+	CLatencyHistogram m_egress;
+};
+
+#endif
@@ -0,0 +1,57 @@
+#!/bin/sh
+#
+# Load test of YSF2DMR between the DMRMaster and YSFReflector stand-ins.
+# The master keeps sending DMR voice to the bridge while every YSF caller
+# sends WiresX DX requests, so the replies are built while the voice is
+# being converted. The worst-case frame delay is taken from the bridge
+# latency histograms and from the largest gap between the frames each
+# stand-in receives.
+#
+# Usage: LoadTest.sh [run secs] [callers]
+
+RUNTIME=${1:-60}
+CALLERS=${2:-2}
+
+DIR=$(cd "$(dirname "$0")" && pwd)
+WORK=$(mktemp -d /tmp/ysf2dmr-load.XXXXXX)
+
+YSF_PORT=42099
+DMR_PORT=62099
+
+sed -e "s/^Address=.*/Address=127.0.0.1/" \
+    -e "s/^Port=62031/Port=$DMR_PORT/" \
+    -e "s/^DstPort=42000/DstPort=$YSF_PORT/" \
+    -e "s/^Daemon=1/Daemon=0/" \
+    -e "s/^EnableWiresX=.*/EnableWiresX=1/" \
+    -e "s#^FilePath=.*#FilePath=$WORK#" \
+    -e "s/^FileLevel=.*/FileLevel=1/" \
+    -e "s#^TGListFile=.*#TGListFile=$DIR/TGList-DMR.txt#" \
+    -e "s#^File=/usr/local/etc/DMRIds.dat#File=$DIR/DMRIds.dat#" \
+    -e "/^\[aprs.fi\]/,/^$/s/^Enable=1/Enable=0/" \
+    "$DIR/YSF2DMR.ini" > "$WORK/YSF2DMR.ini"
+
+cd "$WORK" || exit 1
+
+"$DIR/YSFReflector" -p $YSF_PORT -c $CALLERS -i 2 -l 1 -x 100 -s 0 -t $((RUNTIME + 5)) > reflector.out 2>&1 &
+REFLECTOR=$!
+"$DIR/DMRMaster" -p $DMR_PORT -d 9990 -c 4 -l 3 -i 0 -t $((RUNTIME + 5)) > master.out 2>&1 &
+MASTER=$!
+
+sleep 1
+"$DIR/YSF2DMR" "$WORK/YSF2DMR.ini" > bridge.out 2>&1 &
+BRIDGE=$!
+
+sleep $RUNTIME
+
+# Dump the latency histograms before stopping the bridge
+kill -USR1 $BRIDGE
+sleep 1
+kill -TERM $BRIDGE
+wait $BRIDGE $REFLECTOR $MASTER
+
+echo "WiresX DX requests answered: $(grep -h -c 'Received DX from' YSF2DMR-*.log)"
+grep -h "Latency .*ingress->egress" YSF2DMR-*.log | sed -e 's/^.*Latency/Latency/'
+grep -h "Gateway .*gap" reflector.out | sed -e 's/^.*Gateway/YSF side:/'
+grep -h "Peer .*gap" master.out | sed -e 's/^.*Peer/DMR side: peer/'
+
+echo "Logs are in $WORK"
@@ -0,0 +1,273 @@
+/*
+ *   Copyright (C) 2019 by Manuel Sanchez EA7EE
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "MetricsServer.h"
+#include "Log.h"
+
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+
+// Drop a client that has not sent a full request within this time
+const unsigned int CLIENT_TIMEOUT = 2U;
+
+CMetricsServer::CMetricsServer(const std::string& address, unsigned int port, const std::string& path) :
+m_address(address),
+m_port(port),
+m_path(path),
+m_fd(-1),
+m_client(-1),
+m_request(),
+m_length(0U),
+m_timer(1000U, CLIENT_TIMEOUT)
+{
+	assert(!path.empty() || port > 0U);
+
+#if defined(_WIN32) || defined(_WIN64)
+	WSAData data;
+	int wsaRet = ::WSAStartup(MAKEWORD(2, 2), &data);
+	if (wsaRet != 0)
+		LogError("Error from WSAStartup");
+#endif
+}
+
+CMetricsServer::~CMetricsServer()
+{
+#if defined(_WIN32) || defined(_WIN64)
+	::WSACleanup();
+#endif
+}
+
+bool CMetricsServer::open()
+{
+	if (!m_path.empty()) {
+#if defined(_WIN32) || defined(_WIN64)
+		LogError("Unix domain sockets are not supported, use a TCP port for the metrics");
+		return false;
+#else
+		sockaddr_un addr;
+		::memset(&addr, 0x00, sizeof(sockaddr_un));
+		addr.sun_family = AF_UNIX;
+
+		if (m_path.length() >= sizeof(addr.sun_path)) {
+			LogError("The metrics socket path is too long - %s", m_path.c_str());
+			return false;
+		}
+
+		::strcpy(addr.sun_path, m_path.c_str());
+
+		m_fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+		if (m_fd < 0) {
+			LogError("Cannot create the metrics socket, err: %d", errno);
+			return false;
+		}
+
+		// Remove a stale socket left by a previous run
+		::unlink(m_path.c_str());
+
+		if (::bind(m_fd, (sockaddr*)&addr, sizeof(sockaddr_un)) == -1) {
+			LogError("Cannot bind the metrics socket %s, err: %d", m_path.c_str(), errno);
+			::close(m_fd);
+			m_fd = -1;
+			return false;
+		}
+#endif
+	} else {
+		sockaddr_in addr;
+		::memset(&addr, 0x00, sizeof(sockaddr_in));
+		addr.sin_family      = AF_INET;
+		addr.sin_port        = htons(m_port);
+		addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+		if (!m_address.empty()) {
+			addr.sin_addr.s_addr = ::inet_addr(m_address.c_str());
+			if (addr.sin_addr.s_addr == INADDR_NONE) {
+				LogError("The metrics address is invalid - %s", m_address.c_str());
+				return false;
+			}
+		}
+
+		m_fd = ::socket(PF_INET, SOCK_STREAM, 0);
+		if (m_fd < 0) {
+#if defined(_WIN32) || defined(_WIN64)
+			LogError("Cannot create the metrics socket, err: %lu", ::GetLastError());
+#else
+			LogError("Cannot create the metrics socket, err: %d", errno);
+#endif
+			return false;
+		}
+
+		int reuse = 1;
+		if (::setsockopt(m_fd, SOL_SOCKET, SO_REUSEADDR, (char *)&reuse, sizeof(reuse)) == -1) {
+#if defined(_WIN32) || defined(_WIN64)
+			LogError("Cannot set the metrics socket option, err: %lu", ::GetLastError());
+#else
+			LogError("Cannot set the metrics socket option, err: %d", errno);
+#endif
+			close();
+			return false;
+		}
+
+		if (::bind(m_fd, (sockaddr*)&addr, sizeof(sockaddr_in)) == -1) {
+#if defined(_WIN32) || defined(_WIN64)
+			LogError("Cannot bind the metrics address, err: %lu", ::GetLastError());
+#else
+			LogError("Cannot bind the metrics address, err: %d", errno);
+#endif
+			close();
+			return false;
+		}
+	}
+
+	if (::listen(m_fd, 5) == -1) {
+#if defined(_WIN32) || defined(_WIN64)
+		LogError("Cannot listen on the metrics socket, err: %lu", ::GetLastError());
+#else
+		LogError("Cannot listen on the metrics socket, err: %d", errno);
+#endif
+		close();
+		return false;
+	}
+
+	if (m_path.empty())
+		LogMessage("Metrics available on http://%s:%u/metrics", m_address.empty() ? "127.0.0.1" : m_address.c_str(), m_port);
+	else
+		LogMessage("Metrics available on %s", m_path.c_str());
+
+	return true;
+}
+
+bool CMetricsServer::clock(unsigned int ms)
+{
+	if (m_fd < 0)
+		return false;
+
+	if (m_client < 0) {
+		if (!isReadable(m_fd))
+			return false;
+
+		m_client = ::accept(m_fd, NULL, NULL);
+		if (m_client < 0)
+			return false;
+
+		m_length = 0U;
+		m_timer.start();
+		return false;
+	}
+
+	m_timer.clock(ms);
+	if (m_timer.hasExpired()) {
+		closeClient();
+		return false;
+	}
+
+	if (!isReadable(m_client))
+		return false;
+
+	int len = ::recv(m_client, m_request + m_length, sizeof(m_request) - m_length - 1U, 0);
+	if (len <= 0) {
+		closeClient();
+		return false;
+	}
+
+	m_length += len;
+	m_request[m_length] = 0x00;
+
+	// Only the request line matters, wait for the end of the headers
+	return ::strstr(m_request, "\r\n\r\n") != NULL || m_length == (sizeof(m_request) - 1U);
+}
+
+void CMetricsServer::reply(const std::string& text)
+{
+	if (m_client < 0)
+		return;
+
+	std::string response;
+	if (::strncmp(m_request, "GET ", 4U) == 0) {
+		char header[200U];
+		::sprintf(header, "HTTP/1.0 200 OK\r\nContent-Type: text/plain; version=0.0.4\r\nContent-Length: %u\r\nConnection: close\r\n\r\n", (unsigned int)text.length());
+		response = std::string(header) + text;
+	} else {
+		response = "HTTP/1.0 405 Method Not Allowed\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+	}
+
+	const char* p = response.c_str();
+	unsigned int left = response.length();
+	while (left > 0U) {
+		int len = ::send(m_client, p, left, 0);
+		if (len <= 0)
+			break;
+
+		p    += len;
+		left -= len;
+	}
+
+	closeClient();
+}
+
+void CMetricsServer::close()
+{
+	closeClient();
+
+	if (m_fd < 0)
+		return;
+
+#if defined(_WIN32) || defined(_WIN64)
+	::closesocket(m_fd);
+#else
+	::close(m_fd);
+
+	if (!m_path.empty())
+		::unlink(m_path.c_str());
+#endif
+
+	m_fd = -1;
+}
+
+bool CMetricsServer::isReadable(int fd) const
+{
+	fd_set readFds;
+	FD_ZERO(&readFds);
+#if defined(_WIN32) || defined(_WIN64)
+	FD_SET((unsigned int)fd, &readFds);
+#else
+	FD_SET(fd, &readFds);
+#endif
+
+	// Return immediately
+	timeval tv;
+	tv.tv_sec  = 0L;
+	tv.tv_usec = 0L;
+
+	return ::select(fd + 1, &readFds, NULL, NULL, &tv) > 0;
+}
+
+void CMetricsServer::closeClient()
+{
+	if (m_client < 0)
+		return;
+
+#if defined(_WIN32) || defined(_WIN64)
+	::closesocket(m_client);
+#else
+	::close(m_client);
+#endif
+
+	m_client = -1;
+	m_timer.stop();
+}
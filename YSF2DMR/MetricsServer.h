@@ -0,0 +1,70 @@
+/*
+ *   Copyright (C) 2019 by Manuel Sanchez EA7EE
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#ifndef MetricsServer_H
+#define MetricsServer_H
+
+#include "Timer.h"
+
+#include <string>
+
+#if !defined(_WIN32) && !defined(_WIN64)
+#include <sys/time.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <errno.h>
+#else
+#include <winsock.h>
+#endif
+
+// Minimal HTTP endpoint for Prometheus style scrapes. It is polled from
+// the main loop and never blocks: clock() returns true once a complete
+// request has arrived, the caller then builds the text and calls reply().
+// A non empty path selects a Unix domain socket instead of TCP.
+class CMetricsServer {
+public:
+	CMetricsServer(const std::string& address, unsigned int port, const std::string& path);
+	~CMetricsServer();
+
+	bool open();
+
+	bool clock(unsigned int ms);
+
+	void reply(const std::string& text);
+
+	void close();
+
+private:
+	std::string  m_address;
+	unsigned int m_port;
+	std::string  m_path;
+	int          m_fd;
+	int          m_client;
+	char         m_request[1024U];
+	unsigned int m_length;
+	CTimer       m_timer;
+
+	bool isReadable(int fd) const;
+	void closeClient();
+};
+
+#endif
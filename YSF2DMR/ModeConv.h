@@ -22,6 +22,9 @@
 #include "YSFDefines.h"
 #include "RingBuffer.h"
 
+#include <cstdint>
+#include <cstdio>
+
 #if !defined(MODECONV_H)
 #define MODECONV_H
 
@@ -32,12 +35,12 @@ public:
 
 	void LoadTable(unsigned int levelA, unsigned int levelB);
 
-	void putDMR(unsigned char* bytes);
+	void putDMR(const unsigned char* bytes);
 	void putDMRHeader();
 	void putDMREOT();
 
-	void putYSF_Mode1(unsigned char* bytes, FILE *file);
-	void putYSF(unsigned char* bytes);
+	void putYSF_Mode1(const unsigned char* bytes, FILE *file);
+	void putYSF(const unsigned char* bytes);
 	void putDummyYSF();
 	void putYSFHeader();
 	void putYSFEOT();
@@ -45,17 +48,32 @@ public:
 	unsigned int getYSF(unsigned char* bytes);
 	unsigned int getDMR(unsigned char* bytes);
 
-	void AMB2YSF(unsigned char * bytes);
+	void AMB2YSF(const unsigned char* bytes);
+
+	void setTime(unsigned long long time);
+	unsigned long long getYSFTime() const;
+	unsigned long long getDMRTime() const;
+
+	const CRingBuffer<uint64_t>& getYSFBuffer() const;
+	const CRingBuffer<uint64_t>& getDMRBuffer() const;
 
 private:
-	void putAMBE2YSF(unsigned int a, unsigned int b, unsigned int dat_c);
-	void putAMBE2DMR(unsigned int dat_a, unsigned int dat_b, unsigned int dat_c);
+	uint64_t adjustGain(uint64_t frame) const;
+	void putAMBE2YSF(uint64_t frame);
+	void putAMBE2DMR(uint64_t frame);
 	unsigned int m_ysfN;
 	unsigned int m_dmrN;
-	CRingBuffer<unsigned char> m_YSF;
-	CRingBuffer<unsigned char> m_DMR;
+	CRingBuffer<uint64_t> m_YSF;
+	CRingBuffer<uint64_t> m_DMR;
+	CRingBuffer<unsigned long long> m_YSFTime;
+	CRingBuffer<unsigned long long> m_DMRTime;
+	unsigned long long m_time;
+	unsigned long long m_ysfTime;
+	unsigned long long m_dmrTime;
 	unsigned char m_ctable[32];
 
+	unsigned long long getTime(CRingBuffer<unsigned long long>& buffer);
+
 };
 
 #endif
@@ -0,0 +1,154 @@
+/*
+ *   Copyright (C) 2019 by Manuel Sanchez EA7EE
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "NetworkReaderThread.h"
+#include "LatencyTrace.h"
+#include "StopWatch.h"
+#include "Log.h"
+
+#include <cassert>
+#include <cstring>
+
+const unsigned int YSF_QUEUE_LENGTH = 100U;
+const unsigned int DMR_QUEUE_LENGTH = 200U;
+
+CNetworkReaderThread::CNetworkReaderThread(CYSFNetwork* ysfNetwork, CDMRNetwork* dmrNetwork) :
+CThread(),
+m_ysfNetwork(ysfNetwork),
+m_dmrNetwork(dmrNetwork),
+m_ysfQueue(YSF_QUEUE_LENGTH, "YSF Rx Queue"),
+m_dmrQueue(DMR_QUEUE_LENGTH, "DMR Rx Queue"),
+m_ysfFrames(0U),
+m_dmrFrames(0U),
+m_cpuTime(0ULL),
+m_ysfFrame(),
+m_dmrFrame(),
+m_exit(false)
+{
+	assert(ysfNetwork != NULL);
+	assert(dmrNetwork != NULL);
+}
+
+CNetworkReaderThread::~CNetworkReaderThread()
+{
+}
+
+bool CNetworkReaderThread::start()
+{
+	return run();
+}
+
+void CNetworkReaderThread::entry()
+{
+	LogMessage("Starting the Network Reader thread");
+
+	CStopWatch stopWatch;
+	stopWatch.start();
+
+	while (!m_exit) {
+		unsigned int ms = stopWatch.elapsed();
+		stopWatch.start();
+
+		clock(ms);
+
+		m_cpuTime.store(CThread::getCPUTime(), std::memory_order_relaxed);
+
+		sleep(1U);
+	}
+
+	LogMessage("Stopping the Network Reader thread");
+}
+
+void CNetworkReaderThread::clock(unsigned int ms)
+{
+	m_ysfNetwork->clock(ms);
+
+	while ((m_ysfFrame.m_length = m_ysfNetwork->read(m_ysfFrame.m_data)) > 0U) {
+		m_ysfFrame.m_time = CLatencyTrace::getTime();
+		m_ysfFrames.fetch_add(1U, std::memory_order_relaxed);
+		if (!m_ysfQueue.addData(m_ysfFrame))
+			LogWarning("%s overflow, frame dropped", m_ysfQueue.getName());
+	}
+
+	m_dmrNetwork->clock(ms);
+
+	while (m_dmrNetwork->read(m_dmrFrame.m_data)) {
+		m_dmrFrame.m_time = CLatencyTrace::getTime();
+		m_dmrFrames.fetch_add(1U, std::memory_order_relaxed);
+		if (!m_dmrQueue.addData(m_dmrFrame))
+			LogWarning("%s overflow, frame dropped", m_dmrQueue.getName());
+	}
+}
+
+void CNetworkReaderThread::stop()
+{
+	m_exit = true;
+
+	wait();
+}
+
+unsigned int CNetworkReaderThread::readYSF(unsigned char* data, unsigned long long& time)
+{
+	assert(data != NULL);
+
+	CYSFRxFrame frame;
+	if (!m_ysfQueue.getData(frame))
+		return 0U;
+
+	::memcpy(data, frame.m_data, frame.m_length);
+	time = frame.m_time;
+
+	return frame.m_length;
+}
+
+bool CNetworkReaderThread::readDMR(CDMRData& data, unsigned long long& time)
+{
+	CDMRRxFrame frame;
+	if (!m_dmrQueue.getData(frame))
+		return false;
+
+	data = frame.m_data;
+	time = frame.m_time;
+
+	return true;
+}
+
+unsigned int CNetworkReaderThread::getYSFFrames() const
+{
+	return m_ysfFrames.load(std::memory_order_relaxed);
+}
+
+unsigned int CNetworkReaderThread::getDMRFrames() const
+{
+	return m_dmrFrames.load(std::memory_order_relaxed);
+}
+
+unsigned int CNetworkReaderThread::getYSFOverflows() const
+{
+	return m_ysfQueue.getOverflows();
+}
+
+unsigned int CNetworkReaderThread::getDMROverflows() const
+{
+	return m_dmrQueue.getOverflows();
+}
+
+unsigned long long CNetworkReaderThread::getCPUTime() const
+{
+	return m_cpuTime.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,86 @@
+/*
+ *   Copyright (C) 2019 by Manuel Sanchez EA7EE
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#ifndef	NetworkReaderThread_H
+#define	NetworkReaderThread_H
+
+#include "YSFNetwork.h"
+#include "DMRNetwork.h"
+#include "FrameQueue.h"
+#include "DMRData.h"
+#include "Thread.h"
+
+#include <atomic>
+
+class CYSFRxFrame {
+public:
+	unsigned char      m_data[200U];
+	unsigned int       m_length;
+	unsigned long long m_time;
+};
+
+class CDMRRxFrame {
+public:
+	CDMRData           m_data;
+	unsigned long long m_time;
+};
+
+// Network ingress stage: clocks both networks and hands every received
+// frame to the conversion stage through lock-free queues. Frames are
+// stamped with their ingress time for latency tracing.
+class CNetworkReaderThread : public CThread {
+public:
+	CNetworkReaderThread(CYSFNetwork* ysfNetwork, CDMRNetwork* dmrNetwork);
+	virtual ~CNetworkReaderThread();
+
+	virtual bool start();
+
+	virtual void entry();
+
+	virtual void stop();
+
+	// One pass of the stage. A replay calls it from the main loop instead
+	// of starting the thread, so the stages run in a fixed order.
+	void clock(unsigned int ms);
+
+	unsigned int readYSF(unsigned char* data, unsigned long long& time);
+
+	bool readDMR(CDMRData& data, unsigned long long& time);
+
+	unsigned int getYSFFrames() const;
+	unsigned int getDMRFrames() const;
+
+	unsigned int getYSFOverflows() const;
+	unsigned int getDMROverflows() const;
+
+	unsigned long long getCPUTime() const;
+
+private:
+	CYSFNetwork*                    m_ysfNetwork;
+	CDMRNetwork*                    m_dmrNetwork;
+	CFrameQueue<CYSFRxFrame>        m_ysfQueue;
+	CFrameQueue<CDMRRxFrame>        m_dmrQueue;
+	std::atomic<unsigned int>       m_ysfFrames;
+	std::atomic<unsigned int>       m_dmrFrames;
+	std::atomic<unsigned long long> m_cpuTime;
+	CYSFRxFrame                     m_ysfFrame;
+	CDMRRxFrame                     m_dmrFrame;
+	std::atomic<bool>               m_exit;
+};
+
+#endif
@@ -0,0 +1,242 @@
+/*
+ *   Copyright (C) 2019 by Manuel Sanchez EA7EE
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "NetworkWriterThread.h"
+#include "Clock.h"
+#include "Log.h"
+
+#include <cassert>
+#include <cstring>
+
+const unsigned int YSF_QUEUE_LENGTH = 100U;
+const unsigned int DMR_QUEUE_LENGTH = 200U;
+
+// A stream starts this long after its first frame is queued, so the later
+// frames may arrive this late without leaving a gap. Converting between
+// 3 and 5 AMBE frames a network frame makes them up to 40 ms late. The
+// first YSF voice frame also needs two DMR bursts after the header, and
+// comes up to 150 ms behind it, 50 ms later than its slot.
+const unsigned long long YSF_START_DELAY = 80000ULL;
+const unsigned long long DMR_START_DELAY = 40000ULL;
+
+// With more frames than this waiting the grid runs a tenth faster, so a
+// backlog from a stall drains instead of adding delay to the whole stream
+const unsigned int BACKLOG_FRAMES = 3U;
+
+// Whether the next frame is due on the grid. The first frame after a
+// pause, more than one period behind the grid, starts a new grid.
+static bool isDue(unsigned long long& next, unsigned long long now, unsigned int period, unsigned long long delay)
+{
+	if (now > next + period * 1000ULL)
+		next = now + delay;
+
+	return now >= next;
+}
+
+// Move the grid on by one frame once one is sent
+static void advance(unsigned long long& next, unsigned int period, unsigned int waiting)
+{
+	next += (waiting > BACKLOG_FRAMES ? period * 900ULL : period * 1000ULL);
+}
+
+CNetworkWriterThread::CNetworkWriterThread(CYSFNetwork* ysfNetwork, CDMRNetwork* dmrNetwork, unsigned int ysfPeriod, unsigned int dmrPeriod, CLatencyTrace* ysfTrace, CLatencyTrace* dmrTrace) :
+CThread(),
+m_ysfNetwork(ysfNetwork),
+m_dmrNetwork(dmrNetwork),
+m_ysfPeriod(ysfPeriod),
+m_dmrPeriod(dmrPeriod),
+m_ysfTrace(ysfTrace),
+m_dmrTrace(dmrTrace),
+m_ysfQueue(YSF_QUEUE_LENGTH, "YSF Tx Queue"),
+m_dmrQueue(DMR_QUEUE_LENGTH, "DMR Tx Queue"),
+m_ysfFrames(0U),
+m_dmrFrames(0U),
+m_cpuTime(0ULL),
+m_ysfNext(0ULL),
+m_dmrNext(0ULL),
+m_ysfFrame(),
+m_dmrFrame(),
+m_ysfHeld(false),
+m_exit(false)
+{
+	assert(ysfNetwork != NULL);
+	assert(dmrNetwork != NULL);
+	assert(ysfTrace != NULL);
+	assert(dmrTrace != NULL);
+}
+
+CNetworkWriterThread::~CNetworkWriterThread()
+{
+}
+
+bool CNetworkWriterThread::start()
+{
+	return run();
+}
+
+void CNetworkWriterThread::entry()
+{
+	LogMessage("Starting the Network Writer thread");
+
+	while (!m_exit) {
+		clock();
+
+		m_cpuTime.store(CThread::getCPUTime(), std::memory_order_relaxed);
+
+		sleep(1U);
+	}
+
+	LogMessage("Stopping the Network Writer thread");
+}
+
+void CNetworkWriterThread::clock()
+{
+	unsigned long long now = CClock::getTime();
+
+	if (m_dmrQueue.hasData() && isDue(m_dmrNext, now, m_dmrPeriod, DMR_START_DELAY)) {
+		bool sent = false;
+
+		while (m_dmrQueue.getData(m_dmrFrame)) {
+			if (m_dmrFrame.m_reset != 0U) {
+				m_dmrNetwork->reset(m_dmrFrame.m_reset);
+				continue;
+			}
+
+			m_dmrNetwork->write(m_dmrFrame.m_data);
+			m_dmrFrames.fetch_add(1U, std::memory_order_relaxed);
+			m_dmrTrace->add(LP_EGRESS, m_dmrFrame.m_time);
+			sent = true;
+			if (m_dmrFrame.m_last)
+				break;
+		}
+
+		if (sent)
+			advance(m_dmrNext, m_dmrPeriod, m_dmrQueue.dataSize());
+	}
+
+	// A paced frame that is not due yet is held, and blocks the queue
+	// behind it so nothing overtakes it
+	for (;;) {
+		if (!m_ysfHeld) {
+			if (!m_ysfQueue.getData(m_ysfFrame))
+				break;
+			m_ysfHeld = true;
+		}
+
+		if (m_ysfFrame.m_poll) {
+			m_ysfNetwork->writePoll();
+			m_ysfHeld = false;
+			continue;
+		}
+
+		if (m_ysfFrame.m_paced && !isDue(m_ysfNext, now, m_ysfPeriod, YSF_START_DELAY))
+			break;
+
+		m_ysfNetwork->write(m_ysfFrame.m_data);
+		m_ysfFrames.fetch_add(1U, std::memory_order_relaxed);
+		m_ysfTrace->add(LP_EGRESS, m_ysfFrame.m_time);
+		m_ysfHeld = false;
+
+		if (m_ysfFrame.m_paced) {
+			advance(m_ysfNext, m_ysfPeriod, m_ysfQueue.dataSize());
+			break;
+		}
+	}
+}
+
+void CNetworkWriterThread::stop()
+{
+	m_exit = true;
+
+	wait();
+}
+
+void CNetworkWriterThread::writeYSF(const unsigned char* data, unsigned long long time, bool paced)
+{
+	assert(data != NULL);
+
+	CYSFTxFrame frame;
+	::memcpy(frame.m_data, data, 155U);
+	frame.m_paced = paced;
+	frame.m_poll  = false;
+	frame.m_time = time;
+
+	if (!m_ysfQueue.addData(frame))
+		LogWarning("%s overflow, frame dropped", m_ysfQueue.getName());
+}
+
+void CNetworkWriterThread::writeYSFPoll()
+{
+	CYSFTxFrame frame;
+	frame.m_paced = false;
+	frame.m_poll  = true;
+	frame.m_time = 0ULL;
+
+	if (!m_ysfQueue.addData(frame))
+		LogWarning("%s overflow, poll dropped", m_ysfQueue.getName());
+}
+
+void CNetworkWriterThread::writeDMR(const CDMRData& data, unsigned long long time, bool last)
+{
+	CDMRTxFrame frame;
+	frame.m_data  = data;
+	frame.m_last  = last;
+	frame.m_reset = 0U;
+	frame.m_time  = time;
+
+	if (!m_dmrQueue.addData(frame))
+		LogWarning("%s overflow, frame dropped", m_dmrQueue.getName());
+}
+
+void CNetworkWriterThread::resetDMR(unsigned int slotNo)
+{
+	assert(slotNo == 1U || slotNo == 2U);
+
+	CDMRTxFrame frame;
+	frame.m_last  = false;
+	frame.m_reset = slotNo;
+	frame.m_time  = 0ULL;
+
+	if (!m_dmrQueue.addData(frame))
+		LogWarning("%s overflow, reset dropped", m_dmrQueue.getName());
+}
+
+unsigned int CNetworkWriterThread::getYSFFrames() const
+{
+	return m_ysfFrames.load(std::memory_order_relaxed);
+}
+
+unsigned int CNetworkWriterThread::getDMRFrames() const
+{
+	return m_dmrFrames.load(std::memory_order_relaxed);
+}
+
+unsigned int CNetworkWriterThread::getYSFOverflows() const
+{
+	return m_ysfQueue.getOverflows();
+}
+
+unsigned int CNetworkWriterThread::getDMROverflows() const
+{
+	return m_dmrQueue.getOverflows();
+}
+
+unsigned long long CNetworkWriterThread::getCPUTime() const
+{
+	return m_cpuTime.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,111 @@
+/*
+ *   Copyright (C) 2019 by Manuel Sanchez EA7EE
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#ifndef	NetworkWriterThread_H
+#define	NetworkWriterThread_H
+
+#include "YSFNetwork.h"
+#include "DMRNetwork.h"
+#include "LatencyTrace.h"
+#include "FrameQueue.h"
+#include "DMRData.h"
+#include "Thread.h"
+
+#include <atomic>
+
+// A frame with m_poll set is not sent, the writer sends a poll instead
+// when it reaches it. Neither a poll nor a frame without m_paced, such
+// as a WiresX reply, waits for or uses a YSF pacing slot.
+class CYSFTxFrame {
+public:
+	unsigned char      m_data[155U];
+	bool               m_paced;
+	bool               m_poll;
+	unsigned long long m_time;
+};
+
+// m_last marks the final frame of a burst, the writer waits one frame
+// period after it before sending the next burst. A non zero m_reset is
+// not sent, the writer resets that slot of the network when it reaches
+// it, so the new stream id is only used after the frames queued before.
+class CDMRTxFrame {
+public:
+	CDMRData           m_data;
+	bool               m_last;
+	unsigned int       m_reset;
+	unsigned long long m_time;
+};
+
+// Paced egress stage: the conversion stage queues fully built frames and
+// this thread sends them at the YSF and DMR frame rates. The periods are
+// the real frame periods of each mode, frames go out on a grid of fixed
+// deadlines rather than a period after the previous send.
+class CNetworkWriterThread : public CThread {
+public:
+	CNetworkWriterThread(CYSFNetwork* ysfNetwork, CDMRNetwork* dmrNetwork, unsigned int ysfPeriod, unsigned int dmrPeriod, CLatencyTrace* ysfTrace, CLatencyTrace* dmrTrace);
+	virtual ~CNetworkWriterThread();
+
+	virtual bool start();
+
+	virtual void entry();
+
+	virtual void stop();
+
+	// One pass of the stage. A replay calls it from the main loop instead
+	// of starting the thread, so the stages run in a fixed order.
+	void clock();
+
+	void writeYSF(const unsigned char* data, unsigned long long time, bool paced = true);
+
+	// Poll the reflector after the frames already queued
+	void writeYSFPoll();
+
+	void writeDMR(const CDMRData& data, unsigned long long time, bool last = true);
+
+	// Start a new DMR stream on the slot once the queued frames are sent
+	void resetDMR(unsigned int slotNo);
+
+	unsigned int getYSFFrames() const;
+	unsigned int getDMRFrames() const;
+
+	unsigned int getYSFOverflows() const;
+	unsigned int getDMROverflows() const;
+
+	unsigned long long getCPUTime() const;
+
+private:
+	CYSFNetwork*                    m_ysfNetwork;
+	CDMRNetwork*                    m_dmrNetwork;
+	unsigned int                    m_ysfPeriod;
+	unsigned int                    m_dmrPeriod;
+	CLatencyTrace*                  m_ysfTrace;
+	CLatencyTrace*                  m_dmrTrace;
+	CFrameQueue<CYSFTxFrame>        m_ysfQueue;
+	CFrameQueue<CDMRTxFrame>        m_dmrQueue;
+	std::atomic<unsigned int>       m_ysfFrames;
+	std::atomic<unsigned int>       m_dmrFrames;
+	std::atomic<unsigned long long> m_cpuTime;
+	unsigned long long              m_ysfNext;
+	unsigned long long              m_dmrNext;
+	CYSFTxFrame                     m_ysfFrame;
+	CDMRTxFrame                     m_dmrFrame;
+	bool                            m_ysfHeld;
+	std::atomic<bool>               m_exit;
+};
+
+#endif
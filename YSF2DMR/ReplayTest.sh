@@ -0,0 +1,67 @@
+#!/bin/sh
+#
+# Capture and replay check of YSF2DMR. The bridge is run live between the
+# DMRMaster and YSFReflector stand-ins with its traffic captured, then the
+# capture is replayed twice on virtual time. Both replays must send the
+# same datagrams at the same virtual times, which is the reference to
+# compare a changed build against with CaptureDiff.
+#
+# Usage: ReplayTest.sh [run secs] [callers]
+
+RUNTIME=${1:-20}
+CALLERS=${2:-2}
+
+DIR=$(cd "$(dirname "$0")" && pwd)
+WORK=$(mktemp -d /tmp/ysf2dmr-replay.XXXXXX)
+
+YSF_PORT=42099
+DMR_PORT=62099
+
+config() {
+	sed -e "s/^Address=.*/Address=127.0.0.1/" \
+	    -e "s/^Port=62031/Port=$DMR_PORT/" \
+	    -e "s/^DstPort=42000/DstPort=$YSF_PORT/" \
+	    -e "s/^Daemon=1/Daemon=0/" \
+	    -e "s/^EnableWiresX=.*/EnableWiresX=1/" \
+	    -e "s#^FilePath=.*#FilePath=$WORK#" \
+	    -e "s/^FileRoot=.*/FileRoot=$1/" \
+	    -e "s/^FileLevel=.*/FileLevel=1/" \
+	    -e "s#^TGListFile=.*#TGListFile=$DIR/TGList-DMR.txt#" \
+	    -e "s#^File=/usr/local/etc/DMRIds.dat#File=$DIR/DMRIds.dat#" \
+	    -e "/^\[aprs.fi\]/,/^$/s/^Enable=1/Enable=0/" \
+	    -e "s/^Mode=0/Mode=$2/" \
+	    -e "s#^File=/tmp/ysf2dmr.cap#File=$WORK/live.cap#" \
+	    -e "s#^Output=.*#Output=$WORK/$1.cap#" \
+	    "$DIR/YSF2DMR.ini" > "$WORK/$1.ini"
+}
+
+cd "$WORK" || exit 1
+
+config live 1
+config replay1 2
+config replay2 2
+
+"$DIR/YSFReflector" -p $YSF_PORT -c $CALLERS -i 3 -l 2 -x 50 -s 0 -t $((RUNTIME + 5)) > reflector.out 2>&1 &
+REFLECTOR=$!
+"$DIR/DMRMaster" -p $DMR_PORT -d 9990 -c 5 -l 2 -i 0 -t $((RUNTIME + 5)) > master.out 2>&1 &
+MASTER=$!
+
+sleep 1
+"$DIR/YSF2DMR" "$WORK/live.ini" > live.out 2>&1 &
+BRIDGE=$!
+
+sleep $RUNTIME
+
+kill -TERM $BRIDGE
+wait $BRIDGE $REFLECTOR $MASTER
+
+"$DIR/YSF2DMR" "$WORK/replay1.ini" > replay1.out 2>&1
+"$DIR/YSF2DMR" "$WORK/replay2.ini" > replay2.out 2>&1
+
+grep -h "Replay finished" replay1-*.log | sed -e 's/^.*Replay/Replay/'
+"$DIR/CaptureDiff" -t replay1.cap replay2.cap
+RET=$?
+
+echo "Captures are in $WORK"
+
+exit $RET
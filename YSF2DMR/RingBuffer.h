@@ -32,7 +32,9 @@ public:
 	m_name(name),
 	m_buffer(NULL),
 	m_iPtr(0U),
-	m_oPtr(0U)
+	m_oPtr(0U),
+	m_overflows(0U),
+	m_underflows(0U)
 	{
 		assert(length > 0U);
 		assert(name != NULL);
@@ -51,6 +53,7 @@ public:
 	{
 		if (nSamples >= freeSpace()) {
 			LogError("%s buffer overflow, clearing the buffer. (%u >= %u)", m_name, nSamples, freeSpace());
+			m_overflows++;
 			clear();
 			return false;
 		}
@@ -69,6 +72,7 @@ public:
 	{
 		if (dataSize() < nSamples) {
 			LogError("**** Underflow in %s ring buffer, %u < %u", m_name, dataSize(), nSamples);
+			m_underflows++;
 			return false;
 		}
 
@@ -143,12 +147,29 @@ public:
 		return m_oPtr == m_iPtr;
 	}
 
+	unsigned int getOverflows() const
+	{
+		return m_overflows;
+	}
+
+	unsigned int getUnderflows() const
+	{
+		return m_underflows;
+	}
+
+	const char* getName() const
+	{
+		return m_name;
+	}
+
 private:
 	unsigned int m_length;
 	const char*  m_name;
 	T*           m_buffer;
 	unsigned int m_iPtr;
 	unsigned int m_oPtr;
+	unsigned int m_overflows;
+	unsigned int m_underflows;
 };
 
 #endif
@@ -17,17 +17,18 @@
  */
 
 #include "StopWatch.h"
+#include "Clock.h"
 
 #if defined(_WIN32) || defined(_WIN64)
 
 CStopWatch::CStopWatch() :
-m_frequencyS(),
 m_frequencyMS(),
-m_start()
+m_startMS(0ULL)
 {
-	::QueryPerformanceFrequency(&m_frequencyS);
+	LARGE_INTEGER frequencyS;
+	::QueryPerformanceFrequency(&frequencyS);
 
-	m_frequencyMS.QuadPart = m_frequencyS.QuadPart / 1000ULL;
+	m_frequencyMS.QuadPart = frequencyS.QuadPart / 1000ULL;
 }
 
 CStopWatch::~CStopWatch()
@@ -42,24 +43,6 @@ unsigned long long CStopWatch::time() const
 	return (unsigned long long)(now.QuadPart / m_frequencyMS.QuadPart);
 }
 
-unsigned long long CStopWatch::start()
-{
-	::QueryPerformanceCounter(&m_start);
-
-	return (unsigned long long)(m_start.QuadPart / m_frequencyS.QuadPart);
-}
-
-unsigned int CStopWatch::elapsed()
-{
-	LARGE_INTEGER now;
-	::QueryPerformanceCounter(&now);
-
-	LARGE_INTEGER temp;
-	temp.QuadPart = (now.QuadPart - m_start.QuadPart) * 1000;
-
-	return (unsigned int)(temp.QuadPart / m_frequencyS.QuadPart);
-}
-
 #else
 
 #include <cstdio>
@@ -82,24 +65,17 @@ unsigned long long CStopWatch::time() const
 	return now.tv_sec * 1000ULL + now.tv_usec / 1000ULL;
 }
 
+#endif
+
+// Intervals follow CClock, so they run on virtual time during a replay
 unsigned long long CStopWatch::start()
 {
-	struct timespec now;
-	::clock_gettime(CLOCK_MONOTONIC, &now);
-
-	m_startMS = now.tv_sec * 1000ULL + now.tv_nsec / 1000000ULL;
+	m_startMS = CClock::getTime() / 1000ULL;
 
 	return m_startMS;
 }
 
 unsigned int CStopWatch::elapsed()
 {
-	struct timespec now;
-	::clock_gettime(CLOCK_MONOTONIC, &now);
-
-	unsigned long long nowMS = now.tv_sec * 1000ULL + now.tv_nsec / 1000000ULL;
-
-	return nowMS - m_startMS;
+	return (unsigned int)(CClock::getTime() / 1000ULL - m_startMS);
 }
-
-#endif
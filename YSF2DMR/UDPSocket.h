@@ -19,6 +19,8 @@
 #ifndef UDPSocket_H
 #define UDPSocket_H
 
+#include "Capture.h"
+
 #include <string>
 
 #if !defined(_WIN32) && !defined(_WIN64)
@@ -47,12 +49,19 @@ public:
 
 	void close();
 
+	// Record all traffic to capture, or take the received datagrams from
+	// replay instead of the network and only record what is sent.
+	void setCapture(CCapture* capture, CReplay* replay, unsigned char channel);
+
 	static in_addr lookup(const std::string& hostName);
 
 private:
 	std::string    m_address;
 	unsigned short m_port;
 	int            m_fd;
+	CCapture*      m_capture;
+	CReplay*       m_replay;
+	unsigned char  m_channel;
 };
 
 #endif
@@ -85,7 +85,7 @@ const unsigned char PICT_PREAMB_RESP[]  = {0x5DU, 0x50U, 0x5FU, 0x26U};
 
 const unsigned char UP_ACK[] = {0x47U, 0x30U, 0x5FU, 0x26U};
 
-CWiresX::CWiresX(CWiresXStorage* storage, const std::string& callsign, const std::string& suffix, CYSFNetwork* network, std::string tgfile, bool makeUpper, unsigned int reloadTime) :
+CWiresX::CWiresX(CWiresXStorage* storage, const std::string& callsign, const std::string& suffix, CNetworkWriterThread* writer, std::string tgfile, bool makeUpper, unsigned int reloadTime) :
 CThread(),
 m_storage(storage),
 m_callsign(callsign),
@@ -97,7 +97,7 @@ m_name(),
 m_txFrequency(0U),
 m_rxFrequency(0U),
 m_dstID(0U),
-m_network(network),
+m_writer(writer),
 m_command(NULL),
 m_timer(1000U, 1U),
 m_ptimer(1000U, 1U),
@@ -117,7 +117,7 @@ m_bufferTX(10000U, "YSF Wires-X TX Buffer"),
 m_type(0U),
 m_number(0U)
 {
-	assert(network != NULL);
+	assert(writer != NULL);
 
 	m_node = callsign;
 	if (suffix.size() > 0U) {
@@ -759,7 +759,6 @@ void CWiresX::clock(unsigned int ms)
 	if (m_timer.isRunning() && m_timer.hasExpired()) {
 		switch (m_status) {
 		case WXSI_DX:
-			CThread::sleep(100U);
 			sendDXReply();
 			break;
 		case WXSI_LNEWS:
@@ -966,12 +965,8 @@ void CWiresX::createReply(const unsigned char* data, unsigned int length, const
 
 void CWiresX::writeData(const unsigned char* buffer)
 {
-	// Send host Wires-X reply using ring buffer
-	/* unsigned char len = 155U;
-	m_bufferTX.addData(&len, 1U);
-	m_bufferTX.addData(buffer, len); */
-
-	m_network->write(buffer);
+	// Queued behind the voice already waiting, but not paced like it
+	m_writer->writeYSF(buffer, 0ULL, false);
 }
 
 unsigned char CWiresX::calculateFT(unsigned int length, unsigned int offset) const
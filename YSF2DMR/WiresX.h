@@ -22,6 +22,7 @@
 #define	WIRESX_H
 
 #include "Storage.h"
+#include "NetworkWriterThread.h"
 #include "YSFNetwork.h"
 #include "DMRNetwork.h"
 #include "Thread.h"
@@ -91,7 +92,7 @@ public:
 
 class CWiresX: public CThread  {
 public:
-	CWiresX(CWiresXStorage* storage, const std::string& callsign, const std::string& suffix, CYSFNetwork* network, std::string tgfile, bool makeUpper, unsigned int reloadTime);
+	CWiresX(CWiresXStorage* storage, const std::string& callsign, const std::string& suffix, CNetworkWriterThread* writer, std::string tgfile, bool makeUpper, unsigned int reloadTime);
 	virtual ~CWiresX();
 
     	bool read();
@@ -131,7 +132,7 @@ private:
 	unsigned int         m_rxFrequency;
 	unsigned int         m_dstID;
 	unsigned int         m_fulldstID;
-	CYSFNetwork*         m_network;
+	CNetworkWriterThread* m_writer;
 	unsigned char*       m_command;
 	unsigned int         m_count;
 	CTimer               m_timer;
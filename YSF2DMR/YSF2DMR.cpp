@@ -34,13 +34,15 @@
 const unsigned char dt1_temp[] = {0x31, 0x22, 0x62, 0x5F, 0x29, 0x00, 0x00, 0x00, 0x00, 0x00};
 const unsigned char dt2_temp[] = {0x00, 0x00, 0x00, 0x00, 0x6C, 0x20, 0x1C, 0x20, 0x03, 0x08};
 
-#define DMR_FRAME_PER       55U
-#define YSF_FRAME_PER       90U
+#define DMR_FRAME_PER       60U
+#define YSF_FRAME_PER       100U
 #define BEACON_PER			55U
 
 #define XLX_SLOT            2U
 #define XLX_COLOR_CODE      3U
 
+#define DMR_LC_CACHE_SIZE   16U
+
 #define TIME_MIN			60000U
 #define TIME_SEC			1000U
 
@@ -64,6 +66,7 @@ const char* HEADER4 = "Copyright(C) 2018,2019 by CA6JAU, EA7EE, G4KLX and others
 #include <cctype>
 
 int end = 0;
+int latency = 0;
 
 #if !defined(_WIN32) && !defined(_WIN64)
 void sig_handler(int signo)
@@ -71,6 +74,8 @@ void sig_handler(int signo)
 	if (signo == SIGTERM) {
 		end = 1;
 		::fprintf(stdout, "Received SIGTERM\n");
+	} else if (signo == SIGUSR1) {
+		latency = 1;
 	}
 }
 #endif
@@ -97,6 +102,10 @@ int main(int argc, char** argv)
 	// Capture SIGTERM to finish gracelessly
 	if (signal(SIGTERM, sig_handler) == SIG_ERR)
 		::fprintf(stdout, "Can't catch SIGTERM\n");
+
+	// Capture SIGUSR1 to dump the latency histograms
+	if (signal(SIGUSR1, sig_handler) == SIG_ERR)
+		::fprintf(stdout, "Can't catch SIGUSR1\n");
 #endif
 
 	CYSF2DMR* gateway = new CYSF2DMR(std::string(iniFile));
@@ -116,6 +125,13 @@ m_conf(configFile),
 m_wiresX(NULL),
 m_dmrNetwork(NULL),
 m_ysfNetwork(NULL),
+m_reader(NULL),
+m_writer(NULL),
+m_ysfLatency("DMR->YSF"),
+m_dmrLatency("YSF->DMR"),
+m_metrics(NULL),
+m_capture(NULL),
+m_replay(NULL),
 m_lookup(NULL),
 m_conv(),
 m_colorcode(1U),
@@ -137,7 +153,9 @@ m_dtmf(NULL),
 m_APRS(NULL),
 m_dmrFrames(0U),
 m_ysfFrames(0U),
-m_EmbeddedLC(),
+m_lcCache(DMR_LC_CACHE_SIZE),
+m_dmrLC(),
+m_dchCache(),
 m_TGList(),
 m_dmrflco(FLCO_GROUP),
 m_dmrinfo(false),
@@ -295,6 +313,24 @@ int CYSF2DMR::run()
 	unsigned int lev_b = m_conf.getAMBECompB();
 	m_conv.LoadTable(lev_a,lev_b);
 
+	unsigned int captureMode = m_conf.getCaptureMode();
+	if (captureMode == 1U) {
+		m_capture = new CCapture(m_conf.getCaptureFile());
+		if (!m_capture->open()) {
+			::LogFinalise();
+			return 1;
+		}
+	} else if (captureMode == 2U) {
+		m_replay = new CReplay(m_conf.getCaptureFile());
+		m_capture = new CCapture(m_conf.getCaptureOutput());
+		if (!m_replay->open() || !m_capture->open()) {
+			::LogFinalise();
+			return 1;
+		}
+	}
+
+	m_ysfNetwork->setCapture(m_capture, m_replay);
+
 	ret = m_ysfNetwork->open();
 	if (!ret) {
 		::LogError("Cannot open the YSF network port");
@@ -322,12 +358,19 @@ int CYSF2DMR::run()
 	CTimer networkWatchdog(100U, 0U, 1500U);
 	CTimer pollTimer(1000U, 5U);
 	CTimer ysfWatchdog(1000U, 0U, 500U);
+	CTimer latencyTimer(1000U, m_conf.getLogLatencyTime() * 60U);
+	CTimer replayTimer(1000U, 2U);
+
+	// Everything sent to either network goes through the writer, so it
+	// must exist before WiresX
+	m_reader = new CNetworkReaderThread(m_ysfNetwork, m_dmrNetwork);
+	m_writer = new CNetworkWriterThread(m_ysfNetwork, m_dmrNetwork, YSF_FRAME_PER, DMR_FRAME_PER, &m_ysfLatency, &m_dmrLatency);
 
 	// CWiresX Control Object
 	if (m_enableWiresX) {
 		bool makeUpper = m_conf.getWiresXMakeUpper();
 		m_storage = new CWiresXStorage;
-		m_wiresX = new CWiresX(m_storage, m_callsign, m_suffix, m_ysfNetwork, m_TGList, makeUpper, tglist_reload);
+		m_wiresX = new CWiresX(m_storage, m_callsign, m_suffix, m_writer, m_TGList, makeUpper, tglist_reload);
 		m_dtmf = new CDTMF;
 
 		if (m_wiresX->getOpt(m_dstid)==2) m_dmrflco = FLCO_USER_USER;
@@ -348,17 +391,14 @@ int CYSF2DMR::run()
 
 	CStopWatch TGChange;
 	CStopWatch stopWatch;
-	CStopWatch ysfWatch;
-	CStopWatch dmrWatch;
 	CStopWatch bea_voice_Watch;
 	CStopWatch beacon_Watch;
 	CStopWatch timeout_Watch;
 	CStopWatch news_Watch;
 	stopWatch.start();
-	ysfWatch.start();
-	dmrWatch.start();
 	pollTimer.start();
 	ysfWatchdog.stop();
+	latencyTimer.start();
 	beacon_Watch.start();
 	timeout_Watch.start();
 	news_Watch.start();
@@ -366,6 +406,23 @@ int CYSF2DMR::run()
 	unsigned char ysf_cnt = 0;
 	unsigned char dmr_cnt = 0;
 
+	// A replay runs the network stages inline with the conversion, so
+	// the threads are only started for live traffic
+	if (m_replay != NULL) {
+		m_replay->start();
+	} else {
+		m_reader->start();
+		m_writer->start();
+	}
+
+	if (m_conf.getMetricsEnabled()) {
+		m_metrics = new CMetricsServer(m_conf.getMetricsAddress(), m_conf.getMetricsPort(), m_conf.getMetricsPath());
+		if (!m_metrics->open()) {
+			delete m_metrics;
+			m_metrics = NULL;
+		}
+	}
+
 	LogMessage("Starting YSF2DMR-%s", VERSION);
 
 	bool enableUnlink = m_conf.getDMRNetworkEnableUnlink();
@@ -391,10 +448,14 @@ int CYSF2DMR::run()
 
 	for (; end == 0;) {
 		unsigned char buffer[2000U];
+		unsigned long long rxTime;
 
 		CDMRData tx_dmrdata;
 		unsigned int ms = stopWatch.elapsed();
 
+		if (m_replay != NULL)
+			m_reader->clock(ms);
+
 		if (sending_picture && (m_wiresX->EndPicture() || (news_Watch.elapsed()> (10*TIME_MIN)))) {
 				not_busy=1;
 				m_dmrNetwork->enable(true);
@@ -427,7 +488,7 @@ int CYSF2DMR::run()
 			}
 
 			if (!m_xlxmodule.empty() && !m_xlxConnected) {
-				writeXLXLink(m_srcid, m_dstid, m_dmrNetwork);
+				writeXLXLink(m_srcid, m_dstid);
 				LogMessage("XLX, Linking to reflector XLX%03u, module %s", m_xlxrefl, m_xlxmodule.c_str());
 				m_xlxConnected = true;
 			}
@@ -504,7 +565,9 @@ int CYSF2DMR::run()
 			}
 		}
 
-		while (m_ysfNetwork->read(buffer) > 0U) {
+		while (m_reader->readYSF(buffer, rxTime) > 0U) {
+			m_conv.setTime(rxTime);
+
 			CYSFFICH fich;
 			bool valid = fich.decode(buffer + 35U);
 
@@ -711,7 +774,7 @@ int CYSF2DMR::run()
 							std::string ysfDst = ysfPayload.getDest();
 							LogMessage("Received YSF Header: Src: %s Dst: %s", ysfSrc.c_str(), ysfDst.c_str());
 
-							m_dmrNetwork->reset(2U);	// OE1KBC fix
+							m_writer->resetDMR(2U);	// OE1KBC fix
 
 							m_srcid = findYSFID(ysfSrc, true);
 							m_conv.putYSFHeader();
@@ -733,6 +796,7 @@ int CYSF2DMR::run()
 						not_busy=0;
 						ysfWatchdog.start();
 						m_conv.putYSF(buffer + 35U);
+						m_dmrLatency.add(LP_CONV_PUT, rxTime);
 						m_ysfFrames++;
 					}
 				}
@@ -755,6 +819,8 @@ int CYSF2DMR::run()
 			char file_name[]="/usr/local/etc/beacon.amb";
 			unsigned int n;
 
+			m_conv.setTime(0ULL);
+
 			switch (beacon_status) {
 				case BE_INIT:
 						m_netSrc = "BEACON";
@@ -770,7 +836,6 @@ int CYSF2DMR::run()
 							LogMessage("Beacon Init: %s.",file_name);
 							//fread(buffer,4U,1U,file_out);
 							m_conv.putDMRHeader();
-							ysfWatch.start();
 							beacon_status = BE_DATA;
 						}
 						bea_voice_Watch.start();
@@ -802,8 +867,10 @@ int CYSF2DMR::run()
 
 		}
 
-		if (dmrWatch.elapsed() > DMR_FRAME_PER) {
-			unsigned int dmrFrameType = m_conv.getDMR(m_dmrFrame);
+		unsigned int dmrFrameType;
+		while ((dmrFrameType = m_conv.getDMR(m_dmrFrame)) != TAG_NODATA) {
+			unsigned long long txTime = m_conv.getDMRTime();
+			m_dmrLatency.add(LP_CONV_GET, txTime);
 
 			if(dmrFrameType == TAG_HEADER) {
 			    not_busy=0;
@@ -820,31 +887,18 @@ int CYSF2DMR::run()
 				rx_dmrdata.setRSSI(0U);
 				rx_dmrdata.setDataType(DT_VOICE_LC_HEADER);
 
-				// Add sync
-				CSync::addDMRDataSync(m_dmrFrame, 0);
-
-				// Add SlotType
-				CDMRSlotType slotType;
-				slotType.setColorCode(m_colorcode);
-				slotType.setDataType(DT_VOICE_LC_HEADER);
-				slotType.getData(m_dmrFrame);
-
-				// Full LC
-				CDMRLC dmrLC = CDMRLC(m_dmrflco, m_srcid, m_dstid);
-				CDMRFullLC fullLC;
-				fullLC.encode(dmrLC, m_dmrFrame, DT_VOICE_LC_HEADER);
-				m_EmbeddedLC.setLC(dmrLC);
+				// Sync, SlotType and Full LC, encoded once per LC
+				m_dmrLC = m_lcCache.get(m_colorcode, m_dmrflco, m_srcid, m_dstid);
+				m_dmrLC.getHeader(m_dmrFrame);
 
 				rx_dmrdata.setData(m_dmrFrame);
 				//CUtils::dump(1U, "DMR data:", m_dmrFrame, 33U);
 
 				for (unsigned int i = 0U; i < 3U; i++) {
 					rx_dmrdata.setSeqNo(dmr_cnt);
-					m_dmrNetwork->write(rx_dmrdata);
+					m_writer->writeDMR(rx_dmrdata, i == 0U ? txTime : 0ULL, i == 2U);
 					dmr_cnt++;
 				}
-
-				dmrWatch.start();
 			}
 			else if(dmrFrameType == TAG_EOT) {
 				not_busy=1;
@@ -855,7 +909,6 @@ int CYSF2DMR::run()
 				if (n_dmr) {
 					for (unsigned int i = 0U; i < fill; i++) {
 
-						CDMREMB emb;
 						CDMRData rx_dmrdata;
 
 						rx_dmrdata.setSlotNo(2U);
@@ -870,18 +923,13 @@ int CYSF2DMR::run()
 
 						::memcpy(m_dmrFrame, DMR_SILENCE_DATA, DMR_FRAME_LENGTH_BYTES);
 
-						// Generate the Embedded LC
-						unsigned char lcss = m_EmbeddedLC.getData(m_dmrFrame, n_dmr);
-
-						// Generate the EMB
-						emb.setColorCode(m_colorcode);
-						emb.setLCSS(lcss);
-						emb.getData(m_dmrFrame);
+						// Add the Embedded LC and EMB
+						m_dmrLC.getEmbedded(m_dmrFrame, n_dmr);
 
 						rx_dmrdata.setData(m_dmrFrame);
 
 						//CUtils::dump(1U, "DMR data:", m_dmrFrame, 33U);
-						m_dmrNetwork->write(rx_dmrdata);
+						m_writer->writeDMR(rx_dmrdata, 0ULL, false);
 
 						n_dmr++;
 						dmr_cnt++;
@@ -898,28 +946,14 @@ int CYSF2DMR::run()
 				rx_dmrdata.setRSSI(0U);
 				rx_dmrdata.setDataType(DT_TERMINATOR_WITH_LC);
 
-				// Add sync
-				CSync::addDMRDataSync(m_dmrFrame, 0);
-
-				// Add SlotType
-				CDMRSlotType slotType;
-				slotType.setColorCode(m_colorcode);
-				slotType.setDataType(DT_TERMINATOR_WITH_LC);
-				slotType.getData(m_dmrFrame);
-
-				// Full LC
-				CDMRLC dmrLC = CDMRLC(m_dmrflco, m_srcid, m_dstid);
-				CDMRFullLC fullLC;
-				fullLC.encode(dmrLC, m_dmrFrame, DT_TERMINATOR_WITH_LC);
+				// Sync, SlotType and Full LC, encoded once per LC
+				m_lcCache.get(m_colorcode, m_dmrflco, m_srcid, m_dstid).getTerminator(m_dmrFrame);
 
 				rx_dmrdata.setData(m_dmrFrame);
 				//CUtils::dump(1U, "DMR data:", m_dmrFrame, 33U);
-				m_dmrNetwork->write(rx_dmrdata);
-
-				dmrWatch.start();
+				m_writer->writeDMR(rx_dmrdata, txTime);
 			}
 			else if(dmrFrameType == TAG_DATA) {
-				CDMREMB emb;
 				CDMRData rx_dmrdata;
 				unsigned int n_dmr = (dmr_cnt - 3U) % 6U;
 
@@ -936,32 +970,27 @@ int CYSF2DMR::run()
 					rx_dmrdata.setDataType(DT_VOICE_SYNC);
 					// Add sync
 					CSync::addDMRAudioSync(m_dmrFrame, 0U);
-					// Prepare Full LC data
-					CDMRLC dmrLC = CDMRLC(m_dmrflco, m_srcid, m_dstid);
-					// Configure the Embedded LC
-					m_EmbeddedLC.setLC(dmrLC);
+					// Pick up the Embedded LC for this superframe
+					m_dmrLC = m_lcCache.get(m_colorcode, m_dmrflco, m_srcid, m_dstid);
 				}
 				else {
 					rx_dmrdata.setDataType(DT_VOICE);
-					// Generate the Embedded LC
-					unsigned char lcss = m_EmbeddedLC.getData(m_dmrFrame, n_dmr);
-					// Generate the EMB
-					emb.setColorCode(m_colorcode);
-					emb.setLCSS(lcss);
-					emb.getData(m_dmrFrame);
+					// Add the Embedded LC and EMB
+					m_dmrLC.getEmbedded(m_dmrFrame, n_dmr);
 				}
 
 				rx_dmrdata.setData(m_dmrFrame);
 
 				//CUtils::dump(1U, "DMR data:", m_dmrFrame, 33U);
-				m_dmrNetwork->write(rx_dmrdata);
+				m_writer->writeDMR(rx_dmrdata, txTime);
 
 				dmr_cnt++;
-				dmrWatch.start();
 			}
 		}
 
-		while (m_dmrNetwork->read(tx_dmrdata) > 0U) {
+		while (m_reader->readDMR(tx_dmrdata, rxTime)) {
+			m_conv.setTime(rxTime);
+
 			if (beacon_status==BE_DATA) beacon_status=BE_EOT;
 			unsigned int SrcId = tx_dmrdata.getSrcId();
 			unsigned int DstId = tx_dmrdata.getDstId();
@@ -974,7 +1003,7 @@ int CYSF2DMR::run()
 
 				if(DataType == DT_TERMINATOR_WITH_LC) {
 					if (m_dmrFrames == 0U) {
-						m_dmrNetwork->reset(2U);
+						m_writer->resetDMR(2U);
 						networkWatchdog.stop();
 						m_dmrinfo = false;
 						m_firstSync = false;
@@ -987,7 +1016,7 @@ int CYSF2DMR::run()
 						unlinkReceived = true;
 
 					m_conv.putDMREOT();
-					m_dmrNetwork->reset(2U);
+					m_writer->resetDMR(2U);
 					networkWatchdog.stop();
 					m_dmrFrames = 0U;
 					m_dmrinfo = false;
@@ -1076,6 +1105,7 @@ int CYSF2DMR::run()
 					}
 
 					m_conv.putDMR(dmr_frame); // Add DMR frame for YSF conversion
+					m_ysfLatency.add(LP_CONV_PUT, rxTime);
 					m_dmrFrames++;
 				}
 			}
@@ -1084,13 +1114,14 @@ int CYSF2DMR::run()
 					unsigned char dmr_frame[50];
 					tx_dmrdata.getData(dmr_frame);
 					m_conv.putDMR(dmr_frame); // Add DMR frame for YSF conversion
+					m_ysfLatency.add(LP_CONV_PUT, rxTime);
 					m_dmrFrames++;
 				}
 
 				networkWatchdog.clock(ms);
 				if (networkWatchdog.hasExpired()) {
 					LogDebug("Network watchdog has expired, %.1f seconds", float(m_dmrFrames) / 16.667F);
-					m_dmrNetwork->reset(2U);
+					m_writer->resetDMR(2U);
 					networkWatchdog.stop();
 					m_dmrFrames = 0U;
 					m_dmrinfo = false;
@@ -1100,8 +1131,10 @@ int CYSF2DMR::run()
 			m_dmrLastDT = DataType;
 		}
 
-		if (ysfWatch.elapsed() > YSF_FRAME_PER) {
-			unsigned int ysfFrameType = m_conv.getYSF(m_ysfFrame + 35U);
+		unsigned int ysfFrameType;
+		while ((ysfFrameType = m_conv.getYSF(m_ysfFrame + 35U)) != TAG_NODATA) {
+			unsigned long long txTime = m_conv.getYSFTime();
+			m_ysfLatency.add(LP_CONV_GET, txTime);
 
 			if(ysfFrameType == TAG_HEADER) {
 				not_busy=0;
@@ -1145,10 +1178,9 @@ int CYSF2DMR::run()
 				CYSFPayload payload;
 				payload.writeHeader(m_ysfFrame + 35U, csd1, csd2);
 
-				m_ysfNetwork->write(m_ysfFrame);
+				m_writer->writeYSF(m_ysfFrame, txTime);
 
 				ysf_cnt++;
-				ysfWatch.start();
 			}
 			else if (ysfFrameType == TAG_EOT) {
 				::memcpy(m_ysfFrame + 0U, "YSFD", 4U);
@@ -1189,11 +1221,10 @@ int CYSF2DMR::run()
 				CYSFPayload payload;
 				payload.writeHeader(m_ysfFrame + 35U, csd1, csd2);
 
-				m_ysfNetwork->write(m_ysfFrame);
+				m_writer->writeYSF(m_ysfFrame, txTime);
 			}
 			else if (ysfFrameType == TAG_DATA) {
 				CYSFFICH fich;
-				CYSFPayload ysfPayload;
 
 				unsigned int fn = (ysf_cnt - 1U) % 8U;
 
@@ -1207,22 +1238,22 @@ int CYSF2DMR::run()
 
 				switch (fn) {
 					case 0:
-						ysfPayload.writeVDMode2Data(m_ysfFrame + 35U, (const unsigned char*)"**********");
+						m_dchCache.writeVDMode2Data(m_ysfFrame + 35U, fn, (const unsigned char*)"**********");
 						break;
 					case 1:
-						ysfPayload.writeVDMode2Data(m_ysfFrame + 35U, (const unsigned char*)m_netSrc.c_str());
+						m_dchCache.writeVDMode2Data(m_ysfFrame + 35U, fn, (const unsigned char*)m_netSrc.c_str());
 						break;
 					case 2:
-						ysfPayload.writeVDMode2Data(m_ysfFrame + 35U, (const unsigned char*)m_netDst.c_str());
+						m_dchCache.writeVDMode2Data(m_ysfFrame + 35U, fn, (const unsigned char*)m_netDst.c_str());
 						break;
 					case 6:
-						ysfPayload.writeVDMode2Data(m_ysfFrame + 35U, gps_buffer);
+						m_dchCache.writeVDMode2Data(m_ysfFrame + 35U, fn, gps_buffer);
 						break;
 					case 7:
-						ysfPayload.writeVDMode2Data(m_ysfFrame + 35U, gps_buffer+10U);
+						m_dchCache.writeVDMode2Data(m_ysfFrame + 35U, fn, gps_buffer+10U);
 						break;
 					default:
-						ysfPayload.writeVDMode2Data(m_ysfFrame + 35U, (const unsigned char*)"          ");
+						m_dchCache.writeVDMode2Data(m_ysfFrame + 35U, fn, (const unsigned char*)"          ");
 				}
 
 				// Set the FICH
@@ -1249,18 +1280,14 @@ int CYSF2DMR::run()
 				m_ysfFrame[34U] = (ysf_cnt & 0x7FU) << 1;
 
 				// Send data to MMDVMHost
-				m_ysfNetwork->write(m_ysfFrame);
+				m_writer->writeYSF(m_ysfFrame, txTime);
 
 				ysf_cnt++;
-				ysfWatch.start();
 			}
 		}
 
 		stopWatch.start();
 
-		m_ysfNetwork->clock(ms);
-		m_dmrNetwork->clock(ms);
-
 		if (m_wiresX != NULL)
 			m_wiresX->clock(ms);
 
@@ -1269,12 +1296,13 @@ int CYSF2DMR::run()
 
 		pollTimer.clock(ms);
 		if (pollTimer.isRunning() && pollTimer.hasExpired()) {
-			m_ysfNetwork->writePoll();
+			m_writer->writeYSFPoll();
 			pollTimer.start();
 		}
 
 		ysfWatchdog.clock(ms);
 		if (ysfWatchdog.isRunning() && ysfWatchdog.hasExpired()) {
+			m_conv.setTime(0ULL);
 			int extraFrames = (m_hangTime / 100U) - m_ysfFrames;
 			for (int i = 0U; i < extraFrames; i++)
 				m_conv.putDummyYSF();
@@ -1284,13 +1312,64 @@ int CYSF2DMR::run()
 		if (m_xlxReflectors != NULL)
 			m_xlxReflectors->clock(ms);
 
-		if (ms < 5U)
+		latencyTimer.clock(ms);
+		if (latency == 1 || (latencyTimer.isRunning() && latencyTimer.hasExpired())) {
+			m_dmrLatency.dump();
+			m_ysfLatency.dump();
+			latencyTimer.start();
+			latency = 0;
+		}
+
+		// Give the pipeline time to drain once the replay has run out
+		if (m_replay != NULL && m_replay->isFinished()) {
+			if (!replayTimer.isRunning())
+				replayTimer.start();
+
+			replayTimer.clock(ms);
+			if (replayTimer.hasExpired()) {
+				LogMessage("Replay finished, %u ms of traffic in %.3f s of CPU", m_replay->getElapsed(), double(CThread::getCPUTime()) / 1000000.0);
+				end = 1;
+			}
+		}
+
+		if (m_metrics != NULL && m_metrics->clock(ms)) {
+			std::string text;
+			writeMetrics(text);
+			m_metrics->reply(text);
+		}
+
+		// A replay steps at the rate the network threads poll
+		if (m_replay != NULL) {
+			m_writer->clock();
+			m_replay->sleep(1U);
+		} else if (ms < 5U) {
 			CThread::sleep(5U);
+		}
+	}
+
+	if (m_metrics != NULL) {
+		m_metrics->close();
+		delete m_metrics;
+	}
+
+	if (m_replay == NULL) {
+		m_writer->stop();
+		m_reader->stop();
 	}
 
+	delete m_writer;
+	delete m_reader;
+
 	m_ysfNetwork->close();
 	m_dmrNetwork->close();
 
+	if (m_capture != NULL) {
+		m_capture->close();
+		delete m_capture;
+	}
+
+	delete m_replay;
+
 	if (m_APRS != NULL) {
 		m_APRS->stop();
 		delete m_APRS;
@@ -1359,16 +1438,119 @@ void CYSF2DMR::createGPS()
 	}
 }
 
+static void addMetric(std::string& text, const char* name, const char* type, const char* help)
+{
+	char buffer[300U];
+	::sprintf(buffer, "# HELP %s %s\n# TYPE %s %s\n", name, help, name, type);
+	text += buffer;
+}
+
+static void addValue(std::string& text, const char* name, const char* labels, unsigned long long value)
+{
+	char buffer[200U];
+	if (labels != NULL)
+		::sprintf(buffer, "%s{%s} %llu\n", name, labels, value);
+	else
+		::sprintf(buffer, "%s %llu\n", name, value);
+	text += buffer;
+}
+
+static void addValue(std::string& text, const char* name, const char* labels, double value)
+{
+	char buffer[200U];
+	if (labels != NULL)
+		::sprintf(buffer, "%s{%s} %.6f\n", name, labels, value);
+	else
+		::sprintf(buffer, "%s %.6f\n", name, value);
+	text += buffer;
+}
+
+// Runs on the main loop only when a scrape arrives, every counter it reads
+// is either a relaxed atomic or taken under the owner's existing lock.
+void CYSF2DMR::writeMetrics(std::string& text)
+{
+	addMetric(text, "ysf2dmr_frames_received_total", "counter", "Frames read from the network.");
+	addValue(text, "ysf2dmr_frames_received_total", "mode=\"ysf\"", (unsigned long long)m_reader->getYSFFrames());
+	addValue(text, "ysf2dmr_frames_received_total", "mode=\"dmr\"", (unsigned long long)m_reader->getDMRFrames());
+
+	addMetric(text, "ysf2dmr_frames_sent_total", "counter", "Frames written to the network.");
+	addValue(text, "ysf2dmr_frames_sent_total", "mode=\"ysf\"", (unsigned long long)m_writer->getYSFFrames());
+	addValue(text, "ysf2dmr_frames_sent_total", "mode=\"dmr\"", (unsigned long long)m_writer->getDMRFrames());
+
+	addMetric(text, "ysf2dmr_queue_overflows_total", "counter", "Frames dropped because a pipeline queue was full.");
+	addValue(text, "ysf2dmr_queue_overflows_total", "queue=\"ysf_rx\"", (unsigned long long)m_reader->getYSFOverflows());
+	addValue(text, "ysf2dmr_queue_overflows_total", "queue=\"dmr_rx\"", (unsigned long long)m_reader->getDMROverflows());
+	addValue(text, "ysf2dmr_queue_overflows_total", "queue=\"ysf_tx\"", (unsigned long long)m_writer->getYSFOverflows());
+	addValue(text, "ysf2dmr_queue_overflows_total", "queue=\"dmr_tx\"", (unsigned long long)m_writer->getDMROverflows());
+
+	const CRingBuffer<uint64_t>& ysfBuffer = m_conv.getYSFBuffer();
+	const CRingBuffer<uint64_t>& dmrBuffer = m_conv.getDMRBuffer();
+
+	addMetric(text, "ysf2dmr_ring_overflows_total", "counter", "Conversion ring buffer overflows.");
+	addValue(text, "ysf2dmr_ring_overflows_total", "buffer=\"ysf\"", (unsigned long long)ysfBuffer.getOverflows());
+	addValue(text, "ysf2dmr_ring_overflows_total", "buffer=\"dmr\"", (unsigned long long)dmrBuffer.getOverflows());
+
+	addMetric(text, "ysf2dmr_ring_underflows_total", "counter", "Conversion ring buffer underflows.");
+	addValue(text, "ysf2dmr_ring_underflows_total", "buffer=\"ysf\"", (unsigned long long)ysfBuffer.getUnderflows());
+	addValue(text, "ysf2dmr_ring_underflows_total", "buffer=\"dmr\"", (unsigned long long)dmrBuffer.getUnderflows());
+
+	unsigned int depth[3U], missing[3U], overflows[3U];
+	m_dmrNetwork->getDelayStats(1U, depth[1U], missing[1U], overflows[1U]);
+	m_dmrNetwork->getDelayStats(2U, depth[2U], missing[2U], overflows[2U]);
+
+	addMetric(text, "ysf2dmr_delay_buffer_depth", "gauge", "Frames waiting in the DMR jitter buffer.");
+	addValue(text, "ysf2dmr_delay_buffer_depth", "slot=\"1\"", (unsigned long long)depth[1U]);
+	addValue(text, "ysf2dmr_delay_buffer_depth", "slot=\"2\"", (unsigned long long)depth[2U]);
+
+	addMetric(text, "ysf2dmr_delay_buffer_missing_total", "counter", "Frames repeated or silenced because the DMR jitter buffer ran dry.");
+	addValue(text, "ysf2dmr_delay_buffer_missing_total", "slot=\"1\"", (unsigned long long)missing[1U]);
+	addValue(text, "ysf2dmr_delay_buffer_missing_total", "slot=\"2\"", (unsigned long long)missing[2U]);
+
+	addMetric(text, "ysf2dmr_delay_buffer_overflows_total", "counter", "DMR jitter buffer overflows.");
+	addValue(text, "ysf2dmr_delay_buffer_overflows_total", "slot=\"1\"", (unsigned long long)overflows[1U]);
+	addValue(text, "ysf2dmr_delay_buffer_overflows_total", "slot=\"2\"", (unsigned long long)overflows[2U]);
+
+	unsigned int hits, misses, loads, loadTime;
+	m_lookup->getStats(hits, misses, loads, loadTime);
+
+	addMetric(text, "ysf2dmr_lookup_total", "counter", "DMR Id lookups.");
+	addValue(text, "ysf2dmr_lookup_total", "result=\"hit\"", (unsigned long long)hits);
+	addValue(text, "ysf2dmr_lookup_total", "result=\"miss\"", (unsigned long long)misses);
+
+	addMetric(text, "ysf2dmr_lookup_reloads_total", "counter", "DMR Id file loads.");
+	addValue(text, "ysf2dmr_lookup_reloads_total", NULL, (unsigned long long)loads);
+
+	addMetric(text, "ysf2dmr_lookup_reload_seconds", "gauge", "Duration of the last DMR Id file load.");
+	addValue(text, "ysf2dmr_lookup_reload_seconds", NULL, double(loadTime) / 1000.0);
+
+	addMetric(text, "ysf2dmr_lc_cache_total", "counter", "Encoded DMR header, terminator and embedded LC lookups.");
+	addValue(text, "ysf2dmr_lc_cache_total", "result=\"hit\"", (unsigned long long)m_lcCache.getHits());
+	addValue(text, "ysf2dmr_lc_cache_total", "result=\"miss\"", (unsigned long long)m_lcCache.getMisses());
+
+	addMetric(text, "ysf2dmr_dch_cache_total", "counter", "Encoded YSF VD mode 2 DCH lookups.");
+	addValue(text, "ysf2dmr_dch_cache_total", "result=\"hit\"", (unsigned long long)m_dchCache.getHits());
+	addValue(text, "ysf2dmr_dch_cache_total", "result=\"miss\"", (unsigned long long)m_dchCache.getMisses());
+
+	addMetric(text, "ysf2dmr_cpu_seconds_total", "counter", "CPU time used by each pipeline stage.");
+	addValue(text, "ysf2dmr_cpu_seconds_total", "stage=\"ingress\"", double(m_reader->getCPUTime()) / 1000000.0);
+	addValue(text, "ysf2dmr_cpu_seconds_total", "stage=\"conversion\"", double(CThread::getCPUTime()) / 1000000.0);
+	addValue(text, "ysf2dmr_cpu_seconds_total", "stage=\"egress\"", double(m_writer->getCPUTime()) / 1000000.0);
+
+	addMetric(text, "ysf2dmr_dmr_connected", "gauge", "1 when logged in to the DMR master.");
+	addValue(text, "ysf2dmr_dmr_connected", NULL, (unsigned long long)(m_dmrNetwork->isConnected() ? 1U : 0U));
+
+	addMetric(text, "ysf2dmr_dmr_status", "gauge", "DMR login state, 0=connect 1=login 2=authorisation 3=config 4=options 5=running.");
+	addValue(text, "ysf2dmr_dmr_status", NULL, (unsigned long long)m_dmrNetwork->getStatus());
+}
+
 void CYSF2DMR::SendDummyDMR(unsigned int srcid,unsigned int dstid, FLCO dmr_flco)
 {
 	CDMRData dmrdata;
-	CDMRSlotType slotType;
-	CDMRFullLC fullLC;
 
 	int dmr_cnt = 0U;
 
-	// Generate DMR LC for header and TermLC frames
-	CDMRLC dmrLC = CDMRLC(dmr_flco, srcid, dstid);
+	// Encoded DMR header and TermLC frames
+	const CDMRLCBursts& bursts = m_lcCache.get(m_colorcode, dmr_flco, srcid, dstid);
 
 	// Build DMR header
 	dmrdata.setSlotNo(2U);
@@ -1381,23 +1563,15 @@ void CYSF2DMR::SendDummyDMR(unsigned int srcid,unsigned int dstid, FLCO dmr_flco
 	dmrdata.setRSSI(0U);
 	dmrdata.setDataType(DT_VOICE_LC_HEADER);
 
-	// Add sync
-	CSync::addDMRDataSync(m_dmrFrame, 0);
-
-	// Add SlotType
-	slotType.setColorCode(m_colorcode);
-	slotType.setDataType(DT_VOICE_LC_HEADER);
-	slotType.getData(m_dmrFrame);
-
-	// Full LC
-	fullLC.encode(dmrLC, m_dmrFrame, DT_VOICE_LC_HEADER);
+	// Sync, SlotType and Full LC
+	bursts.getHeader(m_dmrFrame);
 
 	dmrdata.setData(m_dmrFrame);
 
 	// Send DMR header
 	for (unsigned int i = 0U; i < 3U; i++) {
 		dmrdata.setSeqNo(dmr_cnt);
-		m_dmrNetwork->write(dmrdata);
+		m_writer->writeDMR(dmrdata, 0ULL, false);
 		dmr_cnt++;
 	}
 
@@ -1405,21 +1579,13 @@ void CYSF2DMR::SendDummyDMR(unsigned int srcid,unsigned int dstid, FLCO dmr_flco
 	dmrdata.setSeqNo(dmr_cnt);
 	dmrdata.setDataType(DT_TERMINATOR_WITH_LC);
 
-	// Add sync
-	CSync::addDMRDataSync(m_dmrFrame, 0);
-
-	// Add SlotType
-	slotType.setColorCode(m_colorcode);
-	slotType.setDataType(DT_TERMINATOR_WITH_LC);
-	slotType.getData(m_dmrFrame);
-
-	// Full LC for TermLC frame
-	fullLC.encode(dmrLC, m_dmrFrame, DT_TERMINATOR_WITH_LC);
+	// Sync, SlotType and Full LC for TermLC frame
+	bursts.getTerminator(m_dmrFrame);
 
 	dmrdata.setData(m_dmrFrame);
 
 	// Send DMR TermLC
-	m_dmrNetwork->write(dmrdata);
+	m_writer->writeDMR(dmrdata, 0ULL);
 }
 
 unsigned int CYSF2DMR::findYSFID(std::string cs, bool showdst)
@@ -1587,6 +1753,8 @@ bool CYSF2DMR::createDMRNetwork()
 
 	m_dmrNetwork->setConfig(m_callsign, rxFrequency, txFrequency, power, m_colorcode, 999U, 999U, height, location, description, url);
 
+	m_dmrNetwork->setCapture(m_capture, m_replay);
+
 	bool ret = m_dmrNetwork->open();
 	if (!ret) {
 		delete m_dmrNetwork;
@@ -1669,10 +1837,8 @@ int CYSF2DMR::getTg(int m_srcHS){
 	return api_tg;
 }
 
-void CYSF2DMR::writeXLXLink(unsigned int srcId, unsigned int dstId, CDMRNetwork* network)
+void CYSF2DMR::writeXLXLink(unsigned int srcId, unsigned int dstId)
 {
-	assert(network != NULL);
-
 	unsigned int streamId = ::rand() + 1U;
 
 	CDMRData data;
@@ -1706,7 +1872,7 @@ void CYSF2DMR::writeXLXLink(unsigned int srcId, unsigned int dstId, CDMRNetwork*
 
 	for (unsigned int i = 0U; i < 3U; i++) {
 		data.setSeqNo(i);
-		network->write(data);
+		m_writer->writeDMR(data, 0ULL, false);
 	}
 
 	data.setDataType(DT_TERMINATOR_WITH_LC);
@@ -1720,7 +1886,7 @@ void CYSF2DMR::writeXLXLink(unsigned int srcId, unsigned int dstId, CDMRNetwork*
 
 	for (unsigned int i = 0U; i < 2U; i++) {
 		data.setSeqNo(i + 3U);
-		network->write(data);
+		m_writer->writeDMR(data, 0ULL, i == 1U);
 	}
 }
 
@@ -24,7 +24,13 @@
 #include "DMRDefines.h"
 #include "ModeConv.h"
 #include "DMRNetwork.h"
+#include "NetworkReaderThread.h"
+#include "NetworkWriterThread.h"
+#include "LatencyTrace.h"
+#include "MetricsServer.h"
+#include "Capture.h"
 #include "DMREmbeddedData.h"
+#include "DMRLCCache.h"
 #include "DMRLC.h"
 #include "DMRFullLC.h"
 #include "DMREMB.h"
@@ -33,6 +39,7 @@
 #include "StopWatch.h"
 #include "Version.h"
 #include "YSFPayload.h"
+#include "YSFDCHCache.h"
 #include "YSFNetwork.h"
 #include "YSFFICH.h"
 #include "Reflectors.h"
@@ -81,6 +88,13 @@ private:
 	CWiresX*         m_wiresX;
 	CDMRNetwork*     m_dmrNetwork;
 	CYSFNetwork*     m_ysfNetwork;
+	CNetworkReaderThread* m_reader;
+	CNetworkWriterThread* m_writer;
+	CLatencyTrace    m_ysfLatency;
+	CLatencyTrace    m_dmrLatency;
+	CMetricsServer*  m_metrics;
+	CCapture*        m_capture;
+	CReplay*         m_replay;
 	CDMRLookup*      m_lookup;
 	CModeConv        m_conv;
 	unsigned int     m_colorcode;
@@ -102,7 +116,9 @@ private:
 	CAPRSReader*     m_APRS;
 	unsigned int     m_dmrFrames;
 	unsigned int     m_ysfFrames;
-	CDMREmbeddedData m_EmbeddedLC;
+	CDMRLCCache      m_lcCache;
+	CDMRLCBursts     m_dmrLC;
+	CYSFDCHCache     m_dchCache;
 	std::string      m_TGList;
 	FLCO             m_dmrflco;
 	bool             m_dmrinfo;
@@ -124,8 +140,9 @@ private:
 	void SendDummyDMR(unsigned int srcid, unsigned int dstid, FLCO dmr_flco);
 	unsigned int findYSFID(std::string cs, bool showdst);
 	std::string getSrcYSF(const unsigned char* source);
-	void writeXLXLink(unsigned int srcId, unsigned int dstId, CDMRNetwork* network);
+	void writeXLXLink(unsigned int srcId, unsigned int dstId);
 	int  getTg(int m_srcHS);
+	void writeMetrics(std::string& text);
 };
 
 #endif
@@ -60,6 +60,8 @@ public:
 
 private:
 	unsigned char* m_fich;
+
+	void encodeFICH(unsigned char* bytes);
 };
 
 #endif
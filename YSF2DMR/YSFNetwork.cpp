@@ -33,7 +33,8 @@ m_address(),
 m_port(0U),
 m_poll(NULL),
 m_unlink(NULL),
-m_buffer(1000U, "YSF Network Buffer")
+m_buffer(1000U, "YSF Network Buffer"),
+m_mutex()
 {
 	m_poll = new unsigned char[14U];
 	::memcpy(m_poll + 0U, "YSFP", 4U);
@@ -57,7 +58,8 @@ m_address(),
 m_port(0U),
 m_poll(NULL),
 m_unlink(NULL),
-m_buffer(1000U, "YSF Network Buffer")
+m_buffer(1000U, "YSF Network Buffer"),
+m_mutex()
 {
 	m_poll = new unsigned char[14U];
 	::memcpy(m_poll + 0U, "YSFP", 4U);
@@ -93,60 +95,73 @@ bool CYSFNetwork::open()
 
 void CYSFNetwork::setDestination(const in_addr& address, unsigned int port)
 {
+	m_mutex.lock();
 	m_address = address;
 	m_port    = port;
+	m_mutex.unlock();
 }
 
 void CYSFNetwork::clearDestination()
 {
+	m_mutex.lock();
 	m_address.s_addr = INADDR_NONE;
 	m_port           = 0U;
+	m_mutex.unlock();
 }
 
+// Only the writer thread sends, voice, WiresX replies and polls alike.
+// The lock keeps the destination consistent for it and the reader thread.
 bool CYSFNetwork::write(const unsigned char* data)
 {
 	assert(data != NULL);
 
-	if (m_port == 0U)
-		return true;
-
 	if (m_debug)
 		CUtils::dump(1U, "YSF Network Data Sent", data, 155U);
 
-	return m_socket.write(data, 155U, m_address, m_port);
+	return writeData(data, 155U);
 }
 
 bool CYSFNetwork::writePoll()
 {
-	if (m_port == 0U)
-		return true;
-
-	return m_socket.write(m_poll, 14U, m_address, m_port);
+	return writeData(m_poll, 14U);
 }
 
 bool CYSFNetwork::writeUnlink()
 {
-	if (m_port == 0U)
-		return true;
+	return writeData(m_unlink, 14U);
+}
+
+bool CYSFNetwork::writeData(const unsigned char* data, unsigned int length)
+{
+	m_mutex.lock();
+
+	bool ret = true;
+	if (m_port != 0U)
+		ret = m_socket.write(data, length, m_address, m_port);
 
-	return m_socket.write(m_unlink, 14U, m_address, m_port);
+	m_mutex.unlock();
+
+	return ret;
 }
 
 void CYSFNetwork::clock(unsigned int ms)
 {
-	if (m_port == 0U)
-		return;
-
 	unsigned char buffer[BUFFER_LENGTH];
 
+	m_mutex.lock();
+
+	if (m_port == 0U) {
+		m_mutex.unlock();
+		return;
+	}
+
 	in_addr address;
 	unsigned int port;
 	int length = m_socket.read(buffer, BUFFER_LENGTH, address, port);
-	if (length <= 0)
-		return;
-
-	if (address.s_addr != m_address.s_addr || port != m_port)
+	if (length <= 0 || address.s_addr != m_address.s_addr || port != m_port) {
+		m_mutex.unlock();
 		return;
+	}
 
 	if (m_debug)
 		CUtils::dump(1U, "YSF Network Data Received", buffer, length);
@@ -155,20 +170,28 @@ void CYSFNetwork::clock(unsigned int ms)
 	m_buffer.addData(&len, 1U);
 
 	m_buffer.addData(buffer, length);
+
+	m_mutex.unlock();
 }
 
 unsigned int CYSFNetwork::read(unsigned char* data)
 {
 	assert(data != NULL);
 
-	if (m_buffer.isEmpty())
+	m_mutex.lock();
+
+	if (m_buffer.isEmpty()) {
+		m_mutex.unlock();
 		return 0U;
+	}
 
 	unsigned char len = 0U;
 	m_buffer.getData(&len, 1U);
 
 	m_buffer.getData(data, len);
 
+	m_mutex.unlock();
+
 	return len;
 }
 
@@ -178,3 +201,8 @@ void CYSFNetwork::close()
 
 	LogMessage("Closing YSF network connection");
 }
+
+void CYSFNetwork::setCapture(CCapture* capture, CReplay* replay)
+{
+	m_socket.setCapture(capture, replay, CAPTURE_YSF);
+}
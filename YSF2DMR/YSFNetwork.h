@@ -22,6 +22,7 @@
 #include "YSFDefines.h"
 #include "UDPSocket.h"
 #include "RingBuffer.h"
+#include "Mutex.h"
 
 #include <cstdint>
 #include <string>
@@ -50,6 +51,8 @@ public:
 
 	void close();
 
+	void setCapture(CCapture* capture, CReplay* replay);
+
 private:
 	std::string                m_callsign;
 	CUDPSocket                 m_socket;
@@ -59,6 +62,9 @@ private:
 	unsigned char*             m_poll;
 	unsigned char*             m_unlink;
 	CRingBuffer<unsigned char> m_buffer;
+	CMutex                     m_mutex;
+
+	bool writeData(const unsigned char* data, unsigned int length);
 };
 
 #endif
@@ -29,6 +29,12 @@ public:
 	bool processHeaderData(unsigned char* bytes);
 
 	void writeVDMode2Data(unsigned char* data, const unsigned char* dt);
+
+	// The whitened, encoded and interleaved VD mode 2 DCH on its own, and
+	// writing such a DCH into a frame
+	void encodeVDMode2Data(const unsigned char* dt, unsigned char* dch);
+	void writeVDMode2DCH(unsigned char* data, const unsigned char* dch);
+
 	bool readVDMode1Data(const unsigned char* data, unsigned char* dt);
 	bool readVDMode2Data(const unsigned char* data, unsigned char* dt);
 
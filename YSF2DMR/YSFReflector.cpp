@@ -0,0 +1,561 @@
+/*
+ *   Copyright (C) 2019 by Manuel Sanchez EA7EE
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "YSFReflector.h"
+#include "YSFDefines.h"
+#include "YSFPayload.h"
+#include "StopWatch.h"
+#include "YSFFICH.h"
+#include "Thread.h"
+#include "Timer.h"
+#include "Sync.h"
+#include "CRC.h"
+#include "Log.h"
+
+#if !defined(_WIN32) && !defined(_WIN64)
+#include <signal.h>
+#endif
+
+#include <cassert>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+
+const unsigned int YSFD_LENGTH    = 155U;
+const unsigned int FRAME_PERIOD   = 100U;
+const unsigned int PEER_TIMEOUT   = 60000U;
+const unsigned int STREAM_TIMEOUT = 1000U;
+const unsigned int BUFFER_LENGTH  = 200U;
+
+// Header, fn 0 with the radio id, fn 1 with the command, terminator
+const unsigned int WIRESX_FRAMES  = 4U;
+
+const unsigned char YSF_SILENCE[] = {0x7BU, 0xB2U, 0x8EU, 0x43U, 0x36U, 0xE4U, 0xA2U, 0x39U, 0x78U, 0x49U, 0x33U, 0x68U, 0x33U};
+
+const unsigned char DX_REQ[] = {0x5DU, 0x71U, 0x5FU};
+
+static bool end = false;
+
+#if !defined(_WIN32) && !defined(_WIN64)
+static void sig_handler(int signum)
+{
+	end = true;
+}
+#endif
+
+static void usage()
+{
+	::fprintf(stderr, "Usage: YSFReflector [-p port] [-n name] [-c callers] [-i call secs] [-l call length secs]\n");
+	::fprintf(stderr, "                    [-x wiresx %%] [-f bad fich %%] [-a address -P port] [-w capture] [-s stats secs] [-t run secs]\n");
+}
+
+int main(int argc, char** argv)
+{
+	unsigned int port       = 42000U;
+	std::string  name       = "STANDIN";
+	unsigned int callers    = 1U;
+	unsigned int callTime   = 30U;
+	unsigned int callLength = 10U;
+	unsigned int wiresX     = 0U;
+	unsigned int badFICH    = 0U;
+	std::string  peerAddress;
+	unsigned int peerPort   = 0U;
+	std::string  capture;
+	unsigned int statsTime  = 10U;
+	unsigned int runTime    = 0U;
+
+	for (int currentArg = 1; currentArg < argc; currentArg++) {
+		std::string arg = argv[currentArg];
+		if (arg.length() != 2U || arg.at(0U) != '-' || (currentArg + 1) >= argc) {
+			usage();
+			return 1;
+		}
+
+		const char* value = argv[++currentArg];
+		switch (arg.at(1U)) {
+			case 'p': port        = (unsigned int)::atoi(value); break;
+			case 'n': name        = value;                       break;
+			case 'c': callers     = (unsigned int)::atoi(value); break;
+			case 'i': callTime    = (unsigned int)::atoi(value); break;
+			case 'l': callLength  = (unsigned int)::atoi(value); break;
+			case 'x': wiresX      = (unsigned int)::atoi(value); break;
+			case 'f': badFICH     = (unsigned int)::atoi(value); break;
+			case 'a': peerAddress = value;                       break;
+			case 'P': peerPort    = (unsigned int)::atoi(value); break;
+			case 'w': capture     = value;                       break;
+			case 's': statsTime   = (unsigned int)::atoi(value); break;
+			case 't': runTime     = (unsigned int)::atoi(value); break;
+			default:
+				usage();
+				return 1;
+		}
+	}
+
+#if !defined(_WIN32) && !defined(_WIN64)
+	::signal(SIGINT,  sig_handler);
+	::signal(SIGTERM, sig_handler);
+#endif
+
+	::LogInitialise(".", "YSFReflector", 0U, 1U);
+
+	CYSFReflector reflector(port, name, callers, callTime, callLength, wiresX, badFICH, statsTime, runTime);
+
+	if (!peerAddress.empty() && peerPort > 0U)
+		reflector.addPeer(peerAddress, peerPort);
+
+	if (!capture.empty())
+		reflector.setCapture(capture);
+
+	int ret = reflector.run();
+
+	::LogFinalise();
+
+	return ret;
+}
+
+CReflectorPeer::CReflectorPeer(const in_addr& address, unsigned int port, bool fixed) :
+m_address(address),
+m_port(port),
+m_fixed(fixed),
+m_linked(fixed),
+m_callsign(),
+m_lastSeen(0ULL),
+m_polls(0U),
+m_unlinks(0U),
+m_txFrames(0U),
+m_rxFrames(0U),
+m_rxBadFICH(0U),
+m_rxData(0U),
+m_rxStreams(0U),
+m_rxEnds(0U),
+m_lastSource(),
+m_lastRxTime(0ULL),
+m_rxGapTotal(0ULL),
+m_rxGapCount(0U),
+m_rxGapMax(0U)
+{
+}
+
+CSyntheticCaller::CSyntheticCaller(const std::string& callsign, unsigned long long nextCall) :
+m_callsign(callsign),
+m_active(false),
+m_type(CT_VOICE),
+m_frame(0U),
+m_frames(0U),
+m_nextFrame(0ULL),
+m_nextCall(nextCall),
+m_calls(0U)
+{
+	m_callsign.resize(YSF_CALLSIGN_LENGTH, ' ');
+}
+
+CYSFReflector::CYSFReflector(unsigned int port, const std::string& name, unsigned int callers, unsigned int callTime, unsigned int callLength, unsigned int wiresX, unsigned int badFICH, unsigned int statsTime, unsigned int runTime) :
+m_socket(port),
+m_name(name),
+m_callTime(callTime),
+m_callLength(callLength),
+m_wiresX(wiresX),
+m_badFICH(badFICH),
+m_statsTime(statsTime),
+m_runTime(runTime),
+m_peers(),
+m_callers(),
+m_capture(NULL)
+{
+	assert(port > 0U);
+	assert(wiresX <= 100U);
+	assert(badFICH <= 100U);
+
+	m_name.resize(YSF_CALLSIGN_LENGTH, ' ');
+
+	// Spread the callers over the call interval
+	for (unsigned int i = 0U; i < callers; i++) {
+		char callsign[20U];
+		::sprintf(callsign, "SIM%04u", i + 1U);
+		m_callers.push_back(new CSyntheticCaller(callsign, 1000ULL + (unsigned long long)i * callTime * 1000ULL / callers));
+	}
+}
+
+CYSFReflector::~CYSFReflector()
+{
+	for (std::vector<CReflectorPeer*>::iterator it = m_peers.begin(); it != m_peers.end(); ++it)
+		delete *it;
+
+	for (std::vector<CSyntheticCaller*>::iterator it = m_callers.begin(); it != m_callers.end(); ++it)
+		delete *it;
+
+	delete m_capture;
+}
+
+void CYSFReflector::addPeer(const std::string& address, unsigned int port)
+{
+	in_addr addr = CUDPSocket::lookup(address);
+	if (addr.s_addr == INADDR_NONE)
+		return;
+
+	m_peers.push_back(new CReflectorPeer(addr, port, true));
+}
+
+void CYSFReflector::setCapture(const std::string& filename)
+{
+	m_capture = new CCapture(filename);
+	if (!m_capture->open()) {
+		delete m_capture;
+		m_capture = NULL;
+	}
+}
+
+int CYSFReflector::run()
+{
+	if (!m_socket.open()) {
+		LogError("Cannot open the reflector port");
+		return 1;
+	}
+
+	::srand((unsigned int)::time(NULL));
+
+	LogMessage("YSF reflector stand-in %s started, %u callers every %us for %us, WiresX %u%%, bad FICH %u%%", m_name.c_str(), (unsigned int)m_callers.size(), m_callTime, m_callLength, m_wiresX, m_badFICH);
+
+	CStopWatch stopWatch;
+	stopWatch.start();
+
+	CTimer statsTimer(1000U, m_statsTime);
+	CTimer runTimer(1000U, m_runTime);
+	statsTimer.start();
+	runTimer.start();
+
+	unsigned long long now  = 0ULL;
+	unsigned long long last = 0ULL;
+
+	unsigned char buffer[BUFFER_LENGTH];
+
+	while (!end) {
+		now = stopWatch.elapsed();
+		unsigned int ms = (unsigned int)(now - last);
+		last = now;
+
+		in_addr address;
+		unsigned int port;
+		int length;
+		while ((length = m_socket.read(buffer, BUFFER_LENGTH, address, port)) > 0)
+			processPacket(buffer, length, address, port, now);
+
+		for (std::vector<CReflectorPeer*>::iterator it = m_peers.begin(); it != m_peers.end(); ++it) {
+			CReflectorPeer* peer = *it;
+			if (peer->m_linked && !peer->m_fixed && (now - peer->m_lastSeen) > PEER_TIMEOUT) {
+				LogWarning("Gateway %s has timed out", peer->m_callsign.c_str());
+				peer->m_linked = false;
+			}
+		}
+
+		if (m_callTime > 0U) {
+			for (std::vector<CSyntheticCaller*>::iterator it = m_callers.begin(); it != m_callers.end(); ++it)
+				clockCaller(*it, now);
+		}
+
+		statsTimer.clock(ms);
+		if (statsTimer.isRunning() && statsTimer.hasExpired()) {
+			writeStats();
+			statsTimer.start();
+		}
+
+		runTimer.clock(ms);
+		if (runTimer.isRunning() && runTimer.hasExpired())
+			end = true;
+
+		CThread::sleep(1U);
+	}
+
+	writeStats();
+
+	if (m_capture != NULL)
+		m_capture->close();
+
+	m_socket.close();
+
+	return 0;
+}
+
+void CYSFReflector::processPacket(const unsigned char* data, unsigned int length, const in_addr& address, unsigned int port, unsigned long long now)
+{
+	assert(data != NULL);
+
+	CReflectorPeer* peer = findPeer(address, port);
+
+	if (length == 14U && ::memcmp(data, "YSFP", 4U) == 0) {
+		if (peer == NULL) {
+			peer = new CReflectorPeer(address, port, false);
+			m_peers.push_back(peer);
+		}
+
+		if (!peer->m_linked) {
+			peer->m_callsign = std::string((const char*)data + 4U, YSF_CALLSIGN_LENGTH);
+			LogMessage("Gateway %s linked from %s:%u", peer->m_callsign.c_str(), ::inet_ntoa(address), port);
+		}
+
+		peer->m_linked   = true;
+		peer->m_lastSeen = now;
+		peer->m_polls++;
+
+		unsigned char reply[14U];
+		::memcpy(reply + 0U, "YSFP", 4U);
+		::memcpy(reply + 4U, m_name.c_str(), YSF_CALLSIGN_LENGTH);
+		m_socket.write(reply, 14U, address, port);
+		return;
+	}
+
+	if (peer == NULL)
+		return;
+
+	peer->m_lastSeen = now;
+
+	if (length == 14U && ::memcmp(data, "YSFU", 4U) == 0) {
+		LogMessage("Gateway %s unlinked", peer->m_callsign.c_str());
+		peer->m_unlinks++;
+		if (!peer->m_fixed)
+			peer->m_linked = false;
+	} else if (length == YSFD_LENGTH && ::memcmp(data, "YSFD", 4U) == 0) {
+		if (m_capture != NULL)
+			m_capture->write(CAPTURE_YSF, false, address, port, data, length);
+
+		processData(peer, data, now);
+	}
+}
+
+void CYSFReflector::processData(CReflectorPeer* peer, const unsigned char* data, unsigned long long now)
+{
+	assert(peer != NULL);
+	assert(data != NULL);
+
+	peer->m_rxFrames++;
+
+	CYSFFICH fich;
+	if (!fich.decode(data + 35U)) {
+		peer->m_rxBadFICH++;
+	} else if (fich.getDT() == YSF_DT_DATA_FR_MODE) {
+		// WiresX replies go out between voice frames, and must not end the
+		// voice stream or count as its gaps
+		peer->m_rxData++;
+		return;
+	}
+
+	std::string source((const char*)data + 14U, YSF_CALLSIGN_LENGTH);
+
+	if (source != peer->m_lastSource || (now - peer->m_lastRxTime) > STREAM_TIMEOUT) {
+		peer->m_rxStreams++;
+		peer->m_lastSource = source;
+	} else {
+		unsigned int gap = (unsigned int)(now - peer->m_lastRxTime);
+		peer->m_rxGapTotal += gap;
+		peer->m_rxGapCount++;
+		if (gap > peer->m_rxGapMax)
+			peer->m_rxGapMax = gap;
+	}
+
+	if ((data[34U] & 0x01U) == 0x01U) {
+		peer->m_rxEnds++;
+		peer->m_lastSource.clear();
+	}
+
+	peer->m_lastRxTime = now;
+}
+
+void CYSFReflector::clockCaller(CSyntheticCaller* caller, unsigned long long now)
+{
+	assert(caller != NULL);
+
+	if (!caller->m_active) {
+		if (now < caller->m_nextCall)
+			return;
+
+		caller->m_active    = true;
+		caller->m_type      = (unsigned int)(::rand() % 100) < m_wiresX ? CT_WIRESX : CT_VOICE;
+		caller->m_frame     = 0U;
+		caller->m_frames    = caller->m_type == CT_WIRESX ? WIRESX_FRAMES : m_callLength * 1000U / FRAME_PERIOD + 2U;
+		caller->m_nextFrame = now;
+		caller->m_nextCall  = now + m_callTime * 1000ULL;
+		caller->m_calls++;
+	}
+
+	while (caller->m_active && now >= caller->m_nextFrame) {
+		unsigned char buffer[YSFD_LENGTH];
+		buildFrame(caller, buffer);
+
+		for (std::vector<CReflectorPeer*>::iterator it = m_peers.begin(); it != m_peers.end(); ++it) {
+			CReflectorPeer* peer = *it;
+			if (!peer->m_linked)
+				continue;
+
+			m_socket.write(buffer, YSFD_LENGTH, peer->m_address, peer->m_port);
+			peer->m_txFrames++;
+		}
+
+		caller->m_frame++;
+		caller->m_nextFrame += FRAME_PERIOD;
+
+		if (caller->m_frame >= caller->m_frames)
+			caller->m_active = false;
+	}
+}
+
+void CYSFReflector::buildFrame(const CSyntheticCaller* caller, unsigned char* data)
+{
+	assert(caller != NULL);
+	assert(data != NULL);
+
+	bool first = caller->m_frame == 0U;
+	bool last  = caller->m_frame == (caller->m_frames - 1U);
+
+	::memset(data, 0x00U, YSFD_LENGTH);
+
+	::memcpy(data + 0U,  "YSFD", 4U);
+	::memcpy(data + 4U,  m_name.c_str(), YSF_CALLSIGN_LENGTH);
+	::memcpy(data + 14U, caller->m_callsign.c_str(), YSF_CALLSIGN_LENGTH);
+	::memcpy(data + 24U, "ALL       ", YSF_CALLSIGN_LENGTH);
+	data[34U] = ((caller->m_frame & 0x7FU) << 1) | (last ? 0x01U : 0x00U);
+
+	unsigned char* frame = data + 35U;
+
+	CSync::addYSFSync(frame);
+
+	CYSFFICH fich;
+	fich.setCS(2U);
+	fich.setFN(0U);
+	fich.setBN(0U);
+	fich.setBT(0U);
+	fich.setDev(false);
+	fich.setSQL(false);
+	fich.setSQ(0U);
+	fich.setVoIP(true);
+	fich.setMR(YSF_MR_BUSY);
+
+	CYSFPayload payload;
+
+	if (first || last) {
+		fich.setFI(first ? YSF_FI_HEADER : YSF_FI_TERMINATOR);
+
+		unsigned char csd1[20U], csd2[20U];
+		::memset(csd1, '*', YSF_CALLSIGN_LENGTH);
+		::memcpy(csd1 + YSF_CALLSIGN_LENGTH, caller->m_callsign.c_str(), YSF_CALLSIGN_LENGTH);
+		::memset(csd2, ' ', YSF_CALLSIGN_LENGTH + YSF_CALLSIGN_LENGTH);
+
+		payload.writeHeader(frame, csd1, csd2);
+	} else if (caller->m_type == CT_VOICE) {
+		unsigned int fn = (caller->m_frame - 1U) % 8U;
+		fich.setFI(YSF_FI_COMMUNICATIONS);
+		fich.setFN(fn);
+
+		unsigned char* p = frame + YSF_SYNC_LENGTH_BYTES + YSF_FICH_LENGTH_BYTES;
+		for (unsigned int i = 0U; i < 5U; i++)
+			::memcpy(p + 5U + i * 18U, YSF_SILENCE, 13U);
+
+		switch (fn) {
+			case 0U:
+				payload.writeVDMode2Data(frame, (const unsigned char*)"**********");
+				break;
+			case 1U:
+				payload.writeVDMode2Data(frame, (const unsigned char*)caller->m_callsign.c_str());
+				break;
+			case 2U:
+				payload.writeVDMode2Data(frame, (const unsigned char*)"ALL       ");
+				break;
+			default:
+				payload.writeVDMode2Data(frame, (const unsigned char*)"          ");
+				break;
+		}
+	} else {
+		unsigned int fn = caller->m_frame - 1U;
+		fich.setFI(YSF_FI_COMMUNICATIONS);
+		fich.setFN(fn);
+
+		if (fn == 0U) {
+			// The radio id is taken from bytes 5 to 9
+			unsigned char dt[20U];
+			::memset(dt, ' ', 20U);
+			::memcpy(dt + 5U, "SIM01", 5U);
+			payload.writeDataFRModeData1(dt, frame);
+			payload.writeDataFRModeData2(dt, frame);
+		} else {
+			unsigned char command[20U];
+			::memset(command, ' ', 20U);
+			command[0U] = 0x00U;
+			::memcpy(command + 1U, DX_REQ, 3U);
+			command[4U] = 0x5DU;
+			::memcpy(command + 5U, caller->m_callsign.c_str(), YSF_CALLSIGN_LENGTH);
+			command[15U] = 0x03U;
+			command[16U] = CCRC::addCRC(command, 16U);
+			payload.writeDataFRModeData2(command, frame);
+		}
+	}
+
+	if (caller->m_type == CT_VOICE) {
+		fich.setFT(7U);
+		fich.setDT(YSF_DT_VD_MODE2);
+	} else {
+		fich.setFT(1U);
+		fich.setDT(YSF_DT_DATA_FR_MODE);
+	}
+
+	fich.encode(frame);
+
+	// Corrupt the FICH beyond what the Golay code can repair
+	if (!first && !last && m_badFICH > 0U && (unsigned int)(::rand() % 100) < m_badFICH) {
+		for (unsigned int i = 0U; i < 8U; i++)
+			frame[YSF_SYNC_LENGTH_BYTES + (::rand() % YSF_FICH_LENGTH_BYTES)] ^= 0xFFU;
+	}
+}
+
+void CYSFReflector::writeStats() const
+{
+	unsigned int linked  = 0U;
+	unsigned int txTotal = 0U;
+	unsigned int rxTotal = 0U;
+
+	for (std::vector<CReflectorPeer*>::const_iterator it = m_peers.begin(); it != m_peers.end(); ++it) {
+		const CReflectorPeer* peer = *it;
+
+		if (peer->m_linked)
+			linked++;
+
+		txTotal += peer->m_txFrames;
+		rxTotal += peer->m_rxFrames;
+
+		float gapMean = peer->m_rxGapCount > 0U ? float(peer->m_rxGapTotal) / float(peer->m_rxGapCount) : 0.0F;
+
+		LogMessage("Gateway %s %s:%u: polls %u, unlinks %u, tx %u, rx %u (%u data) in %u streams (%u ended), bad FICH %u, gap mean %.1fms max %ums",
+			peer->m_callsign.c_str(), ::inet_ntoa(peer->m_address), peer->m_port, peer->m_polls, peer->m_unlinks,
+			peer->m_txFrames, peer->m_rxFrames, peer->m_rxData, peer->m_rxStreams, peer->m_rxEnds, peer->m_rxBadFICH, gapMean, peer->m_rxGapMax);
+	}
+
+	unsigned int calls = 0U;
+	for (std::vector<CSyntheticCaller*>::const_iterator it = m_callers.begin(); it != m_callers.end(); ++it)
+		calls += (*it)->m_calls;
+
+	LogMessage("%u gateways, %u linked, %u calls, %u frames sent, %u frames received", (unsigned int)m_peers.size(), linked, calls, txTotal, rxTotal);
+}
+
+CReflectorPeer* CYSFReflector::findPeer(const in_addr& address, unsigned int port) const
+{
+	for (std::vector<CReflectorPeer*>::const_iterator it = m_peers.begin(); it != m_peers.end(); ++it) {
+		if ((*it)->m_address.s_addr == address.s_addr && (*it)->m_port == port)
+			return *it;
+	}
+
+	return NULL;
+}
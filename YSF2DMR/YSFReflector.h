@@ -0,0 +1,110 @@
+/*
+ *   Copyright (C) 2019 by Manuel Sanchez EA7EE
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#if !defined(YSFReflector_H)
+#define YSFReflector_H
+
+#include "UDPSocket.h"
+#include "Capture.h"
+
+#include <string>
+#include <vector>
+
+class CReflectorPeer {
+public:
+	CReflectorPeer(const in_addr& address, unsigned int port, bool fixed);
+
+	in_addr            m_address;
+	unsigned int       m_port;
+	bool               m_fixed;
+	bool               m_linked;
+	std::string        m_callsign;
+	unsigned long long m_lastSeen;
+	unsigned int       m_polls;
+	unsigned int       m_unlinks;
+	unsigned int       m_txFrames;
+	unsigned int       m_rxFrames;
+	unsigned int       m_rxBadFICH;
+	unsigned int       m_rxData;
+	unsigned int       m_rxStreams;
+	unsigned int       m_rxEnds;
+	std::string        m_lastSource;
+	unsigned long long m_lastRxTime;
+	unsigned long long m_rxGapTotal;
+	unsigned int       m_rxGapCount;
+	unsigned int       m_rxGapMax;
+};
+
+enum CALL_TYPE {
+	CT_VOICE,
+	CT_WIRESX
+};
+
+class CSyntheticCaller {
+public:
+	CSyntheticCaller(const std::string& callsign, unsigned long long nextCall);
+
+	std::string        m_callsign;
+	bool               m_active;
+	CALL_TYPE          m_type;
+	unsigned int       m_frame;
+	unsigned int       m_frames;
+	unsigned long long m_nextFrame;
+	unsigned long long m_nextCall;
+	unsigned int       m_calls;
+};
+
+// Stand-in for a YSFReflector to load test CYSFNetwork and the YSF side
+// of the bridges. Gateways link with YSFP polls and leave with YSFU; a
+// fixed peer can also be given for bridges that do not poll. Synthetic
+// callers send VD mode 2 voice calls and WiresX DX requests to every
+// linked peer, optionally with corrupted FICH, and the YSFD traffic
+// coming back is counted and may be written to a capture file.
+class CYSFReflector {
+public:
+	CYSFReflector(unsigned int port, const std::string& name, unsigned int callers, unsigned int callTime, unsigned int callLength, unsigned int wiresX, unsigned int badFICH, unsigned int statsTime, unsigned int runTime);
+	~CYSFReflector();
+
+	void addPeer(const std::string& address, unsigned int port);
+
+	void setCapture(const std::string& filename);
+
+	int run();
+
+private:
+	CUDPSocket                       m_socket;
+	std::string                      m_name;
+	unsigned int                     m_callTime;
+	unsigned int                     m_callLength;
+	unsigned int                     m_wiresX;
+	unsigned int                     m_badFICH;
+	unsigned int                     m_statsTime;
+	unsigned int                     m_runTime;
+	std::vector<CReflectorPeer*>     m_peers;
+	std::vector<CSyntheticCaller*>   m_callers;
+	CCapture*                        m_capture;
+
+	void processPacket(const unsigned char* data, unsigned int length, const in_addr& address, unsigned int port, unsigned long long now);
+	void processData(CReflectorPeer* peer, const unsigned char* data, unsigned long long now);
+	void clockCaller(CSyntheticCaller* caller, unsigned long long now);
+	void buildFrame(const CSyntheticCaller* caller, unsigned char* data);
+	void writeStats() const;
+	CReflectorPeer* findPeer(const in_addr& address, unsigned int port) const;
+};
+
+#endif
@@ -0,0 +1,74 @@
+/*
+ *   Copyright (C) 2019 by Manuel Sanchez EA7EE
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "Clock.h"
+
+#if defined(_WIN32) || defined(_WIN64)
+#include <windows.h>
+#else
+#include <ctime>
+#endif
+
+#include <atomic>
+
+// Virtual time starts at a fixed point so that anything seeded from the
+// clock is the same on every replay run
+const unsigned long long VIRTUAL_START = 1000000ULL;
+
+static std::atomic<bool>               m_virtual(false);
+static std::atomic<unsigned long long> m_now(0ULL);
+
+unsigned long long CClock::getTime()
+{
+	if (m_virtual.load(std::memory_order_acquire))
+		return m_now.load(std::memory_order_acquire);
+
+#if defined(_WIN32) || defined(_WIN64)
+	LARGE_INTEGER frequency;
+	::QueryPerformanceFrequency(&frequency);
+
+	LARGE_INTEGER now;
+	::QueryPerformanceCounter(&now);
+
+	unsigned long long secs = now.QuadPart / frequency.QuadPart;
+	unsigned long long rest = now.QuadPart % frequency.QuadPart;
+
+	return secs * 1000000ULL + (rest * 1000000ULL) / frequency.QuadPart;
+#else
+	struct timespec now;
+	::clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return now.tv_sec * 1000000ULL + now.tv_nsec / 1000ULL;
+#endif
+}
+
+void CClock::setVirtual()
+{
+	m_now.store(VIRTUAL_START, std::memory_order_release);
+	m_virtual.store(true, std::memory_order_release);
+}
+
+bool CClock::isVirtual()
+{
+	return m_virtual.load(std::memory_order_acquire);
+}
+
+void CClock::advance(unsigned int ms)
+{
+	m_now.fetch_add(ms * 1000ULL, std::memory_order_acq_rel);
+}
@@ -0,0 +1,36 @@
+/*
+ *   Copyright (C) 2019 by Manuel Sanchez EA7EE
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#if !defined(CLOCK_H)
+#define	CLOCK_H
+
+// Monotonic time in microseconds for every timer in the bridge. It reads
+// the system clock until a replay switches it to virtual time, which then
+// only moves when the replay advances it.
+class CClock {
+public:
+	static unsigned long long getTime();
+
+	static void setVirtual();
+
+	static bool isVirtual();
+
+	static void advance(unsigned int ms);
+};
+
+#endif
@@ -34,7 +34,8 @@ enum SECTION {
   SECTION_NXDN_NETWORK,
   SECTION_NXDNID_LOOKUP,
   SECTION_LOG,
-  SECTION_APRS_FI
+  SECTION_APRS_FI,
+  SECTION_CAPTURE
 };
 
 CConf::CConf(const std::string& file) :
@@ -74,7 +75,10 @@ m_aprsPort(0U),
 m_aprsPassword(),
 m_aprsAPIKey(),
 m_aprsRefresh(120),
-m_aprsDescription()
+m_aprsDescription(),
+m_captureMode(0U),
+m_captureFile(),
+m_captureOutput()
 {
 }
 
@@ -110,6 +114,8 @@ bool CConf::read()
 		section = SECTION_LOG;
 	  else if (::strncmp(buffer, "[aprs.fi]", 5U) == 0)
 		section = SECTION_APRS_FI;
+	  else if (::strncmp(buffer, "[Capture]", 9U) == 0)
+		section = SECTION_CAPTURE;
 	  else
         section = SECTION_NONE;
 
@@ -215,6 +221,13 @@ bool CConf::read()
 			m_aprsRefresh = (unsigned int)::atoi(value);
 		else if (::strcmp(key, "Description") == 0)
 			m_aprsDescription = value;
+	} else if (section == SECTION_CAPTURE) {
+		if (::strcmp(key, "Mode") == 0)
+			m_captureMode = (unsigned int)::atoi(value);
+		else if (::strcmp(key, "File") == 0)
+			m_captureFile = value;
+		else if (::strcmp(key, "Output") == 0)
+			m_captureOutput = value;
 	}
   }
 
@@ -402,3 +415,18 @@ std::string CConf::getAPRSDescription() const
 {
 	return m_aprsDescription;
 }
+
+unsigned int CConf::getCaptureMode() const
+{
+	return m_captureMode;
+}
+
+std::string CConf::getCaptureFile() const
+{
+	return m_captureFile;
+}
+
+std::string CConf::getCaptureOutput() const
+{
+	return m_captureOutput;
+}
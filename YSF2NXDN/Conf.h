@@ -79,6 +79,11 @@ public:
   unsigned int getAPRSRefresh() const;  
   std::string  getAPRSDescription() const;  
 
+  // The Capture section
+  unsigned int getCaptureMode() const;
+  std::string  getCaptureFile() const;
+  std::string  getCaptureOutput() const;
+
 private:
   std::string  m_file;
 
@@ -124,6 +129,10 @@ private:
   unsigned int m_aprsRefresh;
   std::string  m_aprsDescription;
 
+  unsigned int m_captureMode;
+  std::string  m_captureFile;
+  std::string  m_captureOutput;
+
 };
 
 #endif
@@ -21,6 +21,8 @@
 #include "YSFDefines.h"
 #include "RingBuffer.h"
 
+#include <cstdint>
+
 #if !defined(MODECONV_H)
 #define MODECONV_H
 
@@ -29,11 +31,11 @@ public:
 	CModeConv();
 	~CModeConv();
 
-	void putNXDN(unsigned char* bytes);
+	void putNXDN(const unsigned char* bytes);
 	void putNXDNHeader();
 	void putNXDNEOT();
 
-	void putYSF(unsigned char* bytes);
+	void putYSF(const unsigned char* bytes);
 	void putYSFHeader();
 	void putYSFEOT();
 
@@ -41,12 +43,10 @@ public:
 	unsigned int getNXDN(unsigned char* bytes);
 
 private:
-	void putAMBE2YSF(unsigned int a, unsigned int b, unsigned int dat_c);
 	unsigned int m_ysfN;
 	unsigned int m_nxdnN;
-	CRingBuffer<unsigned char> m_YSF;
-	CRingBuffer<unsigned char> m_NXDN;
-
+	CRingBuffer<uint64_t> m_YSF;
+	CRingBuffer<uint64_t> m_NXDN;
 };
 
 #endif
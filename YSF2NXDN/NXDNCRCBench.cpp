@@ -0,0 +1,605 @@
+/*
+ *   Copyright (C) 2019 by Manuel Sanchez EA7EE
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+// Checks the table driven NXDN CRC6/12/15 and LICH against the bit at a
+// time versions they replaced, exhaustively where the inputs are small
+// enough, then times both.
+
+#include "NXDNDefines.h"
+#include "NXDNCRC.h"
+#include "NXDNLICH.h"
+#include "Clock.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cassert>
+#include <cstring>
+
+// Every message up to this many bits is checked, longer ones at random
+const unsigned int EXHAUSTIVE_BITS = 26U;
+const unsigned int RANDOM_MESSAGES = 2000000U;
+const unsigned int MAX_BITS        = 300U;
+const unsigned int BENCH_CALLS     = 10000000U;
+const unsigned int BUFFER_LENGTH   = (MAX_BITS + 16U + 7U) / 8U;
+
+// The frame sync and the LICH end in the fifth byte
+const unsigned int LICH_FRAME_LENGTH = (NXDN_FSW_LENGTH_BITS + NXDN_LICH_LENGTH_BITS + 7U) / 8U;
+
+// NXDNCRC.cpp and NXDNLICH.cpp before the tables
+class COldNXDNCRC
+{
+public:
+	static bool checkCRC6(const unsigned char* in, unsigned int length);
+	static void encodeCRC6(unsigned char* in, unsigned int length);
+
+	static bool checkCRC12(const unsigned char* in, unsigned int length);
+	static void encodeCRC12(unsigned char* in, unsigned int length);
+
+	static bool checkCRC15(const unsigned char* in, unsigned int length);
+	static void encodeCRC15(unsigned char* in, unsigned int length);
+
+	static uint8_t  createCRC6(const unsigned char* in, unsigned int length);
+	static uint16_t createCRC12(const unsigned char* in, unsigned int length);
+	static uint16_t createCRC15(const unsigned char* in, unsigned int length);
+};
+
+class COldNXDNLICH {
+public:
+	COldNXDNLICH(const COldNXDNLICH& lich);
+	COldNXDNLICH();
+	~COldNXDNLICH();
+
+	bool decode(const unsigned char* bytes);
+
+	void encode(unsigned char* bytes);
+
+	unsigned char getRFCT() const;
+	unsigned char getFCT() const;
+	unsigned char getOption() const;
+	unsigned char getDirection() const;
+	unsigned char getRaw() const;
+
+	void setRFCT(unsigned char rfct);
+	void setFCT(unsigned char usc);
+	void setOption(unsigned char option);
+	void setDirection(unsigned char direction);
+	void setRaw(unsigned char lich);
+
+	COldNXDNLICH& operator=(const COldNXDNLICH& lich);
+
+private:
+	unsigned char* m_lich;
+
+	bool getParity() const;
+};
+
+const uint8_t  BIT_MASK_TABLE1[] = { 0x80U, 0x40U, 0x20U, 0x10U, 0x08U, 0x04U, 0x02U, 0x01U };
+
+#define WRITE_BIT1(p,i,b) p[(i)>>3] = (b) ? (p[(i)>>3] | BIT_MASK_TABLE1[(i)&7]) : (p[(i)>>3] & ~BIT_MASK_TABLE1[(i)&7])
+#define READ_BIT1(p,i)    (p[(i)>>3] & BIT_MASK_TABLE1[(i)&7])
+
+bool COldNXDNCRC::checkCRC6(const unsigned char* in, unsigned int length)
+{
+	assert(in != NULL);
+
+	uint8_t crc = createCRC6(in, length);
+
+	uint8_t temp[1U];
+	temp[0U] = 0x00U;
+	unsigned int j = length;
+	for (unsigned int i = 2U; i < 8U; i++, j++) {
+		bool b = READ_BIT1(in, j);
+		WRITE_BIT1(temp, i, b);
+	}
+
+	return crc == temp[0U];
+}
+
+void COldNXDNCRC::encodeCRC6(unsigned char* in, unsigned int length)
+{
+	assert(in != NULL);
+
+	uint8_t crc[1U];
+	crc[0U] = createCRC6(in, length);
+
+	unsigned int n = length;
+	for (unsigned int i = 2U; i < 8U; i++, n++) {
+		bool b = READ_BIT1(crc, i);
+		WRITE_BIT1(in, n, b);
+	}
+}
+
+bool COldNXDNCRC::checkCRC12(const unsigned char* in, unsigned int length)
+{
+	assert(in != NULL);
+
+	uint16_t crc = createCRC12(in, length);
+	uint8_t temp1[2U];
+	temp1[0U] = (crc >> 8) & 0xFFU;
+	temp1[1U] = (crc >> 0) & 0xFFU;
+
+	uint8_t temp2[2U];
+	temp2[0U] = 0x00U;
+	temp2[1U] = 0x00U;
+	unsigned int j = length;
+	for (unsigned int i = 4U; i < 16U; i++, j++) {
+		bool b = READ_BIT1(in, j);
+		WRITE_BIT1(temp2, i, b);
+	}
+
+	return temp1[0U] == temp2[0U] && temp1[1U] == temp2[1U];
+}
+
+void COldNXDNCRC::encodeCRC12(unsigned char* in, unsigned int length)
+{
+	assert(in != NULL);
+
+	uint16_t crc = createCRC12(in, length);
+
+	uint8_t temp[2U];
+	temp[0U] = (crc >> 8) & 0xFFU;
+	temp[1U] = (crc >> 0) & 0xFFU;
+
+	unsigned int n = length;
+	for (unsigned int i = 4U; i < 16U; i++, n++) {
+		bool b = READ_BIT1(temp, i);
+		WRITE_BIT1(in, n, b);
+	}
+}
+
+bool COldNXDNCRC::checkCRC15(const unsigned char* in, unsigned int length)
+{
+	assert(in != NULL);
+
+	uint16_t crc = createCRC15(in, length);
+	uint8_t temp1[2U];
+	temp1[0U] = (crc >> 8) & 0xFFU;
+	temp1[1U] = (crc >> 0) & 0xFFU;
+
+	uint8_t temp2[2U];
+	temp2[0U] = 0x00U;
+	temp2[1U] = 0x00U;
+	unsigned int j = length;
+	for (unsigned int i = 1U; i < 16U; i++, j++) {
+		bool b = READ_BIT1(in, j);
+		WRITE_BIT1(temp2, i, b);
+	}
+
+	return temp1[0U] == temp2[0U] && temp1[1U] == temp2[1U];
+}
+
+void COldNXDNCRC::encodeCRC15(unsigned char* in, unsigned int length)
+{
+	assert(in != NULL);
+
+	uint16_t crc = createCRC15(in, length);
+
+	uint8_t temp[2U];
+	temp[0U] = (crc >> 8) & 0xFFU;
+	temp[1U] = (crc >> 0) & 0xFFU;
+
+	unsigned int n = length;
+	for (unsigned int i = 1U; i < 16U; i++, n++) {
+		bool b = READ_BIT1(temp, i);
+		WRITE_BIT1(in, n, b);
+	}
+}
+
+uint8_t COldNXDNCRC::createCRC6(const unsigned char* in, unsigned int length)
+{
+	uint8_t crc = 0x3FU;
+
+	for (unsigned int i = 0U; i < length; i++) {
+		bool bit1 = READ_BIT1(in, i) != 0x00U;
+		bool bit2 = (crc & 0x20U) == 0x20U;
+
+		crc <<= 1;
+
+		if (bit1 ^ bit2)
+			crc ^= 0x27U;
+	}
+
+	return crc & 0x3FU;
+}
+
+uint16_t COldNXDNCRC::createCRC12(const unsigned char* in, unsigned int length)
+{
+	uint16_t crc = 0x0FFFU;
+
+	for (unsigned int i = 0U; i < length; i++) {
+		bool bit1 = READ_BIT1(in, i) != 0x00U;
+		bool bit2 = (crc & 0x0800U) == 0x0800U;
+
+		crc <<= 1;
+
+		if (bit1 ^ bit2)
+			crc ^= 0x080FU;
+	}
+
+	return crc & 0x0FFFU;
+}
+
+uint16_t COldNXDNCRC::createCRC15(const unsigned char* in, unsigned int length)
+{
+	uint16_t crc = 0x7FFFU;
+
+	for (unsigned int i = 0U; i < length; i++) {
+		bool bit1 = READ_BIT1(in, i) != 0x00U;
+		bool bit2 = (crc & 0x4000U) == 0x4000U;
+
+		crc <<= 1;
+
+		if (bit1 ^ bit2)
+			crc ^= 0x4CC5U;
+	}
+
+	return crc & 0x7FFFU;
+}
+
+COldNXDNLICH::COldNXDNLICH(const COldNXDNLICH& lich) :
+m_lich(NULL)
+{
+	m_lich = new unsigned char[1U];
+	m_lich[0U] = lich.m_lich[0U];
+}
+
+COldNXDNLICH::COldNXDNLICH() :
+m_lich(NULL)
+{
+	m_lich = new unsigned char[1U];
+}
+
+COldNXDNLICH::~COldNXDNLICH()
+{
+	delete[] m_lich;
+}
+
+bool COldNXDNLICH::decode(const unsigned char* bytes)
+{
+	assert(bytes != NULL);
+
+	unsigned int offset = NXDN_FSW_LENGTH_BITS;
+	for (unsigned int i = 0U; i < (NXDN_LICH_LENGTH_BITS / 2U); i++, offset += 2U) {
+		bool b = READ_BIT1(bytes, offset);
+		WRITE_BIT1(m_lich, i, b);
+	}
+
+	bool newParity  = getParity();
+	bool origParity = (m_lich[0U] & 0x01U) == 0x01U;
+
+	return origParity == newParity;
+}
+
+void COldNXDNLICH::encode(unsigned char* bytes)
+{
+	assert(bytes != NULL);
+
+	bool parity = getParity();
+	if (parity)
+		m_lich[0U] |= 0x01U;
+	else
+		m_lich[0U] &= 0xFEU;
+
+	unsigned int offset = NXDN_FSW_LENGTH_BITS;
+	for (unsigned int i = 0U; i < (NXDN_LICH_LENGTH_BITS / 2U); i++) {
+		bool b = READ_BIT1(m_lich, i);
+		WRITE_BIT1(bytes, offset, b);
+		offset++;
+		WRITE_BIT1(bytes, offset, true);
+		offset++;
+	}
+}
+
+unsigned char COldNXDNLICH::getRFCT() const
+{
+	return (m_lich[0U] >> 6) & 0x03U;
+}
+
+unsigned char COldNXDNLICH::getFCT() const
+{
+	return (m_lich[0U] >> 4) & 0x03U;
+}
+
+unsigned char COldNXDNLICH::getOption() const
+{
+	return (m_lich[0U] >> 2) & 0x03U;
+}
+
+unsigned char COldNXDNLICH::getDirection() const
+{
+	return (m_lich[0U] >> 1) & 0x01U;
+}
+
+unsigned char COldNXDNLICH::getRaw() const
+{
+	bool parity = getParity();
+	if (parity)
+		m_lich[0U] |= 0x01U;
+	else
+		m_lich[0U] &= 0xFEU;
+
+	return m_lich[0U];
+}
+
+void COldNXDNLICH::setRFCT(unsigned char rfct)
+{
+	m_lich[0U] &= 0x3FU;
+	m_lich[0U] |= (rfct << 6) & 0xC0U;
+}
+
+void COldNXDNLICH::setFCT(unsigned char usc)
+{
+	m_lich[0U] &= 0xCFU;
+	m_lich[0U] |= (usc << 4) & 0x30U;
+}
+
+void COldNXDNLICH::setOption(unsigned char option)
+{
+	m_lich[0U] &= 0xF3U;
+	m_lich[0U] |= (option << 2) & 0x0CU;
+}
+
+void COldNXDNLICH::setDirection(unsigned char direction)
+{
+	m_lich[0U] &= 0xFDU;
+	m_lich[0U] |= (direction << 1) & 0x02U;
+}
+
+void COldNXDNLICH::setRaw(unsigned char lich)
+{
+	m_lich[0U] = lich;
+}
+
+COldNXDNLICH& COldNXDNLICH::operator=(const COldNXDNLICH& lich)
+{
+	if (&lich != this)
+		m_lich[0U] = lich.m_lich[0U];
+
+	return *this;
+}
+
+bool COldNXDNLICH::getParity() const
+{
+	switch (m_lich[0U] & 0xF0U) {
+	case 0x80U:
+	case 0xB0U:
+		return true;
+	default:
+		return false;
+	}
+}
+
+typedef void (*ENCODE_FUNC)(unsigned char* in, unsigned int length);
+typedef bool (*CHECK_FUNC)(const unsigned char* in, unsigned int length);
+
+struct CRCVariant {
+	const char*  m_name;
+	ENCODE_FUNC  m_oldEncode;
+	ENCODE_FUNC  m_newEncode;
+	CHECK_FUNC   m_oldCheck;
+	CHECK_FUNC   m_newCheck;
+	unsigned int m_failures;
+};
+
+static CRCVariant VARIANTS[] = {
+	{"CRC6",  COldNXDNCRC::encodeCRC6,  CNXDNCRC::encodeCRC6,  COldNXDNCRC::checkCRC6,  CNXDNCRC::checkCRC6,  0U},
+	{"CRC12", COldNXDNCRC::encodeCRC12, CNXDNCRC::encodeCRC12, COldNXDNCRC::checkCRC12, CNXDNCRC::checkCRC12, 0U},
+	{"CRC15", COldNXDNCRC::encodeCRC15, CNXDNCRC::encodeCRC15, COldNXDNCRC::checkCRC15, CNXDNCRC::checkCRC15, 0U}
+};
+
+const unsigned int VARIANT_COUNT = sizeof(VARIANTS) / sizeof(CRCVariant);
+
+// Both encoders must write the same CRC into the same buffer, and both
+// checks must agree on it and on a copy with one bit flipped
+static bool checkMessage(const CRCVariant& variant, const unsigned char* message, unsigned int length, unsigned int flip)
+{
+	unsigned char expected[BUFFER_LENGTH], actual[BUFFER_LENGTH];
+	::memcpy(expected, message, BUFFER_LENGTH);
+	::memcpy(actual, message, BUFFER_LENGTH);
+
+	variant.m_oldEncode(expected, length);
+	variant.m_newEncode(actual, length);
+	if (::memcmp(expected, actual, BUFFER_LENGTH) != 0)
+		return false;
+
+	if (!variant.m_newCheck(actual, length))
+		return false;
+
+	actual[flip >> 3] ^= 0x80U >> (flip & 7U);
+
+	return variant.m_oldCheck(actual, length) == variant.m_newCheck(actual, length);
+}
+
+static void checkCRC()
+{
+	unsigned char message[BUFFER_LENGTH];
+
+	for (unsigned int length = 1U; length <= EXHAUSTIVE_BITS; length++) {
+		for (unsigned int value = 0U; value < (1U << length); value++) {
+			::memset(message, 0x00U, BUFFER_LENGTH);
+
+			unsigned int bits = value << (32U - length);
+			message[0U] = bits >> 24;
+			message[1U] = bits >> 16;
+			message[2U] = bits >> 8;
+			message[3U] = bits >> 0;
+
+			for (unsigned int i = 0U; i < VARIANT_COUNT; i++) {
+				if (!checkMessage(VARIANTS[i], message, length, value % length)) {
+					if (VARIANTS[i].m_failures < 5U)
+						::printf("%s: %u bit message %07X differs\n", VARIANTS[i].m_name, length, value);
+					VARIANTS[i].m_failures++;
+				}
+			}
+		}
+	}
+
+	for (unsigned int n = 0U; n < RANDOM_MESSAGES; n++) {
+		for (unsigned int i = 0U; i < BUFFER_LENGTH; i++)
+			message[i] = ::rand();
+
+		unsigned int length = 1U + (::rand() % MAX_BITS);
+		unsigned int flip   = ::rand() % length;
+
+		for (unsigned int i = 0U; i < VARIANT_COUNT; i++) {
+			if (!checkMessage(VARIANTS[i], message, length, flip)) {
+				if (VARIANTS[i].m_failures < 5U)
+					::printf("%s: random %u bit message %u differs\n", VARIANTS[i].m_name, length, n);
+				VARIANTS[i].m_failures++;
+			}
+		}
+	}
+
+	for (unsigned int i = 0U; i < VARIANT_COUNT; i++)
+		::printf("%s: every message of 1 to %u bits and %u of up to %u bits checked, %u differences\n",
+			VARIANTS[i].m_name, EXHAUSTIVE_BITS, RANDOM_MESSAGES, MAX_BITS, VARIANTS[i].m_failures);
+}
+
+static unsigned int checkLICH()
+{
+	unsigned int failures = 0U;
+
+	// Decoding looks at the 24 bits of the frame that hold the LICH
+	unsigned char frame[LICH_FRAME_LENGTH];
+	::memset(frame, 0x00U, sizeof(frame));
+
+	for (unsigned int value = 0U; value < (1U << 24); value++) {
+		frame[2U] = value >> 16;
+		frame[3U] = value >> 8;
+		frame[4U] = value >> 0;
+
+		COldNXDNLICH oldLICH;
+		CNXDNLICH newLICH;
+		bool ok = oldLICH.decode(frame) == newLICH.decode(frame);
+		ok = ok && oldLICH.getRFCT() == newLICH.getRFCT() && oldLICH.getFCT() == newLICH.getFCT();
+		ok = ok && oldLICH.getOption() == newLICH.getOption() && oldLICH.getDirection() == newLICH.getDirection();
+		ok = ok && oldLICH.getRaw() == newLICH.getRaw();
+
+		if (!ok) {
+			if (failures < 5U)
+				::printf("LICH: decode of %06X differs\n", value);
+			failures++;
+		}
+	}
+
+	for (unsigned int value = 0U; value < 256U; value++) {
+		COldNXDNLICH oldLICH;
+		CNXDNLICH newLICH;
+		oldLICH.setRaw(value);
+		newLICH.setRaw(value);
+
+		unsigned char expected[sizeof(frame)], actual[sizeof(frame)];
+		for (unsigned int i = 0U; i < sizeof(frame); i++)
+			expected[i] = actual[i] = ::rand();
+
+		oldLICH.encode(expected);
+		newLICH.encode(actual);
+
+		if (::memcmp(expected, actual, sizeof(frame)) != 0 || oldLICH.getRaw() != newLICH.getRaw()) {
+			if (failures < 5U)
+				::printf("LICH: encode of %02X differs\n", value);
+			failures++;
+		}
+	}
+
+	::printf("LICH: every 24 bit pattern decoded and every value encoded, %u differences\n", failures);
+
+	return failures;
+}
+
+static void benchCRC(const CRCVariant& variant, unsigned int length)
+{
+	unsigned char message[BUFFER_LENGTH];
+	for (unsigned int i = 0U; i < BUFFER_LENGTH; i++)
+		message[i] = ::rand();
+
+	unsigned long long start = CClock::getTime();
+	for (unsigned int n = 0U; n < BENCH_CALLS; n++)
+		variant.m_oldEncode(message, length);
+	unsigned long long oldTime = CClock::getTime() - start;
+
+	start = CClock::getTime();
+	for (unsigned int n = 0U; n < BENCH_CALLS; n++)
+		variant.m_newEncode(message, length);
+	unsigned long long newTime = CClock::getTime() - start;
+
+	::printf("%s (%u bits): %.1f ns before, %.1f ns after\n", variant.m_name, length, double(oldTime) * 1000.0 / BENCH_CALLS, double(newTime) * 1000.0 / BENCH_CALLS);
+}
+
+static void benchLICH()
+{
+	unsigned char frame[LICH_FRAME_LENGTH];
+	for (unsigned int i = 0U; i < sizeof(frame); i++)
+		frame[i] = ::rand();
+
+	// The counts keep the compiler from dropping the decodes
+	unsigned int oldCount = 0U, newCount = 0U;
+
+	COldNXDNLICH oldLICH;
+	unsigned long long start = CClock::getTime();
+	for (unsigned int n = 0U; n < BENCH_CALLS; n++) {
+		frame[3U] = n;
+		oldCount += oldLICH.decode(frame) ? 1U : 0U;
+	}
+	unsigned long long oldDecode = CClock::getTime() - start;
+
+	CNXDNLICH newLICH;
+	start = CClock::getTime();
+	for (unsigned int n = 0U; n < BENCH_CALLS; n++) {
+		frame[3U] = n;
+		newCount += newLICH.decode(frame) ? 1U : 0U;
+	}
+	unsigned long long newDecode = CClock::getTime() - start;
+
+	start = CClock::getTime();
+	for (unsigned int n = 0U; n < BENCH_CALLS; n++) {
+		oldLICH.setRaw(n);
+		oldLICH.encode(frame);
+	}
+	unsigned long long oldEncode = CClock::getTime() - start;
+
+	start = CClock::getTime();
+	for (unsigned int n = 0U; n < BENCH_CALLS; n++) {
+		newLICH.setRaw(n);
+		newLICH.encode(frame);
+	}
+	unsigned long long newEncode = CClock::getTime() - start;
+
+	::printf("LICH decode: %.1f ns before, %.1f ns after (%u/%u valid)\n", double(oldDecode) * 1000.0 / BENCH_CALLS, double(newDecode) * 1000.0 / BENCH_CALLS, oldCount, newCount);
+	::printf("LICH encode: %.1f ns before, %.1f ns after\n", double(oldEncode) * 1000.0 / BENCH_CALLS, double(newEncode) * 1000.0 / BENCH_CALLS);
+}
+
+int main()
+{
+	::srand(0x27U);
+
+	checkCRC();
+	unsigned int failures = checkLICH();
+
+	for (unsigned int i = 0U; i < VARIANT_COUNT; i++)
+		failures += VARIANTS[i].m_failures;
+
+	// The message lengths the bridges use
+	benchCRC(VARIANTS[0U], 26U);
+	benchCRC(VARIANTS[1U], 80U);
+	benchCRC(VARIANTS[2U], 65U);
+	benchLICH();
+
+	return failures == 0U ? 0 : 1;
+}
@@ -0,0 +1,189 @@
+/*
+ *   Copyright (C) 2019 by Manuel Sanchez EA7EE
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+// Checks the frames CNXDNLCCache copies out against the LICH, SACCH and
+// layer 3 messages the bridges built for every frame before it, then times
+// both ways of filling a call.
+
+#include "NXDNLCCache.h"
+#include "NXDNDefines.h"
+#include "NXDNLayer3.h"
+#include "NXDNSACCH.h"
+#include "NXDNLICH.h"
+#include "Clock.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+const unsigned int CHECK_CALLS  = 200000U;
+const unsigned int BENCH_FRAMES = 2000000U;
+
+// The header and terminator as YSF2NXDN and DMR2NXDN built them per frame
+static void buildHeader(unsigned char* data, unsigned char type, unsigned int srcId, unsigned int dstId)
+{
+	CNXDNLICH lich;
+	lich.setRFCT(NXDN_LICH_RFCT_RDCH);
+	lich.setFCT(NXDN_LICH_USC_SACCH_NS);
+	lich.setOption(NXDN_LICH_STEAL_FACCH);
+	lich.setDirection(NXDN_LICH_DIRECTION_INBOUND);
+	data[0U] = lich.getRaw();
+
+	CNXDNSACCH sacch;
+	sacch.setRAN(0x01);
+	sacch.setStructure(NXDN_SR_SINGLE);
+	sacch.setData(SACCH_IDLE);
+	sacch.getRaw(data + 1U);
+
+	unsigned char layer3data[25U];
+	CNXDNLayer3 layer3;
+	layer3.setMessageType(type);
+	layer3.setSourceUnitId(srcId & 0xFFFF);
+	layer3.setDestinationGroupId(dstId & 0xFFFF);
+	layer3.setGroup(true);
+	layer3.setDataBlocks(0U);
+	layer3.getData(layer3data);
+
+	::memcpy(data + 5U, layer3data, 14U);
+	::memcpy(data + 5U + 14U, layer3data, 14U);
+}
+
+// The LICH and SACCH of a voice frame as built per frame
+static void buildVoice(unsigned char* data, unsigned int n, unsigned int srcId, unsigned int dstId)
+{
+	CNXDNLICH lich;
+	lich.setRFCT(NXDN_LICH_RFCT_RDCH);
+	lich.setFCT(NXDN_LICH_USC_SACCH_SS);
+	lich.setOption(NXDN_LICH_STEAL_NONE);
+	lich.setDirection(NXDN_LICH_DIRECTION_INBOUND);
+	data[0U] = lich.getRaw();
+
+	CNXDNSACCH sacch;
+	CNXDNLayer3 layer3;
+	unsigned char message[3U];
+
+	layer3.setMessageType(NXDN_MESSAGE_TYPE_VCALL);
+	layer3.setSourceUnitId(srcId & 0xFFFF);
+	layer3.setDestinationGroupId(dstId & 0xFFFF);
+	layer3.setGroup(true);
+	layer3.setDataBlocks(0U);
+
+	switch (n % 4) {
+		case 0:
+			sacch.setStructure(NXDN_SR_1_4);
+			layer3.encode(message, 18U, 0U);
+			sacch.setData(message);
+			break;
+		case 1:
+			sacch.setStructure(NXDN_SR_2_4);
+			layer3.encode(message, 18U, 18U);
+			sacch.setData(message);
+			break;
+		case 2:
+			sacch.setStructure(NXDN_SR_3_4);
+			layer3.encode(message, 18U, 36U);
+			sacch.setData(message);
+			break;
+		case 3:
+			sacch.setStructure(NXDN_SR_4_4);
+			layer3.encode(message, 18U, 54U);
+			sacch.setData(message);
+			break;
+	}
+
+	sacch.setRAN(0x01);
+	sacch.getRaw(data + 1U);
+}
+
+static bool checkCall(CNXDNLCCache& cache, unsigned int srcId, unsigned int dstId)
+{
+	unsigned char expected[NXDN_LC_CACHE_HEADER_LENGTH], actual[NXDN_LC_CACHE_HEADER_LENGTH];
+
+	buildHeader(expected, NXDN_MESSAGE_TYPE_VCALL, srcId, dstId);
+	cache.writeHeader(actual, srcId, dstId);
+	bool ok = ::memcmp(expected, actual, NXDN_LC_CACHE_HEADER_LENGTH) == 0;
+
+	for (unsigned int n = 0U; n < 4U; n++) {
+		buildVoice(expected, n, srcId, dstId);
+		cache.writeVoice(actual, n, srcId, dstId);
+		ok = ok && ::memcmp(expected, actual, NXDN_LC_CACHE_VOICE_LENGTH) == 0;
+	}
+
+	buildHeader(expected, NXDN_MESSAGE_TYPE_TX_REL, srcId, dstId);
+	cache.writeTerminator(actual, srcId, dstId);
+	ok = ok && ::memcmp(expected, actual, NXDN_LC_CACHE_HEADER_LENGTH) == 0;
+
+	return ok;
+}
+
+int main()
+{
+	CNXDNLCCache cache;
+
+	::srand(4400U);
+
+	unsigned int failures = 0U;
+	for (unsigned int n = 0U; n < CHECK_CALLS; n++) {
+		// Ids above 16 bits must be masked the same way by both
+		unsigned int srcId = ::rand() & 0xFFFFFFU;
+		unsigned int dstId = ::rand() & 0xFFFFFFU;
+
+		if (!checkCall(cache, srcId, dstId)) {
+			if (failures < 5U)
+				::printf("Call from %u to %u differs\n", srcId, dstId);
+			failures++;
+		}
+	}
+
+	::printf("NXDN: %u calls checked, %u differences, cache %u hits and %u misses\n", CHECK_CALLS, failures, cache.getHits(), cache.getMisses());
+
+	unsigned char frame[NXDN_LC_CACHE_HEADER_LENGTH];
+
+	unsigned int srcId = 12345U;
+	unsigned int dstId = 65000U;
+
+	unsigned long long start = CClock::getTime();
+	for (unsigned int n = 0U; n < BENCH_FRAMES; n++)
+		buildVoice(frame, n, srcId, dstId);
+	unsigned long long oldVoice = CClock::getTime() - start;
+
+	start = CClock::getTime();
+	for (unsigned int n = 0U; n < BENCH_FRAMES; n++)
+		cache.writeVoice(frame, n, srcId, dstId);
+	unsigned long long newVoice = CClock::getTime() - start;
+
+	start = CClock::getTime();
+	for (unsigned int n = 0U; n < BENCH_FRAMES; n++)
+		buildHeader(frame, (n % 2U) == 0U ? NXDN_MESSAGE_TYPE_VCALL : NXDN_MESSAGE_TYPE_TX_REL, srcId, dstId);
+	unsigned long long oldHeader = CClock::getTime() - start;
+
+	start = CClock::getTime();
+	for (unsigned int n = 0U; n < BENCH_FRAMES; n++) {
+		if ((n % 2U) == 0U)
+			cache.writeHeader(frame, srcId, dstId);
+		else
+			cache.writeTerminator(frame, srcId, dstId);
+	}
+	unsigned long long newHeader = CClock::getTime() - start;
+
+	double perFrame = 1000.0 / BENCH_FRAMES;
+	::printf("Voice LICH and SACCH: %.1f ns/frame built, %.1f ns/frame cached\n", double(oldVoice) * perFrame, double(newVoice) * perFrame);
+	::printf("Header and terminator: %.1f ns/frame built, %.1f ns/frame cached\n", double(oldHeader) * perFrame, double(newHeader) * perFrame);
+
+	return failures == 0U ? 0 : 1;
+}
@@ -19,8 +19,19 @@
 #if !defined(NXDNConvolution_H)
 #define  NXDNConvolution_H
 
+#include "ECCTables.h"
+
 #include <cstdint>
 
+// Soft symbols run from 0, a certain 0, to NXDN_SOFT_ONE, a certain 1.
+// Hard bits are given as one of the two ends, and bits removed by the
+// puncturing as NXDN_SOFT_ERASURE, which favours neither.
+const uint8_t NXDN_SOFT_ONE     = 254U;
+const uint8_t NXDN_SOFT_ERASURE = NXDN_SOFT_ONE / 2U;
+
+// Marks an erased position in a depuncturing map.
+const uint8_t NXDN_PUNCTURED = 0xFFU;
+
 class CNXDNConvolution {
 public:
 	CNXDNConvolution();
@@ -30,16 +41,42 @@ public:
 	void decode(uint8_t s0, uint8_t s1);
 	void chainback(unsigned char* out, unsigned int nBits);
 
+	// Decodes a whole punctured block of nBits bits, tail included. Entry n
+	// of map is the index in symbols of coded bit n, or NXDN_PUNCTURED, so
+	// the deinterleaving and depuncturing are done as the symbols are read.
+	void decode(const uint8_t* symbols, const uint8_t* map, unsigned char* out, unsigned int nBits);
+
 	void encode(const unsigned char* in, unsigned char* out, unsigned int nBits) const;
 
+	// Builds the map for decode() from the interleaving table, giving the
+	// transmitted position of each coded bit left after puncturing, and the
+	// sorted list of the punctured positions.
+	template<unsigned int N>
+	static constexpr CECCTable<uint8_t, N> depunctureMap(const unsigned int* interleave, const unsigned int* puncture, unsigned int nPuncture)
+	{
+		CECCTable<uint8_t, N> map = {};
+
+		unsigned int n = 0U;
+		unsigned int index = 0U;
+		for (unsigned int i = 0U; i < N; i++) {
+			if (index < nPuncture && puncture[index] == i) {
+				map.m_data[i] = NXDN_PUNCTURED;
+				index++;
+			} else {
+				map.m_data[i] = uint8_t(interleave[n++]);
+			}
+		}
+
+		return map;
+	}
+
 private:
-	uint16_t* m_metrics1;
-	uint16_t* m_metrics2;
-	uint16_t* m_oldMetrics;
-	uint16_t* m_newMetrics;
-	uint64_t* m_decisions;
-	uint64_t* m_dp;
+	int16_t   m_metrics1[16U];
+	int16_t   m_metrics2[16U];
+	int16_t*  m_oldMetrics;
+	int16_t*  m_newMetrics;
+	uint16_t  m_decisions[300U];
+	uint16_t* m_dp;
 };
 
 #endif
-
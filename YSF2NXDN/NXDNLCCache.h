@@ -0,0 +1,56 @@
+/*
+ *   Copyright (C) 2019 by Manuel Sanchez EA7EE
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#ifndef NXDNLCCache_H
+#define NXDNLCCache_H
+
+const unsigned int NXDN_LC_CACHE_HEADER_LENGTH = 33U;		// LICH, SACCH and the layer 3 message twice
+const unsigned int NXDN_LC_CACHE_VOICE_LENGTH  = 5U;		// LICH and SACCH
+
+// Everything in the network frames of a voice call that is not voice
+// depends only on the source and destination: the header and terminator
+// with their idle SACCH and layer 3 message, and the LICH and the four
+// SACCH fragments that the voice frames cycle through. They are built
+// once when the call changes, so each frame is just a copy.
+class CNXDNLCCache {
+public:
+	CNXDNLCCache();
+	~CNXDNLCCache();
+
+	void writeHeader(unsigned char* data, unsigned int srcId, unsigned int dstId);
+	void writeTerminator(unsigned char* data, unsigned int srcId, unsigned int dstId);
+	void writeVoice(unsigned char* data, unsigned int n, unsigned int srcId, unsigned int dstId);
+
+	unsigned int getHits() const;
+	unsigned int getMisses() const;
+
+private:
+	bool          m_valid;
+	unsigned int  m_srcId;
+	unsigned int  m_dstId;
+	unsigned char m_header[NXDN_LC_CACHE_HEADER_LENGTH];
+	unsigned char m_terminator[NXDN_LC_CACHE_HEADER_LENGTH];
+	unsigned char m_voice[4U][NXDN_LC_CACHE_VOICE_LENGTH];
+	unsigned int  m_hits;
+	unsigned int  m_misses;
+
+	void update(unsigned int srcId, unsigned int dstId);
+	void encodeHeader(unsigned char* data, unsigned char type) const;
+};
+
+#endif
@@ -42,6 +42,8 @@ public:
 
 	void close();
 
+	void setCapture(CCapture* capture, CReplay* replay);
+
 	void clock(unsigned int ms);
 
 private:
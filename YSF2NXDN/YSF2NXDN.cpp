@@ -123,7 +123,11 @@ m_dtmf(NULL),
 m_APRS(NULL),
 m_nxdnFrames(0U),
 m_ysfFrames(0U),
-m_nxdninfo(false)
+m_dchCache(),
+m_lcCache(),
+m_nxdninfo(false),
+m_capture(NULL),
+m_replay(NULL)
 {
 	m_ysfFrame  = new unsigned char[200U];
 	m_nxdnFrame = new unsigned char[200U];
@@ -239,8 +243,27 @@ int CYSF2NXDN::run()
 	std::string localAddress = m_conf.getLocalAddress();
 	unsigned int localPort   = m_conf.getLocalPort();
 
+	unsigned int captureMode = m_conf.getCaptureMode();
+	if (captureMode == 1U) {
+		m_capture = new CCapture(m_conf.getCaptureFile());
+		if (!m_capture->open()) {
+			::LogFinalise();
+			return 1;
+		}
+	} else if (captureMode == 2U) {
+		m_replay = new CReplay(m_conf.getCaptureFile());
+		m_capture = new CCapture(m_conf.getCaptureOutput());
+		if (!m_replay->open() || !m_capture->open()) {
+			::LogFinalise();
+			return 1;
+		}
+
+		m_replay->start();
+	}
+
 	m_ysfNetwork = new CYSFNetwork(localAddress, localPort, m_callsign, debug);
 	m_ysfNetwork->setDestination(dstAddress, dstPort);
+	m_ysfNetwork->setCapture(m_capture, m_replay);
 
 	ret = m_ysfNetwork->open();
 	if (!ret) {
@@ -255,6 +278,7 @@ int CYSF2NXDN::run()
 	unsigned int nxdn_localPort    = m_conf.getNXDNLocalPort();
 
 	m_nxdnNetwork = new CNXDNNetwork(nxdn_localAddress, nxdn_localPort, nxdn_dstAddress, nxdn_dstPort, debug);
+	m_nxdnNetwork->setCapture(m_capture, m_replay);
 
 	ret = m_nxdnNetwork->open();
 	if (!ret) {
@@ -271,6 +295,7 @@ int CYSF2NXDN::run()
 
 	CTimer networkWatchdog(100U, 0U, 1500U);
 	CTimer pollTimer(1000U, 5U);
+	CTimer replayTimer(1000U, 2U);
 
 	std::string name = m_conf.getDescription();
 	bool enableWiresX = m_conf.getEnableWiresX();
@@ -412,108 +437,21 @@ int CYSF2NXDN::run()
 			if(nxdnFrameType == TAG_HEADER) {
 				nxdn_cnt = 0U;
 
-				CNXDNLICH lich;
-				lich.setRFCT(NXDN_LICH_RFCT_RDCH);
-				lich.setFCT(NXDN_LICH_USC_SACCH_NS);
-				lich.setOption(NXDN_LICH_STEAL_FACCH);
-				lich.setDirection(NXDN_LICH_DIRECTION_INBOUND);
-				m_nxdnFrame[0U] = lich.getRaw();
-
-				CNXDNSACCH sacch;
-				sacch.setRAN(0x01);
-				sacch.setStructure(NXDN_SR_SINGLE);
-				sacch.setData(SACCH_IDLE);
-				sacch.getRaw(m_nxdnFrame + 1U);
-
-				unsigned char layer3data[25U];
-				CNXDNLayer3 layer3;
-				layer3.setMessageType(NXDN_MESSAGE_TYPE_VCALL);
-				layer3.setSourceUnitId(m_srcid & 0xFFFF);
-				layer3.setDestinationGroupId(m_dstid & 0xFFFF);
-				layer3.setGroup(true);
-				layer3.setDataBlocks(0U);
-				layer3.getData(layer3data);
-
-				::memcpy(m_nxdnFrame + 5U, layer3data, 14U);
-				::memcpy(m_nxdnFrame + 5U + 14U, layer3data, 14U);
+				m_lcCache.writeHeader(m_nxdnFrame, m_srcid, m_dstid);
 
 				m_nxdnNetwork->write(m_nxdnFrame, false);
 
 				nxdnWatch.start();
 			}
 			else if (nxdnFrameType == TAG_EOT) {
-				CNXDNLICH lich;
-				lich.setRFCT(NXDN_LICH_RFCT_RDCH);
-				lich.setFCT(NXDN_LICH_USC_SACCH_NS);
-				lich.setOption(NXDN_LICH_STEAL_FACCH);
-				lich.setDirection(NXDN_LICH_DIRECTION_INBOUND);
-				m_nxdnFrame[0U] = lich.getRaw();
-
-				CNXDNSACCH sacch;
-				sacch.setRAN(0x01);
-				sacch.setStructure(NXDN_SR_SINGLE);
-				sacch.setData(SACCH_IDLE);
-				sacch.getRaw(m_nxdnFrame + 1U);
-
-				unsigned char layer3data[25U];
-				CNXDNLayer3 layer3;
-				layer3.setMessageType(NXDN_MESSAGE_TYPE_TX_REL);
-				layer3.setSourceUnitId(m_srcid & 0xFFFF);
-				layer3.setDestinationGroupId(m_dstid & 0xFFFF);
-				layer3.setGroup(true);
-				layer3.setDataBlocks(0U);
-				layer3.getData(layer3data);
-
-				::memcpy(m_nxdnFrame + 5U, layer3data, 14U);
-				::memcpy(m_nxdnFrame + 5U + 14U, layer3data, 14U);
+				m_lcCache.writeTerminator(m_nxdnFrame, m_srcid, m_dstid);
 
 				m_nxdnNetwork->write(m_nxdnFrame, false);
 
 				nxdn_cnt = 0U;
 			}
 			else if (nxdnFrameType == TAG_DATA) {
-				CNXDNLICH lich;
-				lich.setRFCT(NXDN_LICH_RFCT_RDCH);
-				lich.setFCT(NXDN_LICH_USC_SACCH_SS);
-				lich.setOption(NXDN_LICH_STEAL_NONE);
-				lich.setDirection(NXDN_LICH_DIRECTION_INBOUND);
-				m_nxdnFrame[0U] = lich.getRaw();
-
-				CNXDNSACCH sacch;
-				CNXDNLayer3 layer3;
-				unsigned char message[3U];
-
-				layer3.setMessageType(NXDN_MESSAGE_TYPE_VCALL);
-				layer3.setSourceUnitId(m_srcid & 0xFFFF);
-				layer3.setDestinationGroupId(m_dstid & 0xFFFF);
-				layer3.setGroup(true);
-				layer3.setDataBlocks(0U);
-
-				switch (nxdn_cnt % 4) {
-					case 0:
-						sacch.setStructure(NXDN_SR_1_4);
-						layer3.encode(message, 18U, 0U);
-						sacch.setData(message);
-						break;
-					case 1:
-						sacch.setStructure(NXDN_SR_2_4);
-						layer3.encode(message, 18U, 18U);
-						sacch.setData(message);
-						break;
-					case 2:
-						sacch.setStructure(NXDN_SR_3_4);
-						layer3.encode(message, 18U, 36U);
-						sacch.setData(message);
-						break;
-					case 3:
-						sacch.setStructure(NXDN_SR_4_4);
-						layer3.encode(message, 18U, 54U);
-						sacch.setData(message);
-						break;
-				}
-
-				sacch.setRAN(0x01);
-				sacch.getRaw(m_nxdnFrame + 1U);
+				m_lcCache.writeVoice(m_nxdnFrame, nxdn_cnt, m_srcid, m_dstid);
 
 				// Send data to MMDVMHost
 				m_nxdnNetwork->write(m_nxdnFrame, false);
@@ -660,7 +598,6 @@ int CYSF2NXDN::run()
 			}
 			else if (ysfFrameType == TAG_DATA) {
 				CYSFFICH fich;
-				CYSFPayload ysfPayload;
 
 				unsigned int fn = (ysf_cnt - 1U) % 8U;
 
@@ -674,22 +611,22 @@ int CYSF2NXDN::run()
 
 				switch (fn) {
 					case 0:
-						ysfPayload.writeVDMode2Data(m_ysfFrame + 35U, (const unsigned char*)"**********");
+						m_dchCache.writeVDMode2Data(m_ysfFrame + 35U, fn, (const unsigned char*)"**********");
 						break;
 					case 1:
-						ysfPayload.writeVDMode2Data(m_ysfFrame + 35U, (const unsigned char*)m_netSrc.c_str());
+						m_dchCache.writeVDMode2Data(m_ysfFrame + 35U, fn, (const unsigned char*)m_netSrc.c_str());
 						break;
 					case 2:
-						ysfPayload.writeVDMode2Data(m_ysfFrame + 35U, (const unsigned char*)m_netDst.c_str());
+						m_dchCache.writeVDMode2Data(m_ysfFrame + 35U, fn, (const unsigned char*)m_netDst.c_str());
 						break;
 					case 6:
-						ysfPayload.writeVDMode2Data(m_ysfFrame + 35U, gps_buffer);
+						m_dchCache.writeVDMode2Data(m_ysfFrame + 35U, fn, gps_buffer);
 						break;
 					case 7:
-						ysfPayload.writeVDMode2Data(m_ysfFrame + 35U, gps_buffer + 10U);
+						m_dchCache.writeVDMode2Data(m_ysfFrame + 35U, fn, gps_buffer + 10U);
 						break;
 					default:
-						ysfPayload.writeVDMode2Data(m_ysfFrame + 35U, (const unsigned char*)"          ");
+						m_dchCache.writeVDMode2Data(m_ysfFrame + 35U, fn, (const unsigned char*)"          ");
 				}
 				
 				// Set the FICH
@@ -732,7 +669,21 @@ int CYSF2NXDN::run()
 			pollTimer.start();
 		}
 
-		if (ms < 5U)
+		// Give the conversion time to drain once the replay has run out
+		if (m_replay != NULL && m_replay->isFinished()) {
+			if (!replayTimer.isRunning())
+				replayTimer.start();
+
+			replayTimer.clock(ms);
+			if (replayTimer.hasExpired()) {
+				LogMessage("Replay finished, %u ms of traffic in %.3f s of CPU", m_replay->getElapsed(), double(CThread::getCPUTime()) / 1000000.0);
+				end = 1;
+			}
+		}
+
+		if (m_replay != NULL)
+			m_replay->sleep(5U);
+		else if (ms < 5U)
 			CThread::sleep(5U);
 	}
 
@@ -757,6 +708,13 @@ int CYSF2NXDN::run()
 		delete m_dtmf;
 	}
 
+	if (m_capture != NULL) {
+		m_capture->close();
+		delete m_capture;
+	}
+
+	delete m_replay;
+
 	::LogFinalise();
 
 	return 0;
@@ -849,55 +807,11 @@ std::string CYSF2NXDN::getSrcYSF(const unsigned char* buffer)
 void CYSF2NXDN::sendNXDNPTT(unsigned int src, unsigned int dst)
 {
 	// Send NXDN Header
-	CNXDNLICH lich;
-	lich.setRFCT(NXDN_LICH_RFCT_RDCH);
-	lich.setFCT(NXDN_LICH_USC_SACCH_NS);
-	lich.setOption(NXDN_LICH_STEAL_FACCH);
-	lich.setDirection(NXDN_LICH_DIRECTION_INBOUND);
-	m_nxdnFrame[0U] = lich.getRaw();
-
-	CNXDNSACCH sacch;
-	sacch.setRAN(0x01);
-	sacch.setStructure(NXDN_SR_SINGLE);
-	sacch.setData(SACCH_IDLE);
-	sacch.getRaw(m_nxdnFrame + 1U);
-
-	unsigned char layer3data[25U];
-	CNXDNLayer3 layer3;
-	layer3.setMessageType(NXDN_MESSAGE_TYPE_VCALL);
-	layer3.setSourceUnitId(src & 0xFFFF);
-	layer3.setDestinationGroupId(dst & 0xFFFF);
-	layer3.setGroup(true);
-	layer3.setDataBlocks(0U);
-	layer3.getData(layer3data);
-
-	::memcpy(m_nxdnFrame + 5U, layer3data, 14U);
-	::memcpy(m_nxdnFrame + 5U + 14U, layer3data, 14U);
-
+	m_lcCache.writeHeader(m_nxdnFrame, src, dst);
 	m_nxdnNetwork->write(m_nxdnFrame, false);
 
 	// Send NXDN EOT
-	lich.setRFCT(NXDN_LICH_RFCT_RDCH);
-	lich.setFCT(NXDN_LICH_USC_SACCH_NS);
-	lich.setOption(NXDN_LICH_STEAL_FACCH);
-	lich.setDirection(NXDN_LICH_DIRECTION_INBOUND);
-	m_nxdnFrame[0U] = lich.getRaw();
-
-	sacch.setRAN(0x01);
-	sacch.setStructure(NXDN_SR_SINGLE);
-	sacch.setData(SACCH_IDLE);
-	sacch.getRaw(m_nxdnFrame + 1U);
-
-	layer3.setMessageType(NXDN_MESSAGE_TYPE_TX_REL);
-	layer3.setSourceUnitId(src & 0xFFFF);
-	layer3.setDestinationGroupId(dst & 0xFFFF);
-	layer3.setGroup(true);
-	layer3.setDataBlocks(0U);
-	layer3.getData(layer3data);
-
-	::memcpy(m_nxdnFrame + 5U, layer3data, 14U);
-	::memcpy(m_nxdnFrame + 5U + 14U, layer3data, 14U);
-
+	m_lcCache.writeTerminator(m_nxdnFrame, src, dst);
 	m_nxdnNetwork->write(m_nxdnFrame, false);
 }
 
@@ -25,13 +25,16 @@
 #include "ModeConv.h"
 #include "NXDNLookup.h"
 #include "UDPSocket.h"
+#include "Capture.h"
 #include "StopWatch.h"
 #include "Version.h"
 #include "YSFPayload.h"
+#include "YSFDCHCache.h"
 #include "YSFNetwork.h"
 #include "NXDNConvolution.h"
 #include "NXDNCRC.h"
 #include "NXDNLayer3.h"
+#include "NXDNLCCache.h"
 #include "NXDNLICH.h"
 #include "NXDNSACCH.h"
 #include "NXDNNetwork.h"
@@ -80,7 +83,11 @@ private:
 	CAPRSReader*     m_APRS;
 	unsigned int     m_nxdnFrames;
 	unsigned int     m_ysfFrames;
+	CYSFDCHCache     m_dchCache;
+	CNXDNLCCache     m_lcCache;
 	bool             m_nxdninfo;
+	CCapture*        m_capture;
+	CReplay*         m_replay;
 
 	void sendNXDNPTT(unsigned int src, unsigned int dst);
 	void createGPS();
@@ -33,7 +33,8 @@ enum SECTION {
   SECTION_YSF_NETWORK,
   SECTION_P25_NETWORK,
   SECTION_DMRID_LOOKUP,
-  SECTION_LOG
+  SECTION_LOG,
+  SECTION_CAPTURE
 };
 
 CConf::CConf(const std::string& file) :
@@ -58,13 +59,17 @@ m_p25DstPort(0U),
 m_p25LocalAddress(),
 m_p25LocalPort(0U),
 m_p25TGListFile(),
+m_p25NetworkCoalesce(false),
 m_p25NetworkDebug(false),
 m_dmrIdLookupFile(),
 m_dmrIdLookupTime(0U),
 m_logDisplayLevel(0U),
 m_logFileLevel(0U),
 m_logFilePath(),
-m_logFileRoot()
+m_logFileRoot(),
+m_captureMode(0U),
+m_captureFile(),
+m_captureOutput()
 {
 }
 
@@ -98,6 +103,8 @@ bool CConf::read()
 		section = SECTION_DMRID_LOOKUP;
 	  else if (::strncmp(buffer, "[Log]", 5U) == 0)
 		section = SECTION_LOG;
+	  else if (::strncmp(buffer, "[Capture]", 9U) == 0)
+		section = SECTION_CAPTURE;
 	  else
         section = SECTION_NONE;
 
@@ -168,6 +175,8 @@ bool CConf::read()
 			m_p25LocalPort = (unsigned int)::atoi(value);
 		else if (::strcmp(key, "TGListFile") == 0)
 			m_p25TGListFile = value;
+		else if (::strcmp(key, "Coalesce") == 0)
+			m_p25NetworkCoalesce = ::atoi(value) == 1;
 		else if (::strcmp(key, "Debug") == 0)
 			m_p25NetworkDebug = ::atoi(value) == 1;
 	} else if (section == SECTION_DMRID_LOOKUP) {
@@ -184,6 +193,13 @@ bool CConf::read()
 			m_logFileLevel = (unsigned int)::atoi(value);
 		else if (::strcmp(key, "DisplayLevel") == 0)
 			m_logDisplayLevel = (unsigned int)::atoi(value);
+	} else if (section == SECTION_CAPTURE) {
+		if (::strcmp(key, "Mode") == 0)
+			m_captureMode = (unsigned int)::atoi(value);
+		else if (::strcmp(key, "File") == 0)
+			m_captureFile = value;
+		else if (::strcmp(key, "Output") == 0)
+			m_captureOutput = value;
 	}
   }
 
@@ -292,6 +308,11 @@ std::string CConf::getP25TGListFile() const
 	return m_p25TGListFile;
 }
 
+bool CConf::getP25NetworkCoalesce() const
+{
+	return m_p25NetworkCoalesce;
+}
+
 bool CConf::getP25NetworkDebug() const
 {
 	return m_p25NetworkDebug;
@@ -326,3 +347,18 @@ std::string CConf::getLogFileRoot() const
 {
   return m_logFileRoot;
 }
+
+unsigned int CConf::getCaptureMode() const
+{
+	return m_captureMode;
+}
+
+std::string CConf::getCaptureFile() const
+{
+	return m_captureFile;
+}
+
+std::string CConf::getCaptureOutput() const
+{
+	return m_captureOutput;
+}
@@ -56,6 +56,7 @@ public:
   std::string  getP25LocalAddress() const;
   unsigned int getP25LocalPort() const;
   std::string  getP25TGListFile() const;
+  bool         getP25NetworkCoalesce() const;
   bool         getP25NetworkDebug() const;
 
   // The DMR Id section
@@ -68,6 +69,11 @@ public:
   std::string  getLogFilePath() const;
   std::string  getLogFileRoot() const;
 
+  // The Capture section
+  unsigned int getCaptureMode() const;
+  std::string  getCaptureFile() const;
+  std::string  getCaptureOutput() const;
+
 private:
   std::string  m_file;
   std::string  m_callsign;
@@ -92,6 +98,7 @@ private:
   std::string  m_p25LocalAddress;
   unsigned int m_p25LocalPort;
   std::string  m_p25TGListFile;
+  bool         m_p25NetworkCoalesce;
   bool         m_p25NetworkDebug;
 
   std::string  m_dmrIdLookupFile;
@@ -101,6 +108,10 @@ private:
   unsigned int m_logFileLevel;
   std::string  m_logFilePath;
   std::string  m_logFileRoot;
+
+  unsigned int m_captureMode;
+  std::string  m_captureFile;
+  std::string  m_captureOutput;
 };
 
 #endif
@@ -0,0 +1,66 @@
+#!/bin/sh
+#
+# Test of the P25 side of YSF2P25 against the P25Gateway stand-in, once
+# for each way the stand-in sends: a datagram per record, a batch per LDU
+# and a coalesced datagram per LDU. Every call must reach the bridge whole,
+# so each end of transmission it logs should count every voice record the
+# stand-in sent, whole LDUs at 50 records a second.
+#
+# Usage: GatewayTest.sh [calls] [call length secs]
+
+CALLS=${1:-3}
+LENGTH=${2:-5}
+
+# The last call ends just before the stand-in stops
+RUNTIME=$((CALLS * (LENGTH + 2)))
+
+DIR=$(cd "$(dirname "$0")" && pwd)
+WORK=$(mktemp -d /tmp/ysf2p25-gateway.XXXXXX)
+
+P25_PORT=42120
+BRIDGE_PORT=32110
+
+VOICE=$(awk "BEGIN { n = $LENGTH * 50; printf \"%.1f\", (n - n % 9) / 50 }")
+
+sed -e "s/^LocalPort=32010/LocalPort=$BRIDGE_PORT/" \
+    -e "s/^DstPort=42020/DstPort=$P25_PORT/" \
+    -e "s/^LocalPort=42015/LocalPort=42115/" \
+    -e "s/^DstPort=42000/DstPort=42100/" \
+    -e "s/^EnableWiresX=.*/EnableWiresX=0/" \
+    -e "s#^FilePath=.*#FilePath=$WORK#" \
+    -e "s#^TGListFile=.*#TGListFile=$DIR/TGList-P25.txt#" \
+    -e "s#^File=DMRIds.dat#File=$DIR/DMRIds.dat#" \
+    "$DIR/YSF2P25.ini" > "$WORK/YSF2P25.ini"
+
+cd "$WORK" || exit 1
+
+STATUS=0
+
+for MODE in 0 1 2; do
+	rm -f YSF2P25-*.log
+
+	"$DIR/YSF2P25" "$WORK/YSF2P25.ini" > bridge-$MODE.out 2>&1 &
+	BRIDGE=$!
+
+	sleep 1
+	"$DIR/P25Gateway" -p $P25_PORT -a 127.0.0.1 -P $BRIDGE_PORT -i $((LENGTH + 2)) -l $LENGTH -m $MODE -S $RUNTIME -t $RUNTIME > gateway-$MODE.out 2>&1
+
+	kill -TERM $BRIDGE
+	wait $BRIDGE
+
+	cat YSF2P25-*.log > bridge-$MODE.log
+
+	SENT=$(grep -h "calls, sent" gateway-$MODE.out | tail -1 | sed -e 's/^.* \([0-9]*\) calls, sent.*$/\1/')
+	WHOLE=$(grep -h -c "P25 received end of voice transmission, $VOICE seconds" bridge-$MODE.log)
+	ENDS=$(grep -h -c "P25 received end of voice transmission" bridge-$MODE.log)
+
+	echo "Mode $MODE: $SENT calls sent, $ENDS received, $WHOLE of them whole"
+
+	if [ "$SENT" != "$CALLS" ] || [ "$WHOLE" -ne "$CALLS" ]; then
+		STATUS=1
+	fi
+done
+
+echo "Logs are in $WORK"
+
+exit $STATUS
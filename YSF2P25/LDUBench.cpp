@@ -0,0 +1,733 @@
+/*
+ *   Copyright (C) 2019 by Manuel Sanchez EA7EE
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+// Checks the CP25LDU records against the 18 way switches they replaced,
+// then round trips calls through CP25Network over the loopback, both ways
+// and with and without coalescing, against what the old one record per
+// datagram code sent and read, and reads past whole batches from another
+// source. Times the assembly and parsing of both.
+
+#include "P25Network.h"
+#include "P25LDU.h"
+#include "Clock.h"
+#include "Log.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+const unsigned int CHECK_SUPERFRAMES = 100000U;
+const unsigned int CHECK_STREAM      = 1000000U;
+const unsigned int CHECK_CALLS       = 200U;
+const unsigned int CALL_SUPERFRAMES  = 5U;
+const unsigned int BENCH_RECORDS     = 10000000U;
+
+const unsigned int GATEWAY_PORT  = 42310U;
+const unsigned int BRIDGE_PORT   = 42311U;
+const unsigned int STRANGER_PORT = 42312U;
+
+// How long to wait for the loopback to deliver a superframe, in us
+const unsigned long long ROUND_TRIP_TIMEOUT = 1000000ULL;
+
+// The records as YSF2P25.cpp held them before CP25LDU
+const unsigned char REC62[] = {
+	0x62U, 0x02U, 0x02U, 0x0CU, 0x0BU, 0x12U, 0x64U, 0x00U, 0x00U, 0x80U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U,
+	0x00U, 0x00U, 0x00U, 0x00U, 0x00U};
+
+const unsigned char REC63[] = {
+	0x63U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x02U};
+
+const unsigned char REC64[] = {
+	0x64U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x02U};
+
+const unsigned char REC65[] = {
+	0x65U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x02U};
+
+const unsigned char REC66[] = {
+	0x66U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x02U};
+
+const unsigned char REC67[] = {
+	0x67U, 0xF0U, 0x9DU, 0x6AU, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x02U};
+
+const unsigned char REC68[] = {
+	0x68U, 0x19U, 0xD4U, 0x26U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x02U};
+
+const unsigned char REC69[] = {
+	0x69U, 0xE0U, 0xEBU, 0x7BU, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x02U};
+
+const unsigned char REC6A[] = {
+	0x6AU, 0x00U, 0x00U, 0x02U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U};
+
+const unsigned char REC6B[] = {
+	0x6BU, 0x02U, 0x02U, 0x0CU, 0x0BU, 0x12U, 0x64U, 0x00U, 0x00U, 0x80U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U,
+	0x00U, 0x00U, 0x00U, 0x00U, 0x00U};
+
+const unsigned char REC6C[] = {
+	0x6CU, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x02U};
+
+const unsigned char REC6D[] = {
+	0x6DU, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x02U};
+
+const unsigned char REC6E[] = {
+	0x6EU, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x02U};
+
+const unsigned char REC6F[] = {
+	0x6FU, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x02U};
+
+const unsigned char REC70[] = {
+	0x70U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x02U};
+
+const unsigned char REC71[] = {
+	0x71U, 0xACU, 0xB8U, 0xA4U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x02U};
+
+const unsigned char REC72[] = {
+	0x72U, 0x9BU, 0xDCU, 0x75U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x02U};
+
+const unsigned char REC73[] = {
+	0x73U, 0x00U, 0x00U, 0x02U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U};
+
+const unsigned char REC80[] = {
+	0x80U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U};
+
+// The writer's switch in CYSF2P25::run() before CP25LDU, returning the
+// length it passed to writeData()
+static unsigned int oldEncode(unsigned int p25step, const unsigned char* m_p25Frame, unsigned int m_srcid, unsigned int m_dstid, unsigned char* buffer)
+{
+	switch (p25step) {
+	case 0x00U:
+		::memcpy(buffer, REC62, 22U);
+		::memcpy(buffer + 10U, m_p25Frame, 11U);
+		return 22U;
+	case 0x01U:
+		::memcpy(buffer, REC63, 14U);
+		::memcpy(buffer + 1U, m_p25Frame, 11U);
+		return 14U;
+	case 0x02U:
+		::memcpy(buffer, REC64, 17U);
+		::memcpy(buffer + 5U, m_p25Frame, 11U);
+		buffer[1U] = 0x00U;
+		return 17U;
+	case 0x03U:
+		::memcpy(buffer, REC65, 17U);
+		::memcpy(buffer + 5U, m_p25Frame, 11U);
+		buffer[1U] = (m_dstid >> 16) & 0xFFU;
+		buffer[2U] = (m_dstid >> 8) & 0xFFU;
+		buffer[3U] = (m_dstid >> 0) & 0xFFU;
+		return 17U;
+	case 0x04U:
+		::memcpy(buffer, REC66, 17U);
+		::memcpy(buffer + 5U, m_p25Frame, 11U);
+		buffer[1U] = (m_srcid >> 16) & 0xFFU;
+		buffer[2U] = (m_srcid >> 8) & 0xFFU;
+		buffer[3U] = (m_srcid >> 0) & 0xFFU;
+		return 17U;
+	case 0x05U:
+		::memcpy(buffer, REC67, 17U);
+		::memcpy(buffer + 5U, m_p25Frame, 11U);
+		return 17U;
+	case 0x06U:
+		::memcpy(buffer, REC68, 17U);
+		::memcpy(buffer + 5U, m_p25Frame, 11U);
+		return 17U;
+	case 0x07U:
+		::memcpy(buffer, REC69, 17U);
+		::memcpy(buffer + 5U, m_p25Frame, 11U);
+		return 17U;
+	case 0x08U:
+		::memcpy(buffer, REC6A, 16U);
+		::memcpy(buffer + 4U, m_p25Frame, 11U);
+		return 16U;
+	case 0x09U:
+		::memcpy(buffer, REC6B, 22U);
+		::memcpy(buffer + 10U, m_p25Frame, 11U);
+		return 22U;
+	case 0x0AU:
+		::memcpy(buffer, REC6C, 14U);
+		::memcpy(buffer + 1U, m_p25Frame, 11U);
+		return 14U;
+	case 0x0BU:
+		::memcpy(buffer, REC6D, 17U);
+		::memcpy(buffer + 5U, m_p25Frame, 11U);
+		return 17U;
+	case 0x0CU:
+		::memcpy(buffer, REC6E, 17U);
+		::memcpy(buffer + 5U, m_p25Frame, 11U);
+		return 17U;
+	case 0x0DU:
+		::memcpy(buffer, REC6F, 17U);
+		::memcpy(buffer + 5U, m_p25Frame, 11U);
+		return 17U;
+	case 0x0EU:
+		::memcpy(buffer, REC70, 17U);
+		::memcpy(buffer + 5U, m_p25Frame, 11U);
+		buffer[1U] = 0x80U;
+		return 17U;
+	case 0x0FU:
+		::memcpy(buffer, REC71, 17U);
+		::memcpy(buffer + 5U, m_p25Frame, 11U);
+		return 17U;
+	case 0x10U:
+		::memcpy(buffer, REC72, 17U);
+		::memcpy(buffer + 5U, m_p25Frame, 11U);
+		return 17U;
+	case 0x11U:
+		::memcpy(buffer, REC73, 16U);
+		::memcpy(buffer + 4U, m_p25Frame, 11U);
+		return 16U;
+	default:
+		return 0U;
+	}
+}
+
+// Where CModeConv::putP25() took the IMBE frame from before CP25LDU, 0 for
+// a record it did not know, whose IMBE frame was left uninitialised
+static unsigned int oldIMBEOffset(unsigned char type)
+{
+	switch (type) {
+	case 0x62U:
+	case 0x6BU:
+		return 10U;
+	case 0x63U:
+	case 0x6CU:
+		return 1U;
+	case 0x64U:
+	case 0x65U:
+	case 0x66U:
+	case 0x67U:
+	case 0x68U:
+	case 0x69U:
+	case 0x6DU:
+	case 0x6EU:
+	case 0x6FU:
+	case 0x70U:
+	case 0x71U:
+	case 0x72U:
+		return 5U;
+	case 0x6AU:
+	case 0x73U:
+		return 4U;
+	default:
+		return 0U;
+	}
+}
+
+enum EVENT_TYPE {
+	EVENT_HEADER,
+	EVENT_DSTID,
+	EVENT_SRCID,
+	EVENT_EOT,
+	EVENT_IMBE
+};
+
+class CEvent {
+public:
+	EVENT_TYPE    m_type;
+	unsigned int  m_id;
+	unsigned char m_imbe[P25_IMBE_LENGTH_BYTES];
+
+	bool operator==(const CEvent& other) const
+	{
+		if (m_type != other.m_type)
+			return false;
+
+		if (m_type == EVENT_DSTID || m_type == EVENT_SRCID)
+			return m_id == other.m_id;
+
+		if (m_type == EVENT_IMBE)
+			return ::memcmp(m_imbe, other.m_imbe, P25_IMBE_LENGTH_BYTES) == 0;
+
+		return true;
+	}
+};
+
+static void addEvent(std::vector<CEvent>& events, EVENT_TYPE type, unsigned int id = 0U, const unsigned char* imbe = NULL)
+{
+	CEvent event;
+	event.m_type = type;
+	event.m_id   = id;
+
+	if (imbe != NULL)
+		::memcpy(event.m_imbe, imbe, P25_IMBE_LENGTH_BYTES);
+
+	events.push_back(event);
+}
+
+// The receive loop of CYSF2P25::run() before CP25LDU. Records it did not
+// know were still pushed as IMBE, those are counted in unknown instead.
+class COldReceiver {
+public:
+	COldReceiver() :
+	m_info(false),
+	m_unknown(0U)
+	{
+	}
+
+	void process(const unsigned char* m_p25Frame, std::vector<CEvent>& events)
+	{
+		if (m_p25Frame[0U] != 0xF0U && m_p25Frame[0U] != 0xF1U) {
+			if (m_p25Frame[0U] == 0x62U && !m_info) {
+				addEvent(events, EVENT_HEADER);
+			} else if (m_p25Frame[0U] == 0x65U && !m_info) {
+				unsigned int dstId;
+				dstId  = (m_p25Frame[1U] << 16) & 0xFF0000U;
+				dstId |= (m_p25Frame[2U] << 8)  & 0x00FF00U;
+				dstId |= (m_p25Frame[3U] << 0)  & 0x0000FFU;
+				addEvent(events, EVENT_DSTID, dstId);
+			} else if (m_p25Frame[0U] == 0x66U && !m_info) {
+				unsigned int srcId;
+				srcId  = (m_p25Frame[1U] << 16) & 0xFF0000U;
+				srcId |= (m_p25Frame[2U] << 8)  & 0x00FF00U;
+				srcId |= (m_p25Frame[3U] << 0)  & 0x0000FFU;
+				addEvent(events, EVENT_SRCID, srcId);
+				m_info = true;
+			} else if (m_p25Frame[0U] == 0x80U) {
+				addEvent(events, EVENT_EOT);
+				m_info = false;
+			}
+
+			unsigned int offset = oldIMBEOffset(m_p25Frame[0U]);
+			if (offset > 0U)
+				addEvent(events, EVENT_IMBE, 0U, m_p25Frame + offset);
+			else
+				m_unknown++;
+		}
+	}
+
+	unsigned int getUnknown() const
+	{
+		return m_unknown;
+	}
+
+private:
+	bool         m_info;
+	unsigned int m_unknown;
+};
+
+// The receive loop of CYSF2P25::run() now
+class CNewReceiver {
+public:
+	CNewReceiver() :
+	m_info(false)
+	{
+	}
+
+	void process(const unsigned char* data, std::vector<CEvent>& events)
+	{
+		if (data[0U] == 0xF0U || data[0U] == 0xF1U)
+			return;
+
+		if (data[0U] == 0x80U) {
+			addEvent(events, EVENT_EOT);
+			m_info = false;
+			return;
+		}
+
+		const CP25Record* record = CP25LDU::find(data[0U]);
+		if (record == NULL)
+			return;
+
+		if (!m_info) {
+			if (record->m_start) {
+				addEvent(events, EVENT_HEADER);
+			} else if (record->m_lc == P25_RECORD_LC_DSTID) {
+				addEvent(events, EVENT_DSTID, CP25LDU::getId(data));
+			} else if (record->m_lc == P25_RECORD_LC_SRCID) {
+				addEvent(events, EVENT_SRCID, CP25LDU::getId(data));
+				m_info = true;
+			}
+		}
+
+		addEvent(events, EVENT_IMBE, 0U, data + record->m_imbe);
+	}
+
+private:
+	bool m_info;
+};
+
+static void randomIMBE(unsigned char* imbe)
+{
+	for (unsigned int i = 0U; i < P25_IMBE_LENGTH_BYTES; i++)
+		imbe[i] = ::rand();
+}
+
+static unsigned int checkEncode()
+{
+	unsigned int failures = 0U;
+
+	for (unsigned int i = 0U; i < CHECK_SUPERFRAMES; i++) {
+		unsigned int srcId = ::rand() & 0xFFFFFFU;
+		unsigned int dstId = ::rand() & 0xFFFFFFU;
+
+		for (unsigned int n = 0U; n < P25_LDU_RECORDS; n++) {
+			unsigned char imbe[P25_IMBE_LENGTH_BYTES];
+			randomIMBE(imbe);
+
+			unsigned char expected[P25_LDU_RECORD_MAX_LENGTH], actual[P25_LDU_RECORD_MAX_LENGTH];
+			unsigned int oldLength = oldEncode(n, imbe, srcId, dstId, expected);
+			unsigned int newLength = CP25LDU::encode(n, imbe, srcId, dstId, actual);
+
+			if (oldLength != newLength || ::memcmp(expected, actual, oldLength) != 0) {
+				if (failures < 5U)
+					::printf("Record %u differs\n", n);
+				failures++;
+			}
+		}
+	}
+
+	::printf("Encode: %u records checked, %u differences\n", CHECK_SUPERFRAMES * P25_LDU_RECORDS, failures);
+
+	return failures;
+}
+
+// Voice records mixed with polls, terminators and records of any type
+static unsigned int checkParse()
+{
+	COldReceiver oldReceiver;
+	CNewReceiver newReceiver;
+
+	unsigned int failures = 0U;
+
+	for (unsigned int i = 0U; i < CHECK_STREAM; i++) {
+		unsigned char record[P25_LDU_RECORD_MAX_LENGTH];
+		for (unsigned int j = 0U; j < P25_LDU_RECORD_MAX_LENGTH; j++)
+			record[j] = ::rand();
+
+		switch (::rand() % 8U) {
+		case 0U:
+			break;
+		case 1U:
+			record[0U] = (::rand() % 2U) == 0U ? 0x80U : 0xF0U + (::rand() % 2U);
+			break;
+		default:
+			record[0U] = 0x62U + (::rand() % P25_LDU_RECORDS);
+			break;
+		}
+
+		std::vector<CEvent> expected, actual;
+		oldReceiver.process(record, expected);
+		newReceiver.process(record, actual);
+
+		if (expected != actual) {
+			if (failures < 5U)
+				::printf("Record type %02X parses differently\n", record[0U]);
+			failures++;
+		}
+	}
+
+	::printf("Parse: %u records checked, %u differences, %u not voice records the old code pushed as IMBE\n", CHECK_STREAM, failures, oldReceiver.getUnknown());
+
+	return failures;
+}
+
+// The records of one call, each with its length, as the old writer sent them
+static void makeCall(std::vector<std::vector<unsigned char> >& records)
+{
+	unsigned int srcId = ::rand() & 0xFFFFFFU;
+	unsigned int dstId = ::rand() & 0xFFFFFFU;
+
+	for (unsigned int n = 0U; n < CALL_SUPERFRAMES * P25_LDU_RECORDS; n++) {
+		unsigned char imbe[P25_IMBE_LENGTH_BYTES];
+		randomIMBE(imbe);
+
+		unsigned char buffer[P25_LDU_RECORD_MAX_LENGTH];
+		unsigned int length = oldEncode(n % P25_LDU_RECORDS, imbe, srcId, dstId, buffer);
+		records.push_back(std::vector<unsigned char>(buffer, buffer + length));
+	}
+
+	records.push_back(std::vector<unsigned char>(REC80, REC80 + 17U));
+}
+
+// Bridge to gateway, the stream the gateway reads must be the records the
+// old writer sent, in one datagram each, or back to back when coalescing
+static unsigned int checkWrite(CUDPSocket& gateway, bool coalesce)
+{
+	CP25Network bridge("127.0.0.1", BRIDGE_PORT, "127.0.0.1", GATEWAY_PORT, "BENCH", coalesce, false);
+	if (!bridge.open())
+		return 1U;
+
+	unsigned int failures = 0U;
+	unsigned int datagrams = 0U;
+
+	for (unsigned int call = 0U; call < CHECK_CALLS; call++) {
+		std::vector<std::vector<unsigned char> > records;
+		makeCall(records);
+
+		std::vector<unsigned char> expected;
+		std::vector<unsigned char> actual;
+
+		// One LDU at a time, the terminator with the last one, as writeP25LDU() does
+		unsigned int next = 0U;
+		while (next < records.size()) {
+			unsigned char buffer[P25_LDU_DATAGRAM_MAX_LENGTH];
+			unsigned int lengths[P25_LDU_RECORDS + 1U];
+			unsigned int count = 0U;
+			unsigned int offset = 0U;
+
+			unsigned int last = next + P25_LDU_FRAMES;
+			if (records.size() - last == 1U)
+				last++;
+
+			for (; next < last && next < records.size(); next++) {
+				::memcpy(buffer + offset, &records[next][0U], records[next].size());
+				lengths[count++] = records[next].size();
+				offset += records[next].size();
+				expected.insert(expected.end(), records[next].begin(), records[next].end());
+			}
+
+			bridge.writeLDU(buffer, lengths, count);
+
+			unsigned int wanted = coalesce ? 1U : count;
+			unsigned int received = 0U;
+
+			unsigned long long start = CClock::getTime();
+			while (received < wanted && (CClock::getTime() - start) < ROUND_TRIP_TIMEOUT) {
+				unsigned char datagram[P25_LDU_DATAGRAM_MAX_LENGTH];
+				in_addr address;
+				unsigned int port;
+				int length = gateway.read(datagram, P25_LDU_DATAGRAM_MAX_LENGTH, address, port);
+				if (length <= 0)
+					continue;
+
+				// Without coalescing every datagram is one record
+				if (!coalesce && (unsigned int)length != lengths[received])
+					failures++;
+
+				actual.insert(actual.end(), datagram, datagram + length);
+				received++;
+			}
+
+			if (received != wanted)
+				failures++;
+
+			datagrams += received;
+		}
+
+		if (expected != actual)
+			failures++;
+	}
+
+	bridge.close();
+
+	::printf("Write %s: %u calls, %u datagrams, %u differences\n", coalesce ? "coalesced" : "batched", CHECK_CALLS, datagrams, failures);
+
+	return failures;
+}
+
+// Gateway to bridge, readLDU() must hand the receive loop the records the
+// old readData() did, whether the gateway sends them one by one or whole
+// LDUs in one datagram
+static unsigned int checkRead(CUDPSocket& gateway, bool coalesce)
+{
+	CP25Network bridge("127.0.0.1", BRIDGE_PORT, "127.0.0.1", GATEWAY_PORT, "BENCH", false, false);
+	if (!bridge.open())
+		return 1U;
+
+	in_addr address = CUDPSocket::lookup("127.0.0.1");
+
+	unsigned int failures = 0U;
+	unsigned int total = 0U;
+
+	for (unsigned int call = 0U; call < CHECK_CALLS; call++) {
+		std::vector<std::vector<unsigned char> > records;
+		makeCall(records);
+
+		COldReceiver oldReceiver;
+		CNewReceiver newReceiver;
+		std::vector<CEvent> expected, actual;
+
+		for (unsigned int i = 0U; i < records.size(); i++)
+			oldReceiver.process(&records[i][0U], expected);
+
+		unsigned int next = 0U;
+		while (next < records.size()) {
+			unsigned int first = next;
+			unsigned int last  = next + P25_LDU_FRAMES;
+			if (last > records.size())
+				last = records.size();
+
+			std::vector<unsigned char> datagram;
+			for (next = first; next < last; next++) {
+				if (coalesce)
+					datagram.insert(datagram.end(), records[next].begin(), records[next].end());
+				else
+					gateway.write(&records[next][0U], records[next].size(), address, BRIDGE_PORT);
+			}
+
+			if (coalesce)
+				gateway.write(&datagram[0U], datagram.size(), address, BRIDGE_PORT);
+
+			unsigned int received = 0U;
+
+			unsigned long long start = CClock::getTime();
+			while (received < (last - first) && (CClock::getTime() - start) < ROUND_TRIP_TIMEOUT) {
+				unsigned char data[P25_LDU_RECORDS * P25_LDU_RECORD_MAX_LENGTH];
+				unsigned int lengths[P25_LDU_RECORDS];
+				unsigned int count = bridge.readLDU(data, lengths, P25_LDU_RECORDS);
+
+				for (unsigned int i = 0U; i < count; i++, received++) {
+					const unsigned char* record = data + i * P25_LDU_RECORD_MAX_LENGTH;
+					const std::vector<unsigned char>& sent = records[first + received];
+
+					if (first + received >= last || lengths[i] != sent.size() || ::memcmp(record, &sent[0U], lengths[i]) != 0) {
+						failures++;
+						continue;
+					}
+
+					newReceiver.process(record, actual);
+				}
+			}
+
+			if (received != (last - first))
+				failures++;
+
+			total += received;
+		}
+
+		if (expected != actual)
+			failures++;
+	}
+
+	bridge.close();
+
+	::printf("Read %s: %u calls, %u records, %u differences\n", coalesce ? "coalesced" : "one per datagram", CHECK_CALLS, total, failures);
+
+	return failures;
+}
+
+// Whole batches from another source queued ahead of a record from the
+// gateway, one readLDU() must still return the record
+static unsigned int checkStranger(CUDPSocket& gateway)
+{
+	CP25Network bridge("127.0.0.1", BRIDGE_PORT, "127.0.0.1", GATEWAY_PORT, "BENCH", false, false);
+	if (!bridge.open())
+		return 1U;
+
+	CUDPSocket stranger("127.0.0.1", STRANGER_PORT);
+	if (!stranger.open()) {
+		bridge.close();
+		return 1U;
+	}
+
+	in_addr address = CUDPSocket::lookup("127.0.0.1");
+
+	// Only the invalid source messages, one per stranger datagram
+	LogInitialise(".", "LDUBench", 0U, 4U);
+
+	unsigned int failures = 0U;
+
+	for (unsigned int call = 0U; call < CHECK_CALLS; call++) {
+		unsigned int batches = (call % 3U) + 1U;
+		for (unsigned int i = 0U; i < batches * UDP_BATCH_MAX; i++)
+			stranger.write(REC80, 17U, address, BRIDGE_PORT);
+
+		gateway.write(REC62, 22U, address, BRIDGE_PORT);
+
+		// Let the loopback queue the lot before the single read
+		unsigned long long start = CClock::getTime();
+		while ((CClock::getTime() - start) < 2000ULL)
+			;
+
+		unsigned char data[P25_LDU_RECORDS * P25_LDU_RECORD_MAX_LENGTH];
+		unsigned int lengths[P25_LDU_RECORDS];
+		unsigned int count = bridge.readLDU(data, lengths, P25_LDU_RECORDS);
+
+		if (count != 1U || lengths[0U] != 22U || ::memcmp(data, REC62, 22U) != 0)
+			failures++;
+
+		// Nothing from the stranger is left behind for the next call
+		if (bridge.readLDU(data, lengths, P25_LDU_RECORDS) != 0U)
+			failures++;
+	}
+
+	LogInitialise(".", "LDUBench", 0U, 2U);
+
+	stranger.close();
+	bridge.close();
+
+	::printf("Read past other sources: %u calls behind 1 to 3 whole batches, %u differences\n", CHECK_CALLS, failures);
+
+	return failures;
+}
+
+int main()
+{
+	::srand(2500U);
+
+	unsigned int failures = 0U;
+
+	failures += checkEncode();
+	failures += checkParse();
+
+	CUDPSocket gateway("127.0.0.1", GATEWAY_PORT);
+	if (gateway.open()) {
+		failures += checkWrite(gateway, false);
+		failures += checkWrite(gateway, true);
+		failures += checkRead(gateway, false);
+		failures += checkRead(gateway, true);
+		failures += checkStranger(gateway);
+		gateway.close();
+	} else {
+		::printf("Cannot open the gateway port, the round trips were not run\n");
+		failures++;
+	}
+
+	unsigned char imbe[P25_IMBE_LENGTH_BYTES];
+	randomIMBE(imbe);
+
+	unsigned char (*buffers)[P25_LDU_RECORD_MAX_LENGTH] = new unsigned char[P25_LDU_RECORDS][P25_LDU_RECORD_MAX_LENGTH];
+
+	// The sum keeps the compiler from dropping the work
+	unsigned int sum = 0U;
+
+	unsigned long long start = CClock::getTime();
+	for (unsigned int i = 0U; i < BENCH_RECORDS; i++) {
+		unsigned int n = i % P25_LDU_RECORDS;
+		sum += oldEncode(n, imbe, i, i, buffers[n]) + buffers[n][1U];
+	}
+	unsigned long long oldAssembly = CClock::getTime() - start;
+
+	start = CClock::getTime();
+	for (unsigned int i = 0U; i < BENCH_RECORDS; i++) {
+		unsigned int n = i % P25_LDU_RECORDS;
+		sum -= CP25LDU::encode(n, imbe, i, i, buffers[n]) + buffers[n][1U];
+	}
+	unsigned long long newAssembly = CClock::getTime() - start;
+
+	start = CClock::getTime();
+	for (unsigned int i = 0U; i < BENCH_RECORDS; i++) {
+		const unsigned char* record = buffers[i % P25_LDU_RECORDS];
+		sum += record[oldIMBEOffset(record[0U])];
+	}
+	unsigned long long oldParse = CClock::getTime() - start;
+
+	start = CClock::getTime();
+	for (unsigned int i = 0U; i < BENCH_RECORDS; i++) {
+		const unsigned char* record = buffers[i % P25_LDU_RECORDS];
+		sum -= record[CP25LDU::find(record[0U])->m_imbe];
+	}
+	unsigned long long newParse = CClock::getTime() - start;
+
+	delete[] buffers;
+
+	double perRecord = 1000.0 / BENCH_RECORDS;
+	::printf("Assembly: %.1f ns/record switch, %.1f ns/record table\n", double(oldAssembly) * perRecord, double(newAssembly) * perRecord);
+	::printf("IMBE lookup: %.1f ns/record switch, %.1f ns/record table\n", double(oldParse) * perRecord, double(newParse) * perRecord);
+
+	return (failures == 0U && sum == 0U) ? 0 : 1;
+}
@@ -22,13 +22,15 @@
 #include "Golay24128.h"
 #include "Hamming.h"
 #include "Utils.h"
+#include "ECCTables.h"
 
 #include "Log.h"
 
 #include <cstdio>
 #include <cassert>
+#include <cstdint>
 
-const unsigned int IMBE_INTERLEAVE[] = {
+constexpr unsigned int IMBE_INTERLEAVE[] = {
 	0,  7, 12, 19, 24, 31, 36, 43, 48, 55, 60, 67, 72, 79, 84, 91,  96, 103, 108, 115, 120, 127, 132, 139,
 	1,  6, 13, 18, 25, 30, 37, 42, 49, 54, 61, 66, 73, 78, 85, 90,  97, 102, 109, 114, 121, 126, 133, 138,
 	2,  9, 14, 21, 26, 33, 38, 45, 50, 57, 62, 69, 74, 81, 86, 93,  98, 105, 110, 117, 122, 129, 134, 141,
@@ -39,10 +41,121 @@ const unsigned int IMBE_INTERLEAVE[] = {
 // Unpacked IMBE silence
 const unsigned char IMBE_SILENCE[] = {0x04U, 0x0CU, 0xFDU, 0x7BU, 0xFBU, 0x7DU, 0xF2U, 0x7BU, 0x3DU, 0x9EU, 0x44};
 
-const unsigned char BIT_MASK_TABLE[] = {0x80U, 0x40U, 0x20U, 0x10U, 0x08U, 0x04U, 0x02U, 0x01U};
+// The 144 bits of a VCH, both as sent and de-interleaved, are handled as
+// five 32 bit words, most significant bit first.
+const unsigned int IMBE_WORDS = 5U;
 
-#define WRITE_BIT(p,i,b) p[(i)>>3] = (b) ? (p[(i)>>3] | BIT_MASK_TABLE[(i)&7]) : (p[(i)>>3] & ~BIT_MASK_TABLE[(i)&7])
-#define READ_BIT(p,i)    (p[(i)>>3] & BIT_MASK_TABLE[(i)&7])
+const unsigned int IMBE_NIBBLES = 36U;
+
+// For each nibble of the input and each of its values, the bits it sets in
+// the output, so interleaving is 36 lookups rather than 144 single bits.
+static constexpr CECCTable<unsigned int, IMBE_NIBBLES * 16U * IMBE_WORDS> makePermutationTable(bool interleave)
+{
+	CECCTable<unsigned int, IMBE_NIBBLES * 16U * IMBE_WORDS> table = {};
+
+	for (unsigned int i = 0U; i < 144U; i++) {
+		unsigned int from = interleave ? i : IMBE_INTERLEAVE[i];
+		unsigned int to   = interleave ? IMBE_INTERLEAVE[i] : i;
+
+		unsigned int nibble = from / 4U;
+		unsigned int shift  = 3U - (from % 4U);
+
+		for (unsigned int value = 0U; value < 16U; value++) {
+			if ((value >> shift) & 0x01U)
+				table.m_data[(nibble * 16U + value) * IMBE_WORDS + to / 32U] |= 0x80000000U >> (to % 32U);
+		}
+	}
+
+	return table;
+}
+
+// The 114 bit whitening vector for each value of c0, packed into four words
+static constexpr CECCTable<unsigned int, 4096U * 4U> makeWhiteningTable()
+{
+	CECCTable<unsigned int, 4096U * 4U> table = {};
+
+	for (unsigned int c0 = 0U; c0 < 4096U; c0++) {
+		unsigned int p = 16U * c0;
+		for (unsigned int i = 0U; i < 114U; i++) {
+			p = (173U * p + 13849U) % 65536U;
+			if (p >= 32768U)
+				table.m_data[c0 * 4U + i / 32U] |= 0x80000000U >> (i % 32U);
+		}
+	}
+
+	return table;
+}
+
+static constexpr CECCTable<unsigned int, IMBE_NIBBLES * 16U * IMBE_WORDS> INTERLEAVE_TABLE   = makePermutationTable(true);
+static constexpr CECCTable<unsigned int, IMBE_NIBBLES * 16U * IMBE_WORDS> DEINTERLEAVE_TABLE = makePermutationTable(false);
+static constexpr CECCTable<unsigned int, 4096U * 4U> WHITENING_TABLE = makeWhiteningTable();
+
+static_assert(INTERLEAVE_TABLE.checksum() == 0x4A45F6FDU, "INTERLEAVE_TABLE has changed");
+static_assert(DEINTERLEAVE_TABLE.checksum() == 0x5245DBC5U, "DEINTERLEAVE_TABLE has changed");
+static_assert(WHITENING_TABLE.checksum() == 0xB0788A05U, "WHITENING_TABLE has changed");
+
+static void bytesToWords(const unsigned char* bytes, unsigned int length, unsigned int* words)
+{
+	for (unsigned int i = 0U; i < IMBE_WORDS; i++)
+		words[i] = 0U;
+
+	for (unsigned int i = 0U; i < length; i++)
+		words[i / 4U] |= bytes[i] << (24U - (i % 4U) * 8U);
+}
+
+static void wordsToBytes(const unsigned int* words, unsigned int length, unsigned char* bytes)
+{
+	for (unsigned int i = 0U; i < length; i++)
+		bytes[i] = words[i / 4U] >> (24U - (i % 4U) * 8U);
+}
+
+static unsigned int getBits(const unsigned int* words, unsigned int pos, unsigned int length)
+{
+	unsigned int n = pos / 32U;
+
+	uint64_t value = uint64_t(words[n]) << 32;
+	if (n + 1U < IMBE_WORDS)
+		value |= words[n + 1U];
+
+	return (unsigned int)(value >> (64U - (pos % 32U) - length)) & ((1U << length) - 1U);
+}
+
+static void setBits(unsigned int* words, unsigned int pos, unsigned int length, unsigned int bits)
+{
+	unsigned int n = pos / 32U;
+
+	uint64_t value = uint64_t(bits) << (64U - (pos % 32U) - length);
+
+	words[n] |= (unsigned int)(value >> 32);
+	if (n + 1U < IMBE_WORDS)
+		words[n + 1U] |= (unsigned int)value;
+}
+
+static void permute(const CECCTable<unsigned int, IMBE_NIBBLES * 16U * IMBE_WORDS>& table, const unsigned int* in, unsigned int* out)
+{
+	for (unsigned int i = 0U; i < IMBE_WORDS; i++)
+		out[i] = 0U;
+
+	for (unsigned int i = 0U; i < IMBE_NIBBLES; i++) {
+		unsigned int value = (in[i / 8U] >> (28U - (i % 8U) * 4U)) & 0x0FU;
+
+		const unsigned int* bits = &table[(i * 16U + value) * IMBE_WORDS];
+		for (unsigned int j = 0U; j < IMBE_WORDS; j++)
+			out[j] |= bits[j];
+	}
+}
+
+// The whitening vector covers bits 23 to 136
+static void whiten(unsigned int* bits, unsigned int c0)
+{
+	const unsigned int* prn = &WHITENING_TABLE[c0 * 4U];
+
+	bits[0U] ^= prn[0U] >> 23;
+	bits[1U] ^= (prn[0U] << 9) | (prn[1U] >> 23);
+	bits[2U] ^= (prn[1U] << 9) | (prn[2U] >> 23);
+	bits[3U] ^= (prn[2U] << 9) | (prn[3U] >> 23);
+	bits[4U] ^= prn[3U] << 9;
+}
 
 CModeConv::CModeConv() :
 m_ysfN(0U),
@@ -56,70 +169,9 @@ CModeConv::~CModeConv()
 {
 }
 
-void CModeConv::putP25(unsigned char* data)
+void CModeConv::putP25(const unsigned char* imbe)
 {
-	assert(data != NULL);
-
-	unsigned char imbe[20U];
-
-	switch (data[0U]) {
-	case 0x62U:
-		::memcpy(imbe, data + 10U, 11U);
-		break;
-	case 0x63U:
-		::memcpy(imbe, data + 1U, 11U);
-		break;
-	case 0x64U:
-		::memcpy(imbe, data + 5U, 11U);
-		break;
-	case 0x65U:
-		::memcpy(imbe, data + 5U, 11U);
-		break;
-	case 0x66U:
-		::memcpy(imbe, data + 5U, 11U);
-		break;
-	case 0x67U:
-		::memcpy(imbe, data + 5U, 11U);
-		break;
-	case 0x68U:
-		::memcpy(imbe, data + 5U, 11U);
-		break;
-	case 0x69U:
-		::memcpy(imbe, data + 5U, 11U);
-		break;
-	case 0x6AU:
-		::memcpy(imbe, data + 4U, 11U);
-		break;
-	case 0x6BU:
-		::memcpy(imbe, data + 10U, 11U);
-		break;
-	case 0x6CU:
-		::memcpy(imbe, data + 1U, 11U);
-		break;
-	case 0x6DU:
-		::memcpy(imbe, data + 5U, 11U);
-		break;
-	case 0x6EU:
-		::memcpy(imbe, data + 5U, 11U);
-		break;
-	case 0x6FU:
-		::memcpy(imbe, data + 5U, 11U);
-		break;
-	case 0x70U:
-		::memcpy(imbe, data + 5U, 11U);
-		break;
-	case 0x71U:
-		::memcpy(imbe, data + 5U, 11U);
-		break;
-	case 0x72U:
-		::memcpy(imbe, data + 5U, 11U);
-		break;
-	case 0x73U:
-		::memcpy(imbe, data + 4U, 11U);
-		break;
-	default:
-		break;
-	}
+	assert(imbe != NULL);
 
 	m_YSF.addData(&TAG_DATA, 1U);
 	m_YSF.addData(imbe, 11U);
@@ -289,13 +341,12 @@ unsigned int CModeConv::getYSF(unsigned char* data)
 
 void CModeConv::decode(const unsigned char* data, unsigned char* imbe)
 {
-	bool bit[144U];
+	unsigned int frame[IMBE_WORDS];
+	bytesToWords(data, 18U, frame);
 
 	// De-interleave
-	for (unsigned int i = 0U; i < 144U; i++) {
-		unsigned int n = IMBE_INTERLEAVE[i];
-		bit[i] = READ_BIT(data, n);
-	}
+	unsigned int bit[IMBE_WORDS];
+	permute(DEINTERLEAVE_TABLE, frame, bit);
 
 	// now ..
 
@@ -323,40 +374,22 @@ void CModeConv::decode(const unsigned char* data, unsigned char* imbe)
 	//  7 voice bits     137
 
 	// c0
-	unsigned int c0data = 0U;
-	for (unsigned int i = 0U; i < 12U; i++)
-		c0data = (c0data << 1) | (bit[i] ? 0x01U : 0x00U);
-
-	bool prn[114U];
-
-	// Create the whitening vector and save it for future use
-	unsigned int p = 16U * c0data;
-	for (unsigned int i = 0U; i < 114U; i++) {
-		p = (173U * p + 13849U) % 65536U;
-		prn[i] = p >= 32768U;
-	}
+	unsigned int c0data = getBits(bit, 0U, 12U);
 
 	// De-whiten some bits
-	for (unsigned int i = 0U; i < 114U; i++)
-		bit[i + 23U] ^= prn[i];
-
-	unsigned int offset = 0U;
-	for (unsigned int i = 0U; i < 12U; i++, offset++)
-		WRITE_BIT(imbe, offset, bit[i + 0U]);
-	for (unsigned int i = 0U; i < 12U; i++, offset++)
-		WRITE_BIT(imbe, offset, bit[i + 23U]);
-	for (unsigned int i = 0U; i < 12U; i++, offset++)
-		WRITE_BIT(imbe, offset, bit[i + 46U]);
-	for (unsigned int i = 0U; i < 12U; i++, offset++)
-		WRITE_BIT(imbe, offset, bit[i + 69U]);
-	for (unsigned int i = 0U; i < 11U; i++, offset++)
-		WRITE_BIT(imbe, offset, bit[i + 92U]);
-	for (unsigned int i = 0U; i < 11U; i++, offset++)
-		WRITE_BIT(imbe, offset, bit[i + 107U]);
-	for (unsigned int i = 0U; i < 11U; i++, offset++)
-		WRITE_BIT(imbe, offset, bit[i + 122U]);
-	for (unsigned int i = 0U; i < 7U; i++, offset++)
-		WRITE_BIT(imbe, offset, bit[i + 137U]);
+	whiten(bit, c0data);
+
+	unsigned int out[IMBE_WORDS] = {0U};
+	setBits(out, 0U,  12U, c0data);
+	setBits(out, 12U, 12U, getBits(bit, 23U,  12U));
+	setBits(out, 24U, 12U, getBits(bit, 46U,  12U));
+	setBits(out, 36U, 12U, getBits(bit, 69U,  12U));
+	setBits(out, 48U, 11U, getBits(bit, 92U,  11U));
+	setBits(out, 59U, 11U, getBits(bit, 107U, 11U));
+	setBits(out, 70U, 11U, getBits(bit, 122U, 11U));
+	setBits(out, 81U, 7U,  getBits(bit, 137U, 7U));
+
+	wordsToBytes(out, 11U, imbe);
 }
 
 void CModeConv::encode(unsigned char* data, const unsigned char* imbe)
@@ -364,99 +397,28 @@ void CModeConv::encode(unsigned char* data, const unsigned char* imbe)
 	assert(data != NULL);
 	assert(imbe != NULL);
 
-	bool bTemp[144U];
-	bool* bit = bTemp;
+	unsigned int in[IMBE_WORDS];
+	bytesToWords(imbe, 11U, in);
 
-	// c0
-	unsigned int c0 = 0U;
-	for (unsigned int i = 0U; i < 12U; i++) {
-		bool b = READ_BIT(imbe, i);
-		c0 = (c0 << 1) | (b ? 0x01U : 0x00U);
-	}
-	unsigned int g2 = CGolay24128::encode23127(c0);
-	for (int i = 23; i >= 0; i--) {
-		bit[i] = (g2 & 0x01U) == 0x01U;
-		g2 >>= 1;
-	}
-	bit += 23U;
+	unsigned int c0 = getBits(in, 0U, 12U);
 
-	// c1
-	unsigned int c1 = 0U;
-	for (unsigned int i = 12U; i < 24U; i++) {
-		bool b = READ_BIT(imbe, i);
-		c1 = (c1 << 1) | (b ? 0x01U : 0x00U);
-	}
-	g2 = CGolay24128::encode23127(c1);
-	for (int i = 23; i >= 0; i--) {
-		bit[i] = (g2 & 0x01U) == 0x01U;
-		g2 >>= 1;
-	}
-	bit += 23U;
-
-	// c2
-	unsigned int c2 = 0;
-	for (unsigned int i = 24U; i < 36U; i++) {
-		bool b = READ_BIT(imbe, i);
-		c2 = (c2 << 1) | (b ? 0x01U : 0x00U);
-	}
-	g2 = CGolay24128::encode23127(c2);
-	for (int i = 23; i >= 0; i--) {
-		bit[i] = (g2 & 0x01U) == 0x01U;
-		g2 >>= 1;
-	}
-	bit += 23U;
-
-	// c3
-	unsigned int c3 = 0U;
-	for (unsigned int i = 36U; i < 48U; i++) {
-		bool b = READ_BIT(imbe, i);
-		c3 = (c3 << 1) | (b ? 0x01U : 0x00U);
-	}
-	g2 = CGolay24128::encode23127(c3);
-	for (int i = 23; i >= 0; i--) {
-		bit[i] = (g2 & 0x01U) == 0x01U;
-		g2 >>= 1;
-	}
-	bit += 23U;
-
-	// c4
-	for (unsigned int i = 0U; i < 11U; i++)
-		bit[i] = READ_BIT(imbe, i + 48U);
-	CHamming::encode15113_1(bit);
-	bit += 15U;
-
-	// c5
-	for (unsigned int i = 0U; i < 11U; i++)
-		bit[i] = READ_BIT(imbe, i + 59U);
-	CHamming::encode15113_1(bit);
-	bit += 15U;
-
-	// c6
-	for (unsigned int i = 0U; i < 11U; i++)
-		bit[i] = READ_BIT(imbe, i + 70U);
-	CHamming::encode15113_1(bit);
-	bit += 15U;
-
-	// c7
-	for (unsigned int i = 0U; i < 7U; i++)
-		bit[i] = READ_BIT(imbe, i + 81U);
-
-	bool prn[114U];
-
-	// Create the whitening vector and save it for future use
-	unsigned int p = 16U * c0;
-	for (unsigned int i = 0U; i < 114U; i++) {
-		p = (173U * p + 13849U) % 65536U;
-		prn[i] = p >= 32768U;
-	}
+	// encode23127() returns the codeword shifted up by one bit
+	unsigned int bit[IMBE_WORDS] = {0U};
+	setBits(bit, 0U,   23U, CGolay24128::encode23127(c0) >> 1);
+	setBits(bit, 23U,  23U, CGolay24128::encode23127(getBits(in, 12U, 12U)) >> 1);
+	setBits(bit, 46U,  23U, CGolay24128::encode23127(getBits(in, 24U, 12U)) >> 1);
+	setBits(bit, 69U,  23U, CGolay24128::encode23127(getBits(in, 36U, 12U)) >> 1);
+	setBits(bit, 92U,  15U, CHamming::encode15113_1(getBits(in, 48U, 11U)));
+	setBits(bit, 107U, 15U, CHamming::encode15113_1(getBits(in, 59U, 11U)));
+	setBits(bit, 122U, 15U, CHamming::encode15113_1(getBits(in, 70U, 11U)));
+	setBits(bit, 137U, 7U,  getBits(in, 81U, 7U));
 
 	// Whiten some bits
-	for (unsigned int i = 0U; i < 114U; i++)
-		bTemp[i + 23U] ^= prn[i];
+	whiten(bit, c0);
 
 	// Interleave
-	for (unsigned int i = 0U; i < 144U; i++) {
-		unsigned int n = IMBE_INTERLEAVE[i];
-		WRITE_BIT(data, n, bTemp[i]);
-	}
+	unsigned int frame[IMBE_WORDS];
+	permute(INTERLEAVE_TABLE, bit, frame);
+
+	wordsToBytes(frame, 18U, data);
 }
@@ -29,7 +29,7 @@ public:
 	CModeConv();
 	~CModeConv();
 
-	void putP25(unsigned char* data);
+	void putP25(const unsigned char* imbe);
 	void putP25Header();
 	void putP25EOT();
 
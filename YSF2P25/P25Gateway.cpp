@@ -0,0 +1,337 @@
+/*
+ *   Copyright (C) 2019 by Manuel Sanchez EA7EE
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#include "P25Gateway.h"
+#include "P25Defines.h"
+#include "StopWatch.h"
+#include "P25LDU.h"
+#include "Thread.h"
+#include "Timer.h"
+#include "Log.h"
+
+#if !defined(_WIN32) && !defined(_WIN64)
+#include <signal.h>
+#endif
+
+#include <cassert>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+const unsigned int RECORD_PERIOD = 20U;
+const unsigned int SLOT_LENGTH   = 400U;
+const unsigned int POLL_LENGTH   = 11U;
+
+const unsigned char REC80[] = {
+	0x80U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U};
+
+static bool end = false;
+
+#if !defined(_WIN32) && !defined(_WIN64)
+static void sig_handler(int signum)
+{
+	end = true;
+}
+#endif
+
+static void usage()
+{
+	::fprintf(stderr, "Usage: P25Gateway [-p port] [-a address -P port] [-s src id] [-d dst id] [-i call secs] [-l call length secs]\n");
+	::fprintf(stderr, "                  [-m 0=record|1=batch|2=coalesce] [-S stats secs] [-t run secs]\n");
+}
+
+int main(int argc, char** argv)
+{
+	unsigned int port       = 42020U;
+	std::string  peerAddress;
+	unsigned int peerPort   = 0U;
+	unsigned int srcId      = 1234567U;
+	unsigned int dstId      = 10100U;
+	unsigned int callTime   = 30U;
+	unsigned int callLength = 10U;
+	unsigned int mode       = 0U;
+	unsigned int statsTime  = 10U;
+	unsigned int runTime    = 0U;
+
+	for (int currentArg = 1; currentArg < argc; currentArg++) {
+		std::string arg = argv[currentArg];
+		if (arg.length() != 2U || arg.at(0U) != '-' || (currentArg + 1) >= argc) {
+			usage();
+			return 1;
+		}
+
+		const char* value = argv[++currentArg];
+		switch (arg.at(1U)) {
+			case 'p': port        = (unsigned int)::atoi(value); break;
+			case 'a': peerAddress = value;                       break;
+			case 'P': peerPort    = (unsigned int)::atoi(value); break;
+			case 's': srcId       = (unsigned int)::atoi(value); break;
+			case 'd': dstId       = (unsigned int)::atoi(value); break;
+			case 'i': callTime    = (unsigned int)::atoi(value); break;
+			case 'l': callLength  = (unsigned int)::atoi(value); break;
+			case 'm': mode        = (unsigned int)::atoi(value); break;
+			case 'S': statsTime   = (unsigned int)::atoi(value); break;
+			case 't': runTime     = (unsigned int)::atoi(value); break;
+			default:
+				usage();
+				return 1;
+		}
+	}
+
+	if (mode > PSM_COALESCE) {
+		usage();
+		return 1;
+	}
+
+#if !defined(_WIN32) && !defined(_WIN64)
+	::signal(SIGINT,  sig_handler);
+	::signal(SIGTERM, sig_handler);
+#endif
+
+	::LogInitialise(".", "P25Gateway", 0U, 1U);
+
+	CP25Gateway gateway(port, srcId, dstId, callTime, callLength, P25_SEND_MODE(mode), statsTime, runTime);
+
+	if (!peerAddress.empty() && peerPort > 0U)
+		gateway.setPeer(peerAddress, peerPort);
+
+	int ret = gateway.run();
+
+	::LogFinalise();
+
+	return ret;
+}
+
+CP25Gateway::CP25Gateway(unsigned int port, unsigned int srcId, unsigned int dstId, unsigned int callTime, unsigned int callLength, P25_SEND_MODE mode, unsigned int statsTime, unsigned int runTime) :
+m_socket(port),
+m_srcId(srcId),
+m_dstId(dstId),
+m_callTime(callTime),
+m_callLength(callLength),
+m_mode(mode),
+m_statsTime(statsTime),
+m_runTime(runTime),
+m_address(),
+m_port(0U),
+m_linked(false),
+m_active(false),
+m_record(0U),
+m_records(0U),
+m_nextFrame(0ULL),
+m_nextCall(1000ULL),
+m_calls(0U),
+m_txRecords(0U),
+m_txDatagrams(0U),
+m_txWrites(0U),
+m_rxReads(0U),
+m_rxDatagrams(0U),
+m_rxRecords(0U),
+m_rxPolls(0U),
+m_rxUnlinks(0U),
+m_rxEnds(0U)
+{
+	assert(port > 0U);
+}
+
+CP25Gateway::~CP25Gateway()
+{
+}
+
+void CP25Gateway::setPeer(const std::string& address, unsigned int port)
+{
+	in_addr addr = CUDPSocket::lookup(address);
+	if (addr.s_addr == INADDR_NONE)
+		return;
+
+	m_address = addr;
+	m_port    = port;
+	m_linked  = true;
+}
+
+int CP25Gateway::run()
+{
+	if (!m_socket.open()) {
+		LogError("Cannot open the gateway port");
+		return 1;
+	}
+
+	static const char* MODES[] = {"record", "batch", "coalesce"};
+	LogMessage("P25 gateway stand-in started, calls every %us for %us, %u > TG %u, sending per %s", m_callTime, m_callLength, m_srcId, m_dstId, MODES[m_mode]);
+
+	CStopWatch stopWatch;
+	stopWatch.start();
+
+	CTimer statsTimer(1000U, m_statsTime);
+	CTimer runTimer(1000U, m_runTime);
+	statsTimer.start();
+	runTimer.start();
+
+	unsigned long long now  = 0ULL;
+	unsigned long long last = 0ULL;
+
+	unsigned char* buffer = new unsigned char[UDP_BATCH_MAX * SLOT_LENGTH];
+
+	while (!end) {
+		now = stopWatch.elapsed();
+		unsigned int ms = (unsigned int)(now - last);
+		last = now;
+
+		for (;;) {
+			unsigned int lengths[UDP_BATCH_MAX];
+			in_addr addresses[UDP_BATCH_MAX];
+			unsigned int ports[UDP_BATCH_MAX];
+			int n = m_socket.readBatch(buffer, SLOT_LENGTH, UDP_BATCH_MAX, lengths, addresses, ports);
+			if (n <= 0)
+				break;
+
+			m_rxReads++;
+
+			for (int i = 0; i < n; i++)
+				processDatagram(buffer + i * SLOT_LENGTH, lengths[i], addresses[i], ports[i]);
+		}
+
+		if (m_linked && m_callTime > 0U)
+			clockCall(now);
+
+		statsTimer.clock(ms);
+		if (statsTimer.isRunning() && statsTimer.hasExpired()) {
+			writeStats();
+			statsTimer.start();
+		}
+
+		runTimer.clock(ms);
+		if (runTimer.isRunning() && runTimer.hasExpired())
+			end = true;
+
+		CThread::sleep(1U);
+	}
+
+	writeStats();
+
+	delete[] buffer;
+
+	m_socket.close();
+
+	return 0;
+}
+
+void CP25Gateway::processDatagram(const unsigned char* data, unsigned int length, const in_addr& address, unsigned int port)
+{
+	assert(data != NULL);
+
+	m_rxDatagrams++;
+
+	if (length == POLL_LENGTH && (data[0U] == 0xF0U || data[0U] == 0xF1U)) {
+		if (data[0U] == 0xF0U) {
+			if (!m_linked)
+				LogMessage("Bridge %.10s linked from %s:%u", data + 1U, ::inet_ntoa(address), port);
+
+			m_address = address;
+			m_port    = port;
+			m_linked  = true;
+			m_rxPolls++;
+		} else {
+			LogMessage("Bridge %.10s unlinked", data + 1U);
+			m_rxUnlinks++;
+		}
+
+		return;
+	}
+
+	// A coalesced datagram holds several records back to back
+	unsigned int offset = 0U;
+	while (offset < length) {
+		if (data[offset] == 0x80U)
+			m_rxEnds++;
+
+		m_rxRecords++;
+		offset += CP25LDU::getLength(data + offset, length - offset);
+	}
+}
+
+void CP25Gateway::clockCall(unsigned long long now)
+{
+	if (!m_active) {
+		if (now < m_nextCall)
+			return;
+
+		m_active    = true;
+		m_record    = 0U;
+		m_records   = m_callLength * 1000U / RECORD_PERIOD;
+		m_records  -= m_records % P25_LDU_FRAMES;
+		m_nextFrame = now;
+		m_nextCall  = now + m_callTime * 1000ULL;
+		m_calls++;
+	}
+
+	unsigned int frames = m_mode == PSM_RECORD ? 1U : P25_LDU_FRAMES;
+
+	while (m_active && now >= m_nextFrame) {
+		unsigned char buffer[(P25_LDU_FRAMES + 1U) * P25_LDU_RECORD_MAX_LENGTH];
+		unsigned int lengths[P25_LDU_FRAMES + 1U];
+		unsigned int count  = 0U;
+		unsigned int offset = 0U;
+
+		for (unsigned int i = 0U; i < frames && m_record < m_records; i++, m_record++) {
+			lengths[count] = CP25LDU::encode(m_record % P25_LDU_RECORDS, P25_NULL_IMBE, m_srcId, m_dstId, buffer + offset);
+			offset += lengths[count++];
+		}
+
+		if (m_record >= m_records) {
+			::memcpy(buffer + offset, REC80, P25_LDU_EOT_LENGTH);
+			lengths[count++] = P25_LDU_EOT_LENGTH;
+			offset += P25_LDU_EOT_LENGTH;
+			m_active = false;
+		}
+
+		m_txRecords += count;
+
+		switch (m_mode) {
+			case PSM_RECORD:
+				offset = 0U;
+				for (unsigned int i = 0U; i < count; i++) {
+					m_socket.write(buffer + offset, lengths[i], m_address, m_port);
+					offset += lengths[i];
+				}
+				m_txDatagrams += count;
+				m_txWrites    += count;
+				break;
+			case PSM_BATCH:
+				m_socket.writeBatch(buffer, lengths, count, m_address, m_port);
+				m_txDatagrams += count;
+				m_txWrites++;
+				break;
+			default:
+				m_socket.write(buffer, offset, m_address, m_port);
+				m_txDatagrams++;
+				m_txWrites++;
+				break;
+		}
+
+		m_nextFrame += frames * RECORD_PERIOD;
+	}
+}
+
+void CP25Gateway::writeStats() const
+{
+	float perRead = m_rxReads > 0U ? float(m_rxRecords) / float(m_rxReads) : 0.0F;
+
+	LogMessage("%u calls, sent %u records in %u datagrams with %u writes", m_calls, m_txRecords, m_txDatagrams, m_txWrites);
+	LogMessage("Received %u records (%u ended) in %u datagrams with %u reads, %.1f records per read, polls %u, unlinks %u",
+		m_rxRecords, m_rxEnds, m_rxDatagrams, m_rxReads, perRead, m_rxPolls, m_rxUnlinks);
+}
@@ -0,0 +1,80 @@
+/*
+ *   Copyright (C) 2019 by Manuel Sanchez EA7EE
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#if !defined(P25Gateway_H)
+#define P25Gateway_H
+
+#include "UDPSocket.h"
+
+#include <string>
+
+enum P25_SEND_MODE {
+	PSM_RECORD,
+	PSM_BATCH,
+	PSM_COALESCE
+};
+
+// Stand-in for a P25Gateway to measure the P25 network I/O of YSF2P25.
+// Synthetic calls are sent as LDU1/LDU2 superframes with silent IMBE,
+// either one datagram per record every 20ms as a real gateway does, or a
+// whole LDU every 180ms in one batch or one coalesced datagram. The
+// records coming back are counted, with coalesced datagrams split, along
+// with the datagrams and read calls needed for them.
+class CP25Gateway {
+public:
+	CP25Gateway(unsigned int port, unsigned int srcId, unsigned int dstId, unsigned int callTime, unsigned int callLength, P25_SEND_MODE mode, unsigned int statsTime, unsigned int runTime);
+	~CP25Gateway();
+
+	void setPeer(const std::string& address, unsigned int port);
+
+	int run();
+
+private:
+	CUDPSocket         m_socket;
+	unsigned int       m_srcId;
+	unsigned int       m_dstId;
+	unsigned int       m_callTime;
+	unsigned int       m_callLength;
+	P25_SEND_MODE      m_mode;
+	unsigned int       m_statsTime;
+	unsigned int       m_runTime;
+	in_addr            m_address;
+	unsigned int       m_port;
+	bool               m_linked;
+	bool               m_active;
+	unsigned int       m_record;
+	unsigned int       m_records;
+	unsigned long long m_nextFrame;
+	unsigned long long m_nextCall;
+	unsigned int       m_calls;
+	unsigned int       m_txRecords;
+	unsigned int       m_txDatagrams;
+	unsigned int       m_txWrites;
+	unsigned int       m_rxReads;
+	unsigned int       m_rxDatagrams;
+	unsigned int       m_rxRecords;
+	unsigned int       m_rxPolls;
+	unsigned int       m_rxUnlinks;
+	unsigned int       m_rxEnds;
+
+	void processDatagram(const unsigned char* data, unsigned int length, const in_addr& address, unsigned int port);
+	void clockCall(unsigned long long now);
+	void writeStats() const;
+};
+
+#endif
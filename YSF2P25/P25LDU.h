@@ -0,0 +1,76 @@
+/*
+ *   Copyright (C) 2019 by Manuel Sanchez EA7EE
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+ */
+
+#ifndef P25LDU_H
+#define P25LDU_H
+
+// The voice records of one superframe exchanged with the P25Gateway,
+// nine for LDU1 (0x62 to 0x6A) followed by nine for LDU2 (0x6B to 0x73).
+const unsigned int P25_LDU_RECORDS = 18U;
+
+// The voice records of one LDU
+const unsigned int P25_LDU_FRAMES = 9U;
+
+const unsigned int P25_LDU_RECORD_MAX_LENGTH = 22U;
+
+const unsigned int P25_IMBE_LENGTH_BYTES = 11U;
+
+// The terminator record that ends a call
+const unsigned int P25_LDU_EOT_LENGTH = 17U;
+
+// The most one datagram may carry, a whole superframe coalesced with the
+// terminator
+const unsigned int P25_LDU_DATAGRAM_MAX_LENGTH = (P25_LDU_RECORDS + 1U) * P25_LDU_RECORD_MAX_LENGTH;
+
+// The link control field a record carries in bytes 1 to 3, if any
+enum P25_RECORD_LC {
+	P25_RECORD_LC_NONE,
+	P25_RECORD_LC_DSTID,
+	P25_RECORD_LC_SRCID
+};
+
+class CP25Record {
+public:
+	unsigned int         m_length;
+	unsigned int         m_imbe;
+	bool                 m_start;
+	P25_RECORD_LC        m_lc;
+	const unsigned char* m_template;
+};
+
+// Table driven parsing and assembly of the LDU1 and LDU2 voice records.
+class CP25LDU {
+public:
+	// The descriptor of a voice record from its type byte, NULL for any
+	// other record.
+	static const CP25Record* find(unsigned char type);
+
+	// The link control id held by a record that carries one
+	static unsigned int getId(const unsigned char* data);
+
+	// The length of the record at the start of length bytes of a datagram.
+	// Coalesced records follow each other, and anything that is not a
+	// voice record or the terminator runs to the end of the datagram.
+	static unsigned int getLength(const unsigned char* data, unsigned int length);
+
+	// Assemble record n, 0 to 17, of the superframe around an IMBE frame
+	// and return its length.
+	static unsigned int encode(unsigned int n, const unsigned char* imbe, unsigned int srcId, unsigned int dstId, unsigned char* data);
+};
+
+#endif
@@ -17,6 +17,7 @@
  */
 
 #include "P25Network.h"
+#include "P25LDU.h"
 #include "Utils.h"
 #include "Log.h"
 
@@ -24,19 +25,28 @@
 #include <cassert>
 #include <cstring>
 
-CP25Network::CP25Network(const std::string& localAddress, unsigned int localPort, const std::string& gatewayAddress, unsigned int gatewayPort, const std::string& callsign, bool debug) :
+CP25Network::CP25Network(const std::string& localAddress, unsigned int localPort, const std::string& gatewayAddress, unsigned int gatewayPort, const std::string& callsign, bool coalesce, bool debug) :
 m_callsign(callsign),
 m_address(),
 m_port(gatewayPort),
 m_socket(localAddress, localPort),
-m_debug(debug)
+m_coalesce(coalesce),
+m_debug(debug),
+m_datagrams(NULL),
+m_lengths(),
+m_count(0U),
+m_next(0U),
+m_offset(0U)
 {
 	m_callsign.resize(10U, ' ');
 	m_address = CUDPSocket::lookup(gatewayAddress);
+
+	m_datagrams = new unsigned char[UDP_BATCH_MAX * P25_LDU_DATAGRAM_MAX_LENGTH];
 }
 
 CP25Network::~CP25Network()
 {
+	delete[] m_datagrams;
 }
 
 bool CP25Network::open()
@@ -110,9 +120,104 @@ unsigned int CP25Network::readData(unsigned char* data, unsigned int length)
 	return len;
 }
 
+bool CP25Network::writeLDU(const unsigned char* data, const unsigned int* lengths, unsigned int count)
+{
+	assert(data != NULL);
+	assert(lengths != NULL);
+	assert(count > 0U);
+
+	unsigned int length = 0U;
+	for (unsigned int i = 0U; i < count; i++) {
+		if (m_debug)
+			CUtils::dump(1U, "P25 Network Data Sent", data + length, lengths[i]);
+
+		length += lengths[i];
+	}
+
+	if (m_coalesce)
+		return m_socket.write(data, length, m_address, m_port);
+	else
+		return m_socket.writeBatch(data, lengths, count, m_address, m_port);
+}
+
+unsigned int CP25Network::readLDU(unsigned char* data, unsigned int* lengths, unsigned int count)
+{
+	assert(data != NULL);
+	assert(lengths != NULL);
+	assert(count > 0U);
+
+	if (m_next >= m_count && !readDatagrams())
+		return 0U;
+
+	unsigned int records = 0U;
+	while (records < count && m_next < m_count) {
+		const unsigned char* datagram = m_datagrams + m_next * P25_LDU_DATAGRAM_MAX_LENGTH;
+		unsigned int length = CP25LDU::getLength(datagram + m_offset, m_lengths[m_next] - m_offset);
+
+		unsigned char* record = data + records * P25_LDU_RECORD_MAX_LENGTH;
+		lengths[records] = length < P25_LDU_RECORD_MAX_LENGTH ? length : P25_LDU_RECORD_MAX_LENGTH;
+		::memcpy(record, datagram + m_offset, lengths[records]);
+
+		if (m_debug)
+			CUtils::dump(1U, "P25 Network Data Received", record, lengths[records]);
+
+		records++;
+
+		m_offset += length;
+		if (m_offset >= m_lengths[m_next]) {
+			m_offset = 0U;
+			m_next++;
+		}
+	}
+
+	return records;
+}
+
+bool CP25Network::readDatagrams()
+{
+	in_addr addresses[UDP_BATCH_MAX];
+	unsigned int ports[UDP_BATCH_MAX];
+
+	m_count  = 0U;
+	m_next   = 0U;
+	m_offset = 0U;
+
+	// A batch with nothing from the gateway is not the end of the queue
+	while (m_count == 0U) {
+		int n = m_socket.readBatch(m_datagrams, P25_LDU_DATAGRAM_MAX_LENGTH, UDP_BATCH_MAX, m_lengths, addresses, ports);
+		if (n <= 0)
+			return false;
+
+		// Drop anything not from the gateway and close up the gaps
+		for (int i = 0; i < n; i++) {
+			if (m_address.s_addr != addresses[i].s_addr || ports[i] != m_port) {
+				LogMessage("P25 packet received from an invalid source, %08X != %08X and/or %u != %u", m_address.s_addr, addresses[i].s_addr, m_port, ports[i]);
+				continue;
+			}
+
+			if (m_lengths[i] == 0U)
+				continue;
+
+			if (m_count != (unsigned int)i) {
+				::memcpy(m_datagrams + m_count * P25_LDU_DATAGRAM_MAX_LENGTH, m_datagrams + i * P25_LDU_DATAGRAM_MAX_LENGTH, m_lengths[i]);
+				m_lengths[m_count] = m_lengths[i];
+			}
+
+			m_count++;
+		}
+	}
+
+	return true;
+}
+
 void CP25Network::close()
 {
 	m_socket.close();
 
 	LogInfo("Closing P25 network connection");
 }
+
+void CP25Network::setCapture(CCapture* capture, CReplay* replay)
+{
+	m_socket.setCapture(capture, replay, CAPTURE_P25);
+}
@@ -26,7 +26,7 @@
 
 class CP25Network {
 public:
-	CP25Network(const std::string& localAddress, unsigned int localPort, const std::string& gatewayAddress, unsigned int gatewayPort, const std::string& callsign, bool debug);
+	CP25Network(const std::string& localAddress, unsigned int localPort, const std::string& gatewayAddress, unsigned int gatewayPort, const std::string& callsign, bool coalesce, bool debug);
 	~CP25Network();
 
 	bool open();
@@ -35,18 +35,38 @@ public:
 
 	unsigned int readData(unsigned char* data, unsigned int length);
 
+	// Send the records of an LDU, held back to back, with one system call,
+	// or as one datagram when coalescing.
+	bool writeLDU(const unsigned char* data, const unsigned int* lengths, unsigned int count);
+
+	// Read up to count records, each into its own P25_LDU_RECORD_MAX_LENGTH
+	// byte slot, and return how many. The waiting datagrams are read with
+	// one system call and coalesced ones are split into their records.
+	// Records that do not fit are returned by the next call.
+	unsigned int readLDU(unsigned char* data, unsigned int* lengths, unsigned int count);
+
 	bool writePoll();
 
 	bool writeUnlink();
 
 	void close();
 
+	void setCapture(CCapture* capture, CReplay* replay);
+
 private:
-	std::string  m_callsign;
-	in_addr      m_address;
-	unsigned int m_port;
-	CUDPSocket   m_socket;
-	bool         m_debug;
+	std::string    m_callsign;
+	in_addr        m_address;
+	unsigned int   m_port;
+	CUDPSocket     m_socket;
+	bool           m_coalesce;
+	bool           m_debug;
+	unsigned char* m_datagrams;
+	unsigned int   m_lengths[UDP_BATCH_MAX];
+	unsigned int   m_count;
+	unsigned int   m_next;
+	unsigned int   m_offset;
+
+	bool readDatagrams();
 };
 
 #endif
@@ -59,9 +59,26 @@ void CThread::sleep(unsigned int ms)
 	::Sleep(ms);
 }
 
+unsigned long long CThread::getCPUTime()
+{
+	FILETIME creation, exit, kernel, user;
+	if (!::GetThreadTimes(::GetCurrentThread(), &creation, &exit, &kernel, &user))
+		return 0ULL;
+
+	ULARGE_INTEGER k, u;
+	k.LowPart  = kernel.dwLowDateTime;
+	k.HighPart = kernel.dwHighDateTime;
+	u.LowPart  = user.dwLowDateTime;
+	u.HighPart = user.dwHighDateTime;
+
+	// FILETIME is in 100ns units
+	return (k.QuadPart + u.QuadPart) / 10ULL;
+}
+
 #else
 
 #include <unistd.h>
+#include <ctime>
 
 CThread::CThread() :
 m_thread()
@@ -98,4 +115,13 @@ void CThread::sleep(unsigned int ms)
 	::usleep(ms * 1000);
 }
 
+unsigned long long CThread::getCPUTime()
+{
+	struct timespec ts;
+	if (::clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) != 0)
+		return 0ULL;
+
+	return (unsigned long long)ts.tv_sec * 1000000ULL + (unsigned long long)ts.tv_nsec / 1000ULL;
+}
+
 #endif
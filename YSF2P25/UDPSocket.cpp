@@ -30,7 +30,10 @@
 CUDPSocket::CUDPSocket(const std::string& address, unsigned int port) :
 m_address(address),
 m_port(port),
-m_fd(-1)
+m_fd(-1),
+m_capture(NULL),
+m_replay(NULL),
+m_channel(0U)
 {
 	assert(!address.empty());
 
@@ -45,7 +48,10 @@ m_fd(-1)
 CUDPSocket::CUDPSocket(unsigned int port) :
 m_address(),
 m_port(port),
-m_fd(-1)
+m_fd(-1),
+m_capture(NULL),
+m_replay(NULL),
+m_channel(0U)
 {
 #if defined(_WIN32) || defined(_WIN64)
 	WSAData data;
@@ -102,8 +108,20 @@ in_addr CUDPSocket::lookup(const std::string& hostname)
 #endif
 }
 
+void CUDPSocket::setCapture(CCapture* capture, CReplay* replay, unsigned char channel)
+{
+	assert(channel < CAPTURE_CHANNELS);
+
+	m_capture = capture;
+	m_replay  = replay;
+	m_channel = channel;
+}
+
 bool CUDPSocket::open()
 {
+	if (m_replay != NULL)
+		return true;
+
 	m_fd = ::socket(PF_INET, SOCK_DGRAM, 0);
 	if (m_fd < 0) {
 #if defined(_WIN32) || defined(_WIN64)
@@ -161,6 +179,9 @@ int CUDPSocket::read(unsigned char* buffer, unsigned int length, in_addr& addres
 	assert(buffer != NULL);
 	assert(length > 0U);
 
+	if (m_replay != NULL)
+		return m_replay->read(m_channel, buffer, length, address, port);
+
 	// Check that the readfrom() won't block
 	fd_set readFds;
 	FD_ZERO(&readFds);
@@ -212,6 +233,9 @@ int CUDPSocket::read(unsigned char* buffer, unsigned int length, in_addr& addres
 	address = addr.sin_addr;
 	port    = ntohs(addr.sin_port);
 
+	if (m_capture != NULL)
+		m_capture->write(m_channel, false, address, port, buffer, len);
+
 	return len;
 }
 
@@ -220,6 +244,12 @@ bool CUDPSocket::write(const unsigned char* buffer, unsigned int length, const i
 	assert(buffer != NULL);
 	assert(length > 0U);
 
+	if (m_capture != NULL)
+		m_capture->write(m_channel, true, address, port, buffer, length);
+
+	if (m_replay != NULL)
+		return true;
+
 	sockaddr_in addr;
 	::memset(&addr, 0x00, sizeof(sockaddr_in));
 
@@ -252,8 +282,140 @@ bool CUDPSocket::write(const unsigned char* buffer, unsigned int length, const i
 	return true;
 }
 
+int CUDPSocket::readBatch(unsigned char* buffer, unsigned int length, unsigned int count, unsigned int* lengths, in_addr* addresses, unsigned int* ports)
+{
+	assert(buffer != NULL);
+	assert(length > 0U);
+	assert(count > 0U);
+	assert(lengths != NULL);
+	assert(addresses != NULL);
+	assert(ports != NULL);
+
+#if defined(__linux__)
+	// Captured and replayed datagrams go through read() one at a time
+	if (m_capture == NULL && m_replay == NULL) {
+		if (count > UDP_BATCH_MAX)
+			count = UDP_BATCH_MAX;
+
+		mmsghdr msgs[UDP_BATCH_MAX];
+		iovec iovecs[UDP_BATCH_MAX];
+		sockaddr_in addrs[UDP_BATCH_MAX];
+
+		::memset(msgs, 0x00, count * sizeof(mmsghdr));
+
+		for (unsigned int i = 0U; i < count; i++) {
+			iovecs[i].iov_base = buffer + i * length;
+			iovecs[i].iov_len  = length;
+
+			msgs[i].msg_hdr.msg_iov     = &iovecs[i];
+			msgs[i].msg_hdr.msg_iovlen  = 1U;
+			msgs[i].msg_hdr.msg_name    = &addrs[i];
+			msgs[i].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+		}
+
+		int n = ::recvmmsg(m_fd, msgs, count, MSG_DONTWAIT, NULL);
+		if (n < 0) {
+			if (errno == EAGAIN || errno == EWOULDBLOCK)
+				return 0;
+
+			LogError("Error returned from recvmmsg, err: %d", errno);
+			return -1;
+		}
+
+		for (int i = 0; i < n; i++) {
+			lengths[i]   = msgs[i].msg_len;
+			addresses[i] = addrs[i].sin_addr;
+			ports[i]     = ntohs(addrs[i].sin_port);
+		}
+
+		return n;
+	}
+#endif
+
+	unsigned int n = 0U;
+
+	while (n < count) {
+		int len = read(buffer + n * length, length, addresses[n], ports[n]);
+		if (len < 0)
+			return n > 0U ? int(n) : -1;
+		if (len == 0)
+			break;
+
+		lengths[n++] = len;
+	}
+
+	return int(n);
+}
+
+bool CUDPSocket::writeBatch(const unsigned char* buffer, const unsigned int* lengths, unsigned int count, const in_addr& address, unsigned int port)
+{
+	assert(buffer != NULL);
+	assert(lengths != NULL);
+	assert(count > 0U);
+
+#if defined(__linux__)
+	// Captured and replayed datagrams go through write() one at a time
+	if (m_capture == NULL && m_replay == NULL) {
+		assert(count <= UDP_BATCH_MAX);
+
+		sockaddr_in addr;
+		::memset(&addr, 0x00, sizeof(sockaddr_in));
+
+		addr.sin_family = AF_INET;
+		addr.sin_addr   = address;
+		addr.sin_port   = htons(port);
+
+		mmsghdr msgs[UDP_BATCH_MAX];
+		iovec iovecs[UDP_BATCH_MAX];
+
+		::memset(msgs, 0x00, count * sizeof(mmsghdr));
+
+		unsigned int offset = 0U;
+		for (unsigned int i = 0U; i < count; i++) {
+			assert(lengths[i] > 0U);
+
+			iovecs[i].iov_base = (void*)(buffer + offset);
+			iovecs[i].iov_len  = lengths[i];
+			offset += lengths[i];
+
+			msgs[i].msg_hdr.msg_iov     = &iovecs[i];
+			msgs[i].msg_hdr.msg_iovlen  = 1U;
+			msgs[i].msg_hdr.msg_name    = &addr;
+			msgs[i].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+		}
+
+		// A short count is not an error, send the rest from where it stopped
+		unsigned int sent = 0U;
+		while (sent < count) {
+			int ret = ::sendmmsg(m_fd, msgs + sent, count - sent, 0);
+			if (ret < 0) {
+				LogError("Error returned from sendmmsg, err: %d", errno);
+				return false;
+			}
+
+			sent += ret;
+		}
+
+		return true;
+	}
+#endif
+
+	bool ret = true;
+
+	unsigned int offset = 0U;
+	for (unsigned int i = 0U; i < count; i++) {
+		ret = write(buffer + offset, lengths[i], address, port) && ret;
+		offset += lengths[i];
+	}
+
+	return ret;
+}
+
 void CUDPSocket::close()
 {
+	if (m_replay != NULL)
+		return;
+
 #if defined(_WIN32) || defined(_WIN64)
 	::closesocket(m_fd);
 #else
@@ -19,6 +19,8 @@
 #ifndef UDPSocket_H
 #define UDPSocket_H
 
+#include "Capture.h"
+
 #include <string>
 
 #if !defined(_WIN32) && !defined(_WIN64)
@@ -34,6 +36,9 @@
 #include <winsock.h>
 #endif
 
+// The most datagrams moved by one readBatch() or writeBatch()
+const unsigned int UDP_BATCH_MAX = 32U;
+
 class CUDPSocket {
 public:
 	CUDPSocket(const std::string& address, unsigned int port = 0U);
@@ -45,14 +50,30 @@ public:
 	int  read(unsigned char* buffer, unsigned int length, in_addr& address, unsigned int& port);
 	bool write(const unsigned char* buffer, unsigned int length, const in_addr& address, unsigned int port);
 
+	// Read up to count waiting datagrams, each into its own slot of length
+	// bytes, and return how many were read. On Linux this is one system
+	// call.
+	int  readBatch(unsigned char* buffer, unsigned int length, unsigned int count, unsigned int* lengths, in_addr* addresses, unsigned int* ports);
+
+	// Send count datagrams held back to back in buffer, in one system call
+	// on Linux.
+	bool writeBatch(const unsigned char* buffer, const unsigned int* lengths, unsigned int count, const in_addr& address, unsigned int port);
+
 	void close();
 
+	// Record all traffic to capture, or take the received datagrams from
+	// replay instead of the network and only record what is sent.
+	void setCapture(CCapture* capture, CReplay* replay, unsigned char channel);
+
 	static in_addr lookup(const std::string& hostName);
 
 private:
 	std::string    m_address;
 	unsigned short m_port;
 	int            m_fd;
+	CCapture*      m_capture;
+	CReplay*       m_replay;
+	unsigned char  m_channel;
 };
 
 #endif
@@ -33,67 +33,12 @@
 // Unpacked IMBE silence
 const unsigned char IMBE_SILENCE[] = {0x04U, 0x0CU, 0xFDU, 0x7BU, 0xFBU, 0x7DU, 0xF2U, 0x7BU, 0x3DU, 0x9EU, 0x44};
 
-const unsigned char REC62[] = {
-	0x62U, 0x02U, 0x02U, 0x0CU, 0x0BU, 0x12U, 0x64U, 0x00U, 0x00U, 0x80U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U,
-	0x00U, 0x00U, 0x00U, 0x00U, 0x00U};
-
-const unsigned char REC63[] = {
-	0x63U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x02U};
-
-const unsigned char REC64[] = {
-	0x64U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x02U};
-
-const unsigned char REC65[] = {
-	0x65U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x02U};
-
-const unsigned char REC66[] = {
-	0x66U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x02U};
-
-const unsigned char REC67[] = {
-	0x67U, 0xF0U, 0x9DU, 0x6AU, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x02U};
-
-const unsigned char REC68[] = {
-	0x68U, 0x19U, 0xD4U, 0x26U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x02U};
-
-const unsigned char REC69[] = {
-	0x69U, 0xE0U, 0xEBU, 0x7BU, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x02U};
-
-const unsigned char REC6A[] = {
-	0x6AU, 0x00U, 0x00U, 0x02U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U};
-
-const unsigned char REC6B[] = {
-	0x6BU, 0x02U, 0x02U, 0x0CU, 0x0BU, 0x12U, 0x64U, 0x00U, 0x00U, 0x80U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U,
-	0x00U, 0x00U, 0x00U, 0x00U, 0x00U};
-
-const unsigned char REC6C[] = {
-	0x6CU, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x02U};
-
-const unsigned char REC6D[] = {
-	0x6DU, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x02U};
-
-const unsigned char REC6E[] = {
-	0x6EU, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x02U};
-
-const unsigned char REC6F[] = {
-	0x6FU, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x02U};
-
-const unsigned char REC70[] = {
-	0x70U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x02U};
-
-const unsigned char REC71[] = {
-	0x71U, 0xACU, 0xB8U, 0xA4U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x02U};
-
-const unsigned char REC72[] = {
-	0x72U, 0x9BU, 0xDCU, 0x75U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x02U};
-
-const unsigned char REC73[] = {
-	0x73U, 0x00U, 0x00U, 0x02U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U};
-
 const unsigned char REC80[] = {
 	0x80U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U, 0x00U};
 
 #define P25_FRAME_PER       15U
 #define YSF_FRAME_PER       90U
+#define P25_LDU_TIMEOUT     360U
 
 #if defined(_WIN32) || defined(_WIN64)
 const char* DEFAULT_INI_FILE = "YSF2P25.ini";
@@ -176,14 +121,26 @@ m_netDst(),
 m_ysfSrc(),
 m_ysfFrame(NULL),
 m_p25Frame(NULL),
+m_p25LDU(NULL),
+m_p25LDULengths(),
+m_p25LDUCount(0U),
+m_p25LDULength(0U),
+m_p25Records(NULL),
 m_dtmf(NULL),
 m_p25Frames(0U),
 m_ysfFrames(0U),
-m_p25info(false)
+m_p25info(false),
+m_capture(NULL),
+m_replay(NULL)
 {
 	m_ysfFrame = new unsigned char[200U];
 	m_p25Frame = new unsigned char[100U];
 
+	// One LDU and the terminator waiting to be sent, and the records of
+	// up to a superframe received at once
+	m_p25LDU     = new unsigned char[(P25_LDU_FRAMES + 1U) * P25_LDU_RECORD_MAX_LENGTH];
+	m_p25Records = new unsigned char[P25_LDU_RECORDS * P25_LDU_RECORD_MAX_LENGTH];
+
 	::memset(m_ysfFrame, 0U, 200U);
 	::memset(m_p25Frame, 0U, 100U);
 }
@@ -192,6 +149,8 @@ CYSF2P25::~CYSF2P25()
 {
 	delete[] m_ysfFrame;
 	delete[] m_p25Frame;
+	delete[] m_p25LDU;
+	delete[] m_p25Records;
 }
 
 int CYSF2P25::run()
@@ -294,8 +253,27 @@ int CYSF2P25::run()
 	unsigned int localPort   = m_conf.getLocalPort();
 	bool debug               = m_conf.getNetworkDebug();
 
+	unsigned int captureMode = m_conf.getCaptureMode();
+	if (captureMode == 1U) {
+		m_capture = new CCapture(m_conf.getCaptureFile());
+		if (!m_capture->open()) {
+			::LogFinalise();
+			return 1;
+		}
+	} else if (captureMode == 2U) {
+		m_replay = new CReplay(m_conf.getCaptureFile());
+		m_capture = new CCapture(m_conf.getCaptureOutput());
+		if (!m_replay->open() || !m_capture->open()) {
+			::LogFinalise();
+			return 1;
+		}
+
+		m_replay->start();
+	}
+
 	m_ysfNetwork = new CYSFNetwork(localAddress, localPort, m_callsign, debug);
 	m_ysfNetwork->setDestination(dstAddress, dstPort);
+	m_ysfNetwork->setCapture(m_capture, m_replay);
 
 	ret = m_ysfNetwork->open();
 	if (!ret) {
@@ -308,9 +286,11 @@ int CYSF2P25::run()
 	unsigned int p25_dstPort     = m_conf.getP25DstPort();
 	std::string p25_localAddress = m_conf.getP25LocalAddress();
 	unsigned int p25_localPort   = m_conf.getP25LocalPort();
+	bool p25_coalesce            = m_conf.getP25NetworkCoalesce();
 	bool p25_debug               = m_conf.getP25NetworkDebug();
 
-	m_p25Network = new CP25Network(p25_localAddress, p25_localPort, p25_dstAddress, p25_dstPort, m_callsign, p25_debug);
+	m_p25Network = new CP25Network(p25_localAddress, p25_localPort, p25_dstAddress, p25_dstPort, m_callsign, p25_coalesce, p25_debug);
+	m_p25Network->setCapture(m_capture, m_replay);
 
 	ret = m_p25Network->open();
 	if (!ret) {
@@ -327,6 +307,7 @@ int CYSF2P25::run()
 
 	CTimer networkWatchdog(100U, 0U, 1500U);
 	CTimer pollTimer(1000U, 5U);
+	CTimer replayTimer(1000U, 2U);
 
 	std::string suffix = m_conf.getSuffix();
 	std::string name = m_conf.getDescription();
@@ -456,118 +437,31 @@ int CYSF2P25::run()
 			unsigned int p25FrameType = m_conv.getP25(m_p25Frame);
 
 			if(p25FrameType == TAG_HEADER) {
+				// Whatever a stream without a terminator left goes out first
+				writeP25LDU();
 				p25_cnt = 0U;
 				p25Watch.start();
 			}
 			else if(p25FrameType == TAG_EOT) {
-				m_p25Network->writeData(REC80, 17U);
+				// The terminator goes out with the rest of the last LDU
+				::memcpy(m_p25LDU + m_p25LDULength, REC80, 17U);
+				m_p25LDULengths[m_p25LDUCount++] = 17U;
+				m_p25LDULength += 17U;
+				writeP25LDU();
 				p25Watch.start();
 			}
 			else if(p25FrameType == TAG_DATA) {
-				unsigned int p25step = p25_cnt % 18U;
 				//CUtils::dump(1U, "P25 Data", m_p25Frame, 11U);
 
 				if (p25_cnt > 2U) {
-					switch (p25step) {
-					case 0x00U:
-						::memcpy(buffer, REC62, 22U);
-						::memcpy(buffer + 10U, m_p25Frame, 11U);
-						m_p25Network->writeData(buffer, 22U);
-						break;
-					case 0x01U:
-						::memcpy(buffer, REC63, 14U);
-						::memcpy(buffer + 1U, m_p25Frame, 11U);
-						m_p25Network->writeData(buffer, 14U);
-						break;
-					case 0x02U:
-						::memcpy(buffer, REC64, 17U);
-						::memcpy(buffer + 5U, m_p25Frame, 11U);
-						buffer[1U] = 0x00U;
-						m_p25Network->writeData(buffer, 17U);
-						break;
-					case 0x03U:
-						::memcpy(buffer, REC65, 17U);
-						::memcpy(buffer + 5U, m_p25Frame, 11U);
-						buffer[1U] = (m_dstid >> 16) & 0xFFU;
-						buffer[2U] = (m_dstid >> 8) & 0xFFU;
-						buffer[3U] = (m_dstid >> 0) & 0xFFU;
-						m_p25Network->writeData(buffer, 17U);
-						break;
-					case 0x04U:
-						::memcpy(buffer, REC66, 17U);
-						::memcpy(buffer + 5U, m_p25Frame, 11U);
-						buffer[1U] = (m_srcid >> 16) & 0xFFU;
-						buffer[2U] = (m_srcid >> 8) & 0xFFU;
-						buffer[3U] = (m_srcid >> 0) & 0xFFU;
-						m_p25Network->writeData(buffer, 17U);
-						break;
-					case 0x05U:
-						::memcpy(buffer, REC67, 17U);
-						::memcpy(buffer + 5U, m_p25Frame, 11U);
-						m_p25Network->writeData(buffer, 17U);
-						break;
-					case 0x06U:
-						::memcpy(buffer, REC68, 17U);
-						::memcpy(buffer + 5U, m_p25Frame, 11U);
-						m_p25Network->writeData(buffer, 17U);
-						break;
-					case 0x07U:
-						::memcpy(buffer, REC69, 17U);
-						::memcpy(buffer + 5U, m_p25Frame, 11U);
-						m_p25Network->writeData(buffer, 17U);
-						break;
-					case 0x08U:
-						::memcpy(buffer, REC6A, 16U);
-						::memcpy(buffer + 4U, m_p25Frame, 11U);
-						m_p25Network->writeData(buffer, 16U);
-						break;
-					case 0x09U:
-						::memcpy(buffer, REC6B, 22U);
-						::memcpy(buffer + 10U, m_p25Frame, 11U);
-						m_p25Network->writeData(buffer, 22U);
-						break;
-					case 0x0AU:
-						::memcpy(buffer, REC6C, 14U);
-						::memcpy(buffer + 1U, m_p25Frame, 11U);
-						m_p25Network->writeData(buffer, 14U);
-						break;
-					case 0x0BU:
-						::memcpy(buffer, REC6D, 17U);
-						::memcpy(buffer + 5U, m_p25Frame, 11U);
-						m_p25Network->writeData(buffer, 17U);
-						break;
-					case 0x0CU:
-						::memcpy(buffer, REC6E, 17U);
-						::memcpy(buffer + 5U, m_p25Frame, 11U);
-						m_p25Network->writeData(buffer, 17U);
-						break;
-					case 0x0DU:
-						::memcpy(buffer, REC6F, 17U);
-						::memcpy(buffer + 5U, m_p25Frame, 11U);
-						m_p25Network->writeData(buffer, 17U);
-						break;
-					case 0x0EU:
-						::memcpy(buffer, REC70, 17U);
-						::memcpy(buffer + 5U, m_p25Frame, 11U);
-						buffer[1U] = 0x80U;
-						m_p25Network->writeData(buffer, 17U);
-						break;
-					case 0x0FU:
-						::memcpy(buffer, REC71, 17U);
-						::memcpy(buffer + 5U, m_p25Frame, 11U);
-						m_p25Network->writeData(buffer, 17U);
-						break;
-					case 0x10U:
-						::memcpy(buffer, REC72, 17U);
-						::memcpy(buffer + 5U, m_p25Frame, 11U);
-						m_p25Network->writeData(buffer, 17U);
-						break;
-					case 0x11U:
-						::memcpy(buffer, REC73, 16U);
-						::memcpy(buffer + 4U, m_p25Frame, 11U);
-						m_p25Network->writeData(buffer, 16U);
-						break;
-					}
+					unsigned int n = p25_cnt % P25_LDU_RECORDS;
+					unsigned int length = CP25LDU::encode(n, m_p25Frame, m_srcid, m_dstid, m_p25LDU + m_p25LDULength);
+					m_p25LDULengths[m_p25LDUCount++] = length;
+					m_p25LDULength += length;
+
+					// Each LDU is sent once its last record is in
+					if ((n % P25_LDU_FRAMES) == (P25_LDU_FRAMES - 1U) || m_p25LDUCount == P25_LDU_FRAMES)
+						writeP25LDU();
 				}
 
 				p25_cnt++;
@@ -575,30 +469,47 @@ int CYSF2P25::run()
 			}
 		}
 
-		while (m_p25Network->readData(m_p25Frame, 22U) > 0U) {
-			//CUtils::dump(1U, "P25 Data", m_p25Frame, 22U);
-			if (m_p25Frame[0U] != 0xF0U && m_p25Frame[0U] != 0xF1U) {
-				if (m_p25Frame[0U] == 0x62U && !m_p25info) {
-					m_p25Frames = 0;
-					m_conv.putP25Header();
-				} else if (m_p25Frame[0U] == 0x65U && !m_p25info) {
-					dstId  = (m_p25Frame[1U] << 16) & 0xFF0000U;
-					dstId |= (m_p25Frame[2U] << 8)  & 0x00FF00U;
-					dstId |= (m_p25Frame[3U] << 0)  & 0x0000FFU;
-					m_netDst = m_lookup->findCS(dstId);
-				} else if (m_p25Frame[0U] == 0x66U && !m_p25info) {
-					srcId  = (m_p25Frame[1U] << 16) & 0xFF0000U;
-					srcId |= (m_p25Frame[2U] << 8)  & 0x00FF00U;
-					srcId |= (m_p25Frame[3U] << 0)  & 0x0000FFU;
-					m_netSrc = m_lookup->findCS(srcId);
-					LogMessage("Received P25 audio: Src: %s Dst: %s", m_netSrc.c_str(), m_netDst.c_str());
-					m_p25info = true;
-				} else if (m_p25Frame[0U] == 0x80U) {
+		// A stream that stops without a terminator leaves its last records
+		// waiting, they go out once none has come for two LDU periods
+		if (m_p25LDUCount > 0U && p25Watch.elapsed() > P25_LDU_TIMEOUT)
+			writeP25LDU();
+
+		unsigned int lengths[P25_LDU_RECORDS];
+		unsigned int records;
+		while ((records = m_p25Network->readLDU(m_p25Records, lengths, P25_LDU_RECORDS)) > 0U) {
+			for (unsigned int i = 0U; i < records; i++) {
+				const unsigned char* data = m_p25Records + i * P25_LDU_RECORD_MAX_LENGTH;
+				//CUtils::dump(1U, "P25 Data", data, lengths[i]);
+				if (data[0U] == 0xF0U || data[0U] == 0xF1U)
+					continue;
+
+				if (data[0U] == 0x80U) {
 					LogMessage("P25 received end of voice transmission, %.1f seconds", float(m_p25Frames) / 50.0F);
 					m_p25info = false;
 					m_conv.putP25EOT();
+					continue;
+				}
+
+				const CP25Record* record = CP25LDU::find(data[0U]);
+				if (record == NULL)
+					continue;
+
+				if (!m_p25info) {
+					if (record->m_start) {
+						m_p25Frames = 0;
+						m_conv.putP25Header();
+					} else if (record->m_lc == P25_RECORD_LC_DSTID) {
+						dstId = CP25LDU::getId(data);
+						m_netDst = m_lookup->findCS(dstId);
+					} else if (record->m_lc == P25_RECORD_LC_SRCID) {
+						srcId = CP25LDU::getId(data);
+						m_netSrc = m_lookup->findCS(srcId);
+						LogMessage("Received P25 audio: Src: %s Dst: %s", m_netSrc.c_str(), m_netDst.c_str());
+						m_p25info = true;
+					}
 				}
-				m_conv.putP25(m_p25Frame);
+
+				m_conv.putP25(data + record->m_imbe);
 				m_p25Frames++;
 			}
 		}
@@ -726,7 +637,21 @@ int CYSF2P25::run()
 			pollTimer.start();
 		}
 
-		if (ms < 5U)
+		// Give the conversion time to drain once the replay has run out
+		if (m_replay != NULL && m_replay->isFinished()) {
+			if (!replayTimer.isRunning())
+				replayTimer.start();
+
+			replayTimer.clock(ms);
+			if (replayTimer.hasExpired()) {
+				LogMessage("Replay finished, %u ms of traffic in %.3f s of CPU", m_replay->getElapsed(), double(CThread::getCPUTime()) / 1000000.0);
+				end = 1;
+			}
+		}
+
+		if (m_replay != NULL)
+			m_replay->sleep(5U);
+		else if (ms < 5U)
 			CThread::sleep(5U);
 	}
 
@@ -741,6 +666,13 @@ int CYSF2P25::run()
 		delete m_dtmf;
 	}
 
+	if (m_capture != NULL) {
+		m_capture->close();
+		delete m_capture;
+	}
+
+	delete m_replay;
+
 	::LogFinalise();
 
 	return 0;
@@ -800,26 +732,26 @@ std::string CYSF2P25::getSrcYSF(const unsigned char* buffer)
 
 void CYSF2P25::sendP25PTT(unsigned int src, unsigned int dst)
 {
-	unsigned char buffer[20U];
-
-	// Just send records 65 & 66 to activate linking in P25Gateway
-
-	// Send record 65
-	::memcpy(buffer, REC65, 17U);
-	::memcpy(buffer + 5U, IMBE_SILENCE, 11U);
-	buffer[1U] = (dst >> 16) & 0xFFU;
-	buffer[2U] = (dst >> 8) & 0xFFU;
-	buffer[3U] = (dst >> 0) & 0xFFU;
-	m_p25Network->writeData(buffer, 17U);
-
-	// Send record 66
-	::memcpy(buffer, REC66, 17U);
-	::memcpy(buffer + 5U, IMBE_SILENCE, 11U);
-	buffer[1U] = (src >> 16) & 0xFFU;
-	buffer[2U] = (src >> 8) & 0xFFU;
-	buffer[3U] = (src >> 0) & 0xFFU;
-	m_p25Network->writeData(buffer, 17U);
-
-	// Send EOT
-	m_p25Network->writeData(REC80, 17U);
+	unsigned char buffer[3U * P25_LDU_RECORD_MAX_LENGTH];
+
+	// Just send records 65 & 66 to activate linking in P25Gateway,
+	// followed by the EOT
+	unsigned int lengths[3U];
+	lengths[0U] = CP25LDU::encode(3U, IMBE_SILENCE, src, dst, buffer);
+	lengths[1U] = CP25LDU::encode(4U, IMBE_SILENCE, src, dst, buffer + lengths[0U]);
+	::memcpy(buffer + lengths[0U] + lengths[1U], REC80, 17U);
+	lengths[2U] = 17U;
+
+	m_p25Network->writeLDU(buffer, lengths, 3U);
+}
+
+void CYSF2P25::writeP25LDU()
+{
+	if (m_p25LDUCount == 0U)
+		return;
+
+	m_p25Network->writeLDU(m_p25LDU, m_p25LDULengths, m_p25LDUCount);
+
+	m_p25LDUCount  = 0U;
+	m_p25LDULength = 0U;
 }
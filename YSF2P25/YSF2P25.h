@@ -25,11 +25,13 @@
 #include "ModeConv.h"
 #include "DMRLookup.h"
 #include "UDPSocket.h"
+#include "Capture.h"
 #include "StopWatch.h"
 #include "Version.h"
 #include "YSFPayload.h"
 #include "YSFNetwork.h"
 #include "P25Network.h"
+#include "P25LDU.h"
 #include "YSFFICH.h"
 #include "Thread.h"
 #include "Timer.h"
@@ -68,12 +70,20 @@ private:
 	std::string      m_ysfSrc;
 	unsigned char*   m_ysfFrame;
 	unsigned char*   m_p25Frame;
+	unsigned char*   m_p25LDU;
+	unsigned int     m_p25LDULengths[P25_LDU_FRAMES + 1U];
+	unsigned int     m_p25LDUCount;
+	unsigned int     m_p25LDULength;
+	unsigned char*   m_p25Records;
 	CDTMF*           m_dtmf;
 	unsigned int     m_p25Frames;
 	unsigned int     m_ysfFrames;
 	bool             m_p25info;
+	CCapture*        m_capture;
+	CReplay*         m_replay;
 
 	void sendP25PTT(unsigned int src, unsigned int dst);
+	void writeP25LDU();
 	unsigned int findYSFID(std::string cs, bool showdst);
 	std::string getSrcYSF(const unsigned char* source);
 };
@@ -26,6 +26,8 @@ const unsigned int YSF_SYNC_LENGTH_BYTES = 5U;
 
 const unsigned int YSF_FICH_LENGTH_BYTES = 25U;
 
+const unsigned int YSF_VD_MODE2_DCH_LENGTH_BYTES = 25U;
+
 const unsigned char YSF_SYNC_OK = 0x01U;
 
 const unsigned int  YSF_CALLSIGN_LENGTH   = 10U;
@@ -27,6 +27,7 @@
 #include <cstdio>
 #include <cassert>
 #include <cstring>
+#include <cstdint>
 
 const unsigned char BIT_MASK_TABLE[] = {0x80U, 0x40U, 0x20U, 0x10U, 0x08U, 0x04U, 0x02U, 0x01U};
 
@@ -55,10 +56,28 @@ const unsigned int INTERLEAVE_TABLE[] = {
   36U, 76U, 116U, 156U, 196U,
   38U, 78U, 118U, 158U, 198U};
 
+// Encoded FICHs, kept per thread so no locking is needed. A stream only
+// uses a handful of FICHs, mostly differing in FN, so a small direct
+// mapped table keyed on the four FICH bytes catches nearly every frame.
+const unsigned int FICH_CACHE_BITS = 6U;
+
+class CFICHCacheEntry {
+public:
+	bool          m_valid;
+	uint32_t      m_key;
+	unsigned char m_crc[2U];
+	unsigned char m_data[YSF_FICH_LENGTH_BYTES];
+};
+
+static thread_local CFICHCacheEntry FICH_CACHE[1U << FICH_CACHE_BITS];
+
 CYSFFICH::CYSFFICH() :
 m_fich(NULL)
 {
 	m_fich  = new unsigned char[6U];
+
+	// Fields that are never set must not carry heap contents on the air
+	::memset(m_fich, 0x00U, 6U);
 }
 
 CYSFFICH::~CYSFFICH()
@@ -112,6 +131,26 @@ void CYSFFICH::encode(unsigned char* bytes)
 	// Skip the sync bytes
 	bytes += YSF_SYNC_LENGTH_BYTES;
 
+	uint32_t key = (uint32_t(m_fich[0U]) << 24) | (uint32_t(m_fich[1U]) << 16) | (uint32_t(m_fich[2U]) << 8) | uint32_t(m_fich[3U]);
+
+	CFICHCacheEntry& entry = FICH_CACHE[(key * 2654435761U) >> (32U - FICH_CACHE_BITS)];
+	if (!entry.m_valid || entry.m_key != key) {
+		encodeFICH(entry.m_data);
+
+		entry.m_key = key;
+		entry.m_crc[0U] = m_fich[4U];
+		entry.m_crc[1U] = m_fich[5U];
+		entry.m_valid = true;
+	}
+
+	m_fich[4U] = entry.m_crc[0U];
+	m_fich[5U] = entry.m_crc[1U];
+
+	::memcpy(bytes, entry.m_data, YSF_FICH_LENGTH_BYTES);
+}
+
+void CYSFFICH::encodeFICH(unsigned char* bytes)
+{
 	CCRC::addCCITT162(m_fich, 6U);
 
 	unsigned int b0 = ((m_fich[0U] << 4) & 0xFF0U) | ((m_fich[1U] >> 4) & 0x00FU);
@@ -178,3 +178,8 @@ void CYSFNetwork::close()
 
 	LogMessage("Closing YSF network connection");
 }
+
+void CYSFNetwork::setCapture(CCapture* capture, CReplay* replay)
+{
+	m_socket.setCapture(capture, replay, CAPTURE_YSF);
+}
@@ -50,6 +50,8 @@ public:
 
 	void close();
 
+	void setCapture(CCapture* capture, CReplay* replay);
+
 private:
 	std::string                m_callsign;
 	CUDPSocket                 m_socket;
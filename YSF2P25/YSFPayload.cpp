@@ -338,8 +338,17 @@ bool CYSFPayload::readDataFRModeData2(const unsigned char* data, unsigned char*
 
 void CYSFPayload::writeVDMode2Data(unsigned char* data, const unsigned char* dt)
 {
-	data += YSF_SYNC_LENGTH_BYTES + YSF_FICH_LENGTH_BYTES;
-	
+	unsigned char dch[YSF_VD_MODE2_DCH_LENGTH_BYTES];
+	encodeVDMode2Data(dt, dch);
+
+	writeVDMode2DCH(data, dch);
+}
+
+void CYSFPayload::encodeVDMode2Data(const unsigned char* dt, unsigned char* dch)
+{
+	assert(dt != NULL);
+	assert(dch != NULL);
+
 	unsigned char dt_tmp[13];
 	::memcpy(dt_tmp, dt, YSF_CALLSIGN_LENGTH);
 
@@ -354,7 +363,6 @@ void CYSFPayload::writeVDMode2Data(unsigned char* data, const unsigned char* dt)
 	conv.start();
 	conv.encode(dt_tmp, convolved, 100U);
 
-	unsigned char bytes[25U];
 	unsigned int j = 0U;
 	for (unsigned int i = 0U; i < 100U; i++) {
 		unsigned int n = INTERLEAVE_TABLE_5_20[i];
@@ -365,21 +373,28 @@ void CYSFPayload::writeVDMode2Data(unsigned char* data, const unsigned char* dt)
 		bool s1 = READ_BIT1(convolved, j) != 0U;
 		j++;
 
-		WRITE_BIT1(bytes, n, s0);
+		WRITE_BIT1(dch, n, s0);
 
 		n++;
-		WRITE_BIT1(bytes, n, s1);
+		WRITE_BIT1(dch, n, s1);
 	}
+}
+
+void CYSFPayload::writeVDMode2DCH(unsigned char* data, const unsigned char* dch)
+{
+	assert(data != NULL);
+	assert(dch != NULL);
+
+	data += YSF_SYNC_LENGTH_BYTES + YSF_FICH_LENGTH_BYTES;
 
 	unsigned char* p1 = data;
-	unsigned char* p2 = bytes;
+	const unsigned char* p2 = dch;
 	for (unsigned int i = 0U; i < 5U; i++) {
 		::memcpy(p1, p2, 5U);
 		p1 += 18U; p2 += 5U;
 	}
 }
 
-
 bool CYSFPayload::readVDMode1Data(const unsigned char* data, unsigned char* dt)
 {
 	assert(data != NULL);